@@ -3,9 +3,37 @@
 #include <Utf8.h>
 
 #include <algorithm>
+#include <cstdlib>
 
 #include "EpdFontFamily.h"
 
+namespace {
+constexpr int16_t METRICS_EMPTY = INT16_MIN;
+constexpr int16_t METRICS_MISSING = INT16_MAX;
+
+// CUSTOM TRACKING: in forced bold mode letter spacing is reduced by 1px, except after normal and non-breaking spaces
+int trackingAdjustment(const uint32_t cp) {
+  return EpdFontFamily::globalForceBold && cp != ' ' && cp != 0x00A0 ? -1 : 0;
+}
+}  // namespace
+
+// Latin-1 codepoints index a table directly; everything else goes through a small hashed table where a colliding
+// codepoint simply replaces the previous entry. ~1.3KB per font, and only fonts that are actually measured get one.
+struct EpdFont::MetricsCache {
+  static constexpr uint32_t DIRECT_SIZE = 256;
+  static constexpr uint32_t HASHED_BITS = 5;
+
+  struct HashedEntry {
+    uint32_t cp;  // 0 = empty
+    GlyphMetrics metrics;
+  };
+
+  GlyphMetrics direct[DIRECT_SIZE];
+  HashedEntry hashed[1 << HASHED_BITS];
+};
+
+EpdFont::~EpdFont() { free(metricsCache); }
+
 void EpdFont::getTextBounds(const char* string, const int startX, const int startY, int* minX, int* minY, int* maxX,
                             int* maxY) const {
   *minX = startX;
@@ -37,13 +65,7 @@ void EpdFont::getTextBounds(const char* string, const int startX, const int star
     *minY = std::min(*minY, cursorY + glyph->top - glyph->height);
     *maxY = std::max(*maxY, cursorY + glyph->top);
 
-    cursorX += glyph->advanceX;
-
-    // CUSTOM TRACKING: If we are in forced bold mode, reduce letter spacing by 1px
-    // We explicitly exclude normal spaces (' ') and non-breaking spaces (0x00A0)
-    if (EpdFontFamily::globalForceBold && cp != ' ' && cp != 0x00A0) {
-      cursorX -= 1;
-    }
+    cursorX += glyph->advanceX + trackingAdjustment(cp);
   }
 }
 
@@ -56,6 +78,83 @@ void EpdFont::getTextDimensions(const char* string, int* w, int* h) const {
   *h = maxY - minY;
 }
 
+EpdFont::GlyphMetrics EpdFont::lookupGlyphMetrics(const uint32_t cp) const {
+  const EpdGlyph* glyph = getGlyph(cp);
+  if (!glyph) {
+    glyph = getGlyph(REPLACEMENT_GLYPH);
+  }
+  if (!glyph) {
+    return {METRICS_MISSING, 0, 0};
+  }
+  return {glyph->left, glyph->width, glyph->advanceX};
+}
+
+EpdFont::GlyphMetrics EpdFont::getGlyphMetrics(const uint32_t cp) const {
+  if (!metricsCache) {
+    if (metricsCacheFailed) {
+      return lookupGlyphMetrics(cp);
+    }
+    metricsCache = static_cast<MetricsCache*>(malloc(sizeof(MetricsCache)));
+    if (!metricsCache) {
+      metricsCacheFailed = true;
+      return lookupGlyphMetrics(cp);
+    }
+    for (auto& metrics : metricsCache->direct) {
+      metrics.left = METRICS_EMPTY;
+    }
+    for (auto& entry : metricsCache->hashed) {
+      entry.cp = 0;
+    }
+  }
+
+  if (cp < MetricsCache::DIRECT_SIZE) {
+    GlyphMetrics& metrics = metricsCache->direct[cp];
+    if (metrics.left == METRICS_EMPTY) {
+      metrics = lookupGlyphMetrics(cp);
+    }
+    return metrics;
+  }
+
+  // Fibonacci hashing spreads neighbouring codepoints (one script's letters) over the table
+  auto& entry = metricsCache->hashed[(cp * 2654435761u) >> (32 - MetricsCache::HASHED_BITS)];
+  if (entry.cp != cp) {
+    entry.metrics = lookupGlyphMetrics(cp);
+    entry.cp = cp;
+  }
+  return entry.metrics;
+}
+
+void EpdFont::extendText(TextExtent& extent, const uint32_t cp) const {
+  const GlyphMetrics metrics = getGlyphMetrics(cp);
+  if (metrics.left == METRICS_MISSING) {
+    return;
+  }
+  extent.minX = std::min(extent.minX, extent.cursorX + metrics.left);
+  extent.maxX = std::max(extent.maxX, extent.cursorX + metrics.left + metrics.width);
+  extent.cursorX += metrics.advanceX + trackingAdjustment(cp);
+}
+
+int EpdFont::getTextWidth(const char* string) const {
+  TextExtent extent;
+  uint32_t cp;
+  while ((cp = utf8NextCodepoint(reinterpret_cast<const uint8_t**>(&string)))) {
+    extendText(extent, cp);
+  }
+  return extent.width();
+}
+
+int EpdFont::getTextAdvanceX(const char* string) const {
+  int cursorX = 0;
+  uint32_t cp;
+  while ((cp = utf8NextCodepoint(reinterpret_cast<const uint8_t**>(&string)))) {
+    const GlyphMetrics metrics = getGlyphMetrics(cp);
+    if (metrics.left != METRICS_MISSING) {
+      cursorX += metrics.advanceX + trackingAdjustment(cp);
+    }
+  }
+  return cursorX;
+}
+
 bool EpdFont::hasPrintableChars(const char* string) const {
   int w = 0, h = 0;
 
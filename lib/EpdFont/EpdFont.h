@@ -2,13 +2,42 @@
 #include "EpdFontData.h"
 
 class EpdFont {
+  // Horizontal glyph metrics, all that width measurement needs
+  struct GlyphMetrics {
+    int16_t left;  // METRICS_MISSING if neither the glyph nor the replacement glyph exists
+    uint8_t width;
+    uint8_t advanceX;
+  };
+  // Direct-mapped metrics cache, allocated on the first measurement (see EpdFont.cpp)
+  struct MetricsCache;
+  mutable MetricsCache* metricsCache = nullptr;
+  mutable bool metricsCacheFailed = false;
+
   void getTextBounds(const char* string, int startX, int startY, int* minX, int* minY, int* maxX, int* maxY) const;
+  GlyphMetrics lookupGlyphMetrics(uint32_t cp) const;
+  GlyphMetrics getGlyphMetrics(uint32_t cp) const;
 
  public:
   const EpdFontData* data;
   explicit EpdFont(const EpdFontData* data) : data(data) {}
-  ~EpdFont() = default;
+  ~EpdFont();
+  EpdFont(const EpdFont&) = delete;
+  EpdFont& operator=(const EpdFont&) = delete;
   void getTextDimensions(const char* string, int* w, int* h) const;
+  // Same as the width from getTextDimensions(), without the vertical bounds and with cached glyph metrics
+  int getTextWidth(const char* string) const;
+  // Sum of the glyph advances, i.e. how far the cursor moves when the string is drawn
+  int getTextAdvanceX(const char* string) const;
+
+  // getTextWidth() one codepoint at a time: after each extendText() call, width() is the width of the codepoints
+  // added so far. Lets callers measure every prefix of a string in a single pass.
+  struct TextExtent {
+    int minX = 0;
+    int maxX = 0;
+    int cursorX = 0;
+    int width() const { return maxX - minX; }
+  };
+  void extendText(TextExtent& extent, uint32_t cp) const;
   bool hasPrintableChars(const char* string) const;
 
   const EpdGlyph* getGlyph(uint32_t cp) const;
@@ -29,3 +29,11 @@ bool EpdFontFamily::hasPrintableChars(const char* string, const Style style) con
 void EpdFontFamily::getTextDimensions(const char* string, int* w, int* h, const Style style) const {
   getFont(style)->getTextDimensions(string, w, h);
 }
+
+int EpdFontFamily::getTextWidth(const char* string, const Style style) const {
+  return getFont(style)->getTextWidth(string);
+}
+
+int EpdFontFamily::getTextAdvanceX(const char* string, const Style style) const {
+  return getFont(style)->getTextAdvanceX(string);
+}
@@ -17,6 +17,8 @@ class EpdFontFamily {
   const EpdGlyph* getGlyph(uint32_t cp, Style style) const;
   bool hasPrintableChars(const char* string, Style style) const;
   void getTextDimensions(const char* string, int* w, int* h, Style style) const;
+  int getTextWidth(const char* string, Style style) const;
+  int getTextAdvanceX(const char* string, Style style) const;
 
  private:
   const EpdFont* regular;
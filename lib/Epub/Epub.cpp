@@ -1,11 +1,16 @@
 #include "Epub.h"
 
 #include <FsHelpers.h>
+#include <GifToBmpConverter.h>
 #include <HalStorage.h>
 #include <HardwareSerial.h>
 #include <JpegToBmpConverter.h>
+#include <PngToBmpConverter.h>
 #include <ZipFile.h>
 
+#include <cctype>
+#include <cstring>
+
 #include "Epub/parsers/ContainerParser.h"
 #include "Epub/parsers/ContentOpfParser.h"
 #include "Epub/parsers/TocNavParser.h"
@@ -235,30 +240,13 @@ void Epub::parseCssFiles() const {
     for (const auto& cssPath : cssFiles) {
       Serial.printf("[%lu] [EBP] Parsing CSS file: %s\n", millis(), cssPath.c_str());
 
-      // Extract CSS file to temp location
-      const auto tmpCssPath = getCachePath() + "/.tmp.css";
-      FsFile tempCssFile;
-      if (!Storage.openFileForWrite("EBP", tmpCssPath, tempCssFile)) {
-        Serial.printf("[%lu] [EBP] Could not create temp CSS file\n", millis());
-        continue;
-      }
-      if (!readItemContentsToStream(cssPath, tempCssFile, 1024)) {
+      // Tokenize straight from the inflating zip entry
+      ZipInflateStream cssStream;
+      if (!openItemStream(cssPath, cssStream, 1024)) {
         Serial.printf("[%lu] [EBP] Could not read CSS file: %s\n", millis(), cssPath.c_str());
-        tempCssFile.close();
-        Storage.remove(tmpCssPath.c_str());
-        continue;
-      }
-      tempCssFile.close();
-
-      // Parse the CSS file
-      if (!Storage.openFileForRead("EBP", tmpCssPath, tempCssFile)) {
-        Serial.printf("[%lu] [EBP] Could not open temp CSS file for reading\n", millis());
-        Storage.remove(tmpCssPath.c_str());
         continue;
       }
-      cssParser->loadFromStream(tempCssFile);
-      tempCssFile.close();
-      Storage.remove(tmpCssPath.c_str());
+      cssParser->loadFromStream(cssStream);
     }
 
     // Save to cache for next time
@@ -284,6 +272,7 @@ bool Epub::load(const bool buildIfMissing, const bool skipLoadingCss) {
 
   // Try to load existing cache first
   if (bookMetadataCache->load()) {
+    loadZipIndex();
     if (!skipLoadingCss && !loadCssRulesFromCache()) {
       Serial.printf("[%lu] [EBP] Warning: CSS rules cache not found, attempting to parse CSS files\n", millis());
       // to get CSS file list
@@ -307,6 +296,7 @@ bool Epub::load(const bool buildIfMissing, const bool skipLoadingCss) {
   setupCacheDir();
 
   const uint32_t indexingStart = millis();
+  loadZipIndex();
 
   // Begin building cache - stream entries to disk immediately
   if (!bookMetadataCache->beginWrite()) {
@@ -398,6 +388,16 @@ bool Epub::load(const bool buildIfMissing, const bool skipLoadingCss) {
   return true;
 }
 
+void Epub::loadZipIndex() {
+  const std::string indexPath = cachePath + "/zip_index.bin";
+  if (zipIndex.load(indexPath, filepath)) {
+    return;
+  }
+  if (!ZipIndex::build(filepath, indexPath) || !zipIndex.load(indexPath, filepath)) {
+    Serial.printf("[%lu] [EBP] No zip index, items will be looked up in the central directory\n", millis());
+  }
+}
+
 bool Epub::clearCache() const {
   if (!Storage.exists(cachePath.c_str())) {
     Serial.printf("[%lu] [EPB] Cache does not exist, no action needed\n", millis());
@@ -452,130 +452,121 @@ const std::string& Epub::getLanguage() const {
   return bookMetadataCache->coreMetadata.language;
 }
 
-std::string Epub::getCoverBmpPath(bool cropped) const {
-  const auto coverFileName = std::string("cover") + (cropped ? "_crop" : "");
-  return cachePath + "/" + coverFileName + ".bmp";
-}
-
-bool Epub::generateCoverBmp(bool cropped) const {
-  // Already generated, return true
-  if (Storage.exists(getCoverBmpPath(cropped).c_str())) {
-    return true;
-  }
+namespace {
+using CoverDecoder = bool (*)(const ImageReadFn& read, const BmpTarget& target);
 
-  if (!bookMetadataCache || !bookMetadataCache->isLoaded()) {
-    Serial.printf("[%lu] [EBP] Cannot generate cover BMP, cache not loaded\n", millis());
-    return false;
-  }
-
-  const auto coverImageHref = bookMetadataCache->coreMetadata.coverItemHref;
-  if (coverImageHref.empty()) {
-    Serial.printf("[%lu] [EBP] No known cover image\n", millis());
+bool hasExtension(const std::string& href, const char* extension) {
+  const size_t len = strlen(extension);
+  if (href.length() < len) {
     return false;
   }
-
-  if (coverImageHref.substr(coverImageHref.length() - 4) == ".jpg" ||
-      coverImageHref.substr(coverImageHref.length() - 5) == ".jpeg") {
-    Serial.printf("[%lu] [EBP] Generating BMP from JPG cover image (%s mode)\n", millis(), cropped ? "cropped" : "fit");
-    const auto coverJpgTempPath = getCachePath() + "/.cover.jpg";
-
-    FsFile coverJpg;
-    if (!Storage.openFileForWrite("EBP", coverJpgTempPath, coverJpg)) {
-      return false;
-    }
-    readItemContentsToStream(coverImageHref, coverJpg, 1024);
-    coverJpg.close();
-
-    if (!Storage.openFileForRead("EBP", coverJpgTempPath, coverJpg)) {
-      return false;
-    }
-
-    FsFile coverBmp;
-    if (!Storage.openFileForWrite("EBP", getCoverBmpPath(cropped), coverBmp)) {
-      coverJpg.close();
+  for (size_t i = 0; i < len; i++) {
+    if (tolower(static_cast<unsigned char>(href[href.length() - len + i])) != extension[i]) {
       return false;
     }
-    const bool success = JpegToBmpConverter::jpegFileToBmpStream(coverJpg, coverBmp, cropped);
-    coverJpg.close();
-    coverBmp.close();
-    Storage.remove(coverJpgTempPath.c_str());
+  }
+  return true;
+}
 
-    if (!success) {
-      Serial.printf("[%lu] [EBP] Failed to generate BMP from JPG cover image\n", millis());
-      Storage.remove(getCoverBmpPath(cropped).c_str());
-    }
-    Serial.printf("[%lu] [EBP] Generated BMP from JPG cover image, success: %s\n", millis(), success ? "yes" : "no");
-    return success;
+// Streaming decoder for the cover image's format, by file extension
+bool findCoverDecoder(const std::string& href, const char** format, CoverDecoder* decode) {
+  if (hasExtension(href, ".jpg") || hasExtension(href, ".jpeg")) {
+    *format = "JPG";
+    *decode = &JpegToBmpConverter::jpegToBmpStream;
+  } else if (hasExtension(href, ".png")) {
+    *format = "PNG";
+    *decode = &PngToBmpConverter::pngToBmpStream;
+  } else if (hasExtension(href, ".gif")) {
+    *format = "GIF";
+    *decode = &GifToBmpConverter::gifToBmpStream;
   } else {
-    Serial.printf("[%lu] [EBP] Cover image is not a JPG, skipping\n", millis());
+    return false;
   }
+  return true;
+}
+}  // namespace
 
-  return false;
+std::string Epub::getCoverBmpPath(bool cropped) const {
+  const auto coverFileName = std::string("cover") + (cropped ? "_crop" : "");
+  return cachePath + "/" + coverFileName + ".bmp";
+}
+
+bool Epub::generateCoverBmp(bool cropped) const {
+  const BmpTarget target{nullptr, BmpTarget::COVER_MAX_WIDTH, BmpTarget::COVER_MAX_HEIGHT, false, cropped};
+  return generateCoverImage(getCoverBmpPath(cropped), target, false, nullptr);
 }
 
 std::string Epub::getThumbBmpPath() const { return cachePath + "/thumb_[HEIGHT].bmp"; }
 std::string Epub::getThumbBmpPath(int height) const { return cachePath + "/thumb_" + std::to_string(height) + ".bmp"; }
 
-bool Epub::generateThumbBmp(int height) const {
+bool Epub::generateThumbBmp(int height, const std::function<bool()>& shouldStop) const {
+  // Use smaller target size for Continue Reading card (half of screen: 240x400)
+  // Generate 1-bit BMP for fast home screen rendering (no gray passes needed)
+  const BmpTarget target{nullptr, static_cast<int>(height * 0.6), height, true, true};
+  return generateCoverImage(getThumbBmpPath(height), target, true, shouldStop);
+}
+
+// Decodes the cover image straight from its zip entry into `bmpPath`, without a temp file. With `markMissing`, a book
+// without a usable cover gets an empty file so it is not tried again.
+bool Epub::generateCoverImage(const std::string& bmpPath, const BmpTarget& target, const bool markMissing,
+                              const std::function<bool()>& shouldStop) const {
   // Already generated, return true
-  if (Storage.exists(getThumbBmpPath(height).c_str())) {
+  if (Storage.exists(bmpPath.c_str())) {
     return true;
   }
 
   if (!bookMetadataCache || !bookMetadataCache->isLoaded()) {
-    Serial.printf("[%lu] [EBP] Cannot generate thumb BMP, cache not loaded\n", millis());
+    Serial.printf("[%lu] [EBP] Cannot generate cover BMP, cache not loaded\n", millis());
     return false;
   }
 
   const auto coverImageHref = bookMetadataCache->coreMetadata.coverItemHref;
+  const char* format = nullptr;
+  CoverDecoder decode = nullptr;
   if (coverImageHref.empty()) {
-    Serial.printf("[%lu] [EBP] No known cover image for thumbnail\n", millis());
-  } else if (coverImageHref.substr(coverImageHref.length() - 4) == ".jpg" ||
-             coverImageHref.substr(coverImageHref.length() - 5) == ".jpeg") {
-    Serial.printf("[%lu] [EBP] Generating thumb BMP from JPG cover image\n", millis());
-    const auto coverJpgTempPath = getCachePath() + "/.cover.jpg";
-
-    FsFile coverJpg;
-    if (!Storage.openFileForWrite("EBP", coverJpgTempPath, coverJpg)) {
-      return false;
-    }
-    readItemContentsToStream(coverImageHref, coverJpg, 1024);
-    coverJpg.close();
+    Serial.printf("[%lu] [EBP] No known cover image\n", millis());
+  } else if (!findCoverDecoder(coverImageHref, &format, &decode)) {
+    Serial.printf("[%lu] [EBP] Cover image is not a JPG, PNG or GIF, skipping\n", millis());
+  } else {
+    Serial.printf("[%lu] [EBP] Generating %s from %s cover image (%s mode)\n", millis(), bmpPath.c_str(), format,
+                  target.crop ? "cropped" : "fit");
 
-    if (!Storage.openFileForRead("EBP", coverJpgTempPath, coverJpg)) {
+    ZipInflateStream coverImage;
+    if (!openItemStream(coverImageHref, coverImage, 1024)) {
       return false;
     }
 
-    FsFile thumbBmp;
-    if (!Storage.openFileForWrite("EBP", getThumbBmpPath(height), thumbBmp)) {
-      coverJpg.close();
-      return false;
+    FsFile bmpFile;
+    bool success = Storage.openFileForWrite("EBP", bmpPath, bmpFile);
+    if (success) {
+      BmpTarget output = target;
+      output.out = &bmpFile;
+      success = decode(
+          [&coverImage, &shouldStop](uint8_t* buf, const size_t len) {
+            // Running out of data makes the decoder give up at its next read
+            return shouldStop && shouldStop() ? 0 : coverImage.read(buf, len);
+          },
+          output);
+      success = success && !coverImage.hasError() && !(shouldStop && shouldStop());
+      bmpFile.close();
     }
-    // Use smaller target size for Continue Reading card (half of screen: 240x400)
-    // Generate 1-bit BMP for fast home screen rendering (no gray passes needed)
-    int THUMB_TARGET_WIDTH = height * 0.6;
-    int THUMB_TARGET_HEIGHT = height;
-    const bool success = JpegToBmpConverter::jpegFileTo1BitBmpStreamWithSize(coverJpg, thumbBmp, THUMB_TARGET_WIDTH,
-                                                                             THUMB_TARGET_HEIGHT);
-    coverJpg.close();
-    thumbBmp.close();
-    Storage.remove(coverJpgTempPath.c_str());
+    coverImage.close();
 
     if (!success) {
-      Serial.printf("[%lu] [EBP] Failed to generate thumb BMP from JPG cover image\n", millis());
-      Storage.remove(getThumbBmpPath(height).c_str());
+      Serial.printf("[%lu] [EBP] Failed to generate BMP from %s cover image\n", millis(), format);
+      Storage.remove(bmpPath.c_str());
     }
-    Serial.printf("[%lu] [EBP] Generated thumb BMP from JPG cover image, success: %s\n", millis(),
+    Serial.printf("[%lu] [EBP] Generated BMP from %s cover image, success: %s\n", millis(), format,
                   success ? "yes" : "no");
     return success;
-  } else {
-    Serial.printf("[%lu] [EBP] Cover image is not a JPG, skipping thumbnail\n", millis());
   }
 
-  // Write an empty bmp file to avoid generation attempts in the future
-  FsFile thumbBmp;
-  Storage.openFileForWrite("EBP", getThumbBmpPath(height), thumbBmp);
-  thumbBmp.close();
+  if (markMissing) {
+    // Write an empty bmp file to avoid generation attempts in the future
+    FsFile emptyBmp;
+    Storage.openFileForWrite("EBP", bmpPath, emptyBmp);
+    emptyBmp.close();
+  }
   return false;
 }
 
@@ -587,7 +578,7 @@ uint8_t* Epub::readItemContentsToBytes(const std::string& itemHref, size_t* size
 
   const std::string path = FsHelpers::normalisePath(itemHref);
 
-  const auto content = ZipFile(filepath).readFileToMemory(path.c_str(), size, trailingNullByte);
+  const auto content = ZipFile(filepath, &zipIndex).readFileToMemory(path.c_str(), size, trailingNullByte);
   if (!content) {
     Serial.printf("[%lu] [EBP] Failed to read item %s\n", millis(), path.c_str());
     return nullptr;
@@ -603,12 +594,22 @@ bool Epub::readItemContentsToStream(const std::string& itemHref, Print& out, con
   }
 
   const std::string path = FsHelpers::normalisePath(itemHref);
-  return ZipFile(filepath).readFileToStream(path.c_str(), out, chunkSize);
+  return ZipFile(filepath, &zipIndex).readFileToStream(path.c_str(), out, chunkSize);
+}
+
+bool Epub::openItemStream(const std::string& itemHref, ZipInflateStream& stream, const size_t chunkSize) const {
+  if (itemHref.empty()) {
+    Serial.printf("[%lu] [EBP] Failed to open item stream, empty href\n", millis());
+    return false;
+  }
+
+  const std::string path = FsHelpers::normalisePath(itemHref);
+  return ZipFile(filepath, &zipIndex).openFileStream(path.c_str(), stream, chunkSize);
 }
 
 bool Epub::getItemSize(const std::string& itemHref, size_t* size) const {
   const std::string path = FsHelpers::normalisePath(itemHref);
-  return ZipFile(filepath).getInflatedFileSize(path.c_str(), size);
+  return ZipFile(filepath, &zipIndex).getInflatedFileSize(path.c_str(), size);
 }
 
 int Epub::getSpineItemsCount() const {
@@ -618,7 +619,20 @@ int Epub::getSpineItemsCount() const {
   return bookMetadataCache->getSpineCount();
 }
 
-size_t Epub::getCumulativeSpineItemSize(const int spineIndex) const { return getSpineItem(spineIndex).cumulativeSize; }
+size_t Epub::getCumulativeSpineItemSize(const int spineIndex) const {
+  if (!bookMetadataCache || !bookMetadataCache->isLoaded()) {
+    Serial.printf("[%lu] [EBP] getCumulativeSpineItemSize called but cache not loaded\n", millis());
+    return 0;
+  }
+  return bookMetadataCache->getCumulativeSize(spineIndex);
+}
+
+int Epub::getSpineIndexForBookOffset(const size_t offset) const {
+  if (!bookMetadataCache || !bookMetadataCache->isLoaded()) {
+    return 0;
+  }
+  return bookMetadataCache->findSpineIndexForOffset(offset);
+}
 
 BookMetadataCache::SpineEntry Epub::getSpineItem(const int spineIndex) const {
   if (!bookMetadataCache || !bookMetadataCache->isLoaded()) {
@@ -668,7 +682,7 @@ int Epub::getSpineIndexForTocIndex(const int tocIndex) const {
     return 0;
   }
 
-  const int spineIndex = bookMetadataCache->getTocEntry(tocIndex).spineIndex;
+  const int spineIndex = bookMetadataCache->getSpineIndexForToc(tocIndex);
   if (spineIndex < 0) {
     Serial.printf("[%lu] [EBP] Section not found for TOC index %d\n", millis(), tocIndex);
     return 0;
@@ -677,7 +691,13 @@ int Epub::getSpineIndexForTocIndex(const int tocIndex) const {
   return spineIndex;
 }
 
-int Epub::getTocIndexForSpineIndex(const int spineIndex) const { return getSpineItem(spineIndex).tocIndex; }
+int Epub::getTocIndexForSpineIndex(const int spineIndex) const {
+  if (!bookMetadataCache || !bookMetadataCache->isLoaded()) {
+    Serial.printf("[%lu] [EBP] getTocIndexForSpineIndex called but cache not loaded\n", millis());
+    return -1;
+  }
+  return bookMetadataCache->getTocIndexForSpine(spineIndex);
+}
 
 size_t Epub::getBookSize() const {
   if (!bookMetadataCache || !bookMetadataCache->isLoaded() || bookMetadataCache->getSpineCount() == 0) {
@@ -702,13 +722,11 @@ int Epub::getSpineIndexForTextReference() const {
     return 0;
   }
 
-  // loop through spine items to get the correct index matching the text href
-  for (size_t i = 0; i < getSpineItemsCount(); i++) {
-    if (getSpineItem(i).href == bookMetadataCache->coreMetadata.textReferenceHref) {
-      Serial.printf("[%lu] [ERS] Text reference %s found at index %d\n", millis(),
-                    bookMetadataCache->coreMetadata.textReferenceHref.c_str(), i);
-      return i;
-    }
+  const int spineIndex = bookMetadataCache->findSpineIndex(bookMetadataCache->coreMetadata.textReferenceHref);
+  if (spineIndex >= 0) {
+    Serial.printf("[%lu] [ERS] Text reference %s found at index %d\n", millis(),
+                  bookMetadataCache->coreMetadata.textReferenceHref.c_str(), spineIndex);
+    return spineIndex;
   }
   // This should not happen, as we checked for empty textReferenceHref earlier
   Serial.printf("[%lu] [EBP] Section not found for text reference\n", millis());
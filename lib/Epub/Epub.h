@@ -1,7 +1,9 @@
 #pragma once
 
 #include <Print.h>
+#include <ZipIndex.h>
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -10,7 +12,8 @@
 #include "Epub/BookMetadataCache.h"
 #include "Epub/css/CssParser.h"
 
-class ZipFile;
+class ZipInflateStream;
+struct BmpTarget;
 
 class Epub {
   // the ncx file (EPUB 2)
@@ -29,6 +32,8 @@ class Epub {
   std::unique_ptr<CssParser> cssParser;
   // CSS files
   std::vector<std::string> cssFiles;
+  // Sorted central directory of the EPUB, so items resolve without scanning the zip
+  ZipIndex zipIndex;
 
   bool findContentOpfFile(std::string* contentOpfFile) const;
   bool parseContentOpf(BookMetadataCache::BookMetadata& bookMetadata);
@@ -37,6 +42,9 @@ class Epub {
   void parseCssFiles() const;
   std::string getCssRulesCache() const;
   bool loadCssRulesFromCache() const;
+  void loadZipIndex();
+  bool generateCoverImage(const std::string& bmpPath, const BmpTarget& target, bool markMissing,
+                          const std::function<bool()>& shouldStop) const;
 
  public:
   explicit Epub(std::string filepath, const std::string& cacheDir) : filepath(std::move(filepath)) {
@@ -57,10 +65,12 @@ class Epub {
   bool generateCoverBmp(bool cropped = false) const;
   std::string getThumbBmpPath() const;
   std::string getThumbBmpPath(int height) const;
-  bool generateThumbBmp(int height) const;
+  // Once `shouldStop` returns true the decode is abandoned and nothing is written
+  bool generateThumbBmp(int height, const std::function<bool()>& shouldStop = nullptr) const;
   uint8_t* readItemContentsToBytes(const std::string& itemHref, size_t* size = nullptr,
                                    bool trailingNullByte = false) const;
   bool readItemContentsToStream(const std::string& itemHref, Print& out, size_t chunkSize) const;
+  bool openItemStream(const std::string& itemHref, ZipInflateStream& stream, size_t chunkSize) const;
   bool getItemSize(const std::string& itemHref, size_t* size) const;
   BookMetadataCache::SpineEntry getSpineItem(int spineIndex) const;
   BookMetadataCache::TocEntry getTocItem(int tocIndex) const;
@@ -69,6 +79,8 @@ class Epub {
   int getSpineIndexForTocIndex(int tocIndex) const;
   int getTocIndexForSpineIndex(int spineIndex) const;
   size_t getCumulativeSpineItemSize(int spineIndex) const;
+  // Spine item containing byte `offset` of the book, getSpineItemsCount() if the book is shorter
+  int getSpineIndexForBookOffset(size_t offset) const;
   int getSpineIndexForTextReference() const;
 
   size_t getBookSize() const;
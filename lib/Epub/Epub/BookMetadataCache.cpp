@@ -1,6 +1,6 @@
 #include "BookMetadataCache.h"
 
-#include <HardwareSerial.h>
+#include <Arduino.h>
 #include <Serialization.h>
 #include <ZipFile.h>
 
@@ -386,11 +386,109 @@ bool BookMetadataCache::load() {
   serialization::readString(bookFile, coreMetadata.coverItemHref);
   serialization::readString(bookFile, coreMetadata.textReferenceHref);
 
+  if (!buildIndex()) {
+    bookFile.close();
+    return false;
+  }
+
   loaded = true;
   Serial.printf("[%lu] [BMC] Loaded cache data: %d spine, %d TOC entries\n", millis(), spineCount, tocCount);
   return true;
 }
 
+// Read the spine and TOC entries, which follow the LUTs back to back, into the in-RAM index in one sequential pass
+bool BookMetadataCache::buildIndex() {
+  const uint32_t start = millis();
+  constexpr size_t spineFixedSize =
+      sizeof(uint32_t) + sizeof(SpineEntry::cumulativeSize) + sizeof(SpineEntry::tocIndex);
+  constexpr size_t tocFixedSize = sizeof(uint32_t) * 3 + sizeof(TocEntry::level) + sizeof(TocEntry::spineIndex);
+  const size_t entriesOffset = lutOffset + sizeof(uint32_t) * spineCount + sizeof(uint32_t) * tocCount;
+  const size_t fixedSize = spineFixedSize * spineCount + tocFixedSize * tocCount;
+  const size_t fileSize = bookFile.size();
+  if (fileSize < entriesOffset + fixedSize) {
+    Serial.printf("[%lu] [BMC] Cache file truncated\n", millis());
+    return false;
+  }
+  const size_t stringsSize = fileSize - entriesOffset - fixedSize;
+
+  spineRecords.clear();
+  spineRecords.reserve(spineCount);
+  tocRecords.clear();
+  tocRecords.reserve(tocCount);
+  stringPool.clear();
+  stringPool.shrink_to_fit();
+  stringsInMemory =
+      stringsSize <= MAX_STRING_POOL_SIZE && ESP.getFreeHeap() >= stringsSize + STRING_POOL_HEAP_RESERVE;
+  if (stringsInMemory) {
+    stringPool.reserve(stringsSize);
+  }
+
+  // Without a pool the strings are skipped, remembering where each entry starts
+  const auto readString = [this, stringsSize](uint16_t& len) {
+    if (stringsInMemory) {
+      return readPooledString(stringsSize, len);
+    }
+    uint32_t fullLen;
+    serialization::readPod(bookFile, fullLen);
+    len = 0;
+    return bookFile.seekCur(fullLen);
+  };
+
+  bookFile.seek(entriesOffset);
+  bool ok = true;
+  for (int i = 0; i < spineCount && ok; i++) {
+    SpineRecord record{};
+    record.dataOffset = stringsInMemory ? stringPool.size() : bookFile.position();
+    ok = readString(record.hrefLen);
+    SpineEntry entry;
+    serialization::readPod(bookFile, entry.cumulativeSize);
+    serialization::readPod(bookFile, entry.tocIndex);
+    record.cumulativeSize = entry.cumulativeSize;
+    record.tocIndex = entry.tocIndex;
+    spineRecords.push_back(record);
+  }
+  for (int i = 0; i < tocCount && ok; i++) {
+    TocRecord record{};
+    record.dataOffset = stringsInMemory ? stringPool.size() : bookFile.position();
+    ok = readString(record.titleLen) && readString(record.hrefLen) && readString(record.anchorLen);
+    serialization::readPod(bookFile, record.level);
+    serialization::readPod(bookFile, record.spineIndex);
+    tocRecords.push_back(record);
+  }
+
+  if (!ok || bookFile.position() != fileSize) {
+    Serial.printf("[%lu] [BMC] Cache entries are corrupt\n", millis());
+    spineRecords.clear();
+    spineRecords.shrink_to_fit();
+    tocRecords.clear();
+    tocRecords.shrink_to_fit();
+    stringPool.clear();
+    stringPool.shrink_to_fit();
+    return false;
+  }
+
+  Serial.printf("[%lu] [BMC] Indexed entries in %lu ms, %u bytes of strings %s\n", millis(), millis() - start,
+                stringsSize, stringsInMemory ? "in memory" : "left on SD");
+  return true;
+}
+
+// Append a length-prefixed string to the pool. Strings longer than a record can describe are cut short.
+bool BookMetadataCache::readPooledString(const size_t poolCapacity, uint16_t& len) {
+  uint32_t fullLen;
+  serialization::readPod(bookFile, fullLen);
+  if (fullLen > poolCapacity - stringPool.size()) {
+    return false;
+  }
+
+  len = fullLen > UINT16_MAX ? UINT16_MAX : static_cast<uint16_t>(fullLen);
+  const size_t offset = stringPool.size();
+  stringPool.resize(offset + len);
+  if (bookFile.read(&stringPool[offset], len) != len) {
+    return false;
+  }
+  return len == fullLen || bookFile.seekCur(fullLen - len);
+}
+
 BookMetadataCache::SpineEntry BookMetadataCache::getSpineEntry(const int index) {
   if (!loaded) {
     Serial.printf("[%lu] [BMC] getSpineEntry called but cache not loaded\n", millis());
@@ -402,12 +500,12 @@ BookMetadataCache::SpineEntry BookMetadataCache::getSpineEntry(const int index)
     return {};
   }
 
-  // Seek to spine LUT item, read from LUT and get out data
-  bookFile.seek(lutOffset + sizeof(uint32_t) * index);
-  uint32_t spineEntryPos;
-  serialization::readPod(bookFile, spineEntryPos);
-  bookFile.seek(spineEntryPos);
-  return readSpineEntry(bookFile);
+  const SpineRecord& record = spineRecords[index];
+  if (!stringsInMemory) {
+    bookFile.seek(record.dataOffset);
+    return readSpineEntry(bookFile);
+  }
+  return {stringPool.substr(record.dataOffset, record.hrefLen), record.cumulativeSize, record.tocIndex};
 }
 
 BookMetadataCache::TocEntry BookMetadataCache::getTocEntry(const int index) {
@@ -421,12 +519,75 @@ BookMetadataCache::TocEntry BookMetadataCache::getTocEntry(const int index) {
     return {};
   }
 
-  // Seek to TOC LUT item, read from LUT and get out data
-  bookFile.seek(lutOffset + sizeof(uint32_t) * spineCount + sizeof(uint32_t) * index);
-  uint32_t tocEntryPos;
-  serialization::readPod(bookFile, tocEntryPos);
-  bookFile.seek(tocEntryPos);
-  return readTocEntry(bookFile);
+  const TocRecord& record = tocRecords[index];
+  if (!stringsInMemory) {
+    bookFile.seek(record.dataOffset);
+    return readTocEntry(bookFile);
+  }
+  const size_t hrefOffset = record.dataOffset + record.titleLen;
+  const size_t anchorOffset = hrefOffset + record.hrefLen;
+  return {stringPool.substr(record.dataOffset, record.titleLen), stringPool.substr(hrefOffset, record.hrefLen),
+          stringPool.substr(anchorOffset, record.anchorLen), record.level, record.spineIndex};
+}
+
+size_t BookMetadataCache::getCumulativeSize(const int spineIndex) const {
+  if (!loaded || spineIndex < 0 || spineIndex >= static_cast<int>(spineCount)) {
+    Serial.printf("[%lu] [BMC] getCumulativeSize index %d out of range\n", millis(), spineIndex);
+    return 0;
+  }
+  return spineRecords[spineIndex].cumulativeSize;
+}
+
+int BookMetadataCache::getTocIndexForSpine(const int spineIndex) const {
+  if (!loaded || spineIndex < 0 || spineIndex >= static_cast<int>(spineCount)) {
+    Serial.printf("[%lu] [BMC] getTocIndexForSpine index %d out of range\n", millis(), spineIndex);
+    return -1;
+  }
+  return spineRecords[spineIndex].tocIndex;
+}
+
+int BookMetadataCache::getSpineIndexForToc(const int tocIndex) const {
+  if (!loaded || tocIndex < 0 || tocIndex >= static_cast<int>(tocCount)) {
+    Serial.printf("[%lu] [BMC] getSpineIndexForToc index %d out of range\n", millis(), tocIndex);
+    return -1;
+  }
+  return tocRecords[tocIndex].spineIndex;
+}
+
+int BookMetadataCache::findSpineIndexForOffset(const size_t offset) const {
+  // Cumulative sizes never decrease along the spine
+  const auto it = std::lower_bound(spineRecords.begin(), spineRecords.end(), offset,
+                                   [](const SpineRecord& record, const size_t value) {
+                                     return record.cumulativeSize < value;
+                                   });
+  return static_cast<int>(it - spineRecords.begin());
+}
+
+int BookMetadataCache::findSpineIndex(const std::string& href) {
+  if (!loaded) {
+    return -1;
+  }
+
+  if (stringsInMemory) {
+    for (int i = 0; i < spineCount; i++) {
+      const SpineRecord& record = spineRecords[i];
+      if (record.hrefLen == href.size() && stringPool.compare(record.dataOffset, record.hrefLen, href) == 0) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  // Spine entries are stored back to back, so they can be scanned with a single seek
+  if (spineCount > 0) {
+    bookFile.seek(spineRecords[0].dataOffset);
+  }
+  for (int i = 0; i < spineCount; i++) {
+    if (readSpineEntry(bookFile).href == href) {
+      return i;
+    }
+  }
+  return -1;
 }
 
 BookMetadataCache::SpineEntry BookMetadataCache::readSpineEntry(FsFile& file) const {
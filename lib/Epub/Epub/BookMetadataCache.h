@@ -44,7 +44,7 @@ class BookMetadataCache {
 
  private:
   std::string cachePath;
-  size_t lutOffset;
+  uint32_t lutOffset;
   uint16_t spineCount;
   uint16_t tocCount;
   bool loaded;
@@ -66,6 +66,31 @@ class BookMetadataCache {
 
   static constexpr uint16_t LARGE_SPINE_THRESHOLD = 400;
 
+  // In-RAM index built by load(), so lookups don't need two SD seeks per entry. The fixed-width fields of every
+  // entry are always kept; the strings are kept in one pool when it fits in MAX_STRING_POOL_SIZE and the free heap,
+  // otherwise they are read from book.bin with a single seek.
+  struct SpineRecord {
+    uint32_t cumulativeSize;
+    uint32_t dataOffset;  // href offset in stringPool, or entry offset in book.bin without a pool
+    uint16_t hrefLen;
+    int16_t tocIndex;
+  };
+  struct TocRecord {
+    uint32_t dataOffset;  // title, href and anchor offset in stringPool (back to back), or entry offset in book.bin
+    uint16_t titleLen;
+    uint16_t hrefLen;
+    uint16_t anchorLen;
+    uint8_t level;
+    int16_t spineIndex;
+  };
+  std::vector<SpineRecord> spineRecords;
+  std::vector<TocRecord> tocRecords;
+  std::string stringPool;
+  bool stringsInMemory = false;
+
+  static constexpr size_t MAX_STRING_POOL_SIZE = 48 * 1024;
+  static constexpr size_t STRING_POOL_HEAP_RESERVE = 96 * 1024;
+
   // FNV-1a 64-bit hash function
   static uint64_t fnvHash64(const std::string& s) {
     uint64_t hash = 14695981039346656037ull;
@@ -80,6 +105,8 @@ class BookMetadataCache {
   uint32_t writeTocEntry(FsFile& file, const TocEntry& entry) const;
   SpineEntry readSpineEntry(FsFile& file) const;
   TocEntry readTocEntry(FsFile& file) const;
+  bool buildIndex();
+  bool readPooledString(size_t poolCapacity, uint16_t& len);
 
  public:
   BookMetadata coreMetadata;
@@ -106,6 +133,14 @@ class BookMetadataCache {
   bool load();
   SpineEntry getSpineEntry(int index);
   TocEntry getTocEntry(int index);
+  // Index-only lookups, no SD access
+  size_t getCumulativeSize(int spineIndex) const;
+  int getTocIndexForSpine(int spineIndex) const;
+  int getSpineIndexForToc(int tocIndex) const;
+  // First spine entry whose cumulative size reaches `offset` (binary search), getSpineCount() if none does
+  int findSpineIndexForOffset(size_t offset) const;
+  // Spine index of `href`, -1 if it isn't in the spine
+  int findSpineIndex(const std::string& href);
   int getSpineCount() const { return spineCount; }
   int getTocCount() const { return tocCount; }
   bool isLoaded() const { return loaded; }
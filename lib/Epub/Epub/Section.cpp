@@ -2,6 +2,9 @@
 
 #include <HalStorage.h>
 #include <Serialization.h>
+#include <ZipFile.h>
+
+#include <algorithm>
 
 #include "Page.h"
 #include "hyphenation/Hyphenator.h"
@@ -14,6 +17,38 @@ constexpr uint32_t HEADER_SIZE = sizeof(uint8_t) + sizeof(int) + sizeof(float) +
                                  sizeof(bool) + sizeof(uint32_t);
 }  // namespace
 
+struct Section::PendingBuild {
+  std::string htmlPath;  // referenced by the parser
+  ZipInflateStream stream;
+  std::vector<uint32_t> lut;
+  std::unique_ptr<ChapterHtmlSlimParser> parser;
+};
+
+Section::Section(const std::shared_ptr<Epub>& epub, const int spineIndex, GfxRenderer& renderer)
+    : epub(epub),
+      spineIndex(spineIndex),
+      renderer(renderer),
+      filePath(epub->getCachePath() + "/sections/" + std::to_string(spineIndex) + ".bin") {}
+
+Section::~Section() {
+  if (pendingBuild) {
+    abandonSectionFile();
+  }
+}
+
+uint16_t Section::estimatedPageCount() const {
+  if (!pendingBuild) {
+    return pageCount;
+  }
+  const size_t parsed = pendingBuild->stream.position();
+  const size_t total = pendingBuild->stream.size();
+  if (pageCount == 0 || parsed == 0 || parsed >= total) {
+    return pageCount + 1;
+  }
+  const uint64_t estimate = static_cast<uint64_t>(pageCount) * total / parsed;
+  return static_cast<uint16_t>(std::min<uint64_t>(std::max<uint64_t>(estimate, pageCount + 1), UINT16_MAX));
+}
+
 uint32_t Section::onPageComplete(std::unique_ptr<Page> page) {
   if (!file) {
     Serial.printf("[%lu] [SCT] File not open for writing page %d\n", millis(), pageCount);
@@ -44,7 +79,8 @@ void Section::writeSectionFileHeader(const int fontId, const float lineCompressi
                                    sizeof(viewportHeight) + sizeof(pageCount) + sizeof(hyphenationEnabled) +
                                    sizeof(embeddedStyle) + sizeof(forceBold) + sizeof(uint32_t),
                 "Header size mismatch");
-  serialization::writePod(file, SECTION_FILE_VERSION);
+  // The version is only written once the LUT is complete, so an interrupted build never loads as a valid section
+  serialization::writePod(file, static_cast<uint8_t>(0));
   serialization::writePod(file, fontId);
   serialization::writePod(file, lineCompression);
   serialization::writePod(file, extraParagraphSpacing);
@@ -128,10 +164,160 @@ bool Section::clearCache() const {
   return true;
 }
 
+bool Section::buildSectionFile(const int fontId, const float lineCompression, const bool extraParagraphSpacing,
+                               const uint8_t paragraphAlignment, const uint16_t viewportWidth,
+                               const uint16_t viewportHeight, const bool hyphenationEnabled, const bool embeddedStyle,
+                               const bool forceBold, const std::function<void()>& popupFn,
+                               const std::function<bool()>& abortFn, const std::string& htmlPath,
+                               ZipInflateStream* stream) {
+  if (!Storage.openFileForWrite("SCT", filePath, file)) {
+    return false;
+  }
+
+  pageCount = 0;
+  writeSectionFileHeader(fontId, lineCompression, extraParagraphSpacing, paragraphAlignment, viewportWidth,
+                         viewportHeight, hyphenationEnabled, embeddedStyle, forceBold);
+
+  std::vector<uint32_t> lut = {};
+
+  ChapterHtmlSlimParser visitor(
+      htmlPath, renderer, fontId, lineCompression, extraParagraphSpacing, paragraphAlignment, viewportWidth,
+      viewportHeight, hyphenationEnabled,
+      [this, &lut](std::unique_ptr<Page> page) { lut.emplace_back(this->onPageComplete(std::move(page))); },
+      embeddedStyle, popupFn, embeddedStyle ? epub->getCssParser() : nullptr, abortFn);
+
+  Hyphenator::setPreferredLanguage(epub->getLanguage());
+  const bool success = stream ? visitor.parseAndBuildPages(*stream) : visitor.parseAndBuildPages();
+
+  if (!success) {
+    Serial.printf("[%lu] [SCT] Failed to parse XML and build pages\n", millis());
+    file.close();
+    Storage.remove(filePath.c_str());
+    return false;
+  }
+
+  return finishSectionFile(lut);
+}
+
+bool Section::finishSectionFile(const std::vector<uint32_t>& lut) {
+  const uint32_t lutOffset = file.position();
+  bool hasFailedLutRecords = false;
+
+  for (const uint32_t& pos : lut) {
+    if (pos == 0) {
+      hasFailedLutRecords = true;
+      break;
+    }
+    serialization::writePod(file, pos);
+  }
+
+  if (hasFailedLutRecords) {
+    Serial.printf("[%lu] [SCT] Failed to write LUT due to invalid page positions\n", millis());
+    file.close();
+    Storage.remove(filePath.c_str());
+    return false;
+  }
+
+  file.seek(HEADER_SIZE - sizeof(uint32_t) - sizeof(pageCount));
+  serialization::writePod(file, pageCount);
+  serialization::writePod(file, lutOffset);
+  file.seek(0);
+  serialization::writePod(file, SECTION_FILE_VERSION);
+  file.close();
+  return true;
+}
+
+void Section::abandonSectionFile() {
+  Serial.printf("[%lu] [SCT] Abandoning incremental build after %d pages\n", millis(), pageCount);
+  pendingBuild.reset();
+  file.close();
+  Storage.remove(filePath.c_str());
+}
+
+bool Section::beginSectionFile(const int fontId, const float lineCompression, const bool extraParagraphSpacing,
+                               const uint8_t paragraphAlignment, const uint16_t viewportWidth,
+                               const uint16_t viewportHeight, const bool hyphenationEnabled, const bool embeddedStyle,
+                               const bool forceBold, const std::function<void()>& popupFn) {
+  if (pendingBuild) {
+    abandonSectionFile();
+  }
+
+  {
+    const auto sectionsDir = epub->getCachePath() + "/sections";
+    Storage.mkdir(sectionsDir.c_str());
+  }
+
+  // Only the zip stream path can be paused; the temp file fallback of createSectionFile builds in one go
+  auto build = std::unique_ptr<PendingBuild>(new PendingBuild());
+  build->htmlPath = epub->getCachePath() + "/.tmp_" + std::to_string(spineIndex) + ".html";
+  if (!epub->openItemStream(epub->getSpineItem(spineIndex).href, build->stream, 1024)) {
+    Serial.printf("[%lu] [SCT] Could not open zip stream for incremental build\n", millis());
+    return false;
+  }
+
+  if (!Storage.openFileForWrite("SCT", filePath, file)) {
+    return false;
+  }
+
+  pageCount = 0;
+  writeSectionFileHeader(fontId, lineCompression, extraParagraphSpacing, paragraphAlignment, viewportWidth,
+                         viewportHeight, hyphenationEnabled, embeddedStyle, forceBold);
+
+  std::vector<uint32_t>* lut = &build->lut;
+  build->parser.reset(new ChapterHtmlSlimParser(
+      build->htmlPath, renderer, fontId, lineCompression, extraParagraphSpacing, paragraphAlignment, viewportWidth,
+      viewportHeight, hyphenationEnabled,
+      [this, lut](std::unique_ptr<Page> page) { lut->emplace_back(this->onPageComplete(std::move(page))); },
+      embeddedStyle, popupFn, embeddedStyle ? epub->getCssParser() : nullptr));
+
+  Hyphenator::setPreferredLanguage(epub->getLanguage());
+  if (!build->parser->beginParse(build->stream)) {
+    file.close();
+    Storage.remove(filePath.c_str());
+    return false;
+  }
+
+  pendingBuild = std::move(build);
+  return true;
+}
+
+bool Section::buildUntilPage(const int page, const std::function<bool()>& pauseFn) {
+  if (!pendingBuild) {
+    return true;
+  }
+
+  const uint32_t start = millis();
+  const uint16_t startPageCount = pageCount;
+  // Other sections may have been built since the last call
+  Hyphenator::setPreferredLanguage(epub->getLanguage());
+  const auto status = pendingBuild->parser->parseMore(
+      [this, page, &pauseFn]() { return (page >= 0 && pageCount > page) || (pauseFn && pauseFn()); });
+
+  if (status == ChapterHtmlSlimParser::ParseStatus::Failed) {
+    Serial.printf("[%lu] [SCT] Failed to parse XML and build pages\n", millis());
+    abandonSectionFile();
+    return false;
+  }
+
+  if (status == ChapterHtmlSlimParser::ParseStatus::Paused) {
+    // Flushed so loadPageFromSectionFile can open the pages written so far
+    file.flush();
+    Serial.printf("[%lu] [SCT] Laid out pages %d-%d in %lu ms, pausing\n", millis(), startPageCount, pageCount - 1,
+                  millis() - start);
+    return true;
+  }
+
+  const std::vector<uint32_t> lut = std::move(pendingBuild->lut);
+  pendingBuild.reset();
+  Serial.printf("[%lu] [SCT] Finished incremental build: %d pages\n", millis(), pageCount);
+  return finishSectionFile(lut);
+}
+
 bool Section::createSectionFile(const int fontId, const float lineCompression, const bool extraParagraphSpacing,
                                 const uint8_t paragraphAlignment, const uint16_t viewportWidth,
                                 const uint16_t viewportHeight, const bool hyphenationEnabled, const bool embeddedStyle,
-                                const bool forceBold, const std::function<void()>& popupFn) {
+                                const bool forceBold, const std::function<void()>& popupFn,
+                                const std::function<bool()>& abortFn) {
   const auto localPath = epub->getSpineItem(spineIndex).href;
   const auto tmpHtmlPath = epub->getCachePath() + "/.tmp_" + std::to_string(spineIndex) + ".html";
 
@@ -140,6 +326,28 @@ bool Section::createSectionFile(const int fontId, const float lineCompression, c
     Storage.mkdir(sectionsDir.c_str());
   }
 
+  // Preferred path: inflate the chapter straight into the parser, no temp file on the SD card
+  {
+    ZipInflateStream stream;
+    if (epub->openItemStream(localPath, stream, 1024)) {
+      const uint32_t start = millis();
+      if (buildSectionFile(fontId, lineCompression, extraParagraphSpacing, paragraphAlignment, viewportWidth,
+                           viewportHeight, hyphenationEnabled, embeddedStyle, forceBold, popupFn, abortFn,
+                           tmpHtmlPath, &stream)) {
+        Serial.printf("[%lu] [SCT] Built section from zip stream (%zu bytes) in %lu ms\n", millis(), stream.size(),
+                      millis() - start);
+        return true;
+      }
+      if (abortFn && abortFn()) {
+        Serial.printf("[%lu] [SCT] Section build aborted\n", millis());
+        return false;
+      }
+      Serial.printf("[%lu] [SCT] Streaming build failed, falling back to temp file\n", millis());
+    } else {
+      Serial.printf("[%lu] [SCT] Could not open zip stream, falling back to temp file\n", millis());
+    }
+  }
+
   bool success = false;
   uint32_t fileSize = 0;
   for (int attempt = 0; attempt < 3 && !success; attempt++) {
@@ -173,58 +381,30 @@ bool Section::createSectionFile(const int fontId, const float lineCompression, c
 
   Serial.printf("[%lu] [SCT] Streamed temp HTML to %s (%d bytes)\n", millis(), tmpHtmlPath.c_str(), fileSize);
 
-  if (!Storage.openFileForWrite("SCT", filePath, file)) {
-    return false;
-  }
-
-  writeSectionFileHeader(fontId, lineCompression, extraParagraphSpacing, paragraphAlignment, viewportWidth,
-                         viewportHeight, hyphenationEnabled, embeddedStyle, forceBold);
-
-  std::vector<uint32_t> lut = {};
-
-  ChapterHtmlSlimParser visitor(
-      tmpHtmlPath, renderer, fontId, lineCompression, extraParagraphSpacing, paragraphAlignment, viewportWidth,
-      viewportHeight, hyphenationEnabled,
-      [this, &lut](std::unique_ptr<Page> page) { lut.emplace_back(this->onPageComplete(std::move(page))); },
-      embeddedStyle, popupFn, embeddedStyle ? epub->getCssParser() : nullptr);
-
-  Hyphenator::setPreferredLanguage(epub->getLanguage());
-  success = visitor.parseAndBuildPages();
-
+  success = buildSectionFile(fontId, lineCompression, extraParagraphSpacing, paragraphAlignment, viewportWidth,
+                             viewportHeight, hyphenationEnabled, embeddedStyle, forceBold, popupFn, abortFn,
+                             tmpHtmlPath, nullptr);
   Storage.remove(tmpHtmlPath.c_str());
-  if (!success) {
-    Serial.printf("[%lu] [SCT] Failed to parse XML and build pages\n", millis());
-    file.close();
-    Storage.remove(filePath.c_str());
-    return false;
-  }
-
-  const uint32_t lutOffset = file.position();
-  bool hasFailedLutRecords = false;
+  return success;
+}
 
-  for (const uint32_t& pos : lut) {
-    if (pos == 0) {
-      hasFailedLutRecords = true;
-      break;
+std::unique_ptr<Page> Section::loadPageFromSectionFile() {
+  if (pendingBuild) {
+    // The LUT is still in memory and `file` is the write handle, so read the page through a second handle
+    if (currentPage < 0 || currentPage >= static_cast<int>(pendingBuild->lut.size()) ||
+        pendingBuild->lut[currentPage] == 0) {
+      return nullptr;
     }
-    serialization::writePod(file, pos);
-  }
-
-  if (hasFailedLutRecords) {
-    Serial.printf("[%lu] [SCT] Failed to write LUT due to invalid page positions\n", millis());
-    file.close();
-    Storage.remove(filePath.c_str());
-    return false;
+    FsFile pageFile;
+    if (!Storage.openFileForRead("SCT", filePath, pageFile)) {
+      return nullptr;
+    }
+    pageFile.seek(pendingBuild->lut[currentPage]);
+    auto page = Page::deserialize(pageFile);
+    pageFile.close();
+    return page;
   }
 
-  file.seek(HEADER_SIZE - sizeof(uint32_t) - sizeof(pageCount));
-  serialization::writePod(file, pageCount);
-  serialization::writePod(file, lutOffset);
-  file.close();
-  return true;
-}
-
-std::unique_ptr<Page> Section::loadPageFromSectionFile() {
   if (!Storage.openFileForRead("SCT", filePath, file)) {
     return nullptr;
   }
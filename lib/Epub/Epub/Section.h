@@ -1,11 +1,13 @@
 #pragma once
 #include <functional>
 #include <memory>
+#include <vector>
 
 #include "Epub.h"
 
 class Page;
 class GfxRenderer;
+class ZipInflateStream;
 
 class Section {
   std::shared_ptr<Epub> epub;
@@ -13,28 +15,50 @@ class Section {
   GfxRenderer& renderer;
   std::string filePath;
   FsFile file;
+  // Parser, chapter stream and page LUT of an incremental build (beginSectionFile) that has not finished yet
+  struct PendingBuild;
+  std::unique_ptr<PendingBuild> pendingBuild;
 
   void writeSectionFileHeader(int fontId, float lineCompression, bool extraParagraphSpacing, uint8_t paragraphAlignment,
                               uint16_t viewportWidth, uint16_t viewportHeight, bool hyphenationEnabled,
                               bool embeddedStyle, bool forceBold);
   uint32_t onPageComplete(std::unique_ptr<Page> page);
+  // Lay out the chapter into the section file, reading from `stream` when given or from `htmlPath` otherwise
+  bool buildSectionFile(int fontId, float lineCompression, bool extraParagraphSpacing, uint8_t paragraphAlignment,
+                        uint16_t viewportWidth, uint16_t viewportHeight, bool hyphenationEnabled, bool embeddedStyle,
+                        bool forceBold, const std::function<void()>& popupFn, const std::function<bool()>& abortFn,
+                        const std::string& htmlPath, ZipInflateStream* stream);
+  // Append the page LUT and complete the header of a fully laid out section file, then close it
+  bool finishSectionFile(const std::vector<uint32_t>& lut);
+  void abandonSectionFile();
 
  public:
   uint16_t pageCount = 0;
   int currentPage = 0;
 
-  explicit Section(const std::shared_ptr<Epub>& epub, const int spineIndex, GfxRenderer& renderer)
-      : epub(epub),
-        spineIndex(spineIndex),
-        renderer(renderer),
-        filePath(epub->getCachePath() + "/sections/" + std::to_string(spineIndex) + ".bin") {}
-  ~Section() = default;
+  explicit Section(const std::shared_ptr<Epub>& epub, int spineIndex, GfxRenderer& renderer);
+  ~Section();
   bool loadSectionFile(int fontId, float lineCompression, bool extraParagraphSpacing, uint8_t paragraphAlignment,
                        uint16_t viewportWidth, uint16_t viewportHeight, bool hyphenationEnabled, bool embeddedStyle,
                        bool forceBold);
   bool clearCache() const;
+  // Build the section file for the current settings. When `abortFn` returns true the build stops, the partial file is
+  // removed and false is returned.
   bool createSectionFile(int fontId, float lineCompression, bool extraParagraphSpacing, uint8_t paragraphAlignment,
                          uint16_t viewportWidth, uint16_t viewportHeight, bool hyphenationEnabled, bool embeddedStyle,
-                         bool forceBold, const std::function<void()>& popupFn = nullptr);
+                         bool forceBold, const std::function<void()>& popupFn = nullptr,
+                         const std::function<bool()>& abortFn = nullptr);
+  // Incremental build: lay out pages only as far as they are needed. beginSectionFile() starts the build and
+  // buildUntilPage() continues it until `page` exists (or the chapter ends, for -1), stopping early once `pauseFn`
+  // returns true. While building, pageCount is the number of pages laid out so far and loadPageFromSectionFile() can
+  // already read them. Destroying the section before the build finishes removes the partial file.
+  bool beginSectionFile(int fontId, float lineCompression, bool extraParagraphSpacing, uint8_t paragraphAlignment,
+                        uint16_t viewportWidth, uint16_t viewportHeight, bool hyphenationEnabled, bool embeddedStyle,
+                        bool forceBold, const std::function<void()>& popupFn = nullptr);
+  bool buildUntilPage(int page, const std::function<bool()>& pauseFn = nullptr);
+  bool isBuilding() const { return pendingBuild != nullptr; }
+  // pageCount once the chapter is laid out. While building, an estimate extrapolated from how much of the chapter has
+  // been parsed, and always more than the pages laid out so far.
+  uint16_t estimatedPageCount() const;
   std::unique_ptr<Page> loadPageFromSectionFile();
 };
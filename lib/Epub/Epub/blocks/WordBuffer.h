@@ -0,0 +1,137 @@
+#pragma once
+
+#include <EpdFontFamily.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/**
+ * WordBuffer - Flat, arena-backed storage for a run of words
+ *
+ * All word bytes live in one contiguous UTF-8 arena (each word null-terminated so it can be handed straight to the
+ * renderer), and each word is described by a small packed record. Compared to parallel std::lists of std::string this
+ * costs two heap blocks per buffer instead of several per word, which matters on a fragmented 160KB heap.
+ */
+class WordBuffer {
+ public:
+  struct Word {
+    uint32_t offset;  // byte offset of the word in the arena
+    uint16_t length;  // byte length, excluding the null terminator
+    uint16_t xpos;    // x position within the line (only meaningful once laid out)
+    EpdFontFamily::Style style;
+    bool continues;  // true = word attaches to previous (no space before it)
+  };
+
+ private:
+  std::vector<char> text;
+  std::vector<Word> words;
+
+  uint32_t appendBytes(const char* bytes, const size_t length) {
+    const auto offset = static_cast<uint32_t>(text.size());
+    text.insert(text.end(), bytes, bytes + length);
+    text.push_back('\0');
+    return offset;
+  }
+
+ public:
+  size_t size() const { return words.size(); }
+  bool empty() const { return words.empty(); }
+  size_t textBytes() const { return text.size(); }
+
+  void reserve(const size_t wordCount, const size_t byteCount) {
+    words.reserve(wordCount);
+    text.reserve(byteCount);
+  }
+
+  // Drop all words but keep the allocated capacity for the next paragraph
+  void clear() {
+    words.clear();
+    text.clear();
+  }
+
+  const Word& operator[](const size_t index) const { return words[index]; }
+  Word& operator[](const size_t index) { return words[index]; }
+  const char* c_str(const size_t index) const { return text.data() + words[index].offset; }
+
+  void push(const char* bytes, const size_t length, const EpdFontFamily::Style style, const bool continues,
+            const uint16_t xpos = 0) {
+    const uint32_t offset = appendBytes(bytes, length);
+    words.push_back({offset, static_cast<uint16_t>(length), xpos, style, continues});
+  }
+
+  // Insert a new word directly after `index`, its bytes appended to the end of the arena
+  void insertAfter(const size_t index, const char* bytes, const size_t length, const EpdFontFamily::Style style,
+                   const bool continues) {
+    const uint32_t offset = appendBytes(bytes, length);
+    words.insert(words.begin() + static_cast<std::ptrdiff_t>(index) + 1,
+                 Word{offset, static_cast<uint16_t>(length), 0, style, continues});
+  }
+
+  // Shrink a word in place to its first `length` bytes, optionally followed by a '-'. Always fits, as the
+  // word's old terminator slot absorbs the extra byte.
+  void truncate(const size_t index, const size_t length, const bool appendHyphen) {
+    Word& word = words[index];
+    char* start = text.data() + word.offset;
+    size_t newLength = length;
+    if (appendHyphen) {
+      start[newLength++] = '-';
+    }
+    start[newLength] = '\0';
+    word.length = static_cast<uint16_t>(newLength);
+  }
+
+  // Replace the word's bytes with `prefix` + old bytes. The new copy is appended to the arena.
+  void prepend(const size_t index, const char* prefix) {
+    const size_t prefixLength = strlen(prefix);
+    const Word old = words[index];
+    const auto offset = static_cast<uint32_t>(text.size());
+    text.resize(text.size() + prefixLength + old.length + 1);
+    memcpy(text.data() + offset, prefix, prefixLength);
+    memcpy(text.data() + offset + prefixLength, text.data() + old.offset, old.length + 1);
+    words[index].offset = offset;
+    words[index].length = static_cast<uint16_t>(prefixLength + old.length);
+  }
+
+  // Remove every occurrence of `pattern` from the word in place
+  void eraseAll(const size_t index, const char* pattern) {
+    const size_t patternLength = strlen(pattern);
+    Word& word = words[index];
+    char* start = text.data() + word.offset;
+    size_t write = 0;
+    for (size_t read = 0; read < word.length;) {
+      if (read + patternLength <= word.length && memcmp(start + read, pattern, patternLength) == 0) {
+        read += patternLength;
+        continue;
+      }
+      start[write++] = start[read++];
+    }
+    start[write] = '\0';
+    word.length = static_cast<uint16_t>(write);
+  }
+
+  // Remove the first `count` words and compact the arena so only the remaining words' bytes are kept
+  void consumeFront(const size_t count) {
+    if (count >= words.size()) {
+      clear();
+      return;
+    }
+
+    words.erase(words.begin(), words.begin() + static_cast<std::ptrdiff_t>(count));
+
+    // Records are not necessarily in arena order (split and prefixed words live at the end), so rebuild the arena
+    // from the surviving records rather than shifting bytes in place.
+    size_t remainingBytes = 0;
+    for (const auto& word : words) {
+      remainingBytes += word.length + 1;
+    }
+    std::vector<char> compacted;
+    compacted.reserve(remainingBytes);
+    for (auto& word : words) {
+      const auto offset = static_cast<uint32_t>(compacted.size());
+      compacted.insert(compacted.end(), text.begin() + word.offset, text.begin() + word.offset + word.length + 1);
+      word.offset = offset;
+    }
+    text.swap(compacted);
+  }
+};
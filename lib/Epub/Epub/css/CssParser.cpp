@@ -1,142 +1,61 @@
 #include "CssParser.h"
 
-#include <HardwareSerial.h>
+#include <Arduino.h>
+#include <ZipFile.h>
 
 #include <algorithm>
 #include <cctype>
+#include <cstring>
 
 namespace {
 
 // Buffer size for reading CSS files
 constexpr size_t READ_BUFFER_SIZE = 512;
 
-// Maximum CSS file size we'll process (prevent memory issues)
-constexpr size_t MAX_CSS_SIZE = 64 * 1024;
+// Longest selector group and declaration block kept while tokenizing. Anything longer is dropped, so memory stays
+// bounded whatever the stylesheet size.
+constexpr size_t MAX_SELECTOR_LENGTH = 1024;
+constexpr size_t MAX_DECLARATIONS_LENGTH = 4096;
+
+// Every rule kept is a heap node (selector string plus CssStyle), and streaming puts no limit on the stylesheet size,
+// so new rules are dropped past MAX_RULES or once free heap falls below RULE_HEAP_RESERVE
+constexpr size_t MAX_RULES = 1024;
+constexpr size_t RULE_HEAP_RESERVE = 48 * 1024;
 
 // Check if character is CSS whitespace
 bool isCssWhitespace(const char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f'; }
 
-// Read entire file into string (with size limit)
-std::string readFileContent(FsFile& file) {
-  std::string content;
-  content.reserve(std::min(static_cast<size_t>(file.size()), MAX_CSS_SIZE));
+char toLowerAscii(const char c) { return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c; }
 
-  char buffer[READ_BUFFER_SIZE];
-  while (file.available() && content.size() < MAX_CSS_SIZE) {
-    const int bytesRead = file.read(buffer, sizeof(buffer));
-    if (bytesRead <= 0) break;
-    content.append(buffer, bytesRead);
-  }
-  return content;
-}
-
-// Remove CSS comments (/* ... */) from content
-std::string stripComments(const std::string& css) {
-  std::string result;
-  result.reserve(css.size());
-
-  size_t pos = 0;
-  while (pos < css.size()) {
-    // Look for start of comment
-    if (pos + 1 < css.size() && css[pos] == '/' && css[pos + 1] == '*') {
-      // Find end of comment
-      const size_t endPos = css.find("*/", pos + 2);
-      if (endPos == std::string::npos) {
-        // Unterminated comment - skip rest of file
-        break;
-      }
-      pos = endPos + 2;
-    } else {
-      result.push_back(css[pos]);
-      ++pos;
-    }
+// FNV-1a over the lowercase name, so lookups need no lowercased copy
+uint32_t nameHash(const char* name, const size_t length) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < length; i++) {
+    hash ^= static_cast<uint8_t>(toLowerAscii(name[i]));
+    hash *= 16777619u;
   }
-  return result;
+  return hash;
 }
 
-// Skip @-rules (like @media, @import, @font-face)
-// Returns position after the @-rule
-size_t skipAtRule(const std::string& css, const size_t start) {
-  // Find the end - either semicolon (simple @-rule) or matching brace
-  size_t pos = start + 1;  // Skip the '@'
-
-  // Skip identifier
-  while (pos < css.size() && (std::isalnum(css[pos]) || css[pos] == '-')) {
-    ++pos;
+// Calls fn(start, length) for each whitespace-separated class name in a class attribute
+template <typename Fn>
+void forEachClass(const char* classAttr, Fn&& fn) {
+  if (!classAttr) {
+    return;
   }
-
-  // Look for { or ;
-  int braceDepth = 0;
-  while (pos < css.size()) {
-    const char c = css[pos];
-    if (c == '{') {
-      ++braceDepth;
-    } else if (c == '}') {
-      --braceDepth;
-      if (braceDepth == 0) {
-        return pos + 1;
-      }
-    } else if (c == ';' && braceDepth == 0) {
-      return pos + 1;
+  const char* p = classAttr;
+  while (*p) {
+    while (*p && isCssWhitespace(*p)) {
+      ++p;
     }
-    ++pos;
-  }
-  return css.size();
-}
-
-// Extract next rule from CSS content
-// Returns true if a rule was found, with selector and body filled
-bool extractNextRule(const std::string& css, size_t& pos, std::string& selector, std::string& body) {
-  selector.clear();
-  body.clear();
-
-  // Skip whitespace and @-rules until we find a regular rule
-  while (pos < css.size()) {
-    // Skip whitespace
-    while (pos < css.size() && isCssWhitespace(css[pos])) {
-      ++pos;
+    const char* start = p;
+    while (*p && !isCssWhitespace(*p)) {
+      ++p;
     }
-
-    if (pos >= css.size()) return false;
-
-    // Handle @-rules iteratively (avoids recursion/stack overflow)
-    if (css[pos] == '@') {
-      pos = skipAtRule(css, pos);
-      continue;  // Try again after skipping the @-rule
+    if (p > start) {
+      fn(start, static_cast<size_t>(p - start));
     }
-
-    break;  // Found start of a regular rule
-  }
-
-  if (pos >= css.size()) return false;
-
-  // Find opening brace
-  const size_t bracePos = css.find('{', pos);
-  if (bracePos == std::string::npos) return false;
-
-  // Extract selector (everything before the brace)
-  selector = css.substr(pos, bracePos - pos);
-
-  // Find matching closing brace
-  int depth = 1;
-  const size_t bodyStart = bracePos + 1;
-  size_t bodyEnd = bodyStart;
-
-  while (bodyEnd < css.size() && depth > 0) {
-    if (css[bodyEnd] == '{')
-      ++depth;
-    else if (css[bodyEnd] == '}')
-      --depth;
-    ++bodyEnd;
-  }
-
-  // Extract body (between braces)
-  if (bodyEnd > bodyStart) {
-    body = css.substr(bodyStart, bodyEnd - bodyStart - 1);
   }
-
-  pos = bodyEnd;
-  return true;
 }
 
 }  // anonymous namespace
@@ -439,6 +358,12 @@ void CssParser::processRuleBlock(const std::string& selectorGroup, const std::st
     auto it = rulesBySelector_.find(key);
     if (it != rulesBySelector_.end()) {
       it->second.applyOver(style);
+    } else if (rulesBySelector_.size() >= MAX_RULES || ESP.getFreeHeap() < RULE_HEAP_RESERVE) {
+      if (!rulesCapped_) {
+        Serial.printf("[%lu] [CSS] Rule limit reached at %zu rules (free heap %d bytes), dropping the rest\n", millis(),
+                      rulesBySelector_.size(), ESP.getFreeHeap());
+        rulesCapped_ = true;
+      }
     } else {
       rulesBySelector_[key] = style;
     }
@@ -452,64 +377,345 @@ bool CssParser::loadFromStream(FsFile& source) {
     Serial.printf("[%lu] [CSS] Cannot read from invalid file\n", millis());
     return false;
   }
+  return loadFromReader([&source](char* buffer, const size_t size) { return source.read(buffer, size); });
+}
 
-  // Read file content
-  const std::string content = readFileContent(source);
-  if (content.empty()) {
-    return true;  // Empty file is valid
+bool CssParser::loadFromStream(ZipInflateStream& source) {
+  if (!source.isOpen()) {
+    Serial.printf("[%lu] [CSS] Cannot read from closed zip stream\n", millis());
+    return false;
+  }
+  const bool ok = loadFromReader([&source](char* buffer, const size_t size) {
+    return static_cast<int>(source.read(reinterpret_cast<uint8_t*>(buffer), size));
+  });
+  if (source.hasError()) {
+    Serial.printf("[%lu] [CSS] Stylesheet could not be inflated, keeping the rules read so far\n", millis());
+    return false;
   }
+  return ok;
+}
 
-  // Remove comments
-  const std::string cleaned = stripComments(content);
+// Tokenizes the stylesheet one chunk at a time. Comments are dropped as they are read, @-rules are skipped by
+// counting braces, and only the rule being read is held in memory, so a stylesheet never has to fit in RAM.
+bool CssParser::loadFromReader(const std::function<int(char* buffer, size_t size)>& read) {
+  enum class State : uint8_t {
+    Selector,      // Before a rule's '{'
+    Declarations,  // Inside a rule's braces
+    AtRule,        // From '@' to the ';' or the brace closing the at-rule's block
+  };
 
-  // Parse rules
-  size_t pos = 0;
-  std::string selector, body;
+  State state = State::Selector;
+  int braceDepth = 0;
+  bool inComment = false;
+  // A '/' or '*' whose meaning depends on the next character, which may be in the next chunk
+  bool pendingSlash = false;
+  bool pendingStar = false;
+  bool overflowed = false;
+  std::string selector;
+  std::string declarations;
+
+  const auto append = [&overflowed](std::string& target, const char c, const size_t maxLength) {
+    if (target.size() < maxLength) {
+      target.push_back(c);
+    } else {
+      overflowed = true;
+    }
+  };
 
-  while (extractNextRule(cleaned, pos, selector, body)) {
-    processRuleBlock(selector, body);
+  const auto finishRule = [&] {
+    if (overflowed) {
+      Serial.printf("[%lu] [CSS] Skipping rule longer than the tokenizer buffers\n", millis());
+    } else {
+      processRuleBlock(selector, declarations);
+    }
+    selector.clear();
+    declarations.clear();
+    overflowed = false;
+  };
+
+  const auto consume = [&](const char c) {
+    switch (state) {
+      case State::Selector:
+        if (c == '{') {
+          state = State::Declarations;
+          braceDepth = 1;
+        } else if (c == '}') {
+          // Stray closing brace: resynchronise on the next rule
+          selector.clear();
+          overflowed = false;
+        } else if (c == '@' && selector.empty()) {
+          state = State::AtRule;
+          braceDepth = 0;
+        } else if (!selector.empty() || !isCssWhitespace(c)) {
+          append(selector, c, MAX_SELECTOR_LENGTH);
+        }
+        break;
+
+      case State::Declarations:
+        if (c == '{') {
+          braceDepth++;
+        } else if (c == '}' && --braceDepth == 0) {
+          finishRule();
+          state = State::Selector;
+          break;
+        }
+        append(declarations, c, MAX_DECLARATIONS_LENGTH);
+        break;
+
+      case State::AtRule:
+        if (c == '{') {
+          braceDepth++;
+        } else if ((c == '}' && braceDepth > 0 && --braceDepth == 0) || (c == ';' && braceDepth == 0)) {
+          state = State::Selector;
+        }
+        break;
+    }
+  };
+
+  char buffer[READ_BUFFER_SIZE];
+  int bytesRead;
+  while ((bytesRead = read(buffer, sizeof(buffer))) > 0) {
+    for (int i = 0; i < bytesRead; i++) {
+      const char c = buffer[i];
+      if (inComment) {
+        if (pendingStar && c == '/') {
+          inComment = false;
+        }
+        pendingStar = c == '*';
+        continue;
+      }
+      if (pendingSlash) {
+        pendingSlash = false;
+        if (c == '*') {
+          inComment = true;
+          pendingStar = false;
+          continue;
+        }
+        consume('/');
+      }
+      if (c == '/') {
+        pendingSlash = true;
+      } else {
+        consume(c);
+      }
+    }
+  }
+  // A rule left open at the end of the file still applies, as browsers close it implicitly
+  if (state == State::Declarations) {
+    finishRule();
   }
 
+  indexStale_ = true;
   Serial.printf("[%lu] [CSS] Parsed %zu rules\n", millis(), rulesBySelector_.size());
   return true;
 }
 
+// Selector index
+
+void CssParser::buildSelectorIndex() const {
+  indexStale_ = false;
+  nameArena_.clear();
+  names_.clear();
+  ruleIndex_.clear();
+  for (auto& entry : memo_) {
+    entry.valid = false;
+  }
+
+  // Splits a selector into its tag and class name. resolveStyle only ever looks up "tag", ".class" and
+  // "tag.class"; any other selector can't match an element, and those containing spaces are left out entirely.
+  const auto splitSelector = [](const std::string& selector, size_t& tagLength, size_t& classStart) {
+    if (selector.find(' ') != std::string::npos) {
+      return false;
+    }
+    const size_t dot = selector.find('.');
+    if (dot == std::string::npos) {
+      tagLength = selector.size();
+      classStart = selector.size();
+      return tagLength > 0;
+    }
+    tagLength = dot;
+    classStart = dot + 1;
+    return classStart < selector.size();
+  };
+
+  // Collect each distinct name once, then give them IDs in hash order. The candidates are released before the rule
+  // index is allocated to keep the build's peak down.
+  {
+    struct Candidate {
+      uint32_t hash;
+      const char* name;
+      uint16_t length;
+    };
+    std::vector<Candidate> candidates;
+    candidates.reserve(rulesBySelector_.size() * 2);
+    const auto addCandidate = [&candidates](const char* name, const size_t length) {
+      if (length > 0 && length <= UINT16_MAX) {
+        candidates.push_back({nameHash(name, length), name, static_cast<uint16_t>(length)});
+      }
+    };
+    for (const auto& [selector, style] : rulesBySelector_) {
+      size_t tagLength, classStart;
+      if (splitSelector(selector, tagLength, classStart)) {
+        addCandidate(selector.data(), tagLength);
+        addCandidate(selector.data() + classStart, selector.size() - classStart);
+      }
+    }
+    const auto sameName = [](const Candidate& a, const Candidate& b) {
+      return a.hash == b.hash && a.length == b.length && strncmp(a.name, b.name, a.length) == 0;
+    };
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+      if (a.hash != b.hash) return a.hash < b.hash;
+      if (a.length != b.length) return a.length < b.length;
+      return strncmp(a.name, b.name, a.length) < 0;
+    });
+    candidates.erase(std::unique(candidates.begin(), candidates.end(), sameName), candidates.end());
+    if (candidates.size() >= UINT16_MAX) {
+      Serial.printf("[%lu] [CSS] Too many selector names to index (%zu)\n", millis(), candidates.size());
+      candidates.resize(UINT16_MAX - 1);
+    }
+
+    size_t arenaSize = 0;
+    for (const auto& candidate : candidates) {
+      arenaSize += candidate.length;
+    }
+    nameArena_.reserve(arenaSize);
+    names_.reserve(candidates.size());
+    for (const auto& candidate : candidates) {
+      names_.push_back({candidate.hash, static_cast<uint32_t>(nameArena_.size()), candidate.length,
+                        static_cast<uint16_t>(names_.size() + 1)});
+      nameArena_.append(candidate.name, candidate.length);
+    }
+  }
+
+  ruleIndex_.reserve(rulesBySelector_.size());
+  for (const auto& [selector, style] : rulesBySelector_) {
+    size_t tagLength, classStart;
+    if (!splitSelector(selector, tagLength, classStart)) {
+      continue;
+    }
+    const bool hasClass = classStart < selector.size();
+    const uint16_t tagId = tagLength > 0 ? findName(selector.data(), tagLength) : 0;
+    const uint16_t classId = hasClass ? findName(selector.data() + classStart, selector.size() - classStart) : 0;
+    // A selector needs every part it names to be indexed, and at least one part
+    if ((tagLength > 0 && tagId == 0) || (hasClass && classId == 0) || (tagId == 0 && classId == 0)) {
+      continue;
+    }
+    ruleIndex_.push_back({static_cast<uint32_t>(tagId) << 16 | classId, &style});
+  }
+  std::sort(ruleIndex_.begin(), ruleIndex_.end(),
+            [](const IndexedRule& a, const IndexedRule& b) { return a.key < b.key; });
+}
+
+uint16_t CssParser::findName(const char* name, const size_t length) const {
+  if (length == 0 || names_.empty()) {
+    return 0;
+  }
+  const uint32_t hash = nameHash(name, length);
+  auto it = std::lower_bound(names_.begin(), names_.end(), hash,
+                             [](const InternedName& entry, const uint32_t h) { return entry.hash < h; });
+  for (; it != names_.end() && it->hash == hash; ++it) {
+    if (it->length != length) {
+      continue;
+    }
+    const char* interned = nameArena_.data() + it->offset;
+    size_t i = 0;
+    while (i < length && toLowerAscii(name[i]) == interned[i]) {
+      ++i;
+    }
+    if (i == length) {
+      return it->id;
+    }
+  }
+  return 0;
+}
+
+void CssParser::applyRule(CssStyle& style, const uint16_t tagId, const uint16_t classId) const {
+  const uint32_t key = static_cast<uint32_t>(tagId) << 16 | classId;
+  const auto it = std::lower_bound(ruleIndex_.begin(), ruleIndex_.end(), key,
+                                   [](const IndexedRule& rule, const uint32_t k) { return rule.key < k; });
+  if (it != ruleIndex_.end() && it->key == key) {
+    style.applyOver(*it->style);
+  }
+}
+
 // Style resolution
 
-CssStyle CssParser::resolveStyle(const std::string& tagName, const std::string& classAttr) const {
+CssStyle CssParser::resolveStyle(const char* tagName, const char* classAttr) const {
   CssStyle result;
-  const std::string tag = normalized(tagName);
-
-  // 1. Apply element-level style (lowest priority)
-  const auto tagIt = rulesBySelector_.find(tag);
-  if (tagIt != rulesBySelector_.end()) {
-    result.applyOver(tagIt->second);
+  if (indexStale_) {
+    buildSelectorIndex();
+  }
+  if (ruleIndex_.empty()) {
+    return result;
   }
 
-  // 2. Apply class styles (medium priority)
-  if (!classAttr.empty()) {
-    const auto classes = splitWhitespace(classAttr);
+  const uint16_t tagId = tagName ? findName(tagName, strlen(tagName)) : 0;
 
-    for (const auto& cls : classes) {
-      std::string classKey = "." + normalized(cls);
+  // Classes without any rule can't change the result, so the memo key is the tag and the indexed classes
+  uint16_t classIds[MEMO_MAX_CLASSES];
+  uint8_t classCount = 0;
+  bool memoizable = true;
+  forEachClass(classAttr, [&](const char* cls, const size_t length) {
+    const uint16_t id = findName(cls, length);
+    if (id == 0) {
+      return;
+    }
+    if (classCount < MEMO_MAX_CLASSES) {
+      classIds[classCount++] = id;
+    } else {
+      memoizable = false;
+    }
+  });
+  if (tagId == 0 && classCount == 0 && memoizable) {
+    return result;
+  }
 
-      auto classIt = rulesBySelector_.find(classKey);
-      if (classIt != rulesBySelector_.end()) {
-        result.applyOver(classIt->second);
-      }
+  MemoEntry* memo = nullptr;
+  if (memoizable) {
+    uint32_t slot = tagId * 31u;
+    for (uint8_t i = 0; i < classCount; i++) {
+      slot = slot * 31u + classIds[i];
+    }
+    memo = &memo_[slot % MEMO_SIZE];
+    if (memo->valid && memo->tagId == tagId && memo->classCount == classCount &&
+        std::equal(classIds, classIds + classCount, memo->classIds)) {
+      return memo->style;
     }
+  }
 
-    // 3. Apply element.class styles (higher priority)
-    for (const auto& cls : classes) {
-      std::string combinedKey = tag + "." + normalized(cls);
+  // 1. Apply element-level style (lowest priority)
+  if (tagId != 0) {
+    applyRule(result, tagId, 0);
+  }
 
-      auto combinedIt = rulesBySelector_.find(combinedKey);
-      if (combinedIt != rulesBySelector_.end()) {
-        result.applyOver(combinedIt->second);
+  // 2. Apply class styles (medium priority)
+  const auto forEachIndexedClass = [&](auto&& fn) {
+    if (memoizable) {
+      for (uint8_t i = 0; i < classCount; i++) {
+        fn(classIds[i]);
       }
+      return;
     }
+    forEachClass(classAttr, [&](const char* cls, const size_t length) {
+      if (const uint16_t id = findName(cls, length)) {
+        fn(id);
+      }
+    });
+  };
+  forEachIndexedClass([&](const uint16_t classId) { applyRule(result, 0, classId); });
+
+  // 3. Apply element.class styles (higher priority)
+  if (tagId != 0) {
+    forEachIndexedClass([&](const uint16_t classId) { applyRule(result, tagId, classId); });
   }
 
+  if (memo) {
+    memo->valid = true;
+    memo->tagId = tagId;
+    memo->classCount = classCount;
+    std::copy(classIds, classIds + classCount, memo->classIds);
+    memo->style = result;
+  }
   return result;
 }
 
@@ -530,12 +736,16 @@ bool CssParser::saveToCache(FsFile& file) const {
   // Write version
   file.write(CSS_CACHE_VERSION);
 
-  // Write rule count
-  const auto ruleCount = static_cast<uint16_t>(rulesBySelector_.size());
+  // Write rule count, and no more rules than it says
+  const auto ruleCount = static_cast<uint16_t>(std::min<size_t>(rulesBySelector_.size(), UINT16_MAX));
   file.write(reinterpret_cast<const uint8_t*>(&ruleCount), sizeof(ruleCount));
 
   // Write each rule: selector string + CssStyle fields
+  uint16_t written = 0;
   for (const auto& pair : rulesBySelector_) {
+    if (written++ == ruleCount) {
+      break;
+    }
     // Write selector string (length-prefixed)
     const auto selectorLen = static_cast<uint16_t>(pair.first.size());
     file.write(reinterpret_cast<const uint8_t*>(&selectorLen), sizeof(selectorLen));
@@ -694,6 +904,7 @@ bool CssParser::loadFromCache(FsFile& file) {
     rulesBySelector_[selector] = style;
   }
 
+  indexStale_ = true;
   Serial.printf("[%lu] [CSS] Loaded %u rules from cache\n", millis(), ruleCount);
   return true;
 }
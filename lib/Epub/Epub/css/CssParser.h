@@ -2,18 +2,22 @@
 
 #include <HalStorage.h>
 
+#include <functional>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 #include "CssStyle.h"
 
+class ZipInflateStream;
+
 /**
  * Lightweight CSS parser for EPUB stylesheets
  *
  * Parses CSS files and extracts styling information relevant for e-ink display.
- * Uses a two-phase approach: first tokenizes the CSS content, then builds
- * a rule database that can be queried during HTML parsing.
+ * Stylesheets are tokenized from the stream in small chunks, so only the rule
+ * being read is held in memory, and the rules are collected into a database
+ * that can be queried during HTML parsing.
  *
  * Supported selectors:
  *   - Element selectors: p, div, h1, etc.
@@ -44,15 +48,24 @@ class CssParser {
    */
   bool loadFromStream(FsFile& source);
 
+  /**
+   * Load and parse CSS straight from an inflating zip entry, without a temp file.
+   * @param source Open zip entry stream to read from
+   * @return true if parsing completed, false if the entry could not be inflated
+   */
+  bool loadFromStream(ZipInflateStream& source);
+
   /**
    * Look up the style for an HTML element, considering tag name and class attributes.
    * Applies CSS cascade: element style < class style < element.class style
+   * Names are matched against the interned selector index without allocating, and recent
+   * (tag, class) combinations are answered from a small memo.
    *
    * @param tagName The HTML element name (e.g., "p", "div")
-   * @param classAttr The class attribute value (may contain multiple space-separated classes)
+   * @param classAttr The class attribute value (may contain multiple space-separated classes), or nullptr
    * @return Combined style with all applicable rules merged
    */
-  [[nodiscard]] CssStyle resolveStyle(const std::string& tagName, const std::string& classAttr) const;
+  [[nodiscard]] CssStyle resolveStyle(const char* tagName, const char* classAttr) const;
 
   /**
    * Parse an inline style attribute string.
@@ -74,7 +87,11 @@ class CssParser {
   /**
    * Clear all loaded rules
    */
-  void clear() { rulesBySelector_.clear(); }
+  void clear() {
+    rulesBySelector_.clear();
+    rulesCapped_ = false;
+    indexStale_ = true;
+  }
 
   /**
    * Save parsed CSS rules to a cache file.
@@ -94,8 +111,47 @@ class CssParser {
  private:
   // Storage: maps normalized selector -> style properties
   std::unordered_map<std::string, CssStyle> rulesBySelector_;
+  // Set once the rule limit has been hit and logged
+  bool rulesCapped_ = false;
+
+  // Selector index for resolveStyle, rebuilt on the first lookup after rules change, so books that are only being
+  // indexed never pay for it and multi-file stylesheets build it once. Every tag and class name that appears in a
+  // "tag", ".class" or "tag.class" selector is interned into a 16-bit ID (0 means absent), and those rules are keyed
+  // by (tagId << 16 | classId) in a sorted vector, pointing at the style in rulesBySelector_.
+  struct InternedName {
+    uint32_t hash;  // FNV-1a of the lowercase name
+    uint32_t offset;
+    uint16_t length;
+    uint16_t id;
+  };
+  struct IndexedRule {
+    uint32_t key;
+    const CssStyle* style;
+  };
+  mutable std::string nameArena_;
+  mutable std::vector<InternedName> names_;     // Sorted by hash
+  mutable std::vector<IndexedRule> ruleIndex_;  // Sorted by key
+  mutable bool indexStale_ = false;
+
+  // Direct-mapped memo of resolved styles for recent (tag, classes) combinations. Section builds are serialized by
+  // the reader, so the const lookups never race on it or on the index.
+  static constexpr uint8_t MEMO_SIZE = 8;
+  static constexpr uint8_t MEMO_MAX_CLASSES = 4;
+  struct MemoEntry {
+    bool valid = false;
+    uint8_t classCount = 0;
+    uint16_t tagId = 0;
+    uint16_t classIds[MEMO_MAX_CLASSES] = {};
+    CssStyle style;
+  };
+  mutable MemoEntry memo_[MEMO_SIZE];
+
+  void buildSelectorIndex() const;
+  [[nodiscard]] uint16_t findName(const char* name, size_t length) const;
+  void applyRule(CssStyle& style, uint16_t tagId, uint16_t classId) const;
 
   // Internal parsing helpers
+  bool loadFromReader(const std::function<int(char* buffer, size_t size)>& read);
   void processRuleBlock(const std::string& selectorGroup, const std::string& declarations);
   static CssStyle parseDeclarations(const std::string& declBlock);
 
@@ -3,6 +3,7 @@
 #include <GfxRenderer.h>
 #include <HalStorage.h>
 #include <HardwareSerial.h>
+#include <ZipFile.h>
 #include <expat.h>
 
 #include "../Page.h"
@@ -109,6 +110,9 @@ void ChapterHtmlSlimParser::startNewTextBlock(const BlockStyle& blockStyle) {
     }
 
     makePages();
+    // Reuse the word arena for the next paragraph rather than reallocating it
+    currentTextBlock->reset(blockStyle);
+    return;
   }
   currentTextBlock.reset(new ParsedText(extraParagraphSpacing, hyphenationEnabled, blockStyle));
 }
@@ -123,8 +127,8 @@ void XMLCALL ChapterHtmlSlimParser::startElement(void* userData, const XML_Char*
   }
 
   // Extract class and style attributes for CSS processing
-  std::string classAttr;
-  std::string styleAttr;
+  const char* classAttr = nullptr;
+  const char* styleAttr = nullptr;
   if (atts != nullptr) {
     for (int i = 0; atts[i]; i += 2) {
       if (strcmp(atts[i], "class") == 0) {
@@ -206,7 +210,7 @@ void XMLCALL ChapterHtmlSlimParser::startElement(void* userData, const XML_Char*
     // Get combined tag + class styles
     cssStyle = self->cssParser->resolveStyle(name, classAttr);
     // Merge inline style (highest priority)
-    if (!styleAttr.empty()) {
+    if (styleAttr && styleAttr[0] != '\0') {
       CssStyle inlineStyle = CssParser::parseInlineStyle(styleAttr);
       cssStyle.applyOver(inlineStyle);
     }
@@ -464,6 +468,46 @@ void XMLCALL ChapterHtmlSlimParser::endElement(void* userData, const XML_Char* n
 }
 
 bool ChapterHtmlSlimParser::parseAndBuildPages() {
+  FsFile file;
+  if (!Storage.openFileForRead("EHP", filepath, file)) {
+    return false;
+  }
+
+  const bool success = parseChunks(file.size(), [&file](void* buf, const size_t len, size_t& read, bool& done) {
+    read = file.read(buf, len);
+    if (read == 0 && file.available() > 0) {
+      Serial.printf("[%lu] [EHP] File read error\n", millis());
+      return false;
+    }
+    done = file.available() == 0;
+    return true;
+  });
+
+  file.close();
+  return success;
+}
+
+bool ChapterHtmlSlimParser::parseAndBuildPages(ZipInflateStream& stream) {
+  return beginParse(stream) && parseMore(nullptr) == ParseStatus::Done;
+}
+
+bool ChapterHtmlSlimParser::beginParse(ZipInflateStream& stream) {
+  return beginChunks(stream.size(), [&stream](void* buf, const size_t len, size_t& read, bool& done) {
+    read = stream.read(static_cast<uint8_t*>(buf), len);
+    if (stream.hasError()) {
+      Serial.printf("[%lu] [EHP] Stream read error\n", millis());
+      return false;
+    }
+    done = stream.eof();
+    return true;
+  });
+}
+
+bool ChapterHtmlSlimParser::parseChunks(const size_t sourceSize, ReadChunkFn readChunkFn) {
+  return beginChunks(sourceSize, std::move(readChunkFn)) && parseMore(nullptr) == ParseStatus::Done;
+}
+
+bool ChapterHtmlSlimParser::beginChunks(const size_t sourceSize, ReadChunkFn readChunkFn) {
   auto paragraphAlignmentBlockStyle = BlockStyle();
   paragraphAlignmentBlockStyle.textAlignDefined = true;
   // Resolve None sentinel to Justify for initial block (no CSS context yet)
@@ -473,72 +517,63 @@ bool ChapterHtmlSlimParser::parseAndBuildPages() {
   paragraphAlignmentBlockStyle.alignment = align;
   startNewTextBlock(paragraphAlignmentBlockStyle);
 
-  const XML_Parser parser = XML_ParserCreate(nullptr);
-  int done;
-
-  if (!parser) {
+  freeXmlParser();
+  xmlParser = XML_ParserCreate(nullptr);
+  if (!xmlParser) {
     Serial.printf("[%lu] [EHP] Couldn't allocate memory for parser\n", millis());
     return false;
   }
 
-  FsFile file;
-  if (!Storage.openFileForRead("EHP", filepath, file)) {
-    XML_ParserFree(parser);
-    return false;
-  }
-
-  // Get file size to decide whether to show indexing popup.
-  if (popupFn && file.size() >= MIN_SIZE_FOR_POPUP) {
+  // Use source size to decide whether to show indexing popup.
+  if (popupFn && sourceSize >= MIN_SIZE_FOR_POPUP) {
     popupFn();
   }
 
-  XML_SetUserData(parser, this);
-  XML_SetElementHandler(parser, startElement, endElement);
-  XML_SetCharacterDataHandler(parser, characterData);
+  XML_SetUserData(xmlParser, this);
+  XML_SetElementHandler(xmlParser, startElement, endElement);
+  XML_SetCharacterDataHandler(xmlParser, characterData);
+  readChunk = std::move(readChunkFn);
+  sourceDone = false;
+  return true;
+}
+
+ChapterHtmlSlimParser::ParseStatus ChapterHtmlSlimParser::parseMore(const std::function<bool()>& pauseFn) {
+  if (!xmlParser) {
+    return ParseStatus::Failed;
+  }
 
   do {
-    void* const buf = XML_GetBuffer(parser, 1024);
+    if (abortFn && abortFn()) {
+      Serial.printf("[%lu] [EHP] Parse aborted\n", millis());
+      freeXmlParser();
+      return ParseStatus::Failed;
+    }
+    if (pauseFn && pauseFn()) {
+      return ParseStatus::Paused;
+    }
+
+    void* const buf = XML_GetBuffer(xmlParser, 1024);
     if (!buf) {
       Serial.printf("[%lu] [EHP] Couldn't allocate memory for buffer\n", millis());
-      XML_StopParser(parser, XML_FALSE);                // Stop any pending processing
-      XML_SetElementHandler(parser, nullptr, nullptr);  // Clear callbacks
-      XML_SetCharacterDataHandler(parser, nullptr);
-      XML_ParserFree(parser);
-      file.close();
-      return false;
+      freeXmlParser();
+      return ParseStatus::Failed;
     }
 
-    const size_t len = file.read(buf, 1024);
-
-    if (len == 0 && file.available() > 0) {
-      Serial.printf("[%lu] [EHP] File read error\n", millis());
-      XML_StopParser(parser, XML_FALSE);                // Stop any pending processing
-      XML_SetElementHandler(parser, nullptr, nullptr);  // Clear callbacks
-      XML_SetCharacterDataHandler(parser, nullptr);
-      XML_ParserFree(parser);
-      file.close();
-      return false;
+    size_t len = 0;
+    if (!readChunk(buf, 1024, len, sourceDone)) {
+      freeXmlParser();
+      return ParseStatus::Failed;
     }
 
-    done = file.available() == 0;
-
-    if (XML_ParseBuffer(parser, static_cast<int>(len), done) == XML_STATUS_ERROR) {
-      Serial.printf("[%lu] [EHP] Parse error at line %lu:\n%s\n", millis(), XML_GetCurrentLineNumber(parser),
-                    XML_ErrorString(XML_GetErrorCode(parser)));
-      XML_StopParser(parser, XML_FALSE);                // Stop any pending processing
-      XML_SetElementHandler(parser, nullptr, nullptr);  // Clear callbacks
-      XML_SetCharacterDataHandler(parser, nullptr);
-      XML_ParserFree(parser);
-      file.close();
-      return false;
+    if (XML_ParseBuffer(xmlParser, static_cast<int>(len), sourceDone) == XML_STATUS_ERROR) {
+      Serial.printf("[%lu] [EHP] Parse error at line %lu:\n%s\n", millis(), XML_GetCurrentLineNumber(xmlParser),
+                    XML_ErrorString(XML_GetErrorCode(xmlParser)));
+      freeXmlParser();
+      return ParseStatus::Failed;
     }
-  } while (!done);
+  } while (!sourceDone);
 
-  XML_StopParser(parser, XML_FALSE);                // Stop any pending processing
-  XML_SetElementHandler(parser, nullptr, nullptr);  // Clear callbacks
-  XML_SetCharacterDataHandler(parser, nullptr);
-  XML_ParserFree(parser);
-  file.close();
+  freeXmlParser();
 
   // Process last page if there is still text
   if (currentTextBlock) {
@@ -548,7 +583,19 @@ bool ChapterHtmlSlimParser::parseAndBuildPages() {
     currentTextBlock.reset();
   }
 
-  return true;
+  return ParseStatus::Done;
+}
+
+void ChapterHtmlSlimParser::freeXmlParser() {
+  if (!xmlParser) {
+    return;
+  }
+  XML_StopParser(xmlParser, XML_FALSE);                // Stop any pending processing
+  XML_SetElementHandler(xmlParser, nullptr, nullptr);  // Clear callbacks
+  XML_SetCharacterDataHandler(xmlParser, nullptr);
+  XML_ParserFree(xmlParser);
+  xmlParser = nullptr;
+  readChunk = nullptr;
 }
 
 void ChapterHtmlSlimParser::addLineToPage(std::shared_ptr<TextBlock> line) {
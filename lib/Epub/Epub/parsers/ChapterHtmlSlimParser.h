@@ -13,6 +13,7 @@
 
 class Page;
 class GfxRenderer;
+class ZipInflateStream;
 
 #define MAX_WORD_SIZE 200
 
@@ -21,6 +22,7 @@ class ChapterHtmlSlimParser {
   GfxRenderer& renderer;
   std::function<void(std::unique_ptr<Page>)> completePageFn;
   std::function<void()> popupFn;  // Popup callback
+  std::function<bool()> abortFn;  // Polled between chunks, parsing stops early when it returns true
   int depth = 0;
   int skipUntilDepth = INT_MAX;
   int boldUntilDepth = INT_MAX;
@@ -61,6 +63,15 @@ class ChapterHtmlSlimParser {
   void startNewTextBlock(const BlockStyle& blockStyle);
   void flushPartWordBuffer();
   void makePages();
+  // Pulls up to `len` bytes into `buf`, setting `read` and `done`. Returns false on a read error.
+  using ReadChunkFn = std::function<bool(void* buf, size_t len, size_t& read, bool& done)>;
+  // Parser state kept between parseMore() calls
+  XML_Parser xmlParser = nullptr;
+  ReadChunkFn readChunk;
+  bool sourceDone = false;
+  bool beginChunks(size_t sourceSize, ReadChunkFn readChunkFn);
+  bool parseChunks(size_t sourceSize, ReadChunkFn readChunkFn);
+  void freeXmlParser();
   // XML callbacks
   static void XMLCALL startElement(void* userData, const XML_Char* name, const XML_Char** atts);
   static void XMLCALL characterData(void* userData, const XML_Char* s, int len);
@@ -73,7 +84,7 @@ class ChapterHtmlSlimParser {
                                  const uint16_t viewportHeight, const bool hyphenationEnabled,
                                  const std::function<void(std::unique_ptr<Page>)>& completePageFn,
                                  const bool embeddedStyle, const std::function<void()>& popupFn = nullptr,
-                                 const CssParser* cssParser = nullptr)
+                                 const CssParser* cssParser = nullptr, const std::function<bool()>& abortFn = nullptr)
 
       : filepath(filepath),
         renderer(renderer),
@@ -86,10 +97,22 @@ class ChapterHtmlSlimParser {
         hyphenationEnabled(hyphenationEnabled),
         completePageFn(completePageFn),
         popupFn(popupFn),
+        abortFn(abortFn),
         cssParser(cssParser),
         embeddedStyle(embeddedStyle) {}
 
-  ~ChapterHtmlSlimParser() = default;
+  ~ChapterHtmlSlimParser() { freeXmlParser(); }
+  // Parse the chapter from `filepath` on the SD card
   bool parseAndBuildPages();
+  // Parse the chapter straight from an open zip entry stream, without a temp file
+  bool parseAndBuildPages(ZipInflateStream& stream);
+
+  // Incremental parsing from an open zip entry stream: beginParse() once, then parseMore() until it no longer returns
+  // Paused. Between calls the expat parser, style stack and partial text block stay in memory, so the chapter picks
+  // up where it stopped. `stream` must outlive the parse.
+  enum class ParseStatus : uint8_t { Done, Paused, Failed };
+  bool beginParse(ZipInflateStream& stream);
+  // Parse until the chapter is done, or until `pauseFn` returns true (polled between 1KB chunks)
+  ParseStatus parseMore(const std::function<bool()>& pauseFn);
   void addLineToPage(std::shared_ptr<TextBlock> line);
 };
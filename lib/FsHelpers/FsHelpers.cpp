@@ -2,6 +2,12 @@
 
 #include <vector>
 
+namespace {
+// Folders/files to hide from the web interface file browser
+// Note: Items starting with "." are automatically hidden
+const char* HIDDEN_ITEMS[] = {"System Volume Information", "XTCache"};
+}  // namespace
+
 std::string FsHelpers::normalisePath(const std::string& path) {
   std::vector<std::string> components;
   std::string component;
@@ -13,7 +19,7 @@ std::string FsHelpers::normalisePath(const std::string& path) {
           if (!components.empty()) {
             components.pop_back();
           }
-        } else {
+        } else if (component != ".") {
           components.push_back(component);
         }
         component.clear();
@@ -23,7 +29,11 @@ std::string FsHelpers::normalisePath(const std::string& path) {
     }
   }
 
-  if (!component.empty()) {
+  if (component == "..") {
+    if (!components.empty()) {
+      components.pop_back();
+    }
+  } else if (!component.empty() && component != ".") {
     components.push_back(component);
   }
 
@@ -37,3 +47,19 @@ std::string FsHelpers::normalisePath(const std::string& path) {
 
   return result;
 }
+
+bool FsHelpers::isProtectedItemName(const std::string& name) {
+  if (!name.empty() && name[0] == '.') {
+    return true;
+  }
+  for (const char* item : HIDDEN_ITEMS) {
+    if (name == item) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool FsHelpers::isSkippedArchiveName(const std::string& name) {
+  return name == "__MACOSX" || isProtectedItemName(name);
+}
@@ -3,5 +3,11 @@
 
 class FsHelpers {
  public:
+  // Resolves "." and ".." components and drops empty ones. ".." never climbs above the start of the path, and the
+  // result has no leading or trailing slash.
   static std::string normalisePath(const std::string& path);
+  // Hidden (dot) files and system folders, which the web interface neither shows nor lets anyone create or change
+  static bool isProtectedItemName(const std::string& name);
+  // Path components an archive may not unpack into: protected names and macOS "__MACOSX" resource folders
+  static bool isSkippedArchiveName(const std::string& name);
 };
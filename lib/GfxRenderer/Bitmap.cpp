@@ -6,7 +6,7 @@
 // ============================================================================
 // IMAGE PROCESSING OPTIONS - Toggle these to test different configurations
 // ============================================================================
-// Note: For cover images, dithering is done in JpegToBmpConverter.cpp
+// Note: For cover images, dithering is done in BmpRowWriter.cpp
 // This file handles BMP reading - use simple quantization to avoid double-dithering
 constexpr bool USE_ATKINSON = true;  // Use Atkinson dithering instead of Floyd-Steinberg
 // ============================================================================
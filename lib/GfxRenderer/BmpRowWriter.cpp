@@ -0,0 +1,350 @@
+#include "BmpRowWriter.h"
+
+#include <HardwareSerial.h>
+#include <Print.h>
+
+#include <cstdlib>
+#include <cstring>
+
+#include "BitmapHelpers.h"
+
+// ============================================================================
+// IMAGE PROCESSING OPTIONS - Toggle these to test different configurations
+// ============================================================================
+constexpr bool USE_8BIT_OUTPUT = false;  // true: 8-bit grayscale (no quantization), false: 2-bit (4 levels)
+// Dithering method selection (only one should be true, or all false for simple quantization):
+constexpr bool USE_ATKINSON = true;          // Atkinson dithering (cleaner than F-S, less error diffusion)
+constexpr bool USE_FLOYD_STEINBERG = false;  // Floyd-Steinberg error diffusion (can cause "worm" artifacts)
+// ============================================================================
+
+static inline void write16(Print& out, const uint16_t value) {
+  out.write(value & 0xFF);
+  out.write((value >> 8) & 0xFF);
+}
+
+static inline void write32(Print& out, const uint32_t value) {
+  out.write(value & 0xFF);
+  out.write((value >> 8) & 0xFF);
+  out.write((value >> 16) & 0xFF);
+  out.write((value >> 24) & 0xFF);
+}
+
+static inline void write32Signed(Print& out, const int32_t value) {
+  out.write(value & 0xFF);
+  out.write((value >> 8) & 0xFF);
+  out.write((value >> 16) & 0xFF);
+  out.write((value >> 24) & 0xFF);
+}
+
+// Helper function: Write BMP header with 8-bit grayscale (256 levels)
+static void writeBmpHeader8bit(Print& bmpOut, const int width, const int height) {
+  // Calculate row padding (each row must be multiple of 4 bytes)
+  const int bytesPerRow = (width + 3) / 4 * 4;  // 8 bits per pixel, padded
+  const int imageSize = bytesPerRow * height;
+  const uint32_t paletteSize = 256 * 4;  // 256 colors * 4 bytes (BGRA)
+  const uint32_t fileSize = 14 + 40 + paletteSize + imageSize;
+
+  // BMP File Header (14 bytes)
+  bmpOut.write('B');
+  bmpOut.write('M');
+  write32(bmpOut, fileSize);
+  write32(bmpOut, 0);                      // Reserved
+  write32(bmpOut, 14 + 40 + paletteSize);  // Offset to pixel data
+
+  // DIB Header (BITMAPINFOHEADER - 40 bytes)
+  write32(bmpOut, 40);
+  write32Signed(bmpOut, width);
+  write32Signed(bmpOut, -height);  // Negative height = top-down bitmap
+  write16(bmpOut, 1);              // Color planes
+  write16(bmpOut, 8);              // Bits per pixel (8 bits)
+  write32(bmpOut, 0);              // BI_RGB (no compression)
+  write32(bmpOut, imageSize);
+  write32(bmpOut, 2835);  // xPixelsPerMeter (72 DPI)
+  write32(bmpOut, 2835);  // yPixelsPerMeter (72 DPI)
+  write32(bmpOut, 256);   // colorsUsed
+  write32(bmpOut, 256);   // colorsImportant
+
+  // Color Palette (256 grayscale entries x 4 bytes = 1024 bytes)
+  for (int i = 0; i < 256; i++) {
+    bmpOut.write(static_cast<uint8_t>(i));  // Blue
+    bmpOut.write(static_cast<uint8_t>(i));  // Green
+    bmpOut.write(static_cast<uint8_t>(i));  // Red
+    bmpOut.write(static_cast<uint8_t>(0));  // Reserved
+  }
+}
+
+// Helper function: Write BMP header with 1-bit color depth (black and white)
+static void writeBmpHeader1bit(Print& bmpOut, const int width, const int height) {
+  // Calculate row padding (each row must be multiple of 4 bytes)
+  const int bytesPerRow = (width + 31) / 32 * 4;  // 1 bit per pixel, round up to 4-byte boundary
+  const int imageSize = bytesPerRow * height;
+  const uint32_t fileSize = 62 + imageSize;  // 14 (file header) + 40 (DIB header) + 8 (palette) + image
+
+  // BMP File Header (14 bytes)
+  bmpOut.write('B');
+  bmpOut.write('M');
+  write32(bmpOut, fileSize);  // File size
+  write32(bmpOut, 0);         // Reserved
+  write32(bmpOut, 62);        // Offset to pixel data (14 + 40 + 8)
+
+  // DIB Header (BITMAPINFOHEADER - 40 bytes)
+  write32(bmpOut, 40);
+  write32Signed(bmpOut, width);
+  write32Signed(bmpOut, -height);  // Negative height = top-down bitmap
+  write16(bmpOut, 1);              // Color planes
+  write16(bmpOut, 1);              // Bits per pixel (1 bit)
+  write32(bmpOut, 0);              // BI_RGB (no compression)
+  write32(bmpOut, imageSize);
+  write32(bmpOut, 2835);  // xPixelsPerMeter (72 DPI)
+  write32(bmpOut, 2835);  // yPixelsPerMeter (72 DPI)
+  write32(bmpOut, 2);     // colorsUsed
+  write32(bmpOut, 2);     // colorsImportant
+
+  // Color Palette (2 colors x 4 bytes = 8 bytes)
+  // Format: Blue, Green, Red, Reserved (BGRA)
+  // Note: In 1-bit BMP, palette index 0 = black, 1 = white
+  uint8_t palette[8] = {
+      0x00, 0x00, 0x00, 0x00,  // Color 0: Black
+      0xFF, 0xFF, 0xFF, 0x00   // Color 1: White
+  };
+  for (const uint8_t i : palette) {
+    bmpOut.write(i);
+  }
+}
+
+// Helper function: Write BMP header with 2-bit color depth
+static void writeBmpHeader2bit(Print& bmpOut, const int width, const int height) {
+  // Calculate row padding (each row must be multiple of 4 bytes)
+  const int bytesPerRow = (width * 2 + 31) / 32 * 4;  // 2 bits per pixel, round up
+  const int imageSize = bytesPerRow * height;
+  const uint32_t fileSize = 70 + imageSize;  // 14 (file header) + 40 (DIB header) + 16 (palette) + image
+
+  // BMP File Header (14 bytes)
+  bmpOut.write('B');
+  bmpOut.write('M');
+  write32(bmpOut, fileSize);  // File size
+  write32(bmpOut, 0);         // Reserved
+  write32(bmpOut, 70);        // Offset to pixel data
+
+  // DIB Header (BITMAPINFOHEADER - 40 bytes)
+  write32(bmpOut, 40);
+  write32Signed(bmpOut, width);
+  write32Signed(bmpOut, -height);  // Negative height = top-down bitmap
+  write16(bmpOut, 1);              // Color planes
+  write16(bmpOut, 2);              // Bits per pixel (2 bits)
+  write32(bmpOut, 0);              // BI_RGB (no compression)
+  write32(bmpOut, imageSize);
+  write32(bmpOut, 2835);  // xPixelsPerMeter (72 DPI)
+  write32(bmpOut, 2835);  // yPixelsPerMeter (72 DPI)
+  write32(bmpOut, 4);     // colorsUsed
+  write32(bmpOut, 4);     // colorsImportant
+
+  // Color Palette (4 colors x 4 bytes = 16 bytes)
+  // Format: Blue, Green, Red, Reserved (BGRA)
+  uint8_t palette[16] = {
+      0x00, 0x00, 0x00, 0x00,  // Color 0: Black
+      0x55, 0x55, 0x55, 0x00,  // Color 1: Dark gray (85)
+      0xAA, 0xAA, 0xAA, 0x00,  // Color 2: Light gray (170)
+      0xFF, 0xFF, 0xFF, 0x00   // Color 3: White
+  };
+  for (const uint8_t i : palette) {
+    bmpOut.write(i);
+  }
+}
+
+BmpRowWriter::~BmpRowWriter() {
+  delete[] rowAccum;
+  delete[] rowCount;
+  delete atkinsonDitherer;
+  delete fsDitherer;
+  delete atkinson1BitDitherer;
+  free(rowBuffer);
+}
+
+void BmpRowWriter::fit(const BmpTarget& target, const int width, const int height) {
+  out = target.out;
+  oneBit = target.oneBit;
+  outWidth = width;
+  outHeight = height;
+  needsScaling = false;
+
+  if (target.maxWidth > 0 && target.maxHeight > 0 && (width > target.maxWidth || height > target.maxHeight)) {
+    // Calculate scale to fit within target dimensions while maintaining aspect ratio
+    const float scaleToFitWidth = static_cast<float>(target.maxWidth) / width;
+    const float scaleToFitHeight = static_cast<float>(target.maxHeight) / height;
+    // We scale to the smaller dimension, so we can potentially crop later.
+    float scale = 1.0;
+    if (target.crop) {  // if we will crop, scale to the smaller dimension
+      scale = (scaleToFitWidth > scaleToFitHeight) ? scaleToFitWidth : scaleToFitHeight;
+    } else {  // else, scale to the larger dimension to fit
+      scale = (scaleToFitWidth < scaleToFitHeight) ? scaleToFitWidth : scaleToFitHeight;
+    }
+
+    outWidth = static_cast<int>(width * scale);
+    outHeight = static_cast<int>(height * scale);
+
+    // Ensure at least 1 pixel
+    if (outWidth < 1) outWidth = 1;
+    if (outHeight < 1) outHeight = 1;
+    needsScaling = true;
+
+    Serial.printf("[%lu] [BMP] Pre-scaling %dx%d -> %dx%d (fit to %dx%d)\n", millis(), width, height, outWidth,
+                  outHeight, target.maxWidth, target.maxHeight);
+  }
+}
+
+bool BmpRowWriter::begin(const int srcWidth, const int srcHeight) {
+  this->srcWidth = srcWidth;
+  // Rows decoded at another size than the image (e.g. only half of an interlaced image's rows) always go through the
+  // scaler, even when the image itself fits the target
+  if (srcWidth != outWidth || srcHeight != outHeight) {
+    needsScaling = true;
+  }
+  // Use fixed-point scaling (16.16) for sub-pixel accuracy
+  // scaleX_fp = (srcWidth << 16) / outWidth
+  scaleX_fp = (static_cast<uint32_t>(srcWidth) << 16) / outWidth;
+  scaleY_fp = (static_cast<uint32_t>(srcHeight) << 16) / outHeight;
+
+  // Write BMP header with output dimensions
+  if (USE_8BIT_OUTPUT && !oneBit) {
+    writeBmpHeader8bit(*out, outWidth, outHeight);
+    bytesPerRow = (outWidth + 3) / 4 * 4;
+  } else if (oneBit) {
+    writeBmpHeader1bit(*out, outWidth, outHeight);
+    bytesPerRow = (outWidth + 31) / 32 * 4;  // 1 bit per pixel
+  } else {
+    writeBmpHeader2bit(*out, outWidth, outHeight);
+    bytesPerRow = (outWidth * 2 + 31) / 32 * 4;
+  }
+
+  rowBuffer = static_cast<uint8_t*>(malloc(bytesPerRow));
+  if (!rowBuffer) {
+    Serial.printf("[%lu] [BMP] Failed to allocate row buffer\n", millis());
+    return false;
+  }
+
+  // Create ditherer if enabled
+  // Use OUTPUT dimensions for dithering (after prescaling)
+  if (oneBit) {
+    // For 1-bit output, use Atkinson dithering for better quality
+    atkinson1BitDitherer = new Atkinson1BitDitherer(outWidth);
+  } else if (!USE_8BIT_OUTPUT) {
+    if (USE_ATKINSON) {
+      atkinsonDitherer = new AtkinsonDitherer(outWidth);
+    } else if (USE_FLOYD_STEINBERG) {
+      fsDitherer = new FloydSteinbergDitherer(outWidth);
+    }
+  }
+
+  // For scaling: accumulate source rows into scaled output rows
+  // We need to track which source Y maps to which output Y
+  // Using fixed-point: srcY_fp = outY * scaleY_fp (gives source Y in 16.16 format)
+  if (needsScaling) {
+    rowAccum = new uint32_t[outWidth]();
+    rowCount = new uint16_t[outWidth]();
+    nextOutY_srcStart = scaleY_fp;  // First boundary is at scaleY_fp (source Y for outY=1)
+  }
+  return true;
+}
+
+// Quantize output row `y` (gray values from `grayAt(x)`) and write it to the BMP
+template <typename GrayAt>
+void BmpRowWriter::writeRow(GrayAt grayAt, const int y) {
+  memset(rowBuffer, 0, bytesPerRow);
+
+  if (USE_8BIT_OUTPUT && !oneBit) {
+    for (int x = 0; x < outWidth; x++) {
+      rowBuffer[x] = adjustPixel(grayAt(x));
+    }
+  } else if (oneBit) {
+    // 1-bit output with Atkinson dithering for better quality
+    for (int x = 0; x < outWidth; x++) {
+      const uint8_t gray = grayAt(x);
+      const uint8_t bit =
+          atkinson1BitDitherer ? atkinson1BitDitherer->processPixel(gray, x) : quantize1bit(gray, x, y);
+      // Pack 1-bit value: MSB first, 8 pixels per byte
+      const int byteIndex = x / 8;
+      const int bitOffset = 7 - (x % 8);
+      rowBuffer[byteIndex] |= (bit << bitOffset);
+    }
+    if (atkinson1BitDitherer) atkinson1BitDitherer->nextRow();
+  } else {
+    // 2-bit output
+    for (int x = 0; x < outWidth; x++) {
+      const uint8_t gray = adjustPixel(grayAt(x));
+      uint8_t twoBit;
+      if (atkinsonDitherer) {
+        twoBit = atkinsonDitherer->processPixel(gray, x);
+      } else if (fsDitherer) {
+        twoBit = fsDitherer->processPixel(gray, x);
+      } else {
+        twoBit = quantize(gray, x, y);
+      }
+      const int byteIndex = (x * 2) / 8;
+      const int bitOffset = 6 - ((x * 2) % 8);
+      rowBuffer[byteIndex] |= (twoBit << bitOffset);
+    }
+    if (atkinsonDitherer)
+      atkinsonDitherer->nextRow();
+    else if (fsDitherer)
+      fsDitherer->nextRow();
+  }
+
+  out->write(rowBuffer, bytesPerRow);
+}
+
+void BmpRowWriter::addSourceRow(const uint8_t* srcRow, const int y) {
+  if (!needsScaling) {
+    // No scaling - direct output (1:1 mapping)
+    writeRow([srcRow](const int x) { return srcRow[x]; }, y);
+    return;
+  }
+
+  // Fixed-point area averaging for exact fit scaling
+  // For each output pixel X, accumulate source pixels that map to it
+  // srcX range for outX: [outX * scaleX_fp >> 16, (outX+1) * scaleX_fp >> 16)
+  for (int outX = 0; outX < outWidth; outX++) {
+    // Calculate source X range for this output pixel
+    const int srcXStart = (static_cast<uint32_t>(outX) * scaleX_fp) >> 16;
+    const int srcXEnd = (static_cast<uint32_t>(outX + 1) * scaleX_fp) >> 16;
+
+    // Accumulate all source pixels in this range
+    int sum = 0;
+    int count = 0;
+    for (int srcX = srcXStart; srcX < srcXEnd && srcX < srcWidth; srcX++) {
+      sum += srcRow[srcX];
+      count++;
+    }
+
+    // Handle edge case: if no pixels in range, use nearest
+    if (count == 0 && srcXStart < srcWidth) {
+      sum = srcRow[srcXStart];
+      count = 1;
+    }
+
+    rowAccum[outX] += sum;
+    rowCount[outX] += count;
+  }
+
+  // Check if we've crossed into the next output row
+  // Current source Y in fixed point: y << 16
+  const uint32_t srcY_fp = static_cast<uint32_t>(y + 1) << 16;
+
+  // Output row when source Y crosses the boundary. When there are fewer source rows than output rows, one source row
+  // can cross several boundaries and is repeated.
+  bool rowWritten = false;
+  while (srcY_fp >= nextOutY_srcStart && currentOutY < outHeight) {
+    writeRow([this](const int x) { return (rowCount[x] > 0) ? (rowAccum[x] / rowCount[x]) : 0; }, currentOutY);
+    currentOutY++;
+    rowWritten = true;
+
+    // Update boundary for next output row
+    nextOutY_srcStart = static_cast<uint32_t>(currentOutY + 1) * scaleY_fp;
+  }
+
+  if (rowWritten) {
+    // Reset accumulators for next output row
+    memset(rowAccum, 0, outWidth * sizeof(uint32_t));
+    memset(rowCount, 0, outWidth * sizeof(uint16_t));
+  }
+}
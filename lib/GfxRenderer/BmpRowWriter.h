@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+class Print;
+class AtkinsonDitherer;
+class FloydSteinbergDitherer;
+class Atkinson1BitDitherer;
+
+// Supplies up to `len` bytes of encoded image data; returns 0 at the end of the data
+using ImageReadFn = std::function<size_t(uint8_t* buf, size_t len)>;
+
+// One BMP to write while decoding an image
+struct BmpTarget {
+  // Cover images are scaled to the portrait display size
+  static constexpr int COVER_MAX_WIDTH = 480;
+  static constexpr int COVER_MAX_HEIGHT = 800;
+
+  Print* out;
+  int maxWidth;
+  int maxHeight;
+  bool oneBit;  // 1-bit instead of 2-bit output
+  bool crop;    // fill maxWidth x maxHeight, cropping later, instead of fitting inside it
+};
+
+/**
+ * Scales, dithers and packs decoded grayscale rows into one BMP.
+ *
+ * Image decoders call fit() with the image size, begin() with the size of the rows they will actually produce (which
+ * may be smaller, e.g. a JPEG decoded at 1/4 scale), then addSourceRow() for each row from top to bottom. Only one
+ * output row is buffered.
+ */
+class BmpRowWriter {
+ public:
+  BmpRowWriter() = default;
+  ~BmpRowWriter();
+  BmpRowWriter(const BmpRowWriter&) = delete;
+  BmpRowWriter& operator=(const BmpRowWriter&) = delete;
+
+  int outWidth = 0;
+  int outHeight = 0;
+  bool needsScaling = false;
+
+  // Calculate output dimensions (pre-scale to fit display exactly) for a `width` x `height` image
+  void fit(const BmpTarget& target, int width, int height);
+  // Write the BMP header and allocate buffers for decoded rows of `srcWidth` x `srcHeight`
+  bool begin(int srcWidth, int srcHeight);
+  // Feed source row `y` of the decoded image
+  void addSourceRow(const uint8_t* srcRow, int y);
+
+ private:
+  Print* out = nullptr;
+  bool oneBit = false;
+  int srcWidth = 0;
+  int bytesPerRow = 0;
+  uint8_t* rowBuffer = nullptr;
+  AtkinsonDitherer* atkinsonDitherer = nullptr;
+  FloydSteinbergDitherer* fsDitherer = nullptr;
+  Atkinson1BitDitherer* atkinson1BitDitherer = nullptr;
+  uint32_t scaleX_fp = 65536;      // 1.0 in 16.16 fixed point
+  uint32_t scaleY_fp = 65536;
+  uint32_t* rowAccum = nullptr;    // Accumulator for each output X (32-bit for larger sums)
+  uint16_t* rowCount = nullptr;    // Count of source pixels accumulated per output X
+  int currentOutY = 0;             // Current output row being accumulated
+  uint32_t nextOutY_srcStart = 0;  // Source Y where next output row starts (16.16 fixed point)
+
+  template <typename GrayAt>
+  void writeRow(GrayAt grayAt, int y);
+};
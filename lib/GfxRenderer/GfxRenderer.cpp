@@ -2,6 +2,14 @@
 
 #include <Utf8.h>
 
+#include "GlyphBlitter.h"
+
+static_assert(static_cast<int>(GlyphBlitter::Portrait) == GfxRenderer::Portrait &&
+                  static_cast<int>(GlyphBlitter::LandscapeClockwise) == GfxRenderer::LandscapeClockwise &&
+                  static_cast<int>(GlyphBlitter::PortraitInverted) == GfxRenderer::PortraitInverted &&
+                  static_cast<int>(GlyphBlitter::LandscapeCounterClockwise) == GfxRenderer::LandscapeCounterClockwise,
+              "GlyphBlitter rotations must match GfxRenderer orientations");
+
 void GfxRenderer::begin() {
   frameBuffer = display.getFrameBuffer();
   if (!frameBuffer) {
@@ -73,15 +81,15 @@ void GfxRenderer::drawPixel(const int x, const int y, const bool state) const {
   }
 }
 
+// Hot path of line breaking: one map lookup, and the font's cached glyph metrics instead of full text bounds
 int GfxRenderer::getTextWidth(const int fontId, const char* text, const EpdFontFamily::Style style) const {
-  if (fontMap.count(fontId) == 0) {
+  const auto font = fontMap.find(fontId);
+  if (font == fontMap.end()) {
     Serial.printf("[%lu] [GFX] Font %d not found\n", millis(), fontId);
     return 0;
   }
 
-  int w = 0, h = 0;
-  fontMap.at(fontId).getTextDimensions(text, &w, &h, style);
-  return w;
+  return font->second.getTextWidth(text, style);
 }
 
 void GfxRenderer::drawCenteredText(const int fontId, const int y, const char* text, const bool black,
@@ -122,14 +130,16 @@ void GfxRenderer::drawLine(int x1, int y1, int x2, int y2, const bool state) con
     if (y2 < y1) {
       std::swap(y1, y2);
     }
-    for (int y = y1; y <= y2; y++) {
-      drawPixel(x1, y, state);
+    for (int x = x1; x <= x1 + textStrikeOffset; x++) {
+      for (int y = y1; y <= y2; y++) {
+        drawPixel(x, y, state);
+      }
     }
   } else if (y1 == y2) {
     if (x2 < x1) {
       std::swap(x1, x2);
     }
-    for (int x = x1; x <= x2; x++) {
+    for (int x = x1; x <= x2 + textStrikeOffset; x++) {
       drawPixel(x, y1, state);
     }
   } else {
@@ -708,6 +718,16 @@ int GfxRenderer::getScreenHeight() const {
   return HalDisplay::DISPLAY_WIDTH;
 }
 
+const EpdFont* GfxRenderer::getFont(const int fontId, const EpdFontFamily::Style style) const {
+  const auto font = fontMap.find(fontId);
+  if (font == fontMap.end()) {
+    Serial.printf("[%lu] [GFX] Font %d not found\n", millis(), fontId);
+    return nullptr;
+  }
+
+  return font->second.getFont(style);
+}
+
 int GfxRenderer::getSpaceWidth(const int fontId) const {
   if (fontMap.count(fontId) == 0) {
     Serial.printf("[%lu] [GFX] Font %d not found\n", millis(), fontId);
@@ -717,23 +737,14 @@ int GfxRenderer::getSpaceWidth(const int fontId) const {
   return fontMap.at(fontId).getGlyph(' ', EpdFontFamily::REGULAR)->advanceX;
 }
 
-int GfxRenderer::getTextAdvanceX(const int fontId, const char* text) const {
-  if (fontMap.count(fontId) == 0) {
+int GfxRenderer::getTextAdvanceX(const int fontId, const char* text, const EpdFontFamily::Style style) const {
+  const auto font = fontMap.find(fontId);
+  if (font == fontMap.end()) {
     Serial.printf("[%lu] [GFX] Font %d not found\n", millis(), fontId);
     return 0;
   }
 
-  uint32_t cp;
-  int width = 0;
-  while ((cp = utf8NextCodepoint(reinterpret_cast<const uint8_t**>(&text)))) {
-    width += fontMap.at(fontId).getGlyph(cp, EpdFontFamily::REGULAR)->advanceX;
-
-    // CUSTOM TRACKING: Reduce spacing by 1px in forced bold mode
-    if (EpdFontFamily::globalForceBold && cp != ' ' && cp != 0x00A0) {
-      width -= 1;
-    }
-  }
-  return width;
+  return font->second.getTextAdvanceX(text, style);
 }
 
 int GfxRenderer::getFontAscenderSize(const int fontId) const {
@@ -872,10 +883,82 @@ void GfxRenderer::freeBwBufferChunks() {
   }
 }
 
+void GfxRenderer::freeGrayMsbChunks() {
+  for (auto& grayMsbChunk : grayMsbChunks) {
+    if (grayMsbChunk) {
+      free(grayMsbChunk);
+      grayMsbChunk = nullptr;
+    }
+  }
+}
+
+/**
+ * Allocates zeroed LSB (in the BW buffer chunks) and MSB planes and starts capturing text into them alongside the BW
+ * framebuffer. Each plane is a framebuffer-sized set of BW_BUFFER_CHUNK_SIZE chunks (48,000 bytes on this panel), so
+ * the capture needs 96,000 bytes on top of the framebuffer: 48,000 bytes more than `storeBwBuffer` alone. On failure
+ * nothing stays allocated and the caller should fall back to separate grayscale passes.
+ * A `displayGrayscaleCapture` and `restoreBwBuffer` call should always follow if this method returned true.
+ */
+bool GfxRenderer::beginGrayscaleCapture() {
+  freeBwBufferChunks();
+  freeGrayMsbChunks();
+
+  for (size_t i = 0; i < BW_BUFFER_NUM_CHUNKS; i++) {
+    bwBufferChunks[i] = static_cast<uint8_t*>(calloc(1, BW_BUFFER_CHUNK_SIZE));
+    grayMsbChunks[i] = static_cast<uint8_t*>(calloc(1, BW_BUFFER_CHUNK_SIZE));
+
+    if (!bwBufferChunks[i] || !grayMsbChunks[i]) {
+      Serial.printf("[%lu] [GFX] Not enough memory for grayscale capture, falling back to separate passes\n",
+                    millis());
+      freeBwBufferChunks();
+      freeGrayMsbChunks();
+      return false;
+    }
+  }
+
+  grayscaleCapture = true;
+  return true;
+}
+
+/**
+ * Pushes the captured planes to the display and runs the grayscale refresh. The framebuffer only has room for one
+ * plane at a time, so it is swapped with the LSB chunks: afterwards the chunks hold the BW image exactly as
+ * `storeBwBuffer` would have left them, and `restoreBwBuffer` must be called next.
+ */
+void GfxRenderer::displayGrayscaleCapture() {
+  grayscaleCapture = false;
+
+  for (size_t i = 0; i < BW_BUFFER_NUM_CHUNKS; i++) {
+    if (!bwBufferChunks[i] || !grayMsbChunks[i]) {
+      Serial.printf("[%lu] [GFX] !! Grayscale capture planes missing - this is likely a bug\n", millis());
+      freeGrayMsbChunks();
+      return;
+    }
+  }
+
+  // LSB plane <-> BW framebuffer
+  for (size_t i = 0; i < BW_BUFFER_NUM_CHUNKS; i++) {
+    uint32_t* bw = reinterpret_cast<uint32_t*>(frameBuffer + i * BW_BUFFER_CHUNK_SIZE);
+    uint32_t* lsb = reinterpret_cast<uint32_t*>(bwBufferChunks[i]);
+    for (size_t j = 0; j < BW_BUFFER_CHUNK_SIZE / sizeof(uint32_t); j++) {
+      std::swap(bw[j], lsb[j]);
+    }
+  }
+  copyGrayscaleLsbBuffers();
+
+  for (size_t i = 0; i < BW_BUFFER_NUM_CHUNKS; i++) {
+    memcpy(frameBuffer + i * BW_BUFFER_CHUNK_SIZE, grayMsbChunks[i], BW_BUFFER_CHUNK_SIZE);
+  }
+  freeGrayMsbChunks();
+  copyGrayscaleMsbBuffers();
+
+  displayGrayBuffer();
+}
+
 /**
  * This should be called before grayscale buffers are populated.
  * A `restoreBwBuffer` call should always follow the grayscale render if this method was called.
- * Uses chunked allocation to avoid needing 48KB of contiguous memory.
+ * Copies the framebuffer (48,000 bytes) into BW_BUFFER_CHUNK_SIZE chunks, so no contiguous block that size is needed.
  * Returns true if buffer was stored successfully, false if allocation failed.
  */
 bool GfxRenderer::storeBwBuffer() {
@@ -969,53 +1052,52 @@ void GfxRenderer::renderChar(const EpdFontFamily& fontFamily, const uint32_t cp,
     return;
   }
 
-  const int is2Bit = fontFamily.getData(style)->is2Bit;
-  const uint32_t offset = glyph->dataOffset;
-  const uint8_t width = glyph->width;
-  const uint8_t height = glyph->height;
-  const int left = glyph->left;
-
-  const uint8_t* bitmap = nullptr;
-  bitmap = &fontFamily.getData(style)->bitmap[offset];
-
-  if (bitmap != nullptr) {
-    for (int glyphY = 0; glyphY < height; glyphY++) {
-      const int screenY = *y - glyph->top + glyphY;
-      for (int glyphX = 0; glyphX < width; glyphX++) {
-        const int pixelPosition = glyphY * width + glyphX;
-        const int screenX = *x + left + glyphX;
-
-        if (is2Bit) {
-          const uint8_t byte = bitmap[pixelPosition / 4];
-          const uint8_t bit_index = (3 - pixelPosition % 4) * 2;
-          // the direct bit from the font is 0 -> white, 1 -> light gray, 2 -> dark gray, 3 -> black
-          // we swap this to better match the way images and screen think about colors:
-          // 0 -> black, 1 -> dark grey, 2 -> light grey, 3 -> white
-          const uint8_t bmpVal = 3 - (byte >> bit_index) & 0x3;
-
-          if (renderMode == BW && bmpVal < 3) {
-            // Black (also paints over the grays in BW mode)
-            drawPixel(screenX, screenY, pixelState);
-          } else if (renderMode == GRAYSCALE_MSB && (bmpVal == 1 || bmpVal == 2)) {
-            // Light gray (also mark the MSB if it's going to be a dark gray too)
-            // We have to flag pixels in reverse for the gray buffers, as 0 leave alone, 1 update
-            drawPixel(screenX, screenY, false);
-          } else if (renderMode == GRAYSCALE_LSB && bmpVal == 1) {
-            // Dark gray
-            drawPixel(screenX, screenY, false);
-          }
-        } else {
-          const uint8_t byte = bitmap[pixelPosition / 8];
-          const uint8_t bit_index = 7 - (pixelPosition % 8);
-
-          if ((byte >> bit_index) & 1) {
-            drawPixel(screenX, screenY, pixelState);
-          }
-        }
-      }
+  const EpdFontData* fontData = fontFamily.getData(style);
+  const bool is2Bit = fontData->is2Bit;
+
+  // the raw 2-bit value from the font is 0 -> white, 1 -> light gray, 2 -> dark gray, 3 -> black
+  uint8_t litMask = GlyphBlitter::LIT_1BIT;
+  bool state = pixelState;
+  if (is2Bit) {
+    if (renderMode == BW) {
+      // Black (also paints over the grays in BW mode)
+      litMask = GlyphBlitter::LIT_2BIT_ANY;
+    } else if (renderMode == GRAYSCALE_MSB) {
+      // Light gray (also mark the MSB if it's going to be a dark gray too)
+      // We have to flag pixels in reverse for the gray buffers, as 0 leave alone, 1 update
+      litMask = GlyphBlitter::LIT_2BIT_LIGHT_AND_DARK;
+      state = false;
+    } else {
+      // Dark gray
+      litMask = GlyphBlitter::LIT_2BIT_DARK;
+      state = false;
     }
   }
 
+  GlyphBlitter::Plane planes[GlyphBlitter::MAX_PLANES];
+  int planeCount = 0;
+  planes[planeCount++] = {{&frameBuffer, HalDisplay::DISPLAY_HEIGHT, HalDisplay::DISPLAY_WIDTH,
+                           HalDisplay::DISPLAY_HEIGHT, HalDisplay::DISPLAY_WIDTH_BYTES},
+                          litMask,
+                          state};
+
+  // Same lit rules as the separate GRAYSCALE_LSB / GRAYSCALE_MSB passes. 1-bit glyphs drawn black would only clear
+  // bits in the zeroed planes, so they are skipped.
+  if (grayscaleCapture && renderMode == BW && (is2Bit || !pixelState)) {
+    planes[planeCount++] = {{bwBufferChunks, BW_BUFFER_CHUNK_ROWS, HalDisplay::DISPLAY_WIDTH,
+                             HalDisplay::DISPLAY_HEIGHT, HalDisplay::DISPLAY_WIDTH_BYTES},
+                            is2Bit ? GlyphBlitter::LIT_2BIT_DARK : GlyphBlitter::LIT_1BIT,
+                            is2Bit ? false : pixelState};
+    planes[planeCount++] = {{grayMsbChunks, BW_BUFFER_CHUNK_ROWS, HalDisplay::DISPLAY_WIDTH,
+                             HalDisplay::DISPLAY_HEIGHT, HalDisplay::DISPLAY_WIDTH_BYTES},
+                            is2Bit ? GlyphBlitter::LIT_2BIT_LIGHT_AND_DARK : GlyphBlitter::LIT_1BIT,
+                            is2Bit ? false : pixelState};
+  }
+
+  GlyphBlitter::blit(planes, planeCount, static_cast<GlyphBlitter::Rotation>(orientation),
+                     &fontData->bitmap[glyph->dataOffset], glyph->width, glyph->height, is2Bit, *x + glyph->left,
+                     *y - glyph->top, textStrikeOffset);
+
   *x += glyph->advanceX;
 
   // CUSTOM TRACKING: Reduce spacing by 1px in forced bold mode
@@ -28,6 +28,9 @@ class GfxRenderer {
   static constexpr size_t BW_BUFFER_NUM_CHUNKS = HalDisplay::BUFFER_SIZE / BW_BUFFER_CHUNK_SIZE;
   static_assert(BW_BUFFER_CHUNK_SIZE * BW_BUFFER_NUM_CHUNKS == HalDisplay::BUFFER_SIZE,
                 "BW buffer chunking does not line up with display buffer size");
+  static constexpr int BW_BUFFER_CHUNK_ROWS = BW_BUFFER_CHUNK_SIZE / HalDisplay::DISPLAY_WIDTH_BYTES;
+  static_assert(BW_BUFFER_CHUNK_ROWS * HalDisplay::DISPLAY_WIDTH_BYTES == BW_BUFFER_CHUNK_SIZE,
+                "BW buffer chunks must hold whole panel rows");
 
   HalDisplay& display;
   RenderMode renderMode;
@@ -35,10 +38,15 @@ class GfxRenderer {
   bool fadingFix;
   uint8_t* frameBuffer = nullptr;
   uint8_t* bwBufferChunks[BW_BUFFER_NUM_CHUNKS] = {nullptr};
+  // MSB plane for single-pass grayscale capture; the LSB plane lives in bwBufferChunks
+  uint8_t* grayMsbChunks[BW_BUFFER_NUM_CHUNKS] = {nullptr};
+  bool grayscaleCapture = false;
+  int textStrikeOffset = 0;
   std::map<int, EpdFontFamily> fontMap;
   void renderChar(const EpdFontFamily& fontFamily, uint32_t cp, int* x, const int* y, bool pixelState,
                   EpdFontFamily::Style style) const;
   void freeBwBufferChunks();
+  void freeGrayMsbChunks();
   template <Color color>
   void drawPixelDither(int x, int y) const;
   template <Color color>
@@ -47,7 +55,10 @@ class GfxRenderer {
  public:
   explicit GfxRenderer(HalDisplay& halDisplay)
       : display(halDisplay), renderMode(BW), orientation(Portrait), fadingFix(false) {}
-  ~GfxRenderer() { freeBwBufferChunks(); }
+  ~GfxRenderer() {
+    freeBwBufferChunks();
+    freeGrayMsbChunks();
+  }
 
   static constexpr int VIEWABLE_MARGIN_TOP = 9;
   static constexpr int VIEWABLE_MARGIN_RIGHT = 3;
@@ -103,8 +114,10 @@ class GfxRenderer {
                         EpdFontFamily::Style style = EpdFontFamily::REGULAR) const;
   void drawText(int fontId, int x, int y, const char* text, bool black = true,
                 EpdFontFamily::Style style = EpdFontFamily::REGULAR) const;
+  // Font a fontId and style resolve to right now (forced bold included), nullptr for an unknown fontId
+  const EpdFont* getFont(int fontId, EpdFontFamily::Style style = EpdFontFamily::REGULAR) const;
   int getSpaceWidth(int fontId) const;
-  int getTextAdvanceX(int fontId, const char* text) const;
+  int getTextAdvanceX(int fontId, const char* text, EpdFontFamily::Style style = EpdFontFamily::REGULAR) const;
   int getFontAscenderSize(int fontId) const;
   int getLineHeight(int fontId) const;
   std::string truncatedText(int fontId, const char* text, int maxWidth,
@@ -124,6 +137,16 @@ class GfxRenderer {
   void restoreBwBuffer();  // Restore and free the stored buffer
   void cleanupGrayscaleWithFrameBuffer() const;
 
+  // Single-pass grayscale: while capturing, text drawn in BW mode also fills the LSB and MSB planes from the same
+  // glyph decode. Returns false (nothing allocated) if the heap cannot hold both planes.
+  bool beginGrayscaleCapture();
+  void endGrayscaleCapture() { grayscaleCapture = false; }
+  // Sends the captured planes and refreshes in grayscale. Leaves the BW framebuffer stored for `restoreBwBuffer`.
+  void displayGrayscaleCapture();
+
+  // Draw text (and lines) a second time this many px to the right, thickening it in a single pass
+  void setTextStrikeOffset(const int offset) { textStrikeOffset = offset; }
+
   // Low level functions
   uint8_t* getFrameBuffer() const;
   static size_t getBufferSize();
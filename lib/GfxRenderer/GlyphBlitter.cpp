@@ -0,0 +1,340 @@
+#include "GlyphBlitter.h"
+
+#include <algorithm>
+
+namespace {
+// Glyph dimensions are uint8_t, so a decoded glyph row (plus strike offset) never exceeds 33 bytes
+constexpr int MAX_ROW_BYTES = 33;
+
+using PlaneRows = uint8_t[GlyphBlitter::MAX_PLANES][MAX_ROW_BYTES];
+using PlaneBands = uint8_t[GlyphBlitter::MAX_PLANES][8][MAX_ROW_BYTES];
+
+inline void applyMask(uint8_t* dst, const uint8_t mask, const bool state) {
+  if (state) {
+    *dst &= ~mask;  // Clear bits
+  } else {
+    *dst |= mask;  // Set bits
+  }
+}
+
+// Apply 8 bits (MSB first) starting at panel x, which need not be byte aligned. Only bytes that actually receive a
+// lit pixel are touched, so zero padding bits hanging off either panel edge are harmless.
+inline void applyBits(uint8_t* row, const int x, const uint8_t bits, const bool state) {
+  if (!bits) {
+    return;
+  }
+  const int byteIndex = x >> 3;
+  const int shift = x & 7;
+  const uint8_t first = bits >> shift;
+  if (first) {
+    applyMask(row + byteIndex, first, state);
+  }
+  if (shift) {
+    const uint8_t second = bits << (8 - shift);
+    if (second) {
+      applyMask(row + byteIndex + 1, second, state);
+    }
+  }
+}
+
+inline uint8_t reverseBits(uint8_t b) {
+  b = (b & 0xF0) >> 4 | (b & 0x0F) << 4;
+  b = (b & 0xCC) >> 2 | (b & 0x33) << 2;
+  b = (b & 0xAA) >> 1 | (b & 0x55) << 1;
+  return b;
+}
+
+// 8 bits of a packed bit string starting at `bitPos`, which may run off either end (those bits read as 0)
+inline uint8_t bitsAt(const uint8_t* bytes, const int byteCount, const int bitPos) {
+  const int index = bitPos >> 3;
+  const int shift = bitPos & 7;
+  uint16_t window = 0;
+  if (index >= 0 && index < byteCount) {
+    window = bytes[index] << 8;
+  }
+  if (shift && index + 1 >= 0 && index + 1 < byteCount) {
+    window |= bytes[index + 1];
+  }
+  return window >> (8 - shift);
+}
+
+// 8x8 bit matrix transpose (Hacker's Delight, transpose8rS32): bit (7 - c) of in[r] becomes bit (7 - r) of out[c]
+inline void transpose8(const uint8_t in[8], uint8_t out[8]) {
+  uint32_t x = in[0] << 24 | in[1] << 16 | in[2] << 8 | in[3];
+  uint32_t y = in[4] << 24 | in[5] << 16 | in[6] << 8 | in[7];
+  uint32_t t;
+
+  t = (x ^ (x >> 7)) & 0x00AA00AA;
+  x = x ^ t ^ (t << 7);
+  t = (y ^ (y >> 7)) & 0x00AA00AA;
+  y = y ^ t ^ (t << 7);
+
+  t = (x ^ (x >> 14)) & 0x0000CCCC;
+  x = x ^ t ^ (t << 14);
+  t = (y ^ (y >> 14)) & 0x0000CCCC;
+  y = y ^ t ^ (t << 14);
+
+  t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+  y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+  x = t;
+
+  out[0] = x >> 24;
+  out[1] = x >> 16;
+  out[2] = x >> 8;
+  out[3] = x;
+  out[4] = y >> 24;
+  out[5] = y >> 16;
+  out[6] = y >> 8;
+  out[7] = y;
+}
+
+inline uint8_t litBits2Bit(const uint16_t hi, const uint16_t lo, const uint8_t litMask) {
+  uint16_t spread = 0;
+  if (litMask & 0b0001) spread |= ~hi & ~lo;
+  if (litMask & 0b0010) spread |= ~hi & lo;
+  if (litMask & 0b0100) spread |= hi & ~lo;
+  if (litMask & 0b1000) spread |= hi & lo;
+  spread &= 0x5555;
+
+  // Gather the even bits into one byte
+  spread = (spread | spread >> 1) & 0x3333;
+  spread = (spread | spread >> 2) & 0x0F0F;
+  spread = (spread | spread >> 4) & 0x00FF;
+  return static_cast<uint8_t>(spread);
+}
+
+inline uint8_t litBits1Bit(const uint8_t bits, const uint8_t litMask) {
+  uint8_t lit = 0;
+  if (litMask & 0b0001) lit |= ~bits;
+  if (litMask & 0b0010) lit |= bits;
+  return lit;
+}
+
+// Decode `count` consecutive glyph pixels starting at `pixel` into lit bits for every plane, MSB first, with the
+// unused bits of the last byte left zero. Plane p's bits go to out + p * planeStride. Never reads past the last
+// source byte the run covers.
+void decodeRun(const uint8_t* bitmap, const bool is2Bit, const int pixel, const int count,
+               const GlyphBlitter::Plane* planes, const int planeCount, uint8_t* out, const int planeStride) {
+  for (int done = 0, byte = 0; done < count; done += 8, byte++) {
+    const int take = std::min(8, count - done);
+    const uint8_t keep = 0xFF << (8 - take);
+    const int first = pixel + done;
+
+    if (is2Bit) {
+      // 8 pixels are 16 bits, which may straddle three source bytes
+      const int bitOffset = first * 2;
+      const int byteIndex = bitOffset >> 3;
+      const int lastByte = (bitOffset + take * 2 - 1) >> 3;
+      uint32_t window = bitmap[byteIndex] << 16;
+      if (lastByte > byteIndex) {
+        window |= bitmap[byteIndex + 1] << 8;
+      }
+      if (lastByte > byteIndex + 1) {
+        window |= bitmap[byteIndex + 2];
+      }
+      const uint16_t values = window >> (8 - (bitOffset & 7));
+
+      // One bit per pixel for each half of the 2-bit value, in the even bit positions
+      const uint16_t hi = (values >> 1) & 0x5555;
+      const uint16_t lo = values & 0x5555;
+      for (int p = 0; p < planeCount; p++) {
+        out[p * planeStride + byte] = litBits2Bit(hi, lo, planes[p].litMask) & keep;
+      }
+    } else {
+      const int byteIndex = first >> 3;
+      const int shift = first & 7;
+      uint16_t window = bitmap[byteIndex] << 8;
+      if (shift + take > 8) {
+        window |= bitmap[byteIndex + 1];
+      }
+      const uint8_t bits = window >> (8 - shift);
+      for (int p = 0; p < planeCount; p++) {
+        out[p * planeStride + byte] = litBits1Bit(bits, planes[p].litMask) & keep;
+      }
+    }
+  }
+}
+
+// Clipped glyph region, in glyph columns/rows of the (possibly strike-widened) glyph
+struct Clip {
+  int glyphWidth;
+  int gxStart;
+  int gxEnd;
+  int gyStart;
+  int gyEnd;
+  int strikeOffset;
+};
+
+// Lit bits of glyph row `gy` over columns [gxStart, gxEnd) for every plane. With a strike offset, column c is lit if
+// the glyph has a lit pixel at c or at c - strikeOffset.
+void decodeRow(const uint8_t* bitmap, const bool is2Bit, const Clip& clip, const int gy,
+               const GlyphBlitter::Plane* planes, const int planeCount, uint8_t* out, const int planeStride) {
+  if (clip.strikeOffset == 0) {
+    decodeRun(bitmap, is2Bit, gy * clip.glyphWidth + clip.gxStart, clip.gxEnd - clip.gxStart, planes, planeCount,
+              out, planeStride);
+    return;
+  }
+
+  // Decode the original pixels that can reach the clipped columns, then OR the row with a shifted copy of itself
+  const int sourceStart = std::max(0, clip.gxStart - clip.strikeOffset);
+  const int sourceEnd = std::min(clip.glyphWidth, clip.gxEnd);
+  const int count = clip.gxEnd - clip.gxStart;
+  if (sourceStart >= sourceEnd) {
+    for (int p = 0; p < planeCount; p++) {
+      std::fill(out + p * planeStride, out + p * planeStride + (count + 7) / 8, 0);
+    }
+    return;
+  }
+
+  PlaneRows source;
+  const int sourceBytes = (sourceEnd - sourceStart + 7) / 8;
+  decodeRun(bitmap, is2Bit, gy * clip.glyphWidth + sourceStart, sourceEnd - sourceStart, planes, planeCount,
+            &source[0][0], MAX_ROW_BYTES);
+
+  const int lead = clip.gxStart - sourceStart;
+  for (int p = 0; p < planeCount; p++) {
+    for (int done = 0, byte = 0; done < count; done += 8, byte++) {
+      const uint8_t keep = 0xFF << (8 - std::min(8, count - done));
+      const uint8_t lit = bitsAt(source[p], sourceBytes, done + lead) |
+                          bitsAt(source[p], sourceBytes, done + lead - clip.strikeOffset);
+      out[p * planeStride + byte] = lit & keep;
+    }
+  }
+}
+
+// Glyph rows land on panel rows (landscape orientations). `reversed` means glyph x runs right to left on the panel,
+// in which case `phyX` is the panel position of the first glyph pixel.
+void blitRows(const GlyphBlitter::Plane* planes, const int planeCount, const uint8_t* bitmap, const bool is2Bit,
+              const Clip& clip, const int firstRow, const int rowStep, const int phyX, const bool reversed) {
+  const int byteCount = (clip.gxEnd - clip.gxStart + 7) / 8;
+  PlaneRows lit;
+
+  for (int gy = clip.gyStart; gy < clip.gyEnd; gy++) {
+    decodeRow(bitmap, is2Bit, clip, gy, planes, planeCount, &lit[0][0], MAX_ROW_BYTES);
+    const int panelRow = firstRow + (gy - clip.gyStart) * rowStep;
+
+    for (int p = 0; p < planeCount; p++) {
+      uint8_t* row = planes[p].target.row(panelRow);
+      const bool state = planes[p].state;
+      if (!reversed) {
+        for (int i = 0; i < byteCount; i++) {
+          applyBits(row, phyX + i * 8, lit[p][i], state);
+        }
+      } else {
+        // Byte i holds glyph pixels 8i..8i+7, which cover panel x phyX-8i-7..phyX-8i once mirrored
+        for (int i = 0; i < byteCount; i++) {
+          applyBits(row, phyX - i * 8 - 7, reverseBits(lit[p][i]), state);
+        }
+      }
+    }
+  }
+}
+
+// Glyph columns land on panel rows (portrait orientations). Glyph rows are decoded in bands of up to 8 that cover one
+// panel byte column, then transposed 8x8 at a time into whole panel bytes.
+void blitColumns(const GlyphBlitter::Plane* planes, const int planeCount, const uint8_t* bitmap, const bool is2Bit,
+                 const Clip& clip, const int firstRow, const int rowStep, const int phyX, const int phyXStep) {
+  const int count = clip.gxEnd - clip.gxStart;
+  const int byteCount = (count + 7) / 8;
+  PlaneBands band;
+
+  int gy = clip.gyStart;
+  while (gy < clip.gyEnd) {
+    const int bandByte = (phyX + (gy - clip.gyStart) * phyXStep) >> 3;
+
+    // Decode every glyph row that falls into this panel byte column straight into its bit slot
+    uint8_t filledSlots = 0;
+    for (; gy < clip.gyEnd; gy++) {
+      const int x = phyX + (gy - clip.gyStart) * phyXStep;
+      if ((x >> 3) != bandByte) {
+        break;
+      }
+      decodeRow(bitmap, is2Bit, clip, gy, planes, planeCount, band[0][x & 7], sizeof(band[0]));
+      filledSlots |= 1 << (x & 7);
+    }
+
+    // Bands at the glyph's top and bottom edges only cover part of the panel byte
+    if (filledSlots != 0xFF) {
+      for (int slot = 0; slot < 8; slot++) {
+        if (!(filledSlots & (1 << slot))) {
+          for (int p = 0; p < planeCount; p++) {
+            std::fill(band[p][slot], band[p][slot] + byteCount, 0);
+          }
+        }
+      }
+    }
+
+    for (int p = 0; p < planeCount; p++) {
+      const auto& slots = band[p];
+      for (int i = 0; i < byteCount; i++) {
+        const uint8_t in[8] = {slots[0][i], slots[1][i], slots[2][i], slots[3][i],
+                               slots[4][i], slots[5][i], slots[6][i], slots[7][i]};
+        if ((in[0] | in[1] | in[2] | in[3] | in[4] | in[5] | in[6] | in[7]) == 0) {
+          continue;
+        }
+        uint8_t out[8];
+        transpose8(in, out);
+
+        // out[j] is the panel byte for glyph column gxStart + 8i + j
+        const int columns = std::min(8, count - i * 8);
+        for (int j = 0; j < columns; j++) {
+          if (out[j]) {
+            const int panelRow = firstRow + (i * 8 + j) * rowStep;
+            applyMask(planes[p].target.row(panelRow) + bandByte, out[j], planes[p].state);
+          }
+        }
+      }
+    }
+  }
+}
+}  // namespace
+
+void GlyphBlitter::blit(const Plane* planes, int planeCount, const Rotation rotation, const uint8_t* bitmap,
+                        const int glyphWidth, const int glyphHeight, const bool is2Bit, const int originX,
+                        const int originY, const int strikeOffset) {
+  planeCount = std::min(planeCount, MAX_PLANES);
+  if (planes == nullptr || planeCount <= 0 || bitmap == nullptr || glyphWidth <= 0 || glyphHeight <= 0 ||
+      strikeOffset < 0 || strikeOffset > 8) {
+    return;
+  }
+
+  // Clip in logical space once. Portrait orientations swap the panel axes.
+  const Target& target = planes[0].target;
+  const bool transposed = rotation == Portrait || rotation == PortraitInverted;
+  const int logicalWidth = transposed ? target.height : target.width;
+  const int logicalHeight = transposed ? target.width : target.height;
+
+  Clip clip;
+  clip.glyphWidth = glyphWidth;
+  clip.strikeOffset = strikeOffset;
+  clip.gxStart = std::max(0, -originX);
+  clip.gxEnd = std::min(glyphWidth + strikeOffset, logicalWidth - originX);
+  clip.gyStart = std::max(0, -originY);
+  clip.gyEnd = std::min(glyphHeight, logicalHeight - originY);
+  if (clip.gxStart >= clip.gxEnd || clip.gyStart >= clip.gyEnd) {
+    return;
+  }
+
+  // Physical position of the first clipped glyph pixel, matching rotateCoordinates in GfxRenderer
+  const int lx = originX + clip.gxStart;
+  const int ly = originY + clip.gyStart;
+
+  switch (rotation) {
+    case Portrait:
+      // phyX = y, phyY = height - 1 - x
+      blitColumns(planes, planeCount, bitmap, is2Bit, clip, target.height - 1 - lx, -1, ly, 1);
+      break;
+    case LandscapeClockwise:
+      // phyX = width - 1 - x, phyY = height - 1 - y
+      blitRows(planes, planeCount, bitmap, is2Bit, clip, target.height - 1 - ly, -1, target.width - 1 - lx, true);
+      break;
+    case PortraitInverted:
+      // phyX = width - 1 - y, phyY = x
+      blitColumns(planes, planeCount, bitmap, is2Bit, clip, lx, 1, target.width - 1 - ly, -1);
+      break;
+    case LandscapeCounterClockwise:
+      // phyX = x, phyY = y
+      blitRows(planes, planeCount, bitmap, is2Bit, clip, ly, 1, lx, false);
+      break;
+  }
+}
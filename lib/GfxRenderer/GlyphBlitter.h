@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * GlyphBlitter - Byte-wise glyph rendering into 1-bit, MSB-first panel framebuffers
+ *
+ * The glyph is clipped against the panel once, then every glyph row or column that lands on a panel row is packed
+ * into whole framebuffer bytes and applied with a single AND/OR per byte. This replaces one drawPixel call (rotation,
+ * bounds check and read-modify-write) per glyph pixel.
+ *
+ * One call can fill several planes (e.g. BW, grayscale LSB and MSB) from a single decode of the glyph bitmap.
+ */
+class GlyphBlitter {
+ public:
+  static constexpr int MAX_PLANES = 3;
+
+  // Logical to physical mapping, in the same order and with the same meaning as GfxRenderer::Orientation
+  enum Rotation : uint8_t { Portrait, LandscapeClockwise, PortraitInverted, LandscapeCounterClockwise };
+
+  // A physical panel sized buffer, either contiguous (one chunk holding every row) or split into equally sized
+  // chunks of whole rows
+  struct Target {
+    uint8_t* const* chunks;
+    int rowsPerChunk;
+    int width;       // physical panel width in pixels
+    int height;      // physical panel height in pixels
+    int widthBytes;  // bytes per physical panel row
+
+    uint8_t* row(const int y) const {
+      if (rowsPerChunk >= height) {
+        return chunks[0] + y * widthBytes;
+      }
+      return chunks[y / rowsPerChunk] + (y % rowsPerChunk) * widthBytes;
+    }
+  };
+
+  // Pixel values a glyph pixel may hold: 1-bit fonts use {0, 1}, 2-bit fonts the raw {0..3} coverage (0 = white).
+  // `litMask` has bit N set if value N should be drawn. Lit pixels are cleared (drawn black) when `state` is true
+  // and set otherwise, matching GfxRenderer::drawPixel.
+  static constexpr uint8_t LIT_1BIT = 0b0010;
+  static constexpr uint8_t LIT_2BIT_ANY = 0b1110;
+  static constexpr uint8_t LIT_2BIT_LIGHT_AND_DARK = 0b0110;
+  static constexpr uint8_t LIT_2BIT_DARK = 0b0100;
+
+  struct Plane {
+    Target target;
+    uint8_t litMask;
+    bool state;
+  };
+
+  // Draw a glyph bitmap whose top-left corner is at logical (originX, originY) into every plane. All planes must
+  // share the same panel geometry. A non-zero `strikeOffset` (0-8) also draws the glyph that many logical pixels to
+  // the right, as if it had been drawn twice.
+  static void blit(const Plane* planes, int planeCount, Rotation rotation, const uint8_t* bitmap, int glyphWidth,
+                   int glyphHeight, bool is2Bit, int originX, int originY, int strikeOffset = 0);
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstring>
+
+#include "BmpRowWriter.h"
+
+// Buffered reads from an ImageReadFn, for decoders that parse their format a few bytes at a time
+class ImageStreamReader {
+ public:
+  explicit ImageStreamReader(const ImageReadFn& read) : read(read) {}
+
+  // Read exactly `len` bytes; false if the data ends first
+  bool readBytes(uint8_t* dst, size_t len) {
+    while (len > 0) {
+      const size_t n = readSome(dst, len);
+      if (n == 0) {
+        return false;
+      }
+      dst += n;
+      len -= n;
+    }
+    return true;
+  }
+
+  bool readByte(uint8_t& value) { return readBytes(&value, 1); }
+
+  bool skip(size_t len) {
+    while (len > 0) {
+      if (!fill()) {
+        return false;
+      }
+      const size_t n = filled - pos < len ? filled - pos : len;
+      pos += n;
+      len -= n;
+    }
+    return true;
+  }
+
+  // Read up to `len` bytes, at most one buffer refill; 0 at the end of the data
+  size_t readSome(uint8_t* dst, const size_t len) {
+    if (!fill()) {
+      return 0;
+    }
+    const size_t n = filled - pos < len ? filled - pos : len;
+    memcpy(dst, buffer + pos, n);
+    pos += n;
+    return n;
+  }
+
+ private:
+  const ImageReadFn& read;
+  uint8_t buffer[512];
+  size_t pos = 0;
+  size_t filled = 0;
+
+  bool fill() {
+    if (pos < filled) {
+      return true;
+    }
+    filled = read(buffer, sizeof(buffer));
+    pos = 0;
+    return filled > 0;
+  }
+};
@@ -0,0 +1,352 @@
+#include "GifToBmpConverter.h"
+
+#include <HalStorage.h>
+#include <HardwareSerial.h>
+#include <ImageStreamReader.h>
+
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+// Only one row is held at full width, so these mostly bound decode time
+constexpr int MAX_IMAGE_WIDTH = 2048;
+constexpr int MAX_IMAGE_HEIGHT = 4096;
+constexpr int MAX_LZW_CODES = 4096;  // 12-bit codes
+
+uint8_t toGray(const int r, const int g, const int b) { return (r * 25 + g * 50 + b * 25) / 100; }
+
+class GifDecoder {
+ public:
+  explicit GifDecoder(const ImageReadFn& read) : in(read) {}
+  ~GifDecoder() {
+    free(prefix);
+    free(suffix);
+    free(stack);
+    free(row);
+  }
+  GifDecoder(const GifDecoder&) = delete;
+  GifDecoder& operator=(const GifDecoder&) = delete;
+
+  bool decode(const BmpTarget& target);
+
+ private:
+  ImageStreamReader in;
+  BmpRowWriter writer;
+
+  // First frame
+  int width = 0;
+  int height = 0;
+  bool interlaced = false;
+  uint8_t paletteGray[256];
+  int transparentIndex = -1;
+
+  // Image data sub-blocks and the LZW bit stream read from them
+  uint8_t blockLeft = 0;
+  bool blocksDone = false;
+  uint32_t bitBuffer = 0;
+  int bitCount = 0;
+
+  // LZW string table: each code is its prefix code plus one final byte
+  uint16_t* prefix = nullptr;
+  uint8_t* suffix = nullptr;
+  uint8_t* stack = nullptr;
+
+  // Row assembly. Rows arrive in interlace order; for interlaced images the ones before the last pass are skipped.
+  uint8_t* row = nullptr;
+  int rowFill = 0;
+  int rowIndex = 0;
+  int skipRows = 0;
+  int srcHeight = 0;
+  int outY = 0;
+
+  bool readHeader();
+  bool readPalette(int size);
+  bool skipSubBlocks();
+  int nextDataByte();
+  int readCode(int codeSize);
+  void emitPixel(uint8_t index);
+  bool decodeLzw(int minCodeSize);
+};
+
+bool GifDecoder::readPalette(const int size) {
+  for (int i = 0; i < size; i++) {
+    uint8_t rgb[3];
+    if (!in.readBytes(rgb, 3)) {
+      return false;
+    }
+    paletteGray[i] = toGray(rgb[0], rgb[1], rgb[2]);
+  }
+  // Indexes beyond the table are invalid; show them as white rather than reading garbage
+  for (int i = size; i < 256; i++) {
+    paletteGray[i] = 255;
+  }
+  return true;
+}
+
+bool GifDecoder::skipSubBlocks() {
+  uint8_t size;
+  do {
+    if (!in.readByte(size) || !in.skip(size)) {
+      return false;
+    }
+  } while (size > 0);
+  return true;
+}
+
+// Parse up to the first image descriptor, leaving the stream at the LZW data
+bool GifDecoder::readHeader() {
+  uint8_t header[13];
+  if (!in.readBytes(header, sizeof(header)) ||
+      (memcmp(header, "GIF87a", 6) != 0 && memcmp(header, "GIF89a", 6) != 0)) {
+    Serial.printf("[%lu] [GIF] Not a GIF file\n", millis());
+    return false;
+  }
+
+  // No color table at all is allowed; fall back to a gray ramp
+  for (int i = 0; i < 256; i++) {
+    paletteGray[i] = i;
+  }
+  const uint8_t screenFlags = header[10];
+  if ((screenFlags & 0x80) && !readPalette(2 << (screenFlags & 0x07))) {
+    return false;
+  }
+
+  while (true) {
+    uint8_t blockType;
+    if (!in.readByte(blockType)) {
+      Serial.printf("[%lu] [GIF] Unexpected end of data before image data\n", millis());
+      return false;
+    }
+
+    if (blockType == 0x2C) {  // Image descriptor
+      uint8_t descriptor[9];
+      if (!in.readBytes(descriptor, sizeof(descriptor))) {
+        return false;
+      }
+      // The frame's own size is used, not the logical screen's: a cover is a single full frame
+      width = descriptor[4] | (descriptor[5] << 8);
+      height = descriptor[6] | (descriptor[7] << 8);
+      const uint8_t imageFlags = descriptor[8];
+      interlaced = (imageFlags & 0x40) != 0;
+      return !(imageFlags & 0x80) || readPalette(2 << (imageFlags & 0x07));
+    }
+
+    if (blockType == 0x21) {  // Extension
+      uint8_t label;
+      if (!in.readByte(label)) {
+        return false;
+      }
+      if (label == 0xF9) {  // Graphic control: the transparent color of the next frame
+        uint8_t size;
+        uint8_t control[4];
+        if (!in.readByte(size) || size < 4 || !in.readBytes(control, 4) || !in.skip(size - 4)) {
+          return false;
+        }
+        transparentIndex = (control[0] & 0x01) ? control[3] : -1;
+      }
+      if (!skipSubBlocks()) {
+        return false;
+      }
+      continue;
+    }
+
+    if (blockType == 0x3B) {  // Trailer
+      Serial.printf("[%lu] [GIF] No image data\n", millis());
+    } else {
+      Serial.printf("[%lu] [GIF] Invalid block type 0x%02X\n", millis(), blockType);
+    }
+    return false;
+  }
+}
+
+// Next byte of the image data sub-blocks, -1 at the end
+int GifDecoder::nextDataByte() {
+  if (blockLeft == 0) {
+    if (blocksDone || !in.readByte(blockLeft) || blockLeft == 0) {
+      blocksDone = true;
+      return -1;
+    }
+  }
+  uint8_t value;
+  if (!in.readByte(value)) {
+    blocksDone = true;
+    return -1;
+  }
+  blockLeft--;
+  return value;
+}
+
+// Codes are packed least significant bit first
+int GifDecoder::readCode(const int codeSize) {
+  while (bitCount < codeSize) {
+    const int value = nextDataByte();
+    if (value < 0) {
+      return -1;
+    }
+    bitBuffer |= static_cast<uint32_t>(value) << bitCount;
+    bitCount += 8;
+  }
+  const int code = static_cast<int>(bitBuffer & ((1u << codeSize) - 1));
+  bitBuffer >>= codeSize;
+  bitCount -= codeSize;
+  return code;
+}
+
+void GifDecoder::emitPixel(const uint8_t index) {
+  if (rowIndex >= height) {
+    return;
+  }
+  row[rowFill++] = index == transparentIndex ? 255 : paletteGray[index];
+  if (rowFill < width) {
+    return;
+  }
+
+  rowFill = 0;
+  if (rowIndex >= skipRows) {
+    writer.addSourceRow(row, outY);
+    outY++;
+  }
+  rowIndex++;
+}
+
+bool GifDecoder::decodeLzw(const int minCodeSize) {
+  const int clearCode = 1 << minCodeSize;
+  const int endCode = clearCode + 1;
+  int codeSize = minCodeSize + 1;
+  int nextCode = endCode + 1;
+  int prevCode = -1;
+  uint8_t firstByte = 0;
+
+  for (int i = 0; i < clearCode; i++) {
+    prefix[i] = 0;
+    suffix[i] = i;
+  }
+
+  while (outY < srcHeight) {
+    const int code = readCode(codeSize);
+    if (code < 0 || code == endCode) {
+      break;
+    }
+    if (code == clearCode) {
+      codeSize = minCodeSize + 1;
+      nextCode = endCode + 1;
+      prevCode = -1;
+      continue;
+    }
+
+    if (prevCode < 0) {
+      // First code after a clear is always a single pixel
+      if (code >= clearCode) {
+        Serial.printf("[%lu] [GIF] Invalid first LZW code %d\n", millis(), code);
+        return false;
+      }
+      firstByte = code;
+      emitPixel(firstByte);
+      prevCode = code;
+      continue;
+    }
+
+    // Unwind the code's string onto the stack, last byte first
+    int sp = 0;
+    int current = code;
+    if (code >= nextCode) {
+      // Not in the table yet: the previous string plus its own first byte
+      if (code > nextCode) {
+        Serial.printf("[%lu] [GIF] Invalid LZW code %d\n", millis(), code);
+        return false;
+      }
+      stack[sp++] = firstByte;
+      current = prevCode;
+    }
+    while (current >= clearCode) {
+      stack[sp++] = suffix[current];
+      current = prefix[current];
+    }
+    firstByte = current;
+    stack[sp++] = firstByte;
+
+    if (nextCode < MAX_LZW_CODES) {
+      prefix[nextCode] = prevCode;
+      suffix[nextCode] = firstByte;
+      nextCode++;
+      if (nextCode == (1 << codeSize) && codeSize < 12) {
+        codeSize++;
+      }
+    }
+    prevCode = code;
+
+    while (sp > 0) {
+      emitPixel(stack[--sp]);
+    }
+  }
+
+  if (outY < srcHeight) {
+    Serial.printf("[%lu] [GIF] Image data ended at row %d of %d\n", millis(), outY, srcHeight);
+    return false;
+  }
+  return true;
+}
+
+bool GifDecoder::decode(const BmpTarget& target) {
+  if (!readHeader()) {
+    return false;
+  }
+
+  Serial.printf("[%lu] [GIF] GIF dimensions: %dx%d%s\n", millis(), width, height, interlaced ? ", interlaced" : "");
+
+  if (width <= 0 || height <= 0 || width > MAX_IMAGE_WIDTH || height > MAX_IMAGE_HEIGHT) {
+    Serial.printf("[%lu] [GIF] Image too large (%dx%d), max supported: %dx%d\n", millis(), width, height,
+                  MAX_IMAGE_WIDTH, MAX_IMAGE_HEIGHT);
+    return false;
+  }
+
+  // Interlaced rows come as every 8th, every 8th again, every 4th, then all the odd rows. Only the last pass is used.
+  skipRows = interlaced ? (height + 1) / 2 : 0;
+  srcHeight = interlaced ? height / 2 : height;
+  if (srcHeight == 0) {
+    Serial.printf("[%lu] [GIF] Interlaced image too small\n", millis());
+    return false;
+  }
+
+  uint8_t minCodeSize;
+  if (!in.readByte(minCodeSize) || minCodeSize == 0 || minCodeSize > 8) {
+    Serial.printf("[%lu] [GIF] Invalid LZW minimum code size\n", millis());
+    return false;
+  }
+
+  writer.fit(target, width, height);
+  if (!writer.begin(width, srcHeight)) {
+    return false;
+  }
+
+  prefix = static_cast<uint16_t*>(malloc(MAX_LZW_CODES * sizeof(uint16_t)));
+  suffix = static_cast<uint8_t*>(malloc(MAX_LZW_CODES));
+  stack = static_cast<uint8_t*>(malloc(MAX_LZW_CODES + 1));
+  row = static_cast<uint8_t*>(malloc(width));
+  if (!prefix || !suffix || !stack || !row) {
+    Serial.printf("[%lu] [GIF] Failed to allocate decode buffers\n", millis());
+    return false;
+  }
+
+  if (!decodeLzw(minCodeSize)) {
+    return false;
+  }
+
+  Serial.printf("[%lu] [GIF] Successfully converted GIF to BMP\n", millis());
+  return true;
+}
+}  // namespace
+
+bool GifToBmpConverter::gifToBmpStream(const ImageReadFn& read, const BmpTarget& target) {
+  GifDecoder decoder(read);
+  return decoder.decode(target);
+}
+
+bool GifToBmpConverter::gifFileToBmpStream(FsFile& gifFile, Print& bmpOut, const bool crop) {
+  return gifToBmpStream(
+      [&gifFile](uint8_t* buf, const size_t len) {
+        const int bytesRead = gifFile.read(buf, len);
+        return bytesRead > 0 ? static_cast<size_t>(bytesRead) : 0;
+      },
+      {&bmpOut, BmpTarget::COVER_MAX_WIDTH, BmpTarget::COVER_MAX_HEIGHT, false, crop});
+}
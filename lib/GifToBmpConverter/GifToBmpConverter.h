@@ -0,0 +1,16 @@
+#pragma once
+
+#include <BmpRowWriter.h>
+
+class FsFile;
+class Print;
+
+class GifToBmpConverter {
+ public:
+  // Convert GIF file to 2-bit BMP at cover size
+  static bool gifFileToBmpStream(FsFile& gifFile, Print& bmpOut, bool crop = true);
+  // Decode the first frame of the GIF from any reader into `target`. Only the LZW tables and a single row are held in
+  // memory. Interlaced images are decoded from their last pass (every odd row), which has the full width and half the
+  // height.
+  static bool gifToBmpStream(const ImageReadFn& read, const BmpTarget& target);
+};
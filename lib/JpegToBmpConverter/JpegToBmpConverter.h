@@ -1,10 +1,13 @@
 #pragma once
 
+#include <BmpRowWriter.h>
+
 class FsFile;
 class Print;
 class ZipFile;
 
 class JpegToBmpConverter {
+ private:
   static unsigned char jpegReadCallback(unsigned char* pBuf, unsigned char buf_size,
                                         unsigned char* pBytes_actually_read, void* pCallback_data);
   static bool jpegFileToBmpStreamInternal(class FsFile& jpegFile, Print& bmpOut, int targetWidth, int targetHeight,
@@ -16,4 +19,7 @@ class JpegToBmpConverter {
   static bool jpegFileToBmpStreamWithSize(FsFile& jpegFile, Print& bmpOut, int targetMaxWidth, int targetMaxHeight);
   // Convert to 1-bit BMP (black and white only, no grays) for fast home screen rendering
   static bool jpegFileTo1BitBmpStreamWithSize(FsFile& jpegFile, Print& bmpOut, int targetMaxWidth, int targetMaxHeight);
+  // Decode the JPEG from any reader, e.g. straight from a zip entry, into `target`. The decoder runs at the smallest
+  // scale that still covers the target.
+  static bool jpegToBmpStream(const ImageReadFn& read, const BmpTarget& target);
 };
@@ -52,12 +52,9 @@ CrossPointPosition ProgressMapper::toCrossPoint(const std::shared_ptr<Epub>& epu
     const size_t targetBytes = static_cast<size_t>(bookSize * koPos.percentage);
 
     // Find the spine item that contains this byte position
-    for (int i = 0; i < epub->getSpineItemsCount(); i++) {
-      const size_t cumulativeSize = epub->getCumulativeSpineItemSize(i);
-      if (cumulativeSize >= targetBytes) {
-        result.spineIndex = i;
-        break;
-      }
+    const int spineIndex = epub->getSpineIndexForBookOffset(targetBytes);
+    if (spineIndex < epub->getSpineItemsCount()) {
+      result.spineIndex = spineIndex;
     }
 
     // Estimate page number within the spine item using percentage (only when no XPath)
@@ -0,0 +1,456 @@
+#include "PngToBmpConverter.h"
+
+#include <HalStorage.h>
+#include <HardwareSerial.h>
+#include <ImageStreamReader.h>
+#include <miniz.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+namespace {
+// Rows are held at full width, so the width is what bounds memory; height only costs time
+constexpr int MAX_IMAGE_WIDTH = 2048;
+constexpr int MAX_IMAGE_HEIGHT = 4096;
+constexpr size_t INPUT_CHUNK_SIZE = 1024;
+
+constexpr uint8_t PNG_SIGNATURE[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+enum PngColorType : uint8_t { GRAY = 0, RGB = 2, PALETTE = 3, GRAY_ALPHA = 4, RGBA = 6 };
+
+// Adam7 passes: first column, first row, column step, row step
+struct Adam7Pass {
+  uint8_t x0, y0, dx, dy;
+};
+constexpr Adam7Pass ADAM7_PASSES[7] = {{0, 0, 8, 8}, {4, 0, 8, 8}, {0, 4, 4, 8}, {2, 0, 4, 4},
+                                       {0, 2, 2, 4}, {1, 0, 2, 2}, {0, 1, 1, 2}};
+constexpr int LAST_ADAM7_PASS = 6;
+
+uint32_t readBe32(const uint8_t* p) {
+  return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+         (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+uint8_t toGray(const int r, const int g, const int b) { return (r * 25 + g * 50 + b * 25) / 100; }
+
+// Transparent pixels are shown on white paper
+uint8_t onWhite(const int gray, const int alpha) { return (gray * alpha + 255 * (255 - alpha)) / 255; }
+
+uint8_t paethPredictor(const int a, const int b, const int c) {
+  const int p = a + b - c;
+  const int pa = abs(p - a);
+  const int pb = abs(p - b);
+  const int pc = abs(p - c);
+  if (pa <= pb && pa <= pc) return a;
+  if (pb <= pc) return b;
+  return c;
+}
+
+class PngDecoder {
+ public:
+  explicit PngDecoder(const ImageReadFn& read) : in(read) {}
+  ~PngDecoder() {
+    free(inflator);
+    free(dictionary);
+    free(inputBuffer);
+    free(curRow);
+    free(prevRow);
+    free(grayRow);
+  }
+  PngDecoder(const PngDecoder&) = delete;
+  PngDecoder& operator=(const PngDecoder&) = delete;
+
+  bool decode(const BmpTarget& target);
+
+ private:
+  ImageStreamReader in;
+  BmpRowWriter writer;
+
+  // Header
+  int width = 0;
+  int height = 0;
+  uint8_t bitDepth = 0;
+  uint8_t colorType = 0;
+  bool interlaced = false;
+  int channels = 0;
+  int filterBpp = 0;         // Bytes per complete pixel, at least 1, as used by the scanline filters
+  uint8_t paletteGray[256];  // Palette entries as gray, already blended with their tRNS alpha
+
+  // Compressed data left in the current IDAT chunk
+  uint32_t idatRemaining = 0;
+  bool idatDone = false;
+
+  // Scanline state
+  tinfl_decompressor* inflator = nullptr;
+  uint8_t* dictionary = nullptr;
+  uint8_t* inputBuffer = nullptr;
+  uint8_t* curRow = nullptr;   // Filter type byte followed by the scanline
+  uint8_t* prevRow = nullptr;  // Previous scanline of the same pass, unfiltered
+  uint8_t* grayRow = nullptr;
+  int pass = 0;
+  bool emitPass = false;  // Rows of this pass are decoded and written; the others are only consumed
+  size_t rowBytes = 0;
+  size_t rowFill = 0;
+  int passRowsLeft = 0;
+  int srcHeight = 0;
+  int outY = 0;
+  bool rowError = false;
+
+  bool readHeaderChunks();
+  size_t readIdat(uint8_t* buf, size_t len);
+  void startPass(int index);
+  void consume(const uint8_t* data, size_t len);
+  void finishRow();
+  bool unfilterRow();
+  void convertRow();
+};
+
+bool PngDecoder::readHeaderChunks() {
+  uint8_t signature[sizeof(PNG_SIGNATURE)];
+  if (!in.readBytes(signature, sizeof(signature)) || memcmp(signature, PNG_SIGNATURE, sizeof(signature)) != 0) {
+    Serial.printf("[%lu] [PNG] Not a PNG file\n", millis());
+    return false;
+  }
+
+  bool haveHeader = false;
+  int paletteSize = 0;
+  uint8_t alpha[256];
+  memset(alpha, 0xFF, sizeof(alpha));
+
+  while (true) {
+    uint8_t chunk[13];
+    if (!in.readBytes(chunk, 8)) {
+      Serial.printf("[%lu] [PNG] Unexpected end of data before image data\n", millis());
+      return false;
+    }
+    const uint32_t length = readBe32(chunk);
+    const char* type = reinterpret_cast<const char*>(chunk + 4);
+
+    if (memcmp(type, "IDAT", 4) == 0) {
+      idatRemaining = length;
+      break;
+    }
+
+    if (memcmp(type, "IEND", 4) == 0) {
+      Serial.printf("[%lu] [PNG] No image data\n", millis());
+      return false;
+    }
+
+    if (memcmp(type, "IHDR", 4) == 0 && length == 13) {
+      if (!in.readBytes(chunk, 13)) {
+        return false;
+      }
+      width = static_cast<int>(readBe32(chunk));
+      height = static_cast<int>(readBe32(chunk + 4));
+      bitDepth = chunk[8];
+      colorType = chunk[9];
+      // Compression and filter method must be 0, interlace 0 (none) or 1 (Adam7)
+      if (chunk[10] != 0 || chunk[11] != 0 || chunk[12] > 1) {
+        Serial.printf("[%lu] [PNG] Unsupported compression, filter or interlace method\n", millis());
+        return false;
+      }
+      interlaced = chunk[12] == 1;
+      haveHeader = true;
+      if (!in.skip(4)) {  // CRC
+        return false;
+      }
+    } else if (memcmp(type, "PLTE", 4) == 0 && length <= 256 * 3) {
+      paletteSize = static_cast<int>(length / 3);
+      for (int i = 0; i < paletteSize; i++) {
+        uint8_t rgb[3];
+        if (!in.readBytes(rgb, 3)) {
+          return false;
+        }
+        paletteGray[i] = toGray(rgb[0], rgb[1], rgb[2]);
+      }
+      if (!in.skip(length - paletteSize * 3 + 4)) {
+        return false;
+      }
+    } else if (memcmp(type, "tRNS", 4) == 0 && colorType == PALETTE && length <= 256) {
+      if (!in.readBytes(alpha, length) || !in.skip(4)) {
+        return false;
+      }
+    } else if (!in.skip(static_cast<size_t>(length) + 4)) {
+      // Ancillary chunks (and tRNS color keys for gray and RGB images) are not needed for a cover
+      return false;
+    }
+  }
+
+  if (!haveHeader) {
+    Serial.printf("[%lu] [PNG] Missing IHDR chunk\n", millis());
+    return false;
+  }
+
+  bool validDepth;
+  switch (colorType) {
+    case GRAY:
+      channels = 1;
+      validDepth = bitDepth == 1 || bitDepth == 2 || bitDepth == 4 || bitDepth == 8 || bitDepth == 16;
+      break;
+    case PALETTE:
+      channels = 1;
+      validDepth = (bitDepth == 1 || bitDepth == 2 || bitDepth == 4 || bitDepth == 8) && paletteSize > 0;
+      break;
+    case RGB:
+      channels = 3;
+      validDepth = bitDepth == 8 || bitDepth == 16;
+      break;
+    case GRAY_ALPHA:
+      channels = 2;
+      validDepth = bitDepth == 8 || bitDepth == 16;
+      break;
+    case RGBA:
+      channels = 4;
+      validDepth = bitDepth == 8 || bitDepth == 16;
+      break;
+    default:
+      validDepth = false;
+      break;
+  }
+  if (!validDepth) {
+    Serial.printf("[%lu] [PNG] Unsupported color type %d with bit depth %d\n", millis(), colorType, bitDepth);
+    return false;
+  }
+
+  // Indexes beyond the palette are invalid; show them as white rather than reading garbage
+  for (int i = 0; i < 256; i++) {
+    paletteGray[i] = i < paletteSize ? onWhite(paletteGray[i], alpha[i]) : 255;
+  }
+  filterBpp = channels * bitDepth / 8 > 0 ? channels * bitDepth / 8 : 1;
+  return true;
+}
+
+// Compressed bytes from the IDAT chunks, which may be split over any number of consecutive chunks
+size_t PngDecoder::readIdat(uint8_t* buf, const size_t len) {
+  while (idatRemaining == 0 && !idatDone) {
+    uint8_t chunk[8];
+    if (!in.skip(4) || !in.readBytes(chunk, 8) || memcmp(chunk + 4, "IDAT", 4) != 0) {
+      idatDone = true;
+      return 0;
+    }
+    idatRemaining = readBe32(chunk);
+  }
+  if (idatDone) {
+    return 0;
+  }
+
+  const size_t n = in.readSome(buf, idatRemaining < len ? idatRemaining : len);
+  if (n == 0) {
+    idatDone = true;
+  }
+  idatRemaining -= n;
+  return n;
+}
+
+void PngDecoder::startPass(int index) {
+  for (; index < 7; index++) {
+    const Adam7Pass& p = interlaced ? ADAM7_PASSES[index] : Adam7Pass{0, 0, 1, 1};
+    const int passWidth = (width - p.x0 + p.dx - 1) / p.dx;
+    const int passHeight = (height - p.y0 + p.dy - 1) / p.dy;
+    // Empty passes have no scanlines at all, not even filter bytes
+    if (passWidth > 0 && passHeight > 0) {
+      pass = index;
+      emitPass = !interlaced || index == LAST_ADAM7_PASS;
+      rowBytes = 1 + (static_cast<size_t>(passWidth) * channels * bitDepth + 7) / 8;
+      passRowsLeft = passHeight;
+      rowFill = 0;
+      memset(prevRow, 0, rowBytes);
+      return;
+    }
+  }
+  passRowsLeft = 0;
+}
+
+void PngDecoder::consume(const uint8_t* data, size_t len) {
+  while (len > 0 && passRowsLeft > 0 && !rowError) {
+    const size_t n = rowBytes - rowFill < len ? rowBytes - rowFill : len;
+    if (emitPass) {
+      memcpy(curRow + rowFill, data, n);
+    }
+    rowFill += n;
+    data += n;
+    len -= n;
+    if (rowFill == rowBytes) {
+      finishRow();
+    }
+  }
+}
+
+void PngDecoder::finishRow() {
+  rowFill = 0;
+  if (emitPass) {
+    if (!unfilterRow()) {
+      rowError = true;
+      return;
+    }
+    convertRow();
+    writer.addSourceRow(grayRow, outY);
+    outY++;
+    std::swap(curRow, prevRow);
+  }
+  if (--passRowsLeft == 0 && interlaced) {
+    startPass(pass + 1);
+  }
+}
+
+bool PngDecoder::unfilterRow() {
+  uint8_t* row = curRow + 1;
+  const uint8_t* prior = prevRow + 1;
+  const size_t n = rowBytes - 1;
+  const size_t bpp = filterBpp;
+
+  switch (curRow[0]) {
+    case 0:  // None
+      break;
+    case 1:  // Sub
+      for (size_t i = bpp; i < n; i++) row[i] += row[i - bpp];
+      break;
+    case 2:  // Up
+      for (size_t i = 0; i < n; i++) row[i] += prior[i];
+      break;
+    case 3:  // Average
+      for (size_t i = 0; i < bpp && i < n; i++) row[i] += prior[i] >> 1;
+      for (size_t i = bpp; i < n; i++) row[i] += (row[i - bpp] + prior[i]) >> 1;
+      break;
+    case 4:  // Paeth
+      for (size_t i = 0; i < bpp && i < n; i++) row[i] += prior[i];
+      for (size_t i = bpp; i < n; i++) row[i] += paethPredictor(row[i - bpp], prior[i], prior[i - bpp]);
+      break;
+    default:
+      Serial.printf("[%lu] [PNG] Invalid filter type %d\n", millis(), curRow[0]);
+      return false;
+  }
+  return true;
+}
+
+void PngDecoder::convertRow() {
+  const uint8_t* p = curRow + 1;
+
+  if (bitDepth < 8) {
+    // Gray or palette, several pixels per byte, leftmost in the high bits
+    const int mask = (1 << bitDepth) - 1;
+    for (int x = 0; x < width; x++) {
+      const int bit = x * bitDepth;
+      const int value = (p[bit >> 3] >> (8 - bitDepth - (bit & 7))) & mask;
+      grayRow[x] = colorType == PALETTE ? paletteGray[value] : value * 255 / mask;
+    }
+    return;
+  }
+
+  // 8 or 16 bits per sample; 16-bit samples are big endian, so their first byte is the one that matters
+  const int s = bitDepth / 8;
+  const int stride = channels * s;
+  for (int x = 0; x < width; x++) {
+    const uint8_t* px = p + x * stride;
+    switch (colorType) {
+      case GRAY:
+        grayRow[x] = px[0];
+        break;
+      case PALETTE:
+        grayRow[x] = paletteGray[px[0]];
+        break;
+      case RGB:
+        grayRow[x] = toGray(px[0], px[s], px[2 * s]);
+        break;
+      case GRAY_ALPHA:
+        grayRow[x] = onWhite(px[0], px[s]);
+        break;
+      default:  // RGBA
+        grayRow[x] = onWhite(toGray(px[0], px[s], px[2 * s]), px[3 * s]);
+        break;
+    }
+  }
+}
+
+bool PngDecoder::decode(const BmpTarget& target) {
+  if (!readHeaderChunks()) {
+    return false;
+  }
+
+  Serial.printf("[%lu] [PNG] PNG dimensions: %dx%d, color type: %d, bit depth: %d%s\n", millis(), width, height,
+                colorType, bitDepth, interlaced ? ", interlaced" : "");
+
+  if (width <= 0 || height <= 0 || width > MAX_IMAGE_WIDTH || height > MAX_IMAGE_HEIGHT) {
+    Serial.printf("[%lu] [PNG] Image too large (%dx%d), max supported: %dx%d\n", millis(), width, height,
+                  MAX_IMAGE_WIDTH, MAX_IMAGE_HEIGHT);
+    return false;
+  }
+
+  // An interlaced image only contributes its last pass: the odd rows
+  srcHeight = interlaced ? height / 2 : height;
+  if (srcHeight == 0) {
+    Serial.printf("[%lu] [PNG] Interlaced image too small\n", millis());
+    return false;
+  }
+
+  writer.fit(target, width, height);
+  if (!writer.begin(width, srcHeight)) {
+    return false;
+  }
+
+  const size_t maxRowBytes = 1 + (static_cast<size_t>(width) * channels * bitDepth + 7) / 8;
+  inflator = static_cast<tinfl_decompressor*>(malloc(sizeof(tinfl_decompressor)));
+  dictionary = static_cast<uint8_t*>(malloc(TINFL_LZ_DICT_SIZE));
+  inputBuffer = static_cast<uint8_t*>(malloc(INPUT_CHUNK_SIZE));
+  curRow = static_cast<uint8_t*>(malloc(maxRowBytes));
+  prevRow = static_cast<uint8_t*>(malloc(maxRowBytes));
+  grayRow = static_cast<uint8_t*>(malloc(width));
+  if (!inflator || !dictionary || !inputBuffer || !curRow || !prevRow || !grayRow) {
+    Serial.printf("[%lu] [PNG] Failed to allocate decode buffers\n", millis());
+    return false;
+  }
+  tinfl_init(inflator);
+  startPass(0);
+
+  // Inflate into the dictionary used as a ring buffer, handing each piece of output to the scanline assembler
+  size_t inputFilled = 0;
+  size_t inputCursor = 0;
+  size_t dictCursor = 0;
+  while (outY < srcHeight && !rowError) {
+    if (inputCursor >= inputFilled && !idatDone) {
+      inputFilled = readIdat(inputBuffer, INPUT_CHUNK_SIZE);
+      inputCursor = 0;
+    }
+
+    size_t inBytes = inputFilled - inputCursor;
+    size_t outBytes = TINFL_LZ_DICT_SIZE - dictCursor;
+    const tinfl_status status =
+        tinfl_decompress(inflator, inputBuffer + inputCursor, &inBytes, dictionary, dictionary + dictCursor, &outBytes,
+                         TINFL_FLAG_PARSE_ZLIB_HEADER | (idatDone ? 0 : TINFL_FLAG_HAS_MORE_INPUT));
+    inputCursor += inBytes;
+    consume(dictionary + dictCursor, outBytes);
+    dictCursor = (dictCursor + outBytes) & (TINFL_LZ_DICT_SIZE - 1);
+
+    if (status < 0) {
+      Serial.printf("[%lu] [PNG] tinfl_decompress() failed with status %d\n", millis(), status);
+      return false;
+    }
+    if (status == TINFL_STATUS_DONE) {
+      break;
+    }
+  }
+
+  if (outY < srcHeight) {
+    Serial.printf("[%lu] [PNG] Image data ended at row %d of %d\n", millis(), outY, srcHeight);
+    return false;
+  }
+
+  Serial.printf("[%lu] [PNG] Successfully converted PNG to BMP\n", millis());
+  return true;
+}
+}  // namespace
+
+bool PngToBmpConverter::pngToBmpStream(const ImageReadFn& read, const BmpTarget& target) {
+  PngDecoder decoder(read);
+  return decoder.decode(target);
+}
+
+bool PngToBmpConverter::pngFileToBmpStream(FsFile& pngFile, Print& bmpOut, const bool crop) {
+  return pngToBmpStream(
+      [&pngFile](uint8_t* buf, const size_t len) {
+        const int bytesRead = pngFile.read(buf, len);
+        return bytesRead > 0 ? static_cast<size_t>(bytesRead) : 0;
+      },
+      {&bmpOut, BmpTarget::COVER_MAX_WIDTH, BmpTarget::COVER_MAX_HEIGHT, false, crop});
+}
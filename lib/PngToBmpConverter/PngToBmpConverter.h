@@ -0,0 +1,16 @@
+#pragma once
+
+#include <BmpRowWriter.h>
+
+class FsFile;
+class Print;
+
+class PngToBmpConverter {
+ public:
+  // Convert PNG file to 2-bit BMP at cover size
+  static bool pngFileToBmpStream(FsFile& pngFile, Print& bmpOut, bool crop = true);
+  // Decode the PNG from any reader into `target`. Rows are unfiltered and converted one at a time, so apart from the
+  // inflate window only two scanlines are held in memory. Interlaced images are decoded from their last Adam7 pass
+  // (every odd row), which has the full width and half the height.
+  static bool pngToBmpStream(const ImageReadFn& read, const BmpTarget& target);
+};
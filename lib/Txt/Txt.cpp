@@ -1,7 +1,9 @@
 #include "Txt.h"
 
 #include <FsHelpers.h>
+#include <GifToBmpConverter.h>
 #include <JpegToBmpConverter.h>
+#include <PngToBmpConverter.h>
 
 Txt::Txt(std::string path, std::string cacheBasePath)
     : filepath(std::move(path)), cacheBasePath(std::move(cacheBasePath)) {
@@ -68,7 +70,7 @@ std::string Txt::findCoverImage() const {
   std::string baseName = getTitle();
 
   // Image extensions to try
-  const char* extensions[] = {".bmp", ".jpg", ".jpeg", ".png", ".BMP", ".JPG", ".JPEG", ".PNG"};
+  const char* extensions[] = {".bmp", ".jpg", ".jpeg", ".png", ".gif", ".BMP", ".JPG", ".JPEG", ".PNG", ".GIF"};
 
   // First priority: look for image with same name as txt file (e.g., mybook.jpg)
   for (const auto& ext : extensions) {
@@ -117,6 +119,8 @@ bool Txt::generateCoverBmp() const {
       (len >= 4 && (coverImagePath.substr(len - 4) == ".jpg" || coverImagePath.substr(len - 4) == ".JPG")) ||
       (len >= 5 && (coverImagePath.substr(len - 5) == ".jpeg" || coverImagePath.substr(len - 5) == ".JPEG"));
   const bool isBmp = len >= 4 && (coverImagePath.substr(len - 4) == ".bmp" || coverImagePath.substr(len - 4) == ".BMP");
+  const bool isPng = len >= 4 && (coverImagePath.substr(len - 4) == ".png" || coverImagePath.substr(len - 4) == ".PNG");
+  const bool isGif = len >= 4 && (coverImagePath.substr(len - 4) == ".gif" || coverImagePath.substr(len - 4) == ".GIF");
 
   if (isBmp) {
     // Copy BMP file to cache
@@ -140,32 +144,39 @@ bool Txt::generateCoverBmp() const {
     return true;
   }
 
-  if (isJpg) {
-    // Convert JPG/JPEG to BMP (same approach as Epub)
-    Serial.printf("[%lu] [TXT] Generating BMP from JPG cover image\n", millis());
-    FsFile coverJpg, coverBmp;
-    if (!Storage.openFileForRead("TXT", coverImagePath, coverJpg)) {
+  if (isJpg || isPng || isGif) {
+    // Convert JPG/JPEG, PNG or GIF to BMP (same approach as Epub)
+    const char* format = isJpg ? "JPG" : isPng ? "PNG" : "GIF";
+    Serial.printf("[%lu] [TXT] Generating BMP from %s cover image\n", millis(), format);
+    FsFile coverImage, coverBmp;
+    if (!Storage.openFileForRead("TXT", coverImagePath, coverImage)) {
       return false;
     }
     if (!Storage.openFileForWrite("TXT", getCoverBmpPath(), coverBmp)) {
-      coverJpg.close();
+      coverImage.close();
       return false;
     }
-    const bool success = JpegToBmpConverter::jpegFileToBmpStream(coverJpg, coverBmp);
-    coverJpg.close();
+    bool success;
+    if (isJpg) {
+      success = JpegToBmpConverter::jpegFileToBmpStream(coverImage, coverBmp);
+    } else if (isPng) {
+      success = PngToBmpConverter::pngFileToBmpStream(coverImage, coverBmp);
+    } else {
+      success = GifToBmpConverter::gifFileToBmpStream(coverImage, coverBmp);
+    }
+    coverImage.close();
     coverBmp.close();
 
     if (!success) {
-      Serial.printf("[%lu] [TXT] Failed to generate BMP from JPG cover image\n", millis());
+      Serial.printf("[%lu] [TXT] Failed to generate BMP from %s cover image\n", millis(), format);
       Storage.remove(getCoverBmpPath().c_str());
     } else {
-      Serial.printf("[%lu] [TXT] Generated BMP from JPG cover image\n", millis());
+      Serial.printf("[%lu] [TXT] Generated BMP from %s cover image\n", millis(), format);
     }
     return success;
   }
 
-  // PNG files are not supported (would need a PNG decoder)
-  Serial.printf("[%lu] [TXT] Cover image format not supported (only BMP/JPG/JPEG)\n", millis());
+  Serial.printf("[%lu] [TXT] Cover image format not supported (only BMP/JPG/JPEG/PNG/GIF)\n", millis());
   return false;
 }
 
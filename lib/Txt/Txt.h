@@ -23,7 +23,7 @@ class Txt {
 
   void setupCacheDir() const;
 
-  // Cover image support - looks for cover.bmp/jpg/jpeg/png in same folder as txt file
+  // Cover image support - looks for cover.bmp/jpg/jpeg/png/gif in same folder as txt file
   [[nodiscard]] std::string getCoverBmpPath() const;
   [[nodiscard]] bool generateCoverBmp() const;
   [[nodiscard]] std::string findCoverImage() const;
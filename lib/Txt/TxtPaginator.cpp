@@ -0,0 +1,142 @@
+#include "TxtPaginator.h"
+
+#include <Utf8.h>
+
+#include <cstdlib>
+#include <cstring>
+
+size_t TxtPaginator::findBreak(const uint8_t* text, const size_t length) const {
+  EpdFont::TextExtent extent;
+  size_t lastSpace = 0;
+  size_t lastBoundary = 0;
+  size_t pos = 0;
+
+  // Prefix widths only grow, so every boundary before the first overflowing character fits and nothing after it does
+  while (pos < length) {
+    if (pos > 0) {
+      lastBoundary = pos;
+      if (text[pos] == ' ') {
+        lastSpace = pos;
+      }
+    }
+
+    const uint8_t* next = text + pos;
+    const uint32_t cp = utf8NextCodepoint(&next);
+    pos = std::min(static_cast<size_t>(next - text), length);
+    font.extendText(extent, cp);
+
+    if (extent.width() > viewportWidth) {
+      if (lastSpace > 0) {
+        return lastSpace;
+      }
+      return lastBoundary > 0 ? lastBoundary : 1;
+    }
+  }
+  return length;
+}
+
+bool TxtPaginator::layoutPage(const uint8_t* window, const size_t size, const bool atEof, const LineFn& onLine,
+                              size_t& consumed) const {
+  int lineCount = 0;
+  size_t pos = 0;
+
+  while (pos < size && lineCount < linesPerPage) {
+    const auto* newline = static_cast<const uint8_t*>(memchr(window + pos, '\n', size - pos));
+    const size_t lineEnd = newline ? newline - window : size;
+
+    // A line running past the window starts the next page, unless it is the first one
+    if (!newline && !atEof && lineCount > 0) {
+      break;
+    }
+
+    size_t displayLen = lineEnd - pos;
+    if (displayLen > 0 && window[pos + displayLen - 1] == '\r') {
+      displayLen--;
+    }
+
+    const uint8_t* line = window + pos;
+    size_t lineBytePos = 0;
+    while (lineBytePos < displayLen && lineCount < linesPerPage) {
+      const size_t remaining = displayLen - lineBytePos;
+      const size_t breakPos = findBreak(line + lineBytePos, remaining);
+      if (onLine) {
+        onLine(reinterpret_cast<const char*>(line + lineBytePos), breakPos);
+      }
+      lineCount++;
+
+      // Skip the space the line was broken at
+      lineBytePos += breakPos;
+      if (breakPos < remaining && line[lineBytePos] == ' ') {
+        lineBytePos++;
+      }
+    }
+
+    if (lineBytePos < displayLen) {
+      // Page full in the middle of a source line
+      pos += lineBytePos;
+      break;
+    }
+    pos = lineEnd + 1;
+  }
+
+  consumed = std::min(pos, size);
+  return lineCount > 0;
+}
+
+TxtPaginator::IndexStatus TxtPaginator::buildIndex(const size_t fileSize, const ReadFn& read,
+                                                   std::vector<size_t>& pageOffsets,
+                                                   const std::function<bool(size_t offset)>& pauseFn) const {
+  if (pageOffsets.empty()) {
+    pageOffsets.push_back(0);
+  }
+
+  auto* window = static_cast<uint8_t*>(malloc(WINDOW_SIZE));
+  if (!window) {
+    return IndexStatus::Failed;
+  }
+
+  // The window slides forward with the page offset: what the previous page did not consume is moved to the front and
+  // only the new tail is read, so every byte of the file is read once
+  size_t offset = pageOffsets.back();
+  size_t windowStart = offset;
+  size_t windowSize = 0;
+  IndexStatus status = IndexStatus::Done;
+
+  while (offset < fileSize) {
+    const size_t shift = offset - windowStart;
+    memmove(window, window + shift, windowSize - shift);
+    windowSize -= shift;
+    windowStart = offset;
+
+    const size_t windowEnd = std::min(fileSize, windowStart + WINDOW_SIZE);
+    while (windowStart + windowSize < windowEnd) {
+      const size_t bytesRead = read(window + windowSize, windowEnd - windowStart - windowSize);
+      if (bytesRead == 0) {
+        status = IndexStatus::Failed;
+        break;
+      }
+      windowSize += bytesRead;
+    }
+    if (status == IndexStatus::Failed) {
+      break;
+    }
+
+    size_t consumed = 0;
+    if (!layoutPage(window, windowSize, windowEnd == fileSize, nullptr, consumed) || consumed == 0) {
+      break;
+    }
+
+    offset += consumed;
+    if (offset >= fileSize) {
+      break;
+    }
+    pageOffsets.push_back(offset);
+    if (pauseFn && pauseFn(offset)) {
+      status = IndexStatus::Paused;
+      break;
+    }
+  }
+
+  free(window);
+  return status;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <EpdFont.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Splits plain text into wrapped lines and pages.
+//
+// A page is laid out from a window of at most WINDOW_SIZE bytes starting at its offset: source lines are wrapped at
+// the last space that fits (or the last character, for words wider than the viewport), empty lines are dropped, and a
+// line that does not end inside the window starts the next page. Glyph extents are accumulated codepoint by codepoint
+// and the scan stops at the first character that overflows, so laying out a page is linear in the bytes it covers.
+class TxtPaginator {
+ public:
+  static constexpr size_t WINDOW_SIZE = 8 * 1024;
+
+  // Reads the next `len` bytes of the file into `buf`, returning the number of bytes read (0 on error)
+  using ReadFn = std::function<size_t(uint8_t* buf, size_t len)>;
+  using LineFn = std::function<void(const char* text, size_t length)>;
+
+  TxtPaginator(const EpdFont& font, int viewportWidth, int linesPerPage)
+      : font(font), viewportWidth(viewportWidth), linesPerPage(linesPerPage) {}
+
+  // Lay out the page at the start of `window` (`atEof` if the window reaches the end of the file), handing every line
+  // to `onLine` (may be null). Returns false if the window holds no text; `consumed` is where the next page starts.
+  bool layoutPage(const uint8_t* window, size_t size, bool atEof, const LineFn& onLine, size_t& consumed) const;
+
+  enum class IndexStatus : uint8_t { Done, Paused, Failed };
+
+  // Extend `pageOffsets` (page start offsets) in one sequential pass over the file, resuming at its last page, or at the
+  // start of the file if it is empty. `read` must continue from that page's offset. `pauseFn` (may be null) is asked
+  // after every page, with the offset reached so far, whether to stop for now.
+  IndexStatus buildIndex(size_t fileSize, const ReadFn& read, std::vector<size_t>& pageOffsets,
+                         const std::function<bool(size_t offset)>& pauseFn) const;
+
+ private:
+  const EpdFont& font;
+  const int viewportWidth;
+  const int linesPerPage;
+
+  // Bytes of `text` that go on one line
+  size_t findBreak(const uint8_t* text, size_t length) const;
+};
@@ -598,6 +598,38 @@ size_t Xtc::loadPage(uint32_t pageIndex, uint8_t* buffer, size_t bufferSize) con
   return const_cast<xtc::XtcParser*>(parser.get())->loadPage(pageIndex, buffer, bufferSize);
 }
 
+size_t Xtc::setupPageCache(const size_t maxPages, const size_t heapReserve) {
+  if (!loaded || !parser) {
+    return 0;
+  }
+
+  // XTG (1-bit): Row-major, ((width+7)/8) * height bytes
+  // XTH (2-bit): Two bit planes, column-major, ((width * height + 7) / 8) * 2 bytes
+  const uint16_t width = parser->getWidth();
+  const uint16_t height = parser->getHeight();
+  size_t pageSize;
+  if (parser->getBitDepth() == 2) {
+    pageSize = ((static_cast<size_t>(width) * height + 7) / 8) * 2;
+  } else {
+    pageSize = ((width + 7) / 8) * height;
+  }
+  return pageCache.allocate(pageSize, maxPages, heapReserve);
+}
+
+const uint8_t* Xtc::getCachedPage(const uint32_t pageIndex, size_t* size) {
+  if (!loaded || !parser) {
+    return nullptr;
+  }
+  return pageCache.get(*parser, pageIndex, size);
+}
+
+bool Xtc::prefetchPage(const uint32_t pageIndex) {
+  if (!loaded || !parser) {
+    return false;
+  }
+  return pageCache.prefetch(*parser, pageIndex);
+}
+
 xtc::XtcError Xtc::loadPageStreaming(uint32_t pageIndex,
                                      std::function<void(const uint8_t* data, size_t size, size_t offset)> callback,
                                      size_t chunkSize) const {
@@ -11,6 +11,7 @@
 #include <string>
 #include <vector>
 
+#include "Xtc/XtcPageCache.h"
 #include "Xtc/XtcParser.h"
 #include "Xtc/XtcTypes.h"
 
@@ -24,6 +25,7 @@ class Xtc {
   std::string filepath;
   std::string cachePath;
   std::unique_ptr<xtc::XtcParser> parser;
+  xtc::XtcPageCache pageCache;
   bool loaded;
 
  public:
@@ -94,6 +96,32 @@ class Xtc {
                                   std::function<void(const uint8_t* data, size_t size, size_t offset)> callback,
                                   size_t chunkSize = 1024) const;
 
+  /**
+   * Set up the read-ahead page cache
+   * @param maxPages Maximum number of page buffers (current, next and previous page)
+   * @param heapReserve Free heap to leave after allocating the buffers
+   * @return Number of page buffers allocated
+   */
+  size_t setupPageCache(size_t maxPages, size_t heapReserve);
+  void releasePageCache() { pageCache.release(); }
+  size_t getPageCacheSlots() const { return pageCache.getSlotCount(); }
+
+  /**
+   * Get a page bitmap through the page cache, reading it first if needed
+   * @param pageIndex Page index (0-based)
+   * @param size Set to the number of bitmap bytes
+   * @return Bitmap owned by the cache, valid until the next cache call, or nullptr on failure
+   */
+  const uint8_t* getCachedPage(uint32_t pageIndex, size_t* size);
+
+  /**
+   * Read a page into the cache ahead of time
+   * @param pageIndex Page index (0-based)
+   * @return true if the page was read, false if it was cached already or there is no slot to spare for it
+   */
+  bool prefetchPage(uint32_t pageIndex);
+  bool isPageCached(uint32_t pageIndex) const { return pageCache.contains(pageIndex); }
+
   // Progress calculation
   uint8_t calculateProgress(uint32_t currentPage) const;
 
@@ -0,0 +1,311 @@
+/**
+ * XtcPageBlitter.cpp
+ *
+ * Direct XTG/XTH page to framebuffer conversion
+ * XTC ebook support for CrossPoint Reader
+ */
+
+#include "XtcPageBlitter.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+namespace xtc {
+
+namespace {
+
+using Plane = XtcPageBlitter::Plane;
+
+// Bits of the pixels the plane draws, from the matching bytes or words of the two XTH bit planes
+template <Plane P, typename T>
+inline T litBits(const T bit1, const T bit2) {
+  if constexpr (P == Plane::Bw) {
+    return bit1 | bit2;
+  } else if constexpr (P == Plane::GrayLsb) {
+    return static_cast<T>(~bit1 & bit2);
+  } else {
+    return bit1 ^ bit2;
+  }
+}
+
+// Bw draws black (clears bits), the gray planes mark pixels by setting bits, as drawPixel(x, y, false) on a
+// clearScreen(0x00) buffer does
+template <Plane P, typename T>
+inline void applyLit(T& dst, const T lit) {
+  if constexpr (P == Plane::Bw) {
+    dst &= static_cast<T>(~lit);
+  } else {
+    dst |= lit;
+  }
+}
+
+template <Plane P>
+void blitXthRow(const uint8_t* bit1, const uint8_t* bit2, uint8_t* dst, const int fullBytes, const uint8_t tailMask) {
+  int i = 0;
+  const auto alignment = reinterpret_cast<uintptr_t>(bit1) | reinterpret_cast<uintptr_t>(bit2) |
+                         reinterpret_cast<uintptr_t>(dst);
+  if ((alignment & (sizeof(uint32_t) - 1)) == 0) {
+    const auto* words1 = reinterpret_cast<const uint32_t*>(bit1);
+    const auto* words2 = reinterpret_cast<const uint32_t*>(bit2);
+    auto* dstWords = reinterpret_cast<uint32_t*>(dst);
+    const int fullWords = fullBytes / static_cast<int>(sizeof(uint32_t));
+    for (int w = 0; w < fullWords; w++) {
+      applyLit<P>(dstWords[w], litBits<P>(words1[w], words2[w]));
+    }
+    i = fullWords * static_cast<int>(sizeof(uint32_t));
+  }
+  for (; i < fullBytes; i++) {
+    applyLit<P>(dst[i], litBits<P>(bit1[i], bit2[i]));
+  }
+  if (tailMask) {
+    applyLit<P>(dst[fullBytes], static_cast<uint8_t>(litBits<P>(bit1[fullBytes], bit2[fullBytes]) & tailMask));
+  }
+}
+
+template <Plane P>
+void blitXthPlane(const uint8_t* page, const uint16_t pageWidth, const uint16_t pageHeight,
+                  const XtcPageBlitter::Panel& panel) {
+  const size_t planeSize = (static_cast<size_t>(pageWidth) * pageHeight + 7) / 8;
+  const size_t colBytes = (pageHeight + 7) / 8;
+  const uint8_t* plane1 = page;
+  const uint8_t* plane2 = page + planeSize;
+
+  // Column c holds logical x = pageWidth - 1 - c, which lands on panel row height - 1 - x; its pixels run along the
+  // panel row
+  const int visiblePixels = std::min<int>(pageHeight, panel.width);
+  const int fullBytes = visiblePixels / 8;
+  const auto tailMask = static_cast<uint8_t>(0xFF00 >> (visiblePixels % 8));
+  const int rowOffset = panel.height - pageWidth;
+  const int firstColumn = std::max(0, -rowOffset);
+
+  for (int c = firstColumn; c < pageWidth; c++) {
+    const size_t offset = c * colBytes;
+    blitXthRow<P>(plane1 + offset, plane2 + offset, panel.frameBuffer + (c + rowOffset) * panel.widthBytes,
+                  fullBytes, tailMask);
+  }
+}
+
+// 8x8 bit matrix transpose (Hacker's Delight, transpose8rS32): bit (7 - c) of in[r] becomes bit (7 - r) of out[c]
+inline void transpose8(const uint8_t in[8], uint8_t out[8]) {
+  uint32_t x = in[0] << 24 | in[1] << 16 | in[2] << 8 | in[3];
+  uint32_t y = in[4] << 24 | in[5] << 16 | in[6] << 8 | in[7];
+  uint32_t t;
+
+  t = (x ^ (x >> 7)) & 0x00AA00AA;
+  x = x ^ t ^ (t << 7);
+  t = (y ^ (y >> 7)) & 0x00AA00AA;
+  y = y ^ t ^ (t << 7);
+
+  t = (x ^ (x >> 14)) & 0x0000CCCC;
+  x = x ^ t ^ (t << 14);
+  t = (y ^ (y >> 14)) & 0x0000CCCC;
+  y = y ^ t ^ (t << 14);
+
+  t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+  y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+  x = t;
+
+  out[0] = x >> 24;
+  out[1] = x >> 16;
+  out[2] = x >> 8;
+  out[3] = x;
+  out[4] = y >> 24;
+  out[5] = y >> 16;
+  out[6] = y >> 8;
+  out[7] = y;
+}
+
+// Draw up to 8 XTG rows starting at row y0 (a multiple of 8). Each 8x8 block of source pixels becomes 8 panel rows
+// of one byte each.
+void blitXtgBlock(const uint8_t* srcRows, const size_t srcRowBytes, const int rows, const int y0,
+                  const int visibleWidth, const XtcPageBlitter::Panel& panel) {
+  uint8_t* dstColumn = panel.frameBuffer + y0 / 8;
+
+  for (int x0 = 0; x0 < visibleWidth; x0 += 8) {
+    uint8_t in[8] = {};
+    uint8_t any = 0;
+    for (int r = 0; r < rows; r++) {
+      in[r] = static_cast<uint8_t>(~srcRows[r * srcRowBytes + x0 / 8]);  // XTG: 0 = black
+      any |= in[r];
+    }
+    if (!any) {
+      continue;
+    }
+
+    uint8_t out[8];
+    transpose8(in, out);
+    const int columns = std::min(8, visibleWidth - x0);
+    for (int c = 0; c < columns; c++) {
+      dstColumn[(panel.height - 1 - x0 - c) * panel.widthBytes] &= static_cast<uint8_t>(~out[c]);
+    }
+  }
+}
+
+}  // namespace
+
+void XtcPageBlitter::blitXtg(const uint8_t* page, const uint16_t pageWidth, const uint16_t pageHeight,
+                             const Panel& panel) {
+  const size_t srcRowBytes = (pageWidth + 7) / 8;
+  // Logical (x, y) lands on panel (y, height - 1 - x)
+  const int visibleWidth = std::min<int>(pageWidth, panel.height);
+  const int visibleHeight = std::min<int>(pageHeight, panel.width);
+
+  for (int y0 = 0; y0 < visibleHeight; y0 += 8) {
+    blitXtgBlock(page + y0 * srcRowBytes, srcRowBytes, std::min(8, visibleHeight - y0), y0, visibleWidth, panel);
+  }
+}
+
+void XtcPageBlitter::blitXth(const uint8_t* page, const uint16_t pageWidth, const uint16_t pageHeight,
+                             const Plane plane, const Panel& panel) {
+  switch (plane) {
+    case Plane::Bw:
+      blitXthPlane<Plane::Bw>(page, pageWidth, pageHeight, panel);
+      break;
+    case Plane::GrayLsb:
+      blitXthPlane<Plane::GrayLsb>(page, pageWidth, pageHeight, panel);
+      break;
+    case Plane::GrayMsb:
+      blitXthPlane<Plane::GrayMsb>(page, pageWidth, pageHeight, panel);
+      break;
+  }
+}
+
+void XtcPageBlitter::countXthPixels(const uint8_t* page, const uint16_t pageWidth, const uint16_t pageHeight,
+                                    uint32_t counts[4]) {
+  const size_t planeSize = (static_cast<size_t>(pageWidth) * pageHeight + 7) / 8;
+  const size_t colBytes = (pageHeight + 7) / 8;
+  const size_t fullBytes = pageHeight / 8;
+  const auto tailMask = static_cast<uint8_t>(0xFF00 >> (pageHeight % 8));
+  const uint8_t* plane1 = page;
+  const uint8_t* plane2 = page + planeSize;
+
+  uint32_t dark = 0, light = 0, black = 0;
+  for (size_t c = 0; c < pageWidth; c++) {
+    const uint8_t* bit1 = plane1 + c * colBytes;
+    const uint8_t* bit2 = plane2 + c * colBytes;
+    size_t i = 0;
+    for (; i + sizeof(uint32_t) <= fullBytes; i += sizeof(uint32_t)) {
+      uint32_t word1, word2;
+      memcpy(&word1, bit1 + i, sizeof(word1));
+      memcpy(&word2, bit2 + i, sizeof(word2));
+      dark += __builtin_popcount(~word1 & word2);
+      light += __builtin_popcount(word1 & ~word2);
+      black += __builtin_popcount(word1 & word2);
+    }
+    for (; i < fullBytes; i++) {
+      dark += __builtin_popcount(static_cast<uint8_t>(~bit1[i] & bit2[i]));
+      light += __builtin_popcount(static_cast<uint8_t>(bit1[i] & ~bit2[i]));
+      black += __builtin_popcount(bit1[i] & bit2[i]);
+    }
+    if (tailMask) {
+      dark += __builtin_popcount(static_cast<uint8_t>(~bit1[fullBytes] & bit2[fullBytes] & tailMask));
+      light += __builtin_popcount(static_cast<uint8_t>(bit1[fullBytes] & ~bit2[fullBytes] & tailMask));
+      black += __builtin_popcount(bit1[fullBytes] & bit2[fullBytes] & tailMask);
+    }
+  }
+
+  counts[0] = static_cast<uint32_t>(pageWidth) * pageHeight - dark - light - black;
+  counts[1] = dark;
+  counts[2] = light;
+  counts[3] = black;
+}
+
+XtcPageBlitter::XtgStream::XtgStream(const uint16_t pageWidth, const uint16_t pageHeight, const Panel& panel)
+    : panel(panel),
+      srcRowBytes((pageWidth + 7) / 8),
+      visibleWidth(std::min<int>(pageWidth, panel.height)),
+      visibleHeight(std::min<int>(pageHeight, panel.width)),
+      keptRowBytes((visibleWidth + 7) / 8),
+      rows(static_cast<size_t>(keptRowBytes) * 8) {}
+
+void XtcPageBlitter::XtgStream::write(const uint8_t* data, size_t size, size_t offset) {
+  while (size > 0) {
+    const int row = static_cast<int>(offset / srcRowBytes);
+    const size_t column = offset % srcRowBytes;
+    const size_t count = std::min(size, srcRowBytes - column);
+
+    if (row < visibleHeight && column < static_cast<size_t>(keptRowBytes)) {
+      memcpy(rows.data() + (row % 8) * keptRowBytes + column, data,
+             std::min(count, static_cast<size_t>(keptRowBytes) - column));
+    }
+    data += count;
+    size -= count;
+    offset += count;
+
+    // Draw the block once its last row (or the last visible row) is complete
+    if (offset % srcRowBytes == 0 && row < visibleHeight && (row % 8 == 7 || row == visibleHeight - 1)) {
+      blitXtgBlock(rows.data(), keptRowBytes, row % 8 + 1, row - row % 8, visibleWidth, panel);
+    }
+  }
+}
+
+XtcPageBlitter::XthStream::XthStream(const uint16_t pageWidth, const uint16_t pageHeight, const Plane plane,
+                                     const Panel& panel)
+    : panel(panel),
+      plane(plane),
+      planeSize((static_cast<size_t>(pageWidth) * pageHeight + 7) / 8),
+      colBytes((pageHeight + 7) / 8),
+      pageWidth(pageWidth) {
+  const int visiblePixels = std::min<int>(pageHeight, panel.width);
+  fullBytes = visiblePixels / 8;
+  tailMask = static_cast<uint8_t>(0xFF00 >> (visiblePixels % 8));
+  rowOffset = panel.height - pageWidth;
+}
+
+void XtcPageBlitter::XthStream::write(const uint8_t* data, const size_t size, const size_t offset) {
+  // The planes are colBytes * pageWidth bytes each, the second starting at planeSize. Both spans can overlap by a
+  // few bytes when the page height is not a multiple of 8, so a byte may belong to both.
+  const size_t planeBytes = colBytes * pageWidth;
+  const size_t end = offset + size;
+
+  if (offset < planeBytes) {
+    apply(false, data, std::min(end, planeBytes) - offset, offset);
+  }
+  if (end > planeSize) {
+    const size_t start = std::max(offset, planeSize);
+    const size_t stop = std::min(end, planeSize + planeBytes);
+    if (stop > start) {
+      apply(true, data + (start - offset), stop - start, start - planeSize);
+    }
+  }
+}
+
+void XtcPageBlitter::XthStream::apply(const bool secondPlane, const uint8_t* data, size_t size,
+                                      size_t planeOffset) const {
+  const size_t visibleBytes = fullBytes + (tailMask ? 1 : 0);
+
+  while (size > 0) {
+    const size_t column = planeOffset / colBytes;
+    const size_t first = planeOffset % colBytes;
+    const size_t count = std::min(size, colBytes - first);
+    const int panelRow = static_cast<int>(column) + rowOffset;
+
+    if (panelRow >= 0 && first < visibleBytes) {
+      uint8_t* dst = panel.frameBuffer + panelRow * panel.widthBytes;
+      const size_t last = std::min(first + count, visibleBytes);
+      for (size_t i = first; i < last; i++) {
+        const uint8_t mask = static_cast<int>(i) < fullBytes ? 0xFF : tailMask;
+        const uint8_t bits = data[i - first];
+        // First plane: stage f(bit1) in the covered bits. Second plane: combine it with bit2.
+        //   Bw: ~bit1 & ~bit2, GrayLsb: ~bit1 & bit2, GrayMsb: bit1 ^ bit2
+        if (!secondPlane) {
+          const uint8_t staged = plane == Plane::GrayMsb ? bits : static_cast<uint8_t>(~bits);
+          dst[i] = static_cast<uint8_t>((dst[i] & ~mask) | (staged & mask));
+        } else if (plane == Plane::Bw) {
+          dst[i] &= static_cast<uint8_t>(~(bits & mask));
+        } else if (plane == Plane::GrayLsb) {
+          dst[i] &= static_cast<uint8_t>(bits | ~mask);
+        } else {
+          dst[i] ^= static_cast<uint8_t>(bits & mask);
+        }
+      }
+    }
+
+    data += count;
+    size -= count;
+    planeOffset += count;
+  }
+}
+
+}  // namespace xtc
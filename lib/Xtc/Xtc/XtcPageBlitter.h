@@ -0,0 +1,83 @@
+/**
+ * XtcPageBlitter.h
+ *
+ * Direct XTG/XTH page to framebuffer conversion
+ * XTC ebook support for CrossPoint Reader
+ *
+ * Pages are written the way GfxRenderer draws them in portrait orientation (logical (x, y) lands on physical
+ * (y, height - 1 - x)), but whole bytes at a time instead of one drawPixel call per pixel. XTH column-major planes
+ * already match the panel row layout and are combined word by word; XTG rows are transposed in 8x8 blocks.
+ * The stream variants do the same for pages that are decoded chunk by chunk without a page buffer.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace xtc {
+
+class XtcPageBlitter {
+ public:
+  // 1-bit, MSB-first physical panel framebuffer (0 = black)
+  struct Panel {
+    uint8_t* frameBuffer;
+    int width;       // physical panel width in pixels
+    int height;      // physical panel height in pixels
+    int widthBytes;  // bytes per physical panel row
+  };
+
+  // Framebuffer planes an XTH page is split into:
+  // Bw clears every non-white pixel, GrayLsb sets dark grey pixels (value 1), GrayMsb sets dark and light grey pixels
+  // (value 1 or 2). Pixels that are not drawn are left untouched, exactly as with drawPixel.
+  enum class Plane : uint8_t { Bw, GrayLsb, GrayMsb };
+
+  // Draw the black pixels of an XTG page (row-major, MSB first, 0 = black)
+  static void blitXtg(const uint8_t* page, uint16_t pageWidth, uint16_t pageHeight, const Panel& panel);
+
+  // Draw one plane of an XTH page (two column-major bit planes, columns right to left, MSB = topmost pixel)
+  static void blitXth(const uint8_t* page, uint16_t pageWidth, uint16_t pageHeight, Plane plane, const Panel& panel);
+
+  // Count XTH pixel values (0 = white, 1 = dark grey, 2 = light grey, 3 = black) into `counts`
+  static void countXthPixels(const uint8_t* page, uint16_t pageWidth, uint16_t pageHeight, uint32_t counts[4]);
+
+  // Incremental blitXtg for pages decoded chunk by chunk (XtcParser::loadPageStreaming). Feed the bitmap bytes in
+  // order; every 8 rows are drawn as soon as they are complete, so only 8 rows are buffered.
+  class XtgStream {
+   public:
+    XtgStream(uint16_t pageWidth, uint16_t pageHeight, const Panel& panel);
+    void write(const uint8_t* data, size_t size, size_t offset);
+
+   private:
+    const Panel panel;
+    size_t srcRowBytes;
+    int visibleWidth;
+    int visibleHeight;
+    int keptRowBytes;
+    std::vector<uint8_t> rows;  // the current block of 8 rows, visible bytes only
+  };
+
+  // Incremental blitXth for one plane of a page decoded chunk by chunk. The first bit plane is staged in the panel
+  // rows the page covers and combined with the second one as it arrives, so those rows must start out cleared to the
+  // plane's background (clearScreen() for Bw, clearScreen(0x00) for the gray planes).
+  class XthStream {
+   public:
+    XthStream(uint16_t pageWidth, uint16_t pageHeight, Plane plane, const Panel& panel);
+    void write(const uint8_t* data, size_t size, size_t offset);
+
+   private:
+    const Panel panel;
+    const Plane plane;
+    size_t planeSize;
+    size_t colBytes;
+    uint16_t pageWidth;
+    int fullBytes;
+    uint8_t tailMask;
+    int rowOffset;
+
+    void apply(bool secondPlane, const uint8_t* data, size_t size, size_t planeOffset) const;
+  };
+};
+
+}  // namespace xtc
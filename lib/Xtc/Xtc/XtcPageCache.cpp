@@ -0,0 +1,127 @@
+/**
+ * XtcPageCache.cpp
+ *
+ * Read-ahead page buffer ring implementation
+ * XTC ebook support for CrossPoint Reader
+ */
+
+#include "XtcPageCache.h"
+
+#include <Arduino.h>
+
+#include <cstdlib>
+
+#include "XtcParser.h"
+
+namespace xtc {
+
+size_t XtcPageCache::allocate(const size_t slotSize, const size_t maxSlots, const size_t heapReserve) {
+  release();
+  this->slotSize = slotSize;
+
+  const size_t wanted = maxSlots < MAX_SLOTS ? maxSlots : MAX_SLOTS;
+  while (slotCount < wanted) {
+    if (slotCount > 0 && ESP.getFreeHeap() < slotSize + heapReserve) {
+      break;
+    }
+    auto* data = static_cast<uint8_t*>(malloc(slotSize));
+    if (!data) {
+      break;
+    }
+    slots[slotCount++].data = data;
+  }
+
+  Serial.printf("[%lu] [XTC] Page cache: %u x %u bytes, free heap %d bytes\n", millis(), slotCount, slotSize,
+                ESP.getFreeHeap());
+  return slotCount;
+}
+
+void XtcPageCache::release() {
+  for (size_t i = 0; i < slotCount; i++) {
+    free(slots[i].data);
+    slots[i] = Slot();
+  }
+  slotCount = 0;
+}
+
+int XtcPageCache::find(const uint32_t pageIndex) const {
+  for (size_t i = 0; i < slotCount; i++) {
+    if (slots[i].size > 0 && slots[i].pageIndex == pageIndex) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+uint32_t XtcPageCache::rank(const uint32_t pageIndex) const {
+  if (pageIndex == pinnedPage) {
+    return 0;
+  }
+  if (pageIndex == pinnedPage + 1) {
+    return 1;
+  }
+  if (pageIndex + 1 == pinnedPage) {
+    return 2;
+  }
+  return 2 + (pageIndex > pinnedPage ? pageIndex - pinnedPage : pinnedPage - pageIndex);
+}
+
+int XtcPageCache::victim(const uint32_t newRank) const {
+  int worst = -1;
+  uint32_t worstRank = newRank;
+  for (size_t i = 0; i < slotCount; i++) {
+    if (slots[i].size == 0) {
+      return static_cast<int>(i);
+    }
+    const uint32_t slotRank = rank(slots[i].pageIndex);
+    if (slotRank > worstRank) {
+      worst = static_cast<int>(i);
+      worstRank = slotRank;
+    }
+  }
+  return worst;
+}
+
+bool XtcPageCache::fill(XtcParser& parser, Slot& slot, const uint32_t pageIndex) {
+  slot.size = parser.loadPage(pageIndex, slot.data, slotSize);
+  slot.pageIndex = pageIndex;
+  return slot.size > 0;
+}
+
+const uint8_t* XtcPageCache::get(XtcParser& parser, const uint32_t pageIndex, size_t* size) {
+  pinnedPage = pageIndex;
+
+  int index = find(pageIndex);
+  if (index < 0) {
+    // Rank 0 outranks everything else, so there is always a slot to load the pinned page into
+    index = victim(0);
+    if (index < 0 || !fill(parser, slots[index], pageIndex)) {
+      return nullptr;
+    }
+  }
+
+  if (size) {
+    *size = slots[index].size;
+  }
+  return slots[index].data;
+}
+
+bool XtcPageCache::prefetch(XtcParser& parser, const uint32_t pageIndex) {
+  if (pageIndex >= parser.getPageCount() || contains(pageIndex)) {
+    return false;
+  }
+
+  const int index = victim(rank(pageIndex));
+  if (index < 0) {
+    return false;
+  }
+
+  const uint32_t start = millis();
+  if (!fill(parser, slots[index], pageIndex)) {
+    return false;
+  }
+  Serial.printf("[%lu] [XTC] Prefetched page %lu in %lu ms\n", millis(), pageIndex, millis() - start);
+  return true;
+}
+
+}  // namespace xtc
@@ -0,0 +1,67 @@
+/**
+ * XtcPageCache.h
+ *
+ * Read-ahead page buffer ring
+ * XTC ebook support for CrossPoint Reader
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace xtc {
+
+class XtcParser;
+
+/**
+ * Small ring of page bitmap buffers, allocated once per book instead of once per page turn.
+ *
+ * The page on screen is pinned; the remaining slots hold read-ahead pages, preferring the next page, then the
+ * previous one. A slot is only recycled for a page that is closer to the pinned page than the one it holds.
+ */
+class XtcPageCache {
+ public:
+  static constexpr size_t MAX_SLOTS = 3;
+
+  XtcPageCache() = default;
+  ~XtcPageCache() { release(); }
+  XtcPageCache(const XtcPageCache&) = delete;
+  XtcPageCache& operator=(const XtcPageCache&) = delete;
+
+  // Allocate up to `maxSlots` buffers of `slotSize` bytes, stopping before free heap would drop below `heapReserve`.
+  // At least one buffer is attempted regardless of the reserve. Returns the number of buffers allocated.
+  size_t allocate(size_t slotSize, size_t maxSlots, size_t heapReserve);
+  void release();
+  size_t getSlotCount() const { return slotCount; }
+
+  bool contains(uint32_t pageIndex) const { return find(pageIndex) >= 0; }
+
+  // Bitmap of `pageIndex`, read from `parser` first if it is not cached. Pins the page. nullptr on failure.
+  const uint8_t* get(XtcParser& parser, uint32_t pageIndex, size_t* size);
+
+  // Read `pageIndex` ahead of time without evicting the pinned page or anything more useful than it.
+  // Returns true if the page was read.
+  bool prefetch(XtcParser& parser, uint32_t pageIndex);
+
+ private:
+  struct Slot {
+    uint8_t* data = nullptr;
+    size_t size = 0;  // bytes of valid page data, 0 = empty
+    uint32_t pageIndex = 0;
+  };
+
+  Slot slots[MAX_SLOTS];
+  size_t slotCount = 0;
+  size_t slotSize = 0;
+  uint32_t pinnedPage = 0;
+
+  int find(uint32_t pageIndex) const;
+  // Lower is more worth keeping: the pinned page, then the next page, then the previous one, then by distance
+  uint32_t rank(uint32_t pageIndex) const;
+  // Slot to (re)use for a page of `newRank`, or -1 if every slot holds something more useful
+  int victim(uint32_t newRank) const;
+  bool fill(XtcParser& parser, Slot& slot, uint32_t pageIndex);
+};
+
+}  // namespace xtc
@@ -0,0 +1,139 @@
+/**
+ * XtcPageDecoder.cpp
+ *
+ * XTG/XTH page payload decoding implementation
+ * XTC ebook support for CrossPoint Reader
+ */
+
+#include "XtcPageDecoder.h"
+
+#include <miniz.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace xtc {
+
+namespace {
+
+constexpr size_t INPUT_CHUNK_SIZE = 1024;
+
+// Inflate a raw deflate payload. Without a callback, `out` is the whole bitmap buffer; with one, `out` is a
+// TINFL_LZ_DICT_SIZE window that wraps around and every produced span is handed to the callback.
+XtcError inflatePayload(const size_t payloadSize, const size_t bitmapSize, const XtcPageDecoder::ReadFn& read,
+                        uint8_t* out, const size_t outSize, const XtcPageDecoder::ChunkFn* callback) {
+  auto* inflator = static_cast<tinfl_decompressor*>(malloc(sizeof(tinfl_decompressor)));
+  auto* input = static_cast<uint8_t*>(malloc(INPUT_CHUNK_SIZE));
+  if (!inflator || !input) {
+    free(inflator);
+    free(input);
+    return XtcError::MEMORY_ERROR;
+  }
+  tinfl_init(inflator);
+
+  const int baseFlags = callback ? 0 : TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF;
+  size_t payloadRemaining = payloadSize;
+  size_t inputFilled = 0;
+  size_t inputCursor = 0;
+  size_t outCursor = 0;
+  size_t produced = 0;
+  XtcError result = XtcError::OK;
+
+  while (true) {
+    if (inputCursor == inputFilled && payloadRemaining > 0) {
+      inputFilled = read(input, std::min(INPUT_CHUNK_SIZE, payloadRemaining));
+      inputCursor = 0;
+      if (inputFilled == 0) {
+        result = XtcError::READ_ERROR;
+        break;
+      }
+      payloadRemaining -= inputFilled;
+    }
+
+    size_t inBytes = inputFilled - inputCursor;
+    size_t outBytes = outSize - outCursor;
+    const int flags = baseFlags | (payloadRemaining > 0 ? TINFL_FLAG_HAS_MORE_INPUT : 0);
+    const tinfl_status status =
+        tinfl_decompress(inflator, input + inputCursor, &inBytes, out, out + outCursor, &outBytes, flags);
+    inputCursor += inBytes;
+
+    if (produced + outBytes > bitmapSize) {
+      result = XtcError::DECOMPRESSION_ERROR;
+      break;
+    }
+    if (callback && outBytes > 0) {
+      (*callback)(out + outCursor, outBytes, produced);
+    }
+    produced += outBytes;
+    outCursor += outBytes;
+    if (callback) {
+      outCursor &= TINFL_LZ_DICT_SIZE - 1;
+    }
+
+    if (status == TINFL_STATUS_DONE) {
+      break;
+    }
+    // Out of input with the stream unfinished, a corrupt stream, or more output than the bitmap can hold
+    if (status < TINFL_STATUS_DONE || (status == TINFL_STATUS_NEEDS_MORE_INPUT && payloadRemaining == 0) ||
+        (status == TINFL_STATUS_HAS_MORE_OUTPUT && !callback)) {
+      result = XtcError::DECOMPRESSION_ERROR;
+      break;
+    }
+  }
+
+  free(input);
+  free(inflator);
+
+  if (result == XtcError::OK && produced != bitmapSize) {
+    result = XtcError::DECOMPRESSION_ERROR;
+  }
+  return result;
+}
+
+}  // namespace
+
+XtcError XtcPageDecoder::decode(const uint8_t compression, const size_t payloadSize, const size_t bitmapSize,
+                                const ReadFn& read, uint8_t* out) {
+  switch (compression) {
+    case PAGE_COMPRESSION_NONE:
+      return read(out, bitmapSize) == bitmapSize ? XtcError::OK : XtcError::READ_ERROR;
+    case PAGE_COMPRESSION_DEFLATE:
+      return inflatePayload(payloadSize, bitmapSize, read, out, bitmapSize, nullptr);
+    default:
+      return XtcError::DECOMPRESSION_ERROR;
+  }
+}
+
+XtcError XtcPageDecoder::decodeStreaming(const uint8_t compression, const size_t payloadSize, const size_t bitmapSize,
+                                         const ReadFn& read, const ChunkFn& callback, const size_t chunkSize) {
+  switch (compression) {
+    case PAGE_COMPRESSION_NONE: {
+      std::vector<uint8_t> chunk(chunkSize);
+      size_t totalRead = 0;
+      while (totalRead < bitmapSize) {
+        const size_t bytesRead = read(chunk.data(), std::min(chunkSize, bitmapSize - totalRead));
+        if (bytesRead == 0) {
+          return XtcError::READ_ERROR;
+        }
+        callback(chunk.data(), bytesRead, totalRead);
+        totalRead += bytesRead;
+      }
+      return XtcError::OK;
+    }
+    case PAGE_COMPRESSION_DEFLATE: {
+      auto* window = static_cast<uint8_t*>(malloc(TINFL_LZ_DICT_SIZE));
+      if (!window) {
+        return XtcError::MEMORY_ERROR;
+      }
+      const XtcError result = inflatePayload(payloadSize, bitmapSize, read, window, TINFL_LZ_DICT_SIZE, &callback);
+      free(window);
+      return result;
+    }
+    default:
+      return XtcError::DECOMPRESSION_ERROR;
+  }
+}
+
+}  // namespace xtc
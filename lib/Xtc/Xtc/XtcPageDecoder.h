@@ -0,0 +1,41 @@
+/**
+ * XtcPageDecoder.h
+ *
+ * XTG/XTH page payload decoding (stored or deflated)
+ * XTC ebook support for CrossPoint Reader
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "XtcTypes.h"
+
+namespace xtc {
+
+/**
+ * Turns a page payload, as stored after its XtgPageHeader, back into the page bitmap.
+ *
+ * Input is pulled through `read` so the decoder works on any source (the SD card in XtcParser, memory in host
+ * tests). Deflated payloads are inflated with miniz's tinfl.
+ */
+class XtcPageDecoder {
+ public:
+  // Reads up to `len` payload bytes into `buf`, returning the number of bytes read (0 on error)
+  using ReadFn = std::function<size_t(uint8_t* buf, size_t len)>;
+  using ChunkFn = std::function<void(const uint8_t* data, size_t size, size_t offset)>;
+
+  // Decode the whole bitmap into `out`, which must hold `bitmapSize` bytes. Deflated pages are inflated in place,
+  // so apart from the inflator no other buffer is needed.
+  static XtcError decode(uint8_t compression, size_t payloadSize, size_t bitmapSize, const ReadFn& read,
+                         uint8_t* out);
+
+  // Decode the bitmap in order, handing it to `callback` in chunks of at most `chunkSize` bytes (stored pages) or
+  // as produced by the inflator through a TINFL_LZ_DICT_SIZE window (deflated pages)
+  static XtcError decodeStreaming(uint8_t compression, size_t payloadSize, size_t bitmapSize, const ReadFn& read,
+                                  const ChunkFn& callback, size_t chunkSize);
+};
+
+}  // namespace xtc
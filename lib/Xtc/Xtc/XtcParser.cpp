@@ -13,6 +13,8 @@
 
 #include <cstring>
 
+#include "XtcPageDecoder.h"
+
 namespace xtc {
 
 XtcParser::XtcParser()
@@ -375,16 +377,19 @@ size_t XtcParser::loadPage(uint32_t pageIndex, uint8_t* buffer, size_t bufferSiz
     return 0;
   }
 
-  // Read bitmap data
-  size_t bytesRead = m_file.read(buffer, bitmapSize);
-  if (bytesRead != bitmapSize) {
-    Serial.printf("[%lu] [XTC] Page read error: expected %u, got %u\n", millis(), bitmapSize, bytesRead);
-    m_lastError = XtcError::READ_ERROR;
+  // Read bitmap data, inflating compressed pages straight into the buffer
+  const XtcError err = XtcPageDecoder::decode(
+      pageHeader.compression, pageHeader.dataSize, bitmapSize,
+      [this](uint8_t* buf, const size_t len) { return m_file.read(buf, len); }, buffer);
+  if (err != XtcError::OK) {
+    Serial.printf("[%lu] [XTC] Page %u read error (compression %u): %s\n", millis(), pageIndex,
+                  pageHeader.compression, errorToString(err));
+    m_lastError = err;
     return 0;
   }
 
   m_lastError = XtcError::OK;
-  return bytesRead;
+  return bitmapSize;
 }
 
 XtcError XtcParser::loadPageStreaming(uint32_t pageIndex,
@@ -423,23 +428,10 @@ XtcError XtcParser::loadPageStreaming(uint32_t pageIndex,
     bitmapSize = ((pageHeader.width + 7) / 8) * pageHeader.height;
   }
 
-  // Read in chunks
-  std::vector<uint8_t> chunk(chunkSize);
-  size_t totalRead = 0;
-
-  while (totalRead < bitmapSize) {
-    size_t toRead = std::min(chunkSize, bitmapSize - totalRead);
-    size_t bytesRead = m_file.read(chunk.data(), toRead);
-
-    if (bytesRead == 0) {
-      return XtcError::READ_ERROR;
-    }
-
-    callback(chunk.data(), bytesRead, totalRead);
-    totalRead += bytesRead;
-  }
-
-  return XtcError::OK;
+  // Read in chunks; compressed pages are inflated through a small window, never a full page buffer
+  return XtcPageDecoder::decodeStreaming(
+      pageHeader.compression, pageHeader.dataSize, bitmapSize,
+      [this](uint8_t* buf, const size_t len) { return m_file.read(buf, len); }, callback, chunkSize);
 }
 
 bool XtcParser::isValidXtcFile(const char* filepath) {
@@ -45,7 +45,7 @@ class XtcParser {
   bool getPageInfo(uint32_t pageIndex, PageInfo& info) const;
 
   /**
-   * Load page bitmap (raw 1-bit data, skipping XTG header)
+   * Load page bitmap (raw 1-bit data, skipping XTG header), inflating compressed pages
    *
    * @param pageIndex Page index (0-based)
    * @param buffer Output buffer (caller allocated)
@@ -56,7 +56,8 @@ class XtcParser {
 
   /**
    * Streaming page load
-   * Memory-efficient method that reads page data in chunks.
+   * Memory-efficient method that reads page data in chunks. Compressed pages are inflated through a 32KB window,
+   * so no full page buffer is needed.
    *
    * @param pageIndex Page index
    * @param callback Callback function to receive data chunks
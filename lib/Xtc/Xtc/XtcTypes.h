@@ -12,7 +12,10 @@
 
 #pragma once
 
+#include <strings.h>
+
 #include <cstdint>
+#include <cstring>
 #include <string>
 
 namespace xtc {
@@ -70,8 +73,8 @@ struct XtgPageHeader {
   uint16_t width;       // 0x04: Image width (pixels)
   uint16_t height;      // 0x06: Image height (pixels)
   uint8_t colorMode;    // 0x08: Color mode (0=monochrome)
-  uint8_t compression;  // 0x09: Compression (0=uncompressed)
-  uint32_t dataSize;    // 0x0A: Image data size (bytes)
+  uint8_t compression;  // 0x09: Compression (PAGE_COMPRESSION_*)
+  uint32_t dataSize;    // 0x0A: Image data size (bytes, compressed size for compressed pages)
   uint64_t md5;         // 0x0E: MD5 checksum (first 8 bytes, optional)
   // Followed by bitmap data at offset 0x16 (22)
   //
@@ -83,9 +86,15 @@ struct XtgPageHeader {
   //   First plane: Bit1 for all pixels
   //   Second plane: Bit2 for all pixels
   //   pixelValue = (bit1 << 1) | bit2
+  //
+  // Compressed pages store the same bitmap bytes as one raw deflate stream (no zlib header) of dataSize bytes
 };
 #pragma pack(pop)
 
+// XtgPageHeader::compression values
+constexpr uint8_t PAGE_COMPRESSION_NONE = 0;
+constexpr uint8_t PAGE_COMPRESSION_DEFLATE = 1;
+
 // Page information (internal use, optimized for memory)
 struct PageInfo {
   uint32_t offset;   // File offset to page data (max 4GB file size)
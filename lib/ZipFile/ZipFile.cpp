@@ -6,6 +6,8 @@
 
 #include <algorithm>
 
+#include "ZipIndex.h"
+
 bool inflateOneShot(const uint8_t* inputBuf, const size_t deflatedSize, uint8_t* outputBuf, const size_t inflatedSize) {
   // Setup inflator
   const auto inflator = static_cast<tinfl_decompressor*>(malloc(sizeof(tinfl_decompressor)));
@@ -30,7 +32,7 @@ bool inflateOneShot(const uint8_t* inputBuf, const size_t deflatedSize, uint8_t*
   return true;
 }
 
-bool ZipFile::loadAllFileStatSlims() {
+bool ZipFile::scanCentralDir(const std::function<void(const char* name, const FileStatSlim& fileStat)>& callback) {
   const bool wasOpen = isOpen();
   if (!wasOpen && !open()) {
     return false;
@@ -47,8 +49,6 @@ bool ZipFile::loadAllFileStatSlims() {
 
   uint32_t sig;
   char itemName[256];
-  fileStatSlimCache.clear();
-  fileStatSlimCache.reserve(zipDetails.totalEntries);
 
   while (file.available()) {
     file.read(&sig, 4);
@@ -70,7 +70,7 @@ bool ZipFile::loadAllFileStatSlims() {
     file.read(itemName, nameLen);
     itemName[nameLen] = '\0';
 
-    fileStatSlimCache.emplace(itemName, fileStat);
+    callback(itemName, fileStat);
 
     // Skip the rest of this entry (extra field + comment)
     file.seekCur(m + k);
@@ -86,6 +86,17 @@ bool ZipFile::loadAllFileStatSlims() {
   return true;
 }
 
+bool ZipFile::loadAllFileStatSlims() {
+  fileStatSlimCache.clear();
+  return scanCentralDir(
+      [this](const char* name, const FileStatSlim& fileStat) { fileStatSlimCache.emplace(name, fileStat); });
+}
+
+bool ZipFile::listEntries(std::vector<std::string>& names) {
+  names.clear();
+  return scanCentralDir([&names](const char* name, const FileStatSlim&) { names.emplace_back(name); });
+}
+
 bool ZipFile::loadFileStatSlim(const char* filename, FileStatSlim* fileStat) {
   if (!fileStatSlimCache.empty()) {
     const auto it = fileStatSlimCache.find(filename);
@@ -96,6 +107,15 @@ bool ZipFile::loadFileStatSlim(const char* filename, FileStatSlim* fileStat) {
     return false;
   }
 
+  if (index) {
+    if (index->find(filename, fileStat)) {
+      return true;
+    }
+    if (index->isComplete()) {
+      return false;
+    }
+  }
+
   const bool wasOpen = isOpen();
   if (!wasOpen && !open()) {
     return false;
@@ -660,3 +680,161 @@ bool ZipFile::readFileToStream(const char* filename, Print& out, const size_t ch
   Serial.printf("[%lu] [ZIP] Unsupported compression method\n", millis());
   return false;
 }
+
+bool ZipFile::openFileStream(const char* filename, ZipInflateStream& stream, const size_t chunkSize) {
+  stream.close();
+
+  FileStatSlim fileStat = {};
+  if (!loadFileStatSlim(filename, &fileStat)) {
+    return false;
+  }
+
+  const long fileOffset = getDataOffset(fileStat);
+  if (fileOffset < 0) {
+    return false;
+  }
+
+  if (fileStat.method != MZ_NO_COMPRESSION && fileStat.method != MZ_DEFLATED) {
+    Serial.printf("[%lu] [ZIP] Unsupported compression method\n", millis());
+    return false;
+  }
+
+  return stream.begin(filePath, fileStat, fileOffset, chunkSize);
+}
+
+bool ZipInflateStream::begin(const std::string& zipPath, const ZipFile::FileStatSlim& fileStat, const long dataOffset,
+                             const size_t chunkSize) {
+  if (!Storage.openFileForRead("ZIP", zipPath, file)) {
+    return false;
+  }
+  file.seek(dataOffset);
+
+  method = fileStat.method;
+  inflatedSize = fileStat.uncompressedSize;
+  compressedRemaining = fileStat.method == MZ_NO_COMPRESSION ? fileStat.uncompressedSize : fileStat.compressedSize;
+  producedBytes = 0;
+  finished = false;
+  errored = false;
+
+  if (method == MZ_NO_COMPRESSION) {
+    // Stored entries are read straight from the file, no buffers needed
+    finished = compressedRemaining == 0;
+    return true;
+  }
+
+  inflator = static_cast<tinfl_decompressor*>(malloc(sizeof(tinfl_decompressor)));
+  inputBuffer = static_cast<uint8_t*>(malloc(chunkSize));
+  dictionary = static_cast<uint8_t*>(malloc(TINFL_LZ_DICT_SIZE));
+  if (!inflator || !inputBuffer || !dictionary) {
+    Serial.printf("[%lu] [ZIP] Failed to allocate memory for inflate stream\n", millis());
+    close();
+    return false;
+  }
+  memset(inflator, 0, sizeof(tinfl_decompressor));
+  tinfl_init(inflator);
+
+  inputChunkSize = chunkSize;
+  inputFilled = 0;
+  inputCursor = 0;
+  dictCursor = 0;
+  pendingStart = 0;
+  pendingLen = 0;
+  return true;
+}
+
+// Run the inflator until it produces output, finishes or fails. Output lands in the dictionary as pending bytes.
+bool ZipInflateStream::inflateMore() {
+  while (!finished && !errored && pendingLen == 0) {
+    // Load more compressed bytes when needed
+    if (inputCursor >= inputFilled && compressedRemaining > 0) {
+      inputFilled = file.read(inputBuffer, compressedRemaining < inputChunkSize ? compressedRemaining : inputChunkSize);
+      inputCursor = 0;
+      if (inputFilled == 0) {
+        Serial.printf("[%lu] [ZIP] Could not read more bytes\n", millis());
+        errored = true;
+        return false;
+      }
+      compressedRemaining -= inputFilled;
+    }
+
+    size_t inBytes = inputFilled - inputCursor;
+    size_t outBytes = TINFL_LZ_DICT_SIZE - dictCursor;
+    const tinfl_status status =
+        tinfl_decompress(inflator, inputBuffer + inputCursor, &inBytes, dictionary, dictionary + dictCursor, &outBytes,
+                         compressedRemaining > 0 ? TINFL_FLAG_HAS_MORE_INPUT : 0);
+    inputCursor += inBytes;
+
+    if (outBytes > 0) {
+      pendingStart = dictCursor;
+      pendingLen = outBytes;
+      producedBytes += outBytes;
+      dictCursor = (dictCursor + outBytes) & (TINFL_LZ_DICT_SIZE - 1);
+    }
+
+    if (status < 0) {
+      Serial.printf("[%lu] [ZIP] tinfl_decompress() failed with status %d\n", millis(), status);
+      errored = true;
+      return false;
+    }
+
+    if (status == TINFL_STATUS_DONE) {
+      finished = true;
+      if (producedBytes != inflatedSize) {
+        Serial.printf("[%lu] [ZIP] Inflated %zu bytes, expected %zu\n", millis(), producedBytes, inflatedSize);
+      }
+    } else if (status == TINFL_STATUS_NEEDS_MORE_INPUT && inputCursor >= inputFilled && compressedRemaining == 0) {
+      Serial.printf("[%lu] [ZIP] Unexpected EOF\n", millis());
+      errored = true;
+      return false;
+    }
+  }
+
+  return pendingLen > 0;
+}
+
+size_t ZipInflateStream::read(uint8_t* buf, const size_t len) {
+  if (!file || errored) {
+    return 0;
+  }
+
+  if (method == MZ_NO_COMPRESSION) {
+    const size_t toRead = compressedRemaining < len ? compressedRemaining : len;
+    const size_t dataRead = toRead > 0 ? file.read(buf, toRead) : 0;
+    if (dataRead != toRead) {
+      Serial.printf("[%lu] [ZIP] Could not read more bytes\n", millis());
+      errored = true;
+    }
+    compressedRemaining -= dataRead;
+    producedBytes += dataRead;
+    finished = compressedRemaining == 0;
+    return dataRead;
+  }
+
+  size_t total = 0;
+  while (total < len) {
+    if (pendingLen == 0 && !inflateMore()) {
+      break;
+    }
+
+    const size_t toCopy = pendingLen < len - total ? pendingLen : len - total;
+    memcpy(buf + total, dictionary + pendingStart, toCopy);
+    pendingStart += toCopy;
+    pendingLen -= toCopy;
+    total += toCopy;
+  }
+
+  return total;
+}
+
+void ZipInflateStream::close() {
+  if (file) {
+    file.close();
+  }
+  free(inflator);
+  free(inputBuffer);
+  free(dictionary);
+  inflator = nullptr;
+  inputBuffer = nullptr;
+  dictionary = nullptr;
+  pendingLen = 0;
+}
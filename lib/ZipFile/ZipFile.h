@@ -1,11 +1,18 @@
 #pragma once
 #include <HalStorage.h>
 
+#include <functional>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+struct tinfl_decompressor_tag;
+class ZipInflateStream;
+class ZipIndex;
+
 class ZipFile {
+  friend class ZipIndex;
+
  public:
   struct FileStatSlim {
     uint16_t method;             // Compression method
@@ -39,6 +46,7 @@ class ZipFile {
 
  private:
   const std::string& filePath;
+  const ZipIndex* index;
   FsFile file;
   ZipDetails zipDetails = {0, 0, false};
   std::unordered_map<std::string, FileStatSlim> fileStatSlimCache;
@@ -47,12 +55,14 @@ class ZipFile {
   uint32_t lastCentralDirPos = 0;
   bool lastCentralDirPosValid = false;
 
+  bool scanCentralDir(const std::function<void(const char* name, const FileStatSlim& fileStat)>& callback);
   bool loadFileStatSlim(const char* filename, FileStatSlim* fileStat);
   long getDataOffset(const FileStatSlim& fileStat);
   bool loadZipDetails();
 
  public:
-  explicit ZipFile(const std::string& filePath) : filePath(filePath) {}
+  // With an index, entries are resolved from it instead of scanning the central directory
+  explicit ZipFile(const std::string& filePath, const ZipIndex* index = nullptr) : filePath(filePath), index(index) {}
   ~ZipFile() = default;
   // Zip file can be opened and closed by hand in order to allow for quick calculation of inflated file size
   // It is NOT recommended to pre-open it for any kind of inflation due to memory constraints
@@ -60,6 +70,9 @@ class ZipFile {
   bool open();
   bool close();
   bool loadAllFileStatSlims();
+  // Names of all entries in central directory order (directories end with '/'). Looking entries up in this order
+  // afterwards is cheap thanks to the sequential central-dir cursor.
+  bool listEntries(std::vector<std::string>& names);
   bool getInflatedFileSize(const char* filename, size_t* size);
   // Batch lookup: scan ZIP central dir once and fill sizes for matching targets.
   // targets must be sorted by (hash, len). sizes[target.index] receives uncompressedSize.
@@ -69,4 +82,55 @@ class ZipFile {
   // These functions will open and close the zip as needed
   uint8_t* readFileToMemory(const char* filename, size_t* size = nullptr, bool trailingNullByte = false);
   bool readFileToStream(const char* filename, Print& out, size_t chunkSize);
+  // Prepare a pull-based reader for a single entry. The stream holds its own file handle, so this ZipFile does not
+  // need to outlive it. chunkSize is the size of the compressed read buffer.
+  bool openFileStream(const char* filename, ZipInflateStream& stream, size_t chunkSize);
+};
+
+// Pull-based reader for a single zip entry. Inflated bytes are produced on demand into a TINFL_LZ_DICT_SIZE sliding
+// window and copied out by read(), so consumers (e.g. expat) can parse an entry without a temp file on the SD card.
+// Holds the inflator, the dictionary and one compressed input chunk (~45KB for deflated entries) while open.
+class ZipInflateStream {
+  friend class ZipFile;
+
+  FsFile file;
+  uint16_t method = 0;
+  size_t inflatedSize = 0;
+  size_t compressedRemaining = 0;
+  size_t producedBytes = 0;
+
+  tinfl_decompressor_tag* inflator = nullptr;
+  uint8_t* inputBuffer = nullptr;
+  size_t inputChunkSize = 0;
+  size_t inputFilled = 0;
+  size_t inputCursor = 0;
+
+  uint8_t* dictionary = nullptr;
+  size_t dictCursor = 0;    // Where the inflator writes next in the circular dictionary
+  size_t pendingStart = 0;  // Inflated bytes not yet handed to the caller
+  size_t pendingLen = 0;
+
+  bool finished = false;
+  bool errored = false;
+
+  bool begin(const std::string& zipPath, const ZipFile::FileStatSlim& fileStat, long dataOffset, size_t chunkSize);
+  bool inflateMore();
+
+ public:
+  ZipInflateStream() = default;
+  ~ZipInflateStream() { close(); }
+  ZipInflateStream(const ZipInflateStream&) = delete;
+  ZipInflateStream& operator=(const ZipInflateStream&) = delete;
+
+  bool isOpen() const { return !!file; }
+  // Uncompressed size of the entry as recorded in the central directory
+  size_t size() const { return inflatedSize; }
+  // Inflated bytes returned by read() so far
+  size_t position() const { return producedBytes - pendingLen; }
+  // True once every inflated byte has been returned by read()
+  bool eof() const { return finished && pendingLen == 0; }
+  bool hasError() const { return errored; }
+  // Reads up to len inflated bytes into buf. Returns fewer than len only at the end of the entry or on error.
+  size_t read(uint8_t* buf, size_t len);
+  void close();
 };
@@ -0,0 +1,204 @@
+#include "ZipIndex.h"
+
+#include <Arduino.h>
+#include <HalStorage.h>
+#include <Serialization.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+constexpr uint8_t ZIP_INDEX_VERSION = 1;
+// Version, complete flag, size of the indexed zip and entry count
+constexpr uint32_t HEADER_SIZE = sizeof(uint8_t) * 2 + sizeof(uint32_t) * 2;
+// Building holds every entry in RAM while they are sorted
+constexpr size_t BUILD_HEAP_RESERVE = 32 * 1024;
+}  // namespace
+
+bool ZipIndex::getZipSize(const std::string& zipPath, uint32_t* size) {
+  FsFile zipFile;
+  if (!Storage.openFileForRead("ZIP", zipPath, zipFile)) {
+    return false;
+  }
+  *size = zipFile.size();
+  zipFile.close();
+  return true;
+}
+
+bool ZipIndex::build(const std::string& zipPath, const std::string& indexPath) {
+  const uint32_t buildStart = millis();
+
+  ZipFile zip(zipPath);
+  if (!zip.open()) {
+    return false;
+  }
+  if (!zip.loadZipDetails()) {
+    zip.close();
+    return false;
+  }
+
+  const uint32_t zipSize = zip.file.size();
+  const uint16_t totalEntries = zip.zipDetails.totalEntries;
+  if (ESP.getFreeHeap() < totalEntries * sizeof(Entry) + BUILD_HEAP_RESERVE) {
+    Serial.printf("[%lu] [ZIP] Not enough memory to index %u zip entries\n", millis(), totalEntries);
+    zip.close();
+    return false;
+  }
+
+  std::vector<Entry> entries;
+  entries.reserve(totalEntries);
+  const bool scanned = zip.scanCentralDir([&entries](const char* name, const ZipFile::FileStatSlim& fileStat) {
+    const size_t nameLen = strlen(name);
+    entries.push_back({ZipFile::fnvHash64(name, nameLen), static_cast<uint16_t>(nameLen), fileStat.method,
+                       fileStat.compressedSize, fileStat.uncompressedSize, fileStat.localHeaderOffset});
+  });
+  zip.close();
+  if (!scanned) {
+    return false;
+  }
+
+  std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.hash < b.hash; });
+
+  // Keep only hashes that belong to a single entry, so a lookup never has to compare names
+  size_t kept = 0;
+  for (size_t i = 0; i < entries.size();) {
+    size_t next = i + 1;
+    while (next < entries.size() && entries[next].hash == entries[i].hash) {
+      next++;
+    }
+    if (next == i + 1) {
+      entries[kept++] = entries[i];
+    }
+    i = next;
+  }
+  const uint8_t complete = kept == entries.size() ? 1 : 0;
+  entries.resize(kept);
+
+  FsFile file;
+  if (!Storage.openFileForWrite("ZIP", indexPath, file)) {
+    return false;
+  }
+
+  const uint32_t entryCount = entries.size();
+  serialization::writePod(file, ZIP_INDEX_VERSION);
+  serialization::writePod(file, complete);
+  serialization::writePod(file, zipSize);
+  serialization::writePod(file, entryCount);
+  for (uint32_t i = 0; i < entryCount; i += ENTRIES_PER_PAGE) {
+    serialization::writePod(file, entries[i].hash);
+  }
+  const size_t entriesSize = entryCount * sizeof(Entry);
+  const bool written = file.write(reinterpret_cast<const uint8_t*>(entries.data()), entriesSize) == entriesSize;
+  file.close();
+
+  if (!written) {
+    Serial.printf("[%lu] [ZIP] Failed to write zip index\n", millis());
+    Storage.remove(indexPath.c_str());
+    return false;
+  }
+
+  Serial.printf("[%lu] [ZIP] Indexed %u of %u zip entries in %lu ms\n", millis(), entryCount, totalEntries,
+                millis() - buildStart);
+  return true;
+}
+
+bool ZipIndex::load(const std::string& indexPath, const std::string& zipPath) {
+  this->indexPath = indexPath;
+  pageHashes.clear();
+  entryCount = 0;
+  entriesOffset = 0;
+  complete = false;
+
+  FsFile file;
+  if (!Storage.openFileForRead("ZIP", indexPath, file)) {
+    return false;
+  }
+
+  uint8_t version;
+  serialization::readPod(file, version);
+  if (version != ZIP_INDEX_VERSION) {
+    Serial.printf("[%lu] [ZIP] Zip index version mismatch: expected %d, got %d\n", millis(), ZIP_INDEX_VERSION,
+                  version);
+    file.close();
+    return false;
+  }
+
+  uint8_t completeFlag;
+  uint32_t indexedZipSize;
+  uint32_t count;
+  serialization::readPod(file, completeFlag);
+  serialization::readPod(file, indexedZipSize);
+  serialization::readPod(file, count);
+
+  uint32_t zipSize;
+  if (!getZipSize(zipPath, &zipSize) || zipSize != indexedZipSize) {
+    Serial.printf("[%lu] [ZIP] Zip index does not match %s\n", millis(), zipPath.c_str());
+    file.close();
+    return false;
+  }
+
+  const uint32_t pageCount = (count + ENTRIES_PER_PAGE - 1) / ENTRIES_PER_PAGE;
+  const uint32_t offset = HEADER_SIZE + pageCount * sizeof(uint64_t);
+  if (file.size() != offset + count * sizeof(Entry)) {
+    Serial.printf("[%lu] [ZIP] Zip index truncated\n", millis());
+    file.close();
+    return false;
+  }
+
+  pageHashes.resize(pageCount);
+  const size_t hashesSize = pageCount * sizeof(uint64_t);
+  const bool read =
+      file.read(reinterpret_cast<uint8_t*>(pageHashes.data()), hashesSize) == static_cast<int>(hashesSize);
+  file.close();
+  if (!read) {
+    pageHashes.clear();
+    return false;
+  }
+
+  entryCount = count;
+  entriesOffset = offset;
+  complete = completeFlag != 0;
+  return true;
+}
+
+bool ZipIndex::find(const char* name, ZipFile::FileStatSlim* fileStat) const {
+  if (pageHashes.empty()) {
+    return false;
+  }
+
+  const size_t nameLen = strlen(name);
+  const uint64_t hash = ZipFile::fnvHash64(name, nameLen);
+
+  // The entry can only be on the last page starting at or before its hash
+  const auto pageIt = std::upper_bound(pageHashes.begin(), pageHashes.end(), hash);
+  if (pageIt == pageHashes.begin()) {
+    return false;
+  }
+  const uint32_t firstEntry = (pageIt - pageHashes.begin() - 1) * ENTRIES_PER_PAGE;
+  const uint32_t pageEntries = std::min(ENTRIES_PER_PAGE, entryCount - firstEntry);
+
+  FsFile file;
+  if (!Storage.openFileForRead("ZIP", indexPath, file)) {
+    return false;
+  }
+  Entry page[ENTRIES_PER_PAGE];
+  file.seek(entriesOffset + firstEntry * sizeof(Entry));
+  const size_t pageSize = pageEntries * sizeof(Entry);
+  const bool read = file.read(reinterpret_cast<uint8_t*>(page), pageSize) == static_cast<int>(pageSize);
+  file.close();
+  if (!read) {
+    return false;
+  }
+
+  const Entry* entry = std::lower_bound(page, page + pageEntries, hash,
+                                        [](const Entry& e, const uint64_t value) { return e.hash < value; });
+  if (entry == page + pageEntries || entry->hash != hash || entry->nameLen != nameLen) {
+    return false;
+  }
+
+  fileStat->method = entry->method;
+  fileStat->compressedSize = entry->compressedSize;
+  fileStat->uncompressedSize = entry->uncompressedSize;
+  fileStat->localHeaderOffset = entry->localHeaderOffset;
+  return true;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ZipFile.h"
+
+// On-disk index of a zip's central directory, sorted by the FNV-1a 64-bit hash of each entry name. The file holds a
+// header, the first hash of every page of entries and then the entries. load() keeps only the page hashes in RAM, so
+// resolving a name is a binary search over them, one seek to the page and a binary search within that page.
+class ZipIndex {
+ public:
+  // Scan the central directory of the zip once and write the index to indexPath
+  static bool build(const std::string& zipPath, const std::string& indexPath);
+  // Read the header and page hashes. Fails if the index is missing, from another version or made for a zip of a
+  // different size.
+  bool load(const std::string& indexPath, const std::string& zipPath);
+  bool isLoaded() const { return !pageHashes.empty(); }
+  // True when every entry of the zip is in the index, so a miss means the name is not in the zip. Entries whose
+  // hashes collide are left out of the index, and names that miss then have to be looked up in the central directory.
+  bool isComplete() const { return complete; }
+  bool find(const char* name, ZipFile::FileStatSlim* fileStat) const;
+
+ private:
+  struct Entry {
+    uint64_t hash;  // FNV-1a 64-bit hash of the entry name
+    uint16_t nameLen;
+    uint16_t method;
+    uint32_t compressedSize;
+    uint32_t uncompressedSize;
+    uint32_t localHeaderOffset;
+  };
+
+  static constexpr uint32_t ENTRIES_PER_PAGE = 32;
+
+  std::string indexPath;
+  std::vector<uint64_t> pageHashes;
+  uint32_t entryCount = 0;
+  uint32_t entriesOffset = 0;
+  bool complete = false;
+
+  static bool getZipSize(const std::string& zipPath, uint32_t* size);
+};
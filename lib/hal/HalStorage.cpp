@@ -6,7 +6,7 @@
 
 HalStorage HalStorage::instance;
 
-HalStorage::HalStorage() {}
+HalStorage::HalStorage() : mutex(xSemaphoreCreateMutex()) {}
 
 bool HalStorage::begin() { return SDCard.begin(); }
 
@@ -62,4 +62,8 @@ bool HalStorage::openFileForWrite(const char* moduleName, const String& path, Fs
   return openFileForWrite(moduleName, path.c_str(), file);
 }
 
-bool HalStorage::removeDir(const char* path) { return SDCard.removeDir(path); }
\ No newline at end of file
+bool HalStorage::removeDir(const char* path) { return SDCard.removeDir(path); }
+
+void HalStorage::lock() { xSemaphoreTake(mutex, portMAX_DELAY); }
+
+void HalStorage::unlock() { xSemaphoreGive(mutex); }
\ No newline at end of file
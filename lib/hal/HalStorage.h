@@ -1,6 +1,8 @@
 #pragma once
 
 #include <SDCardManager.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 
 #include <vector>
 
@@ -38,16 +40,32 @@ class HalStorage {
   bool openFileForWrite(const char* moduleName, const String& path, FsFile& file);
   bool removeDir(const char* path);
 
+  // SdFat is not thread-safe: code that can touch the card while another task does (the web server's handlers, its
+  // upload writer and download reader) holds this lock around each access. It is not recursive, so never wait for one
+  // of those tasks while holding it.
+  void lock();
+  void unlock();
+
   static HalStorage& getInstance() { return instance; }
 
  private:
   static HalStorage instance;
 
   bool initialized = false;
+  SemaphoreHandle_t mutex = nullptr;
 };
 
 #define Storage HalStorage::getInstance()
 
+// Holds the storage lock for its scope
+class StorageLock {
+ public:
+  StorageLock() { Storage.lock(); }
+  ~StorageLock() { Storage.unlock(); }
+  StorageLock(const StorageLock&) = delete;
+  StorageLock& operator=(const StorageLock&) = delete;
+};
+
 // Downstream code must use Storage instead of SdMan
 #ifdef SdMan
 #undef SdMan
@@ -18,6 +18,7 @@ typedef unsigned char uint8;
 typedef unsigned short uint16;
 typedef signed char int8;
 typedef signed short int16;
+typedef signed int int32;
 //------------------------------------------------------------------------------
 #if PJPG_RIGHT_SHIFT_IS_ALWAYS_UNSIGNED
 static int16 replicateSignBit16(int8 n) {
@@ -1606,6 +1607,45 @@ static void convertCr(uint8 dstOfs) {
   }
 }
 /*----------------------------------------------------------------------------*/
+// Scaled IDCT tables for the reduced luma modes, [x][u] = C(u) * cos((2x + 1) * u * pi / 2N) / s(u) in 1.10 fixed
+// point. Evaluating the 8-point IDCT of the low N x N coefficients at N evenly spaced points is an N-point IDCT; s(u)
+// removes the Winograd scale factors that createWinogradQuant() folded into the dequantized coefficients.
+static const int16 gLumaIDCT4[4][4] = {
+    {724, 682, 554, 333}, {724, 283, -554, -805}, {724, -283, -554, 805}, {724, -682, 554, -333}};
+static const int16 gLumaIDCT2[2][2] = {{724, 522}, {724, -522}};
+
+// Turn the current luma block into n x n pixels (n = 4, 2 or 1) in gMCUBufR
+static void transformBlockLuma(uint8 mcuBlock, uint8 n) {
+  // Luma blocks sit where transformBlock puts them: H1V2 stacks its two blocks at 0 and 128
+  uint8* pDst = gMCUBufR + (gScanType == PJPG_YH1V2 ? mcuBlock * 128 : mcuBlock * 64);
+  const int16* pTable = n == 4 ? &gLumaIDCT4[0][0] : &gLumaIDCT2[0][0];
+  int32 rows[4][4];
+  uint8 u, v, x, y;
+
+  if (n == 1) {
+    pDst[0] = clamp(PJPG_DESCALE(gCoeffBuf[0]) + 128);
+    return;
+  }
+
+  // Rows: rows[v][x] = sum over u of coeff(v, u) * table[x][u], back to the coefficient scale
+  for (v = 0; v < n; v++) {
+    for (x = 0; x < n; x++) {
+      int32 sum = 0;
+      for (u = 0; u < n; u++) sum += (int32)gCoeffBuf[v * 8 + u] * pTable[x * n + u];
+      rows[v][x] = (sum + 512) >> 10;
+    }
+  }
+
+  // Columns, then the 2D IDCT's 1/4 and the coefficients' 16x scale (the DC-only case is PJPG_DESCALE)
+  for (y = 0; y < n; y++) {
+    for (x = 0; x < n; x++) {
+      int32 sum = 0;
+      for (v = 0; v < n; v++) sum += rows[v][x] * pTable[y * n + v];
+      pDst[y * 8 + x] = clamp((int16)((sum + (1 << 15)) >> 16) + 128);
+    }
+  }
+}
+/*----------------------------------------------------------------------------*/
 static void transformBlock(uint8 mcuBlock) {
   idctRows();
   idctCols();
@@ -1941,7 +1981,8 @@ static uint8 decodeNextMCU(void) {
 
     compACTab = gCompACTab[componentID];
 
-    if (gReduce) {
+    // The reduced luma modes only need the AC coefficients of luma blocks, and none at 1/8 scale
+    if (gReduce == PJPG_REDUCE_DC || gReduce == PJPG_REDUCE_LUMA_8 || (gReduce != PJPG_REDUCE_NONE && componentID)) {
       // Decode, but throw out the AC coefficients in reduce mode.
       for (k = 1; k < 64; k++) {
         s = huffDecode(compACTab ? &gHuffTab3 : &gHuffTab2, compACTab ? gHuffVal3 : gHuffVal2);
@@ -1968,7 +2009,10 @@ static uint8 decodeNextMCU(void) {
         }
       }
 
-      transformBlockReduce(mcuBlock);
+      if (gReduce == PJPG_REDUCE_DC)
+        transformBlockReduce(mcuBlock);
+      else if (!componentID)
+        transformBlockLuma(mcuBlock, 1);
     } else {
       // Decode and dequantize AC coefficients
       for (k = 1; k < 64; k++) {
@@ -2012,7 +2056,12 @@ static uint8 decodeNextMCU(void) {
 
       while (k < 64) gCoeffBuf[ZAG[k++]] = 0;
 
-      transformBlock(mcuBlock);
+      if (gReduce == PJPG_REDUCE_LUMA_2)
+        transformBlockLuma(mcuBlock, 4);
+      else if (gReduce == PJPG_REDUCE_LUMA_4)
+        transformBlockLuma(mcuBlock, 2);
+      else
+        transformBlock(mcuBlock);
     }
   }
 
@@ -2085,3 +2134,5 @@ unsigned char pjpeg_decode_init(pjpeg_image_info_t* pInfo, pjpeg_need_bytes_call
 
   return 0;
 }
+//------------------------------------------------------------------------------
+void pjpeg_set_reduce(unsigned char reduce) { gReduce = reduce; }
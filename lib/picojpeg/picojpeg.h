@@ -105,13 +105,30 @@ typedef struct {
 typedef unsigned char (*pjpeg_need_bytes_callback_t)(unsigned char* pBuf, unsigned char buf_size,
                                                      unsigned char* pBytes_actually_read, void* pCallback_data);
 
+// Values for pjpeg_decode_init's reduce argument
+enum {
+  PJPG_REDUCE_NONE = 0,
+  // Only the first pixel (the DC value) of each block is decoded, in color
+  PJPG_REDUCE_DC = 1,
+  // Grayscale at 1/2, 1/4 or 1/8 scale: each luma block is turned into 4x4, 2x2 or 1x1 pixels by a scaled IDCT of
+  // its low-frequency coefficients, and chroma is only entropy-decoded. The pixels are stored in m_pMCUBufR at the
+  // top left of each block's usual 8x8 area.
+  PJPG_REDUCE_LUMA_2 = 2,
+  PJPG_REDUCE_LUMA_4 = 3,
+  PJPG_REDUCE_LUMA_8 = 4
+};
+
 // Initializes the decompressor. Returns 0 on success, or one of the above error codes on failure.
 // pNeed_bytes_callback will be called to fill the decompressor's internal input buffer.
-// If reduce is 1, only the first pixel of each block will be decoded. This mode is much faster because it skips the AC
+// reduce is one of the PJPG_REDUCE_ values. The reduced modes are much faster because they skip the AC
 // dequantization, IDCT and chroma upsampling of every image pixel. Not thread safe.
 unsigned char pjpeg_decode_init(pjpeg_image_info_t* pInfo, pjpeg_need_bytes_callback_t pNeed_bytes_callback,
                                 void* pCallback_data, unsigned char reduce);
 
+// Changes the reduce mode chosen in pjpeg_decode_init. Only valid before the first pjpeg_decode_mcu call, so the mode
+// can be picked from the image size the header reported without reading the stream twice.
+void pjpeg_set_reduce(unsigned char reduce);
+
 // Decompresses the file's next MCU. Returns 0 on success, PJPG_NO_MORE_BLOCKS if no more blocks are available, or an
 // error code. Must be called a total of m_MCUSPerRow*m_MCUSPerCol times to completely decompress the image. Not thread
 // safe.
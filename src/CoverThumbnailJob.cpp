@@ -0,0 +1,287 @@
+#include "CoverThumbnailJob.h"
+
+#include <Epub.h>
+#include <HalStorage.h>
+#include <HardwareSerial.h>
+#include <Xtc.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "RecentBooksStore.h"
+#include "util/StringUtils.h"
+
+namespace {
+constexpr char CACHE_DIR[] = "/.crosspoint";
+constexpr unsigned long STEP_GAP_MS = 20;            // Between steps, so the activity gets the mutex back quickly
+constexpr unsigned long IDLE_RESUME_MS = 5000;       // Quiet time before a paused job resumes
+constexpr unsigned long PROGRESS_RENDER_MS = 10000;  // Progress line refresh, each one is a screen update
+
+bool isEpub(const std::string& path) { return StringUtils::checkFileExtension(path, ".epub"); }
+bool isXtc(const std::string& path) {
+  return StringUtils::checkFileExtension(path, ".xtch") || StringUtils::checkFileExtension(path, ".xtc");
+}
+}  // namespace
+
+CoverThumbnailJob CoverThumbnailJob::instance;
+
+void CoverThumbnailJob::start(SemaphoreHandle_t renderingMutex, const int coverHeight,
+                              const std::vector<std::string>& priorityPaths) {
+  if (task) {
+    return;
+  }
+
+  mutex = renderingMutex;
+  this->priorityPaths = priorityPaths;
+  if (finished || coverHeight != this->coverHeight || (foldersToScan.empty() && books.empty())) {
+    // Fresh walk of the card
+    this->coverHeight = coverHeight;
+    foldersToScan.assign(1, "/");
+    books.clear();
+    booksDone = 0;
+    finished = false;
+  }
+  launch();
+}
+
+void CoverThumbnailJob::launch() {
+  // Priority books go right after the book in progress, in the order given. Whether they still need a thumbnail is
+  // only checked by the task, which owns the SD card while it holds the mutex.
+  std::vector<std::string> priority;
+  for (const std::string& path : priorityPaths) {
+    if ((!isEpub(path) && !isXtc(path)) ||
+        std::find(books.begin(), books.begin() + booksDone, path) != books.begin() + booksDone) {
+      continue;  // Not a book, or already handled before the job was paused
+    }
+    const auto queued = std::find(books.begin() + booksDone, books.end(), path);
+    if (queued != books.end()) {
+      books.erase(queued);
+    }
+    priority.push_back(path);
+  }
+  books.insert(books.begin() + booksDone, priority.begin(), priority.end());
+  priorityCount = booksDone + priority.size();
+  booksFound = books.size();
+
+  stopRequested = false;
+  xTaskCreate(&CoverThumbnailJob::taskTrampoline, "CoverThumbnailTask",
+              8192,  // Stack size
+              this,  // Parameters
+              0,     // Priority: only runs while the activity is otherwise idle
+              &task  // Task handle
+  );
+}
+
+void CoverThumbnailJob::stop() {
+  pause();
+  mutex = nullptr;
+}
+
+void CoverThumbnailJob::pause() {
+  if (!task) {
+    return;
+  }
+  stopRequested = true;
+  // The task only touches the SD card while holding the mutex, and drops what it was doing once stopRequested is set
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  if (task) {
+    vTaskDelete(task);
+    task = nullptr;
+  }
+  xSemaphoreGive(mutex);
+}
+
+void CoverThumbnailJob::tick(const bool inputSeen) {
+  if (inputSeen) {
+    lastInputTime = millis();
+    pause();
+  } else if (!task && mutex && !finished && millis() - lastInputTime >= IDLE_RESUME_MS) {
+    launch();
+  }
+}
+
+// The counts shown on the progress line, both 0 when there is nothing to show
+void CoverThumbnailJob::visibleProgress(size_t& done, size_t& found) const {
+  done = booksDone;
+  found = booksFound;
+  if (finished || done >= found) {
+    done = 0;
+    found = 0;
+  }
+}
+
+bool CoverThumbnailJob::progressChanged() const {
+  size_t done;
+  size_t found;
+  visibleProgress(done, found);
+  if (done == renderedDone && found == renderedFound) {
+    return false;
+  }
+  // Always clear the line once the job is done
+  return finished || millis() - lastProgressRenderTime >= PROGRESS_RENDER_MS;
+}
+
+std::string CoverThumbnailJob::renderProgressText() {
+  visibleProgress(renderedDone, renderedFound);
+  lastProgressRenderTime = millis();
+  if (renderedFound == 0) {
+    return "";
+  }
+  return "Preparing covers " + std::to_string(renderedDone) + "/" + std::to_string(renderedFound);
+}
+
+void CoverThumbnailJob::taskTrampoline(void* param) {
+  auto* self = static_cast<CoverThumbnailJob*>(param);
+  self->taskLoop();
+}
+
+void CoverThumbnailJob::taskLoop() {
+  Serial.printf("[%lu] [THM] Cover thumbnail job running, %u of %u books done\n", millis(), booksDone, booksFound);
+
+  bool more = true;
+  while (more) {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    more = !stopRequested && step();
+    if (!more) {
+      task = nullptr;
+    }
+    xSemaphoreGive(mutex);
+
+    if (more) {
+      vTaskDelay(STEP_GAP_MS / portTICK_PERIOD_MS);
+    }
+  }
+  vTaskDelete(nullptr);
+}
+
+// Called with the mutex held: list one folder, or generate one book's thumbnail. Returns false once there is nothing
+// left to do (or stop was requested).
+bool CoverThumbnailJob::step() {
+  if (!foldersToScan.empty()) {
+    const std::string folder = foldersToScan.back();
+    foldersToScan.pop_back();
+    if (!scanFolder(folder)) {
+      foldersToScan.push_back(folder);
+      return false;
+    }
+    return true;
+  }
+
+  if (booksDone < books.size()) {
+    generateThumb(books[booksDone]);
+    if (stopRequested) {
+      return false;
+    }
+    booksDone = booksDone + 1;
+    return true;
+  }
+
+  Serial.printf("[%lu] [THM] Cover thumbnail job finished, %u books\n", millis(), books.size());
+  books.clear();
+  books.shrink_to_fit();
+  priorityCount = 0;
+  booksDone = 0;
+  booksFound = 0;
+  finished = true;
+  return false;
+}
+
+// Queue the folder's books that lack a thumbnail and remember its subfolders. Returns false, queueing nothing, if
+// stopped part way.
+bool CoverThumbnailJob::scanFolder(const std::string& folder) {
+  auto dir = Storage.open(folder.c_str());
+  if (!dir || !dir.isDirectory()) {
+    if (dir) dir.close();
+    return true;
+  }
+
+  const std::string prefix = folder == "/" ? folder : folder + "/";
+  const size_t foldersBefore = foldersToScan.size();
+  const size_t booksBefore = books.size();
+  char name[500];
+  for (auto file = dir.openNextFile(); file; file = dir.openNextFile()) {
+    file.getName(name, sizeof(name));
+    const bool isDirectory = file.isDirectory();
+    file.close();
+    if (stopRequested) {
+      foldersToScan.resize(foldersBefore);
+      books.resize(booksBefore);
+      dir.close();
+      return false;
+    }
+    if (name[0] == '.' || strcmp(name, "System Volume Information") == 0) {
+      continue;
+    }
+
+    const std::string path = prefix + name;
+    if (isDirectory) {
+      foldersToScan.push_back(path);
+    } else if ((isEpub(path) || isXtc(path)) && needsThumb(path) &&
+               std::find(books.begin(), books.begin() + priorityCount, path) == books.begin() + priorityCount) {
+      books.push_back(path);
+    }
+  }
+  dir.close();
+  booksFound = books.size();
+  return true;
+}
+
+bool CoverThumbnailJob::needsThumb(const std::string& path) const {
+  if (isEpub(path)) {
+    return !Storage.exists(Epub(path, CACHE_DIR).getThumbBmpPath(coverHeight).c_str());
+  }
+  return !Storage.exists(Xtc(path, CACHE_DIR).getThumbBmpPath(coverHeight).c_str());
+}
+
+void CoverThumbnailJob::generateThumb(const std::string& path) const {
+  if (!needsThumb(path)) {
+    return;
+  }
+
+  const unsigned long start = millis();
+  bool success = false;
+  std::string thumbPath;
+
+  if (isEpub(path)) {
+    Epub epub(path, CACHE_DIR);
+    thumbPath = epub.getThumbBmpPath(coverHeight);
+    // Skip loading css since we only need metadata here
+    if (epub.load(true, true) && !stopRequested) {
+      success = epub.generateThumbBmp(coverHeight, [this] { return stopRequested; });
+    }
+    if (!success) {
+      epub.setupCacheDir();
+    }
+  } else {
+    Xtc xtc(path, CACHE_DIR);
+    thumbPath = xtc.getThumbBmpPath(coverHeight);
+    if (xtc.load() && !stopRequested) {
+      success = xtc.generateThumbBmp(coverHeight);
+    }
+    if (!success) {
+      xtc.setupCacheDir();
+    }
+  }
+
+  if (stopRequested) {
+    return;
+  }
+  if (!success && !Storage.exists(thumbPath.c_str())) {
+    // Write an empty bmp file to avoid generation attempts in the future
+    FsFile thumbBmp;
+    Storage.openFileForWrite("THM", thumbPath, thumbBmp);
+    thumbBmp.close();
+  }
+  if (!success) {
+    // A recent book without a cover is shown without one on the home screen
+    const auto& recentBooks = RECENT_BOOKS.getBooks();
+    const auto recent = std::find_if(recentBooks.begin(), recentBooks.end(),
+                                     [&path](const RecentBook& book) { return book.path == path; });
+    if (recent != recentBooks.end() && !recent->coverBmpPath.empty()) {
+      const RecentBook book = *recent;
+      RECENT_BOOKS.updateBook(book.path, book.title, book.author, "");
+    }
+  }
+  Serial.printf("[%lu] [THM] %s: %s in %lu ms\n", millis(), path.c_str(), success ? "generated" : "no cover",
+                millis() - start);
+}
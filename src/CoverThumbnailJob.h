@@ -0,0 +1,85 @@
+#pragma once
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * Generates the missing home screen thumbnails of every EPUB and XTC book on the SD card in the background.
+ *
+ * The job walks the card one folder at a time, then decodes one book's cover at a time, from a priority-0 task. Each
+ * step runs with the owning activity's rendering mutex held, so the job never uses the SD card at the same time as the
+ * activity. stop() aborts the step in progress (the cover decode included) and keeps the job's place: the next start()
+ * carries on with the same book. A thumbnail that cannot be generated is written as an empty file, like
+ * Epub::generateThumbBmp() does, so it is not retried, and a recent book without a cover loses its cover path.
+ *
+ * The owning activity calls tick() from its loop(): any button press pauses the job, which resumes on its own once the
+ * buttons have been left alone for a while.
+ */
+class CoverThumbnailJob {
+  // Static instance
+  static CoverThumbnailJob instance;
+
+  TaskHandle_t task = nullptr;
+  SemaphoreHandle_t mutex = nullptr;
+  volatile bool stopRequested = false;
+
+  int coverHeight = 0;
+  std::vector<std::string> priorityPaths;  // As given to start(), for resuming after input
+  unsigned long lastInputTime = 0;
+  std::vector<std::string> foldersToScan;  // Folders not listed yet
+  std::vector<std::string> books;          // Books found without a thumbnail, priority books first
+  size_t priorityCount = 0;
+  volatile size_t booksDone = 0;
+  volatile size_t booksFound = 0;
+  volatile bool finished = false;
+
+  // Progress as last drawn by the activity, see renderProgressText()
+  size_t renderedDone = 0;
+  size_t renderedFound = 0;
+  unsigned long lastProgressRenderTime = 0;
+
+  static void taskTrampoline(void* param);
+  void taskLoop();
+  void launch();
+  void pause();
+  void visibleProgress(size_t& done, size_t& found) const;
+  bool step();
+  bool scanFolder(const std::string& folder);
+  void generateThumb(const std::string& path) const;
+  bool needsThumb(const std::string& path) const;
+
+ public:
+  // Get singleton instance
+  static CoverThumbnailJob& getInstance() { return instance; }
+
+  // Start or resume generating `coverHeight` thumbnails. `priorityPaths` (e.g. the recent books) are handled before the
+  // rest of the library. A job that finished earlier scans the card again, since books may have been added.
+  void start(SemaphoreHandle_t renderingMutex, int coverHeight, const std::vector<std::string>& priorityPaths = {});
+
+  // Abort the current step and wait until the task is gone. Must be called before the mutex is deleted, and before
+  // the caller uses the SD card itself. The job is not resumed by tick() until the next start().
+  void stop();
+
+  // Called from the activity's loop(): pauses the job while buttons are being used, so the activity gets the SD card,
+  // and resumes it after a few seconds without input
+  void tick(bool inputSeen);
+
+  bool isRunning() const { return task != nullptr; }
+  bool isFinished() const { return finished; }
+  size_t getDone() const { return booksDone; }
+  // Priority books still waiting for their thumbnail
+  size_t getPriorityRemaining() const { return booksDone < priorityCount ? priorityCount - booksDone : 0; }
+
+  // The progress line needs redrawing: it changed since renderProgressText(), and either the job just finished or
+  // the last redraw (a screen update each) was a while ago
+  bool progressChanged() const;
+  // "Preparing covers 3/40" while books are waiting, otherwise empty. Called when drawing it.
+  std::string renderProgressText();
+};
+
+// Helper macro to access the cover thumbnail job
+#define COVER_THUMBNAILS CoverThumbnailJob::getInstance()
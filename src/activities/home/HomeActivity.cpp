@@ -1,23 +1,22 @@
 #include "HomeActivity.h"
 
 #include <Bitmap.h>
-#include <Epub.h>
 #include <GfxRenderer.h>
 #include <HalStorage.h>
 #include <Utf8.h>
-#include <Xtc.h>
 
+#include <algorithm>
 #include <cstring>
 #include <vector>
 
 #include "Battery.h"
+#include "CoverThumbnailJob.h"
 #include "CrossPointSettings.h"
 #include "CrossPointState.h"
 #include "MappedInputManager.h"
 #include "RecentBooksStore.h"
 #include "components/UITheme.h"
 #include "fontIds.h"
-#include "util/StringUtils.h"
 
 void HomeActivity::taskTrampoline(void* param) {
   auto* self = static_cast<HomeActivity*>(param);
@@ -35,8 +34,9 @@ int HomeActivity::getMenuItemCount() const {
   return count;
 }
 
-void HomeActivity::loadRecentBooks(int maxBooks) {
+void HomeActivity::loadRecentBooks(const int maxBooks, const int coverHeight) {
   recentBooks.clear();
+  recentCoversPending = false;
   const auto& books = RECENT_BOOKS.getBooks();
   recentBooks.reserve(std::min(static_cast<int>(books.size()), maxBooks));
 
@@ -52,65 +52,41 @@ void HomeActivity::loadRecentBooks(int maxBooks) {
     }
 
     recentBooks.push_back(book);
+    if (!book.coverBmpPath.empty()) {
+      const std::string coverPath = UITheme::getCoverThumbPath(book.coverBmpPath, coverHeight);
+      recentCoversPending = recentCoversPending || !Storage.exists(coverPath.c_str());
+    }
   }
 }
 
-void HomeActivity::loadRecentCovers(int coverHeight) {
-  recentsLoading = true;
-  bool showingLoading = false;
-  Rect popupRect;
+void HomeActivity::startCoverJob() {
+  std::vector<std::string> recentPaths;
+  recentPaths.reserve(recentBooks.size());
+  for (const RecentBook& book : recentBooks) {
+    recentPaths.push_back(book.path);
+  }
+  COVER_THUMBNAILS.start(renderingMutex, UITheme::getInstance().getMetrics().homeCoverHeight, recentPaths);
+}
 
-  int progress = 0;
-  for (RecentBook& book : recentBooks) {
-    if (!book.coverBmpPath.empty()) {
-      std::string coverPath = UITheme::getCoverThumbPath(book.coverBmpPath, coverHeight);
-      if (!Storage.exists(coverPath.c_str())) {
-        // If epub, try to load the metadata for title/author and cover
-        if (StringUtils::checkFileExtension(book.path, ".epub")) {
-          Epub epub(book.path, "/.crosspoint");
-          // Skip loading css since we only need metadata here
-          epub.load(false, true);
-
-          // Try to generate thumbnail image for Continue Reading card
-          if (!showingLoading) {
-            showingLoading = true;
-            popupRect = GUI.drawPopup(renderer, "Loading...");
-          }
-          GUI.fillPopupProgress(renderer, popupRect, 10 + progress * (90 / recentBooks.size()));
-          bool success = epub.generateThumbBmp(coverHeight);
-          if (!success) {
-            RECENT_BOOKS.updateBook(book.path, book.title, book.author, "");
-            book.coverBmpPath = "";
-          }
-          coverRendered = false;
-          updateRequired = true;
-        } else if (StringUtils::checkFileExtension(book.path, ".xtch") ||
-                   StringUtils::checkFileExtension(book.path, ".xtc")) {
-          // Handle XTC file
-          Xtc xtc(book.path, "/.crosspoint");
-          if (xtc.load()) {
-            // Try to generate thumbnail image for Continue Reading card
-            if (!showingLoading) {
-              showingLoading = true;
-              popupRect = GUI.drawPopup(renderer, "Loading...");
-            }
-            GUI.fillPopupProgress(renderer, popupRect, 10 + progress * (90 / recentBooks.size()));
-            bool success = xtc.generateThumbBmp(coverHeight);
-            if (!success) {
-              RECENT_BOOKS.updateBook(book.path, book.title, book.author, "");
-              book.coverBmpPath = "";
-            }
-            coverRendered = false;
-            updateRequired = true;
-          }
-        }
+// Redraw the cover once the recent books' thumbnails exist, and the progress line when the job says so
+void HomeActivity::checkCoverJobProgress() {
+  if (recentCoversPending && COVER_THUMBNAILS.getPriorityRemaining() == 0) {
+    recentCoversPending = false;
+    // Books whose cover could not be decoded lost their cover path in the store
+    xSemaphoreTake(renderingMutex, portMAX_DELAY);
+    for (RecentBook& book : recentBooks) {
+      const auto& stored = RECENT_BOOKS.getBooks();
+      const auto it = std::find(stored.begin(), stored.end(), book);
+      if (it != stored.end()) {
+        book.coverBmpPath = it->coverBmpPath;
       }
     }
-    progress++;
+    xSemaphoreGive(renderingMutex);
+    coverRendered = false;
+    updateRequired = true;
+  } else if (COVER_THUMBNAILS.progressChanged()) {
+    updateRequired = true;
   }
-
-  recentsLoaded = true;
-  recentsLoading = false;
 }
 
 void HomeActivity::onEnter() {
@@ -124,7 +100,10 @@ void HomeActivity::onEnter() {
   selectorIndex = 0;
 
   auto metrics = UITheme::getInstance().getMetrics();
-  loadRecentBooks(metrics.homeRecentBooksCount);
+  loadRecentBooks(metrics.homeRecentBooksCount, metrics.homeCoverHeight);
+
+  // Covers missing from the library are generated in the background, the recent books' first
+  startCoverJob();
 
   // Trigger first update
   updateRequired = true;
@@ -140,6 +119,9 @@ void HomeActivity::onEnter() {
 void HomeActivity::onExit() {
   Activity::onExit();
 
+  // The job uses our mutex, and the next activity will want the SD card
+  COVER_THUMBNAILS.stop();
+
   // Wait until not rendering to delete task to avoid killing mid-instruction to EPD
   xSemaphoreTake(renderingMutex, portMAX_DELAY);
   if (displayTaskHandle) {
@@ -196,6 +178,9 @@ void HomeActivity::freeCoverBuffer() {
 }
 
 void HomeActivity::loop() {
+  // Any button hands the SD card back to us
+  COVER_THUMBNAILS.tick(mappedInput.wasAnyPressed() || mappedInput.wasAnyReleased());
+
   const int menuCount = getMenuItemCount();
 
   buttonNavigator.onNext([this, menuCount] {
@@ -236,6 +221,7 @@ void HomeActivity::loop() {
 
 void HomeActivity::displayTaskLoop() {
   while (true) {
+    checkCoverJobProgress();
     if (updateRequired) {
       updateRequired = false;
       xSemaphoreTake(renderingMutex, portMAX_DELAY);
@@ -278,13 +264,17 @@ void HomeActivity::render() {
   const auto labels = mappedInput.mapLabels("", "Select", "Up", "Down");
   GUI.drawButtonHints(renderer, labels.btn1, labels.btn2, labels.btn3, labels.btn4);
 
+  const std::string coverProgress = COVER_THUMBNAILS.renderProgressText();
+  if (!coverProgress.empty()) {
+    renderer.drawCenteredText(SMALL_FONT_ID,
+                              pageHeight - metrics.buttonHintsHeight - renderer.getLineHeight(SMALL_FONT_ID),
+                              coverProgress.c_str());
+  }
+
   renderer.displayBuffer();
 
   if (!firstRenderDone) {
     firstRenderDone = true;
     updateRequired = true;
-  } else if (!recentsLoaded && !recentsLoading) {
-    recentsLoading = true;
-    loadRecentCovers(metrics.homeCoverHeight);
   }
 }
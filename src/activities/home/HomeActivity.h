@@ -19,9 +19,8 @@ class HomeActivity final : public Activity {
   ButtonNavigator buttonNavigator;
   int selectorIndex = 0;
   bool updateRequired = false;
-  bool recentsLoading = false;
-  bool recentsLoaded = false;
   bool firstRenderDone = false;
+  bool recentCoversPending = false;  // A recent book's thumbnail is still being generated
   bool hasOpdsUrl = false;
   bool coverRendered = false;      // Track if cover has been rendered once
   bool coverBufferStored = false;  // Track if cover buffer is stored
@@ -41,8 +40,9 @@ class HomeActivity final : public Activity {
   bool storeCoverBuffer();    // Store frame buffer for cover image
   bool restoreCoverBuffer();  // Restore frame buffer from stored cover
   void freeCoverBuffer();     // Free the stored cover buffer
-  void loadRecentBooks(int maxBooks);
-  void loadRecentCovers(int coverHeight);
+  void loadRecentBooks(int maxBooks, int coverHeight);
+  void startCoverJob();
+  void checkCoverJobProgress();
 
  public:
   explicit HomeActivity(GfxRenderer& renderer, MappedInputManager& mappedInput,
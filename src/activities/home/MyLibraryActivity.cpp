@@ -5,6 +5,7 @@
 
 #include <algorithm>
 
+#include "CoverThumbnailJob.h"
 #include "MappedInputManager.h"
 #include "components/UITheme.h"
 #include "fontIds.h"
@@ -71,6 +72,9 @@ void MyLibraryActivity::onEnter() {
 
   loadFiles();
 
+  // Carry on generating the library's missing covers while the list is idle
+  COVER_THUMBNAILS.start(renderingMutex, UITheme::getInstance().getMetrics().homeCoverHeight);
+
   selectorIndex = 0;
   updateRequired = true;
 
@@ -85,6 +89,9 @@ void MyLibraryActivity::onEnter() {
 void MyLibraryActivity::onExit() {
   Activity::onExit();
 
+  // The job uses our mutex, and the next activity will want the SD card
+  COVER_THUMBNAILS.stop();
+
   // Wait until not rendering to delete task to avoid killing mid-instruction to EPD
   xSemaphoreTake(renderingMutex, portMAX_DELAY);
   if (displayTaskHandle) {
@@ -98,6 +105,9 @@ void MyLibraryActivity::onExit() {
 }
 
 void MyLibraryActivity::loop() {
+  // Any button hands the SD card back to us (folders are listed from here)
+  COVER_THUMBNAILS.tick(mappedInput.wasAnyPressed() || mappedInput.wasAnyReleased());
+
   // Long press BACK (1s+) goes to root folder
   if (mappedInput.isPressed(MappedInputManager::Button::Back) && mappedInput.getHeldTime() >= GO_HOME_MS &&
       basepath != "/") {
@@ -173,6 +183,9 @@ void MyLibraryActivity::loop() {
 
 void MyLibraryActivity::displayTaskLoop() {
   while (true) {
+    if (COVER_THUMBNAILS.progressChanged()) {
+      updateRequired = true;
+    }
     if (updateRequired) {
       updateRequired = false;
       xSemaphoreTake(renderingMutex, portMAX_DELAY);
@@ -183,7 +196,7 @@ void MyLibraryActivity::displayTaskLoop() {
   }
 }
 
-void MyLibraryActivity::render() const {
+void MyLibraryActivity::render() {
   renderer.clearScreen();
 
   const auto pageWidth = renderer.getScreenWidth();
@@ -194,7 +207,15 @@ void MyLibraryActivity::render() const {
   GUI.drawHeader(renderer, Rect{0, metrics.topPadding, pageWidth, metrics.headerHeight}, folderName);
 
   const int contentTop = metrics.topPadding + metrics.headerHeight + metrics.verticalSpacing;
-  const int contentHeight = pageHeight - contentTop - metrics.buttonHintsHeight - metrics.verticalSpacing;
+  int contentHeight = pageHeight - contentTop - metrics.buttonHintsHeight - metrics.verticalSpacing;
+
+  const std::string coverProgress = COVER_THUMBNAILS.renderProgressText();
+  if (!coverProgress.empty()) {
+    const int lineHeight = renderer.getLineHeight(SMALL_FONT_ID);
+    contentHeight -= lineHeight;
+    renderer.drawCenteredText(SMALL_FONT_ID, pageHeight - metrics.buttonHintsHeight - lineHeight,
+                              coverProgress.c_str());
+  }
   if (files.empty()) {
     renderer.drawText(UI_10_FONT_ID, metrics.contentSidePadding, contentTop + 20, "No books found");
   } else {
@@ -30,7 +30,7 @@ class MyLibraryActivity final : public Activity {
 
   static void taskTrampoline(void* param);
   [[noreturn]] void displayTaskLoop();
-  void render() const;
+  void render();
 
   // Data loading
   void loadFiles();
@@ -13,8 +13,10 @@
 #include "CrossPointState.h"
 #include "EpubReaderChapterSelectionActivity.h"
 #include "EpubReaderPercentSelectionActivity.h"
+#if CROSSPOINT_EMULATED == 0
 #include "KOReaderCredentialStore.h"
 #include "KOReaderSyncActivity.h"
+#endif
 #include "MappedInputManager.h"
 #include "RecentBooksStore.h"
 #include "components/UITheme.h"
@@ -32,6 +34,12 @@ constexpr unsigned long doubleClickMs = 400;
 static bool showHelpOverlay = false;
 static bool isNightMode = false;
 
+// Background pre-pagination: wait this long after a page is shown before touching the SD card, only start with this
+// much free heap and give up if the build drags free heap below the floor
+constexpr unsigned long prefetchIdleDelayMs = 1000;
+constexpr uint32_t prefetchMinFreeHeap = 64 * 1024;
+constexpr uint32_t prefetchHeapFloor = 32 * 1024;
+
 constexpr int statusBarMargin = 19;
 constexpr int progressBarMarginTop = 1;
 
@@ -121,6 +129,11 @@ void EpubReaderActivity::taskTrampoline(void* param) {
   self->displayTaskLoop();
 }
 
+void EpubReaderActivity::prefetchTaskTrampoline(void* param) {
+  auto* self = static_cast<EpubReaderActivity*>(param);
+  self->prefetchTask();
+}
+
 void EpubReaderActivity::onEnter() {
   ActivityWithSubactivity::onEnter();
 
@@ -178,11 +191,17 @@ void EpubReaderActivity::onExit() {
 
   renderer.setOrientation(GfxRenderer::Orientation::Portrait);
 
+  // A running background build stops at its next chunk and releases the mutex
+  cancelPrefetch();
   xSemaphoreTake(renderingMutex, portMAX_DELAY);
   if (displayTaskHandle) {
     vTaskDelete(displayTaskHandle);
     displayTaskHandle = nullptr;
   }
+  if (prefetchTaskHandle) {
+    vTaskDelete(prefetchTaskHandle);
+    prefetchTaskHandle = nullptr;
+  }
   vSemaphoreDelete(renderingMutex);
   renderingMutex = nullptr;
   APP_STATE.readerActivityLoadCount = 0;
@@ -192,6 +211,11 @@ void EpubReaderActivity::onExit() {
 }
 
 void EpubReaderActivity::loop() {
+  // Any input may need the SD card or a redraw, so stop background pre-pagination right away
+  if (mappedInput.wasAnyPressed()) {
+    cancelPrefetch();
+  }
+
   // --- POPUP AUTO-DISMISS ---
   static unsigned long clearPopupTimer = 0;
   if (clearPopupTimer > 0 && millis() > clearPopupTimer) {
@@ -268,6 +292,10 @@ void EpubReaderActivity::loop() {
     }
 
     xSemaphoreTake(renderingMutex, portMAX_DELAY);
+    // The menu and everything reached from it work with the chapter's final page count
+    if (section && section->isBuilding()) {
+      buildSectionUntil(-1, nullptr);
+    }
     const int currentPage = section ? section->currentPage + 1 : 0;
     const int totalPages = section ? section->pageCount : 0;
     float bookProgress = 0.0f;
@@ -353,7 +381,7 @@ void EpubReaderActivity::loop() {
       xSemaphoreTake(renderingMutex, portMAX_DELAY);
       if (section) {
         cachedSpineIndex = currentSpineIndex;
-        cachedChapterTotalPageCount = section->pageCount;
+        cachedChapterTotalPageCount = finalPageCount();
         nextPageNumber = section->currentPage;
       }
       SETTINGS.lineSpacing++;
@@ -380,7 +408,7 @@ void EpubReaderActivity::loop() {
         xSemaphoreTake(renderingMutex, portMAX_DELAY);
         if (section) {
           cachedSpineIndex = currentSpineIndex;
-          cachedChapterTotalPageCount = section->pageCount;
+          cachedChapterTotalPageCount = finalPageCount();
           nextPageNumber = section->currentPage;
         }
         if (SETTINGS.paragraphAlignment == CrossPointSettings::PARAGRAPH_ALIGNMENT::LEFT_ALIGN) {
@@ -425,7 +453,7 @@ void EpubReaderActivity::loop() {
     if (changed) {
       if (section) {
         cachedSpineIndex = currentSpineIndex;
-        cachedChapterTotalPageCount = section->pageCount;
+        cachedChapterTotalPageCount = finalPageCount();
         nextPageNumber = section->currentPage;
       }
       SETTINGS.saveToFile();
@@ -464,7 +492,7 @@ void EpubReaderActivity::loop() {
 
         if (section) {
           cachedSpineIndex = currentSpineIndex;
-          cachedChapterTotalPageCount = section->pageCount;
+          cachedChapterTotalPageCount = finalPageCount();
           nextPageNumber = section->currentPage;
         }
 
@@ -476,7 +504,7 @@ void EpubReaderActivity::loop() {
         if (epub) {
           uint16_t backupSpine = currentSpineIndex;
           uint16_t backupPage = section ? section->currentPage : 0;
-          uint16_t backupPageCount = section ? section->pageCount : 0;
+          uint16_t backupPageCount = finalPageCount();
 
           section.reset();
           saveProgress(backupSpine, backupPage, backupPageCount);
@@ -518,7 +546,7 @@ void EpubReaderActivity::loop() {
     if (changed) {
       if (section) {
         cachedSpineIndex = currentSpineIndex;
-        cachedChapterTotalPageCount = section->pageCount;
+        cachedChapterTotalPageCount = finalPageCount();
         nextPageNumber = section->currentPage;
       }
       SETTINGS.saveToFile();
@@ -594,15 +622,18 @@ void EpubReaderActivity::loop() {
     }
     updateRequired = true;
   } else {
-    if (section->currentPage < section->pageCount - 1) {
+    // The background build changes pageCount as it lays out pages; stop it at its current chunk
+    cancelPrefetch();
+    xSemaphoreTake(renderingMutex, portMAX_DELAY);
+    // Pages past the ones laid out so far are built on demand; renderScreen moves on if the chapter ends first
+    if (section->currentPage < section->pageCount - 1 || section->isBuilding()) {
       section->currentPage++;
     } else {
-      xSemaphoreTake(renderingMutex, portMAX_DELAY);
       nextPageNumber = 0;
       currentSpineIndex++;
       section.reset();
-      xSemaphoreGive(renderingMutex);
     }
+    xSemaphoreGive(renderingMutex);
     updateRequired = true;
   }
 }
@@ -636,17 +667,8 @@ void EpubReaderActivity::jumpToPercent(int percent) {
     return;
   }
 
-  int targetSpineIndex = spineCount - 1;
-  size_t prevCumulative = 0;
-
-  for (int i = 0; i < spineCount; i++) {
-    const size_t cumulative = epub->getCumulativeSpineItemSize(i);
-    if (targetSize <= cumulative) {
-      targetSpineIndex = i;
-      prevCumulative = (i > 0) ? epub->getCumulativeSpineItemSize(i - 1) : 0;
-      break;
-    }
-  }
+  const int targetSpineIndex = std::min(epub->getSpineIndexForBookOffset(targetSize), spineCount - 1);
+  const size_t prevCumulative = (targetSpineIndex > 0) ? epub->getCumulativeSpineItemSize(targetSpineIndex - 1) : 0;
 
   const size_t cumulative = epub->getCumulativeSpineItemSize(targetSpineIndex);
   const size_t spineSize = (cumulative > prevCumulative) ? (cumulative - prevCumulative) : 0;
@@ -669,12 +691,12 @@ void EpubReaderActivity::jumpToPercent(int percent) {
 void EpubReaderActivity::onReaderMenuConfirm(EpubReaderMenuActivity::MenuAction action) {
   switch (action) {
     case EpubReaderMenuActivity::MenuAction::SELECT_CHAPTER: {
+      xSemaphoreTake(renderingMutex, portMAX_DELAY);
       const int currentP = section ? section->currentPage : 0;
-      const int totalP = section ? section->pageCount : 0;
+      const int totalP = finalPageCount();
       const int spineIdx = currentSpineIndex;
       const std::string path = epub->getPath();
 
-      xSemaphoreTake(renderingMutex, portMAX_DELAY);
       exitActivity();
       enterNewActivity(new EpubReaderChapterSelectionActivity(
           this->renderer, this->mappedInput, epub, path, spineIdx, currentP, totalP,
@@ -704,13 +726,14 @@ void EpubReaderActivity::onReaderMenuConfirm(EpubReaderMenuActivity::MenuAction
       break;
     }
     case EpubReaderMenuActivity::MenuAction::GO_TO_PERCENT: {
+      xSemaphoreTake(renderingMutex, portMAX_DELAY);
       float bookProgress = 0.0f;
       if (epub && epub->getBookSize() > 0 && section && section->pageCount > 0) {
-        const float chapterProgress = static_cast<float>(section->currentPage) / static_cast<float>(section->pageCount);
+        const float chapterProgress =
+            static_cast<float>(section->currentPage) / static_cast<float>(section->estimatedPageCount());
         bookProgress = epub->calculateProgress(currentSpineIndex, chapterProgress) * 100.0f;
       }
       const int initialPercent = clampPercent(static_cast<int>(bookProgress + 0.5f));
-      xSemaphoreTake(renderingMutex, portMAX_DELAY);
       exitActivity();
       enterNewActivity(new EpubReaderPercentSelectionActivity(
           renderer, mappedInput, initialPercent,
@@ -735,7 +758,7 @@ void EpubReaderActivity::onReaderMenuConfirm(EpubReaderMenuActivity::MenuAction
       if (epub) {
         uint16_t backupSpine = currentSpineIndex;
         uint16_t backupPage = section->currentPage;
-        uint16_t backupPageCount = section->pageCount;
+        uint16_t backupPageCount = finalPageCount();
 
         section.reset();
         epub->clearCache();
@@ -748,10 +771,11 @@ void EpubReaderActivity::onReaderMenuConfirm(EpubReaderMenuActivity::MenuAction
       break;
     }
     case EpubReaderMenuActivity::MenuAction::SYNC: {
+#if CROSSPOINT_EMULATED == 0
       if (KOREADER_STORE.hasCredentials()) {
         xSemaphoreTake(renderingMutex, portMAX_DELAY);
         const int currentPage = section ? section->currentPage : 0;
-        const int totalPages = section ? section->pageCount : 0;
+        const int totalPages = finalPageCount();
         exitActivity();
         enterNewActivity(new KOReaderSyncActivity(
             renderer, mappedInput, epub, epub->getPath(), currentSpineIndex, currentPage, totalPages,
@@ -766,6 +790,7 @@ void EpubReaderActivity::onReaderMenuConfirm(EpubReaderMenuActivity::MenuAction
             }));
         xSemaphoreGive(renderingMutex);
       }
+#endif
       break;
     }
     case EpubReaderMenuActivity::MenuAction::BUTTON_MOD_SETTINGS: {
@@ -790,7 +815,7 @@ void EpubReaderActivity::applyOrientation(const uint8_t orientation) {
   xSemaphoreTake(renderingMutex, portMAX_DELAY);
   if (section) {
     cachedSpineIndex = currentSpineIndex;
-    cachedChapterTotalPageCount = section->pageCount;
+    cachedChapterTotalPageCount = finalPageCount();
     nextPageNumber = section->currentPage;
   }
 
@@ -807,14 +832,113 @@ void EpubReaderActivity::displayTaskLoop() {
   while (true) {
     if (updateRequired) {
       updateRequired = false;
+      cancelPrefetch();
       xSemaphoreTake(renderingMutex, portMAX_DELAY);
       renderScreen();
+      schedulePrefetch();
       xSemaphoreGive(renderingMutex);
     }
     vTaskDelay(10 / portTICK_PERIOD_MS);
   }
 }
 
+// Called with the rendering mutex held, right after a page has been displayed
+void EpubReaderActivity::schedulePrefetch() {
+  if (!section || subActivity || (prefetchDoneSpineIndex == currentSpineIndex && !section->isBuilding())) {
+    return;
+  }
+
+  // A worker still waiting for its idle delay or for the mutex picks up the current chapter
+  prefetchCancelRequested = false;
+  if (prefetchTaskHandle) {
+    return;
+  }
+
+  if (ESP.getFreeHeap() < prefetchMinFreeHeap) {
+    Serial.printf("[%lu] [ERS] Skipping pre-pagination, free heap %d bytes\n", millis(), ESP.getFreeHeap());
+    return;
+  }
+
+  if (xTaskCreate(&EpubReaderActivity::prefetchTaskTrampoline, "EpubPrefetchTask", 8192, this, 0,
+                  &prefetchTaskHandle) != pdPASS) {
+    Serial.printf("[%lu] [ERS] Could not start pre-pagination task\n", millis());
+    prefetchTaskHandle = nullptr;
+  }
+}
+
+void EpubReaderActivity::prefetchTask() {
+  // Let quick successive page turns cancel before any SD work starts
+  const unsigned long start = millis();
+  while (!prefetchCancelRequested && millis() - start < prefetchIdleDelayMs) {
+    vTaskDelay(50 / portTICK_PERIOD_MS);
+  }
+
+  // Holding the mutex keeps the SD card, fonts and globalForceBold to ourselves; input and redraws cancel the build
+  // so they only ever wait for the chunk being parsed
+  xSemaphoreTake(renderingMutex, portMAX_DELAY);
+  if (!prefetchCancelRequested && section && !subActivity && epub) {
+    const auto pauseFn = [this]() { return prefetchCancelRequested || ESP.getFreeHeap() < prefetchHeapFloor; };
+    // Finish laying out the chapter on screen before its neighbours. Once it is done, redraw the page so the status
+    // bar shows the final page count instead of the estimate; the redraw schedules the neighbours again.
+    if (section->isBuilding()) {
+      buildSectionUntil(-1, pauseFn);
+      if (section && !section->isBuilding()) {
+        updateRequired = true;
+      }
+    } else {
+      const int spineIndex = currentSpineIndex;
+      if (prefetchSection(spineIndex + 1) && prefetchSection(spineIndex - 1)) {
+        prefetchDoneSpineIndex = spineIndex;
+      }
+    }
+  }
+  prefetchTaskHandle = nullptr;
+  xSemaphoreGive(renderingMutex);
+  vTaskDelete(nullptr);
+}
+
+bool EpubReaderActivity::buildSectionUntil(const int page, const std::function<bool()>& pauseFn) {
+  EpdFontFamily::globalForceBold = (SETTINGS.forceBoldText == 1);
+  const bool built = section->buildUntilPage(page, pauseFn);
+  EpdFontFamily::globalForceBold = false;
+  if (!built) {
+    Serial.printf("[%lu] [ERS] Incremental build of spine item %d failed\n", millis(), currentSpineIndex);
+  }
+  return built;
+}
+
+bool EpubReaderActivity::prefetchSection(const int spineIndex) {
+  if (spineIndex < 0 || spineIndex >= epub->getSpineItemsCount()) {
+    return true;
+  }
+
+  const bool useBold = (SETTINGS.forceBoldText == 1);
+  Section candidate(epub, spineIndex, renderer);
+  if (candidate.loadSectionFile(SETTINGS.getReaderFontId(), SETTINGS.getReaderLineCompression(),
+                                SETTINGS.extraParagraphSpacing, SETTINGS.paragraphAlignment, sectionViewportWidth,
+                                sectionViewportHeight, SETTINGS.hyphenationEnabled, SETTINGS.embeddedStyle, useBold)) {
+    return true;
+  }
+
+  Serial.printf("[%lu] [ERS] Pre-paginating spine item %d in background\n", millis(), spineIndex);
+  const unsigned long start = millis();
+  EpdFontFamily::globalForceBold = useBold;
+  const bool built = candidate.createSectionFile(
+      SETTINGS.getReaderFontId(), SETTINGS.getReaderLineCompression(), SETTINGS.extraParagraphSpacing,
+      SETTINGS.paragraphAlignment, sectionViewportWidth, sectionViewportHeight, SETTINGS.hyphenationEnabled,
+      SETTINGS.embeddedStyle, useBold, nullptr,
+      [this]() { return prefetchCancelRequested || ESP.getFreeHeap() < prefetchHeapFloor; });
+  EpdFontFamily::globalForceBold = false;
+
+  if (built) {
+    Serial.printf("[%lu] [ERS] Pre-paginated spine item %d (%d pages) in %lums\n", millis(), spineIndex,
+                  candidate.pageCount, millis() - start);
+  } else {
+    Serial.printf("[%lu] [ERS] Pre-pagination of spine item %d stopped\n", millis(), spineIndex);
+  }
+  return built;
+}
+
 void EpubReaderActivity::renderScreen() {
   if (!epub) {
     return;
@@ -852,6 +976,7 @@ void EpubReaderActivity::renderScreen() {
                             (showProgressBar ? (metrics.bookProgressBarHeight + progressBarMarginTop) : 0);
   }
 
+  const bool sectionCreated = !section;
   if (!section) {
     const auto filepath = epub->getSpineItem(currentSpineIndex).href;
     Serial.printf("[%lu] [ERS] Loading file: %s, index: %d\n", millis(), filepath.c_str(), currentSpineIndex);
@@ -859,6 +984,10 @@ void EpubReaderActivity::renderScreen() {
 
     const uint16_t viewportWidth = renderer.getScreenWidth() - orientedMarginLeft - orientedMarginRight;
     const uint16_t viewportHeight = renderer.getScreenHeight() - orientedMarginTop - orientedMarginBottom;
+    sectionViewportWidth = viewportWidth;
+    sectionViewportHeight = viewportHeight;
+    // Settings or chapter may have changed, so the neighbours need checking again
+    prefetchDoneSpineIndex = -1;
 
     bool useBold = (SETTINGS.forceBoldText == 1);
 
@@ -872,10 +1001,20 @@ void EpubReaderActivity::renderScreen() {
 
       const auto popupFn = [this]() { GUI.drawPopup(renderer, "Indexing..."); };
 
-      if (!section->createSectionFile(SETTINGS.getReaderFontId(), SETTINGS.getReaderLineCompression(),
-                                      SETTINGS.extraParagraphSpacing, SETTINGS.paragraphAlignment, viewportWidth,
-                                      viewportHeight, SETTINGS.hyphenationEnabled, SETTINGS.embeddedStyle, useBold,
-                                      popupFn)) {
+      // Opening a known page: lay out only up to it and let the rest of the chapter follow in the background. Going
+      // to the last page or remapping a position needs the final page count, so those build the whole chapter.
+      const bool remapPosition = cachedChapterTotalPageCount > 0 && currentSpineIndex == cachedSpineIndex;
+      const bool incremental = nextPageNumber != UINT16_MAX && !pendingPercentJump && !remapPosition;
+
+      if (incremental && section->beginSectionFile(SETTINGS.getReaderFontId(), SETTINGS.getReaderLineCompression(),
+                                                   SETTINGS.extraParagraphSpacing, SETTINGS.paragraphAlignment,
+                                                   viewportWidth, viewportHeight, SETTINGS.hyphenationEnabled,
+                                                   SETTINGS.embeddedStyle, useBold, popupFn)) {
+        Serial.printf("[%lu] [ERS] Building section incrementally up to page %d\n", millis(), nextPageNumber);
+      } else if (!section->createSectionFile(SETTINGS.getReaderFontId(), SETTINGS.getReaderLineCompression(),
+                                             SETTINGS.extraParagraphSpacing, SETTINGS.paragraphAlignment,
+                                             viewportWidth, viewportHeight, SETTINGS.hyphenationEnabled,
+                                             SETTINGS.embeddedStyle, useBold, popupFn)) {
         Serial.printf("[%lu] [ERS] Failed to persist page data to SD\n", millis());
         section.reset();
 
@@ -915,6 +1054,21 @@ void EpubReaderActivity::renderScreen() {
     }
   }
 
+  // Lay out the chapter up to the page to show. A page turn past the end of a chapter that was still being built moves
+  // on to the next one.
+  if (section->isBuilding() && section->currentPage >= section->pageCount) {
+    if (!buildSectionUntil(section->currentPage, nullptr)) {
+      section.reset();
+      return;
+    }
+    if (!sectionCreated && !section->isBuilding() && section->currentPage >= section->pageCount) {
+      nextPageNumber = 0;
+      currentSpineIndex++;
+      section.reset();
+      return renderScreen();
+    }
+  }
+
   renderer.clearScreen();
 
   if (section->pageCount == 0) {
@@ -945,7 +1099,7 @@ void EpubReaderActivity::renderScreen() {
     renderContents(std::move(p), orientedMarginTop, orientedMarginRight, orientedMarginBottom, orientedMarginLeft);
     Serial.printf("[%lu] [ERS] Rendered page in %dms\n", millis(), millis() - start);
   }
-  saveProgress(currentSpineIndex, section->currentPage, section->pageCount);
+  saveProgress(currentSpineIndex, section->currentPage, finalPageCount());
 }
 
 void EpubReaderActivity::saveProgress(int spineIndex, int currentPage, int pageCount) {
@@ -970,15 +1124,19 @@ void EpubReaderActivity::renderContents(std::unique_ptr<Page> page, const int or
                                         const int orientedMarginRight, const int orientedMarginBottom,
                                         const int orientedMarginLeft) {
   bool useBold = (SETTINGS.forceBoldText == 1);
+  const bool antiAlias = SETTINGS.textAntiAliasing && !showHelpOverlay && !isNightMode;
+
+  // With enough heap, the BW text and both grayscale planes come out of this one page traversal
+  const bool singlePassGrayscale = antiAlias && renderer.beginGrayscaleCapture();
 
   // 1. Draw the normal black text
   EpdFontFamily::globalForceBold = useBold;
-  page->render(renderer, SETTINGS.getReaderFontId(), orientedMarginLeft, orientedMarginTop);
 
-  // 2. Thicken the core black text by shifting 1 pixel right
-  if (SETTINGS.textAntiAliasing && !showHelpOverlay && !isNightMode) {
-    page->render(renderer, SETTINGS.getReaderFontId(), orientedMarginLeft + 1, orientedMarginTop);
-  }
+  // 2. Thicken the core black text by also drawing it shifted 1 pixel right
+  renderer.setTextStrikeOffset(antiAlias ? 1 : 0);
+  page->render(renderer, SETTINGS.getReaderFontId(), orientedMarginLeft, orientedMarginTop);
+  renderer.setTextStrikeOffset(0);
+  renderer.endGrayscaleCapture();
 
   // IMMEDIATELY TURN OFF BOLD SO THE UI REMAINS NORMAL
   EpdFontFamily::globalForceBold = false;
@@ -1055,18 +1213,24 @@ void EpubReaderActivity::renderContents(std::unique_ptr<Page> page, const int or
     pagesUntilFullRefresh--;
   }
 
-  renderer.storeBwBuffer();
+  if (singlePassGrayscale) {
+    // Swaps the planes through the framebuffer and leaves the BW buffer stored for the restore below
+    renderer.displayGrayscaleCapture();
+  } else {
+    renderer.storeBwBuffer();
+  }
 
-  if (SETTINGS.textAntiAliasing && !showHelpOverlay && !isNightMode) {  // Don't anti-alias the help overlay
+  if (antiAlias && !singlePassGrayscale) {  // Don't anti-alias the help overlay
+    // Not enough heap to capture both planes at once: render them in separate passes
     renderer.clearScreen(0x00);
 
     // TURN ON BOLD FOR GRAYSCALE PASSES
     EpdFontFamily::globalForceBold = useBold;
+    renderer.setTextStrikeOffset(1);
 
     // --- LSB (Light Grays) Pass ---
     renderer.setRenderMode(GfxRenderer::GRAYSCALE_LSB);
     page->render(renderer, SETTINGS.getReaderFontId(), orientedMarginLeft, orientedMarginTop);
-    page->render(renderer, SETTINGS.getReaderFontId(), orientedMarginLeft + 1, orientedMarginTop);
     renderer.copyGrayscaleLsbBuffers();
 
     renderer.clearScreen(0x00);
@@ -1074,11 +1238,11 @@ void EpubReaderActivity::renderContents(std::unique_ptr<Page> page, const int or
     // --- MSB (Dark Grays) Pass ---
     renderer.setRenderMode(GfxRenderer::GRAYSCALE_MSB);
     page->render(renderer, SETTINGS.getReaderFontId(), orientedMarginLeft, orientedMarginTop);
-    page->render(renderer, SETTINGS.getReaderFontId(), orientedMarginLeft + 1, orientedMarginTop);
     renderer.copyGrayscaleMsbBuffers();
 
     // TURN BOLD OFF BEFORE FINAL FLUSH
     EpdFontFamily::globalForceBold = false;
+    renderer.setTextStrikeOffset(0);
 
     renderer.displayGrayBuffer();
     renderer.setRenderMode(GfxRenderer::BW);
@@ -1112,19 +1276,24 @@ void EpubReaderActivity::renderStatusBar(const int orientedMarginRight, const in
   const auto textY = screenHeight - orientedMarginBottom - 4;
   int progressTextWidth = 0;
 
-  const float sectionChapterProg = static_cast<float>(section->currentPage) / section->pageCount;
+  // While the chapter is still being laid out its page count is an estimate, marked with a "~"; the page is drawn
+  // again once the background build finishes
+  const bool estimated = section->isBuilding();
+  const int chapterPageCount = section->estimatedPageCount();
+  const float sectionChapterProg = static_cast<float>(section->currentPage) / chapterPageCount;
   const float bookProgress = epub->calculateProgress(currentSpineIndex, sectionChapterProg) * 100;
 
   if (showProgressText || showProgressPercentage || showBookPercentage) {
     char progressStr[32];
+    char pagesStr[16];
+    snprintf(pagesStr, sizeof(pagesStr), estimated ? "%d/~%d" : "%d/%d", section->currentPage + 1, chapterPageCount);
 
     if (showProgressPercentage) {
-      snprintf(progressStr, sizeof(progressStr), "%d/%d  %.0f%%", section->currentPage + 1, section->pageCount,
-               bookProgress);
+      snprintf(progressStr, sizeof(progressStr), "%s  %.0f%%", pagesStr, bookProgress);
     } else if (showBookPercentage) {
       snprintf(progressStr, sizeof(progressStr), "%.0f%%", bookProgress);
     } else {
-      snprintf(progressStr, sizeof(progressStr), "%d/%d", section->currentPage + 1, section->pageCount);
+      snprintf(progressStr, sizeof(progressStr), "%s", pagesStr);
     }
 
     progressTextWidth = renderer.getTextWidth(SMALL_FONT_ID, progressStr);
@@ -1138,7 +1307,7 @@ void EpubReaderActivity::renderStatusBar(const int orientedMarginRight, const in
 
   if (showChapterProgressBar) {
     const float chapterProgress =
-        (section->pageCount > 0) ? (static_cast<float>(section->currentPage + 1) / section->pageCount) * 100 : 0;
+        (chapterPageCount > 0) ? (static_cast<float>(section->currentPage + 1) / chapterPageCount) * 100 : 0;
     GUI.drawReadingProgressBar(renderer, static_cast<size_t>(chapterProgress));
   }
 
@@ -12,6 +12,14 @@ class EpubReaderActivity final : public ActivityWithSubactivity {
   std::shared_ptr<Epub> epub;
   std::unique_ptr<Section> section = nullptr;
   TaskHandle_t displayTaskHandle = nullptr;
+  // Low-priority worker that pre-paginates the neighbouring spine items while the reader is idle
+  TaskHandle_t prefetchTaskHandle = nullptr;
+  volatile bool prefetchCancelRequested = false;
+  // Spine index whose neighbours have already been pre-paginated for the current settings (-1 = none)
+  int prefetchDoneSpineIndex = -1;
+  // Viewport the current section was laid out for, reused for the background builds
+  uint16_t sectionViewportWidth = 0;
+  uint16_t sectionViewportHeight = 0;
   SemaphoreHandle_t renderingMutex = nullptr;
   int currentSpineIndex = 0;
   int nextPageNumber = 0;
@@ -32,6 +40,16 @@ class EpubReaderActivity final : public ActivityWithSubactivity {
 
   static void taskTrampoline(void* param);
   [[noreturn]] void displayTaskLoop();
+  static void prefetchTaskTrampoline(void* param);
+  void prefetchTask();
+  void schedulePrefetch();
+  void cancelPrefetch() { prefetchCancelRequested = true; }
+  bool prefetchSection(int spineIndex);
+  // Continue an incremental build of the current section (see Section::buildUntilPage)
+  bool buildSectionUntil(int page, const std::function<bool()>& pauseFn);
+  // Page count to remap the reading position by after a relayout. 0 (keep the page number) while the chapter is
+  // still being laid out, as the total is not known yet.
+  int finalPageCount() const { return section && !section->isBuilding() ? section->pageCount : 0; }
   void renderScreen();
   void renderContents(std::unique_ptr<Page> page, int orientedMarginTop, int orientedMarginRight,
                       int orientedMarginBottom, int orientedMarginLeft);
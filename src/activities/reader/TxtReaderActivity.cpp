@@ -5,6 +5,8 @@
 #include <Serialization.h>
 #include <Utf8.h>
 
+#include <algorithm>
+
 #include "CrossPointSettings.h"
 #include "CrossPointState.h"
 #include "MappedInputManager.h"
@@ -16,7 +18,9 @@ namespace {
 constexpr unsigned long goHomeMs = 1000;
 constexpr int statusBarMargin = 25;
 constexpr int progressBarMarginTop = 1;
-constexpr size_t CHUNK_SIZE = 8 * 1024;  // 8KB chunk for reading
+// Background indexing works in slices of this length under the rendering mutex, so a page turn waits at most that long
+constexpr unsigned long indexSliceMs = 100;
+constexpr unsigned long indexSliceGapMs = 20;
 
 // Cache file magic and version
 constexpr uint32_t CACHE_MAGIC = 0x54585449;  // "TXTI"
@@ -83,6 +87,11 @@ void TxtReaderActivity::onExit() {
 
   // Wait until not rendering to delete task
   xSemaphoreTake(renderingMutex, portMAX_DELAY);
+  // The index task only touches the SD card while holding the mutex, so it can be dropped here
+  if (indexTaskHandle) {
+    vTaskDelete(indexTaskHandle);
+    indexTaskHandle = nullptr;
+  }
   if (displayTaskHandle) {
     vTaskDelete(displayTaskHandle);
     displayTaskHandle = nullptr;
@@ -91,6 +100,7 @@ void TxtReaderActivity::onExit() {
   renderingMutex = nullptr;
   pageOffsets.clear();
   currentPageLines.clear();
+  paginator.reset();
   APP_STATE.readerActivityLoadCount = 0;
   APP_STATE.saveToFile();
   txt.reset();
@@ -132,11 +142,11 @@ void TxtReaderActivity::loop() {
     return;
   }
 
-  if (prevTriggered && currentPage > 0) {
-    currentPage--;
+  if (prevTriggered && currentOffset > 0) {
+    pageTurn = -1;
     updateRequired = true;
-  } else if (nextTriggered && currentPage < totalPages - 1) {
-    currentPage++;
+  } else if (nextTriggered && nextPageOffset > currentOffset && nextPageOffset < txt->getFileSize()) {
+    pageTurn = 1;
     updateRequired = true;
   }
 }
@@ -194,70 +204,148 @@ void TxtReaderActivity::initializeReader() {
   Serial.printf("[%lu] [TRS] Viewport: %dx%d, lines per page: %d\n", millis(), viewportWidth, viewportHeight,
                 linesPerPage);
 
-  // Try to load cached page index first
-  if (!loadPageIndexCache()) {
-    // Cache not found, build page index
-    buildPageIndex();
-    // Save to cache for next time
-    savePageIndexCache();
+  if (const EpdFont* font = renderer.getFont(cachedFontId)) {
+    paginator = std::unique_ptr<TxtPaginator>(new TxtPaginator(*font, viewportWidth, linesPerPage));
   }
 
-  // Load saved progress
+  // Use the cached page index if there is one, otherwise open at the saved position right away and collect the
+  // index in the background
+  indexComplete = loadPageIndexCache();
   loadProgress();
 
+  if (!indexComplete && paginator) {
+    xTaskCreate(&TxtReaderActivity::indexTaskTrampoline, "TxtReaderIndexTask",
+                6144,             // Stack size
+                this,             // Parameters
+                0,                // Priority: only runs while the reader is otherwise idle
+                &indexTaskHandle  // Task handle
+    );
+  }
+
   initialized = true;
 }
 
-void TxtReaderActivity::buildPageIndex() {
-  pageOffsets.clear();
-  pageOffsets.push_back(0);  // First page starts at offset 0
+void TxtReaderActivity::indexTaskTrampoline(void* param) {
+  auto* self = static_cast<TxtReaderActivity*>(param);
+  self->indexTask();
+}
 
-  size_t offset = 0;
-  const size_t fileSize = txt->getFileSize();
+void TxtReaderActivity::indexTask() {
+  Serial.printf("[%lu] [TRS] Indexing %zu bytes in the background\n", millis(), txt->getFileSize());
+
+  bool finished = false;
+  while (!finished) {
+    xSemaphoreTake(renderingMutex, portMAX_DELAY);
+    const unsigned long sliceStart = millis();
+    finished = extendPageIndex([sliceStart](size_t) { return millis() - sliceStart >= indexSliceMs; });
+    if (finished) {
+      indexTaskHandle = nullptr;
+      // Redraw so the status bar drops the "~" from the now exact page count
+      updateRequired = true;
+    }
+    xSemaphoreGive(renderingMutex);
 
-  Serial.printf("[%lu] [TRS] Building page index for %zu bytes...\n", millis(), fileSize);
+    if (!finished) {
+      vTaskDelay(indexSliceGapMs / portTICK_PERIOD_MS);
+    }
+  }
+  vTaskDelete(nullptr);
+}
 
-  GUI.drawPopup(renderer, "Indexing...");
+// Called with the rendering mutex held. Returns true once there is nothing left to index (or indexing failed).
+bool TxtReaderActivity::extendPageIndex(const std::function<bool(size_t offset)>& pauseFn) {
+  if (indexComplete) {
+    return true;
+  }
+
+  const size_t resumeOffset = pageOffsets.empty() ? 0 : pageOffsets.back();
+  FsFile file;
+  if (!paginator || !Storage.openFileForRead("TRS", txt->getPath(), file) || !file.seek(resumeOffset)) {
+    Serial.printf("[%lu] [TRS] Cannot open file for indexing\n", millis());
+    return true;
+  }
+
+  const auto status = paginator->buildIndex(
+      txt->getFileSize(),
+      [&file](uint8_t* buf, const size_t len) {
+        const int bytesRead = file.read(buf, len);
+        return bytesRead > 0 ? static_cast<size_t>(bytesRead) : 0;
+      },
+      pageOffsets, pauseFn);
+  file.close();
+
+  switch (status) {
+    case TxtPaginator::IndexStatus::Paused:
+      return false;
+    case TxtPaginator::IndexStatus::Failed:
+      // Keep what was indexed for this session, but do not cache it
+      Serial.printf("[%lu] [TRS] Read error while indexing, index stops at page %zu\n", millis(), pageOffsets.size());
+      return true;
+    case TxtPaginator::IndexStatus::Done:
+      break;
+  }
 
-  while (offset < fileSize) {
-    std::vector<std::string> tempLines;
-    size_t nextOffset = offset;
+  indexComplete = true;
+  updatePageNumbers();
+  Serial.printf("[%lu] [TRS] Built page index: %d pages\n", millis(), totalPages);
+  savePageIndexCache();
+  return true;
+}
 
-    if (!loadPageAtOffset(offset, tempLines, nextOffset)) {
-      break;
-    }
+// Pages can only be found going forward from the start of the file, so the index has to reach this one first
+size_t TxtReaderActivity::previousPageOffset() {
+  if (!indexComplete && (pageOffsets.empty() || pageOffsets.back() < currentOffset)) {
+    extendPageIndex([this](const size_t offset) { return offset >= currentOffset; });
+  }
+  if (pageOffsets.empty()) {
+    return 0;
+  }
 
-    if (nextOffset <= offset) {
-      // No progress made, avoid infinite loop
-      break;
-    }
+  const auto page = std::upper_bound(pageOffsets.begin(), pageOffsets.end(), currentOffset) - 1;
+  if (*page == currentOffset) {
+    return page == pageOffsets.begin() ? 0 : *(page - 1);
+  }
+  // Position saved with other layout settings: go back to the start of the page it falls on
+  return *page;
+}
 
-    offset = nextOffset;
-    if (offset < fileSize) {
-      pageOffsets.push_back(offset);
-    }
+void TxtReaderActivity::updatePageNumbers() {
+  if (pageOffsets.empty()) {
+    currentPage = 0;
+    totalPages = 1;
+    return;
+  }
 
-    // Yield to other tasks periodically
-    if (pageOffsets.size() % 20 == 0) {
-      vTaskDelay(1);
-    }
+  const auto page = std::upper_bound(pageOffsets.begin(), pageOffsets.end(), currentOffset) - 1;
+  currentPage = static_cast<int>(page - pageOffsets.begin());
+  if (indexComplete) {
+    totalPages = static_cast<int>(pageOffsets.size());
+    return;
   }
 
-  totalPages = pageOffsets.size();
-  Serial.printf("[%lu] [TRS] Built page index: %d pages\n", millis(), totalPages);
+  // Estimate from the average page size indexed so far, or the size of the page on screen
+  size_t bytesPerPage = pageOffsets.size() > 1 ? pageOffsets.back() / (pageOffsets.size() - 1) : 0;
+  if (bytesPerPage == 0) {
+    bytesPerPage = nextPageOffset > currentOffset ? nextPageOffset - currentOffset : 1;
+  }
+  if (currentOffset > pageOffsets.back()) {
+    currentPage = static_cast<int>(pageOffsets.size() - 1 + (currentOffset - pageOffsets.back()) / bytesPerPage);
+  }
+  const auto estimatedPages = static_cast<int>((txt->getFileSize() + bytesPerPage - 1) / bytesPerPage);
+  totalPages = std::max(estimatedPages, currentPage + 1);
 }
 
 bool TxtReaderActivity::loadPageAtOffset(size_t offset, std::vector<std::string>& outLines, size_t& nextOffset) {
   outLines.clear();
   const size_t fileSize = txt->getFileSize();
 
-  if (offset >= fileSize) {
+  if (offset >= fileSize || !paginator) {
     return false;
   }
 
-  // Read a chunk from file
-  size_t chunkSize = std::min(CHUNK_SIZE, fileSize - offset);
-  auto* buffer = static_cast<uint8_t*>(malloc(chunkSize + 1));
+  // A page never covers more than one window, so a single read is enough
+  const size_t chunkSize = std::min(TxtPaginator::WINDOW_SIZE, fileSize - offset);
+  auto* buffer = static_cast<uint8_t*>(malloc(chunkSize));
   if (!buffer) {
     Serial.printf("[%lu] [TRS] Failed to allocate %zu bytes\n", millis(), chunkSize);
     return false;
@@ -267,110 +355,16 @@ bool TxtReaderActivity::loadPageAtOffset(size_t offset, std::vector<std::string>
     free(buffer);
     return false;
   }
-  buffer[chunkSize] = '\0';
-
-  // Parse lines from buffer
-  size_t pos = 0;
-
-  while (pos < chunkSize && static_cast<int>(outLines.size()) < linesPerPage) {
-    // Find end of line
-    size_t lineEnd = pos;
-    while (lineEnd < chunkSize && buffer[lineEnd] != '\n') {
-      lineEnd++;
-    }
-
-    // Check if we have a complete line
-    bool lineComplete = (lineEnd < chunkSize) || (offset + lineEnd >= fileSize);
-
-    if (!lineComplete && static_cast<int>(outLines.size()) > 0) {
-      // Incomplete line and we already have some lines, stop here
-      break;
-    }
-
-    // Calculate the actual length of line content in the buffer (excluding newline)
-    size_t lineContentLen = lineEnd - pos;
-
-    // Check for carriage return
-    bool hasCR = (lineContentLen > 0 && buffer[pos + lineContentLen - 1] == '\r');
-    size_t displayLen = hasCR ? lineContentLen - 1 : lineContentLen;
 
-    // Extract line content for display (without CR/LF)
-    std::string line(reinterpret_cast<char*>(buffer + pos), displayLen);
-
-    // Track position within this source line (in bytes from pos)
-    size_t lineBytePos = 0;
-
-    // Word wrap if needed
-    while (!line.empty() && static_cast<int>(outLines.size()) < linesPerPage) {
-      int lineWidth = renderer.getTextWidth(cachedFontId, line.c_str());
-
-      if (lineWidth <= viewportWidth) {
-        outLines.push_back(line);
-        lineBytePos = displayLen;  // Consumed entire display content
-        line.clear();
-        break;
-      }
-
-      // Find break point
-      size_t breakPos = line.length();
-      while (breakPos > 0 && renderer.getTextWidth(cachedFontId, line.substr(0, breakPos).c_str()) > viewportWidth) {
-        // Try to break at space
-        size_t spacePos = line.rfind(' ', breakPos - 1);
-        if (spacePos != std::string::npos && spacePos > 0) {
-          breakPos = spacePos;
-        } else {
-          // Break at character boundary for UTF-8
-          breakPos--;
-          // Make sure we don't break in the middle of a UTF-8 sequence
-          while (breakPos > 0 && (line[breakPos] & 0xC0) == 0x80) {
-            breakPos--;
-          }
-        }
-      }
-
-      if (breakPos == 0) {
-        breakPos = 1;
-      }
-
-      outLines.push_back(line.substr(0, breakPos));
-
-      // Skip space at break point
-      size_t skipChars = breakPos;
-      if (breakPos < line.length() && line[breakPos] == ' ') {
-        skipChars++;
-      }
-      lineBytePos += skipChars;
-      line = line.substr(skipChars);
-    }
-
-    // Determine how much of the source buffer we consumed
-    if (line.empty()) {
-      // Fully consumed this source line, move past the newline
-      pos = lineEnd + 1;
-    } else {
-      // Partially consumed - page is full mid-line
-      // Move pos to where we stopped in the line (NOT past the line)
-      pos = pos + lineBytePos;
-      break;
-    }
-  }
-
-  // Ensure we make progress even if calculations go wrong
-  if (pos == 0 && !outLines.empty()) {
-    // Fallback: at minimum, consume something to avoid infinite loop
-    pos = 1;
-  }
-
-  nextOffset = offset + pos;
-
-  // Make sure we don't go past the file
-  if (nextOffset > fileSize) {
-    nextOffset = fileSize;
-  }
+  size_t consumed = 0;
+  const bool loaded = paginator->layoutPage(
+      buffer, chunkSize, offset + chunkSize >= fileSize,
+      [&outLines](const char* text, const size_t length) { outLines.emplace_back(text, length); }, consumed);
+  nextOffset = offset + consumed;
 
   free(buffer);
 
-  return !outLines.empty();
+  return loaded;
 }
 
 void TxtReaderActivity::renderScreen() {
@@ -383,22 +377,31 @@ void TxtReaderActivity::renderScreen() {
     initializeReader();
   }
 
-  if (pageOffsets.empty()) {
+  size_t offset = currentOffset;
+  if (pageTurn > 0) {
+    offset = nextPageOffset;
+  } else if (pageTurn < 0) {
+    offset = previousPageOffset();
+  }
+  pageTurn = 0;
+
+  // Load page content. Past the last page there can only be empty lines; stay on the current page then.
+  size_t nextOffset = 0;
+  if (!loadPageAtOffset(offset, currentPageLines, nextOffset) && offset != currentOffset) {
+    offset = currentOffset;
+    loadPageAtOffset(offset, currentPageLines, nextOffset);
+  }
+
+  if (currentPageLines.empty()) {
     renderer.clearScreen();
     renderer.drawCenteredText(UI_12_FONT_ID, 300, "Empty file", true, EpdFontFamily::BOLD);
     renderer.displayBuffer();
     return;
   }
 
-  // Bounds check
-  if (currentPage < 0) currentPage = 0;
-  if (currentPage >= totalPages) currentPage = totalPages - 1;
-
-  // Load current page content
-  size_t offset = pageOffsets[currentPage];
-  size_t nextOffset;
-  currentPageLines.clear();
-  loadPageAtOffset(offset, currentPageLines, nextOffset);
+  currentOffset = offset;
+  nextPageOffset = nextOffset;
+  updatePageNumbers();
 
   renderer.clearScreen();
   renderPage();
@@ -519,12 +522,15 @@ void TxtReaderActivity::renderStatusBar(const int orientedMarginRight, const int
 
   if (showProgressText || showProgressPercentage || showBookPercentage) {
     char progressStr[32];
+    // "~" marks estimates while the page index is still being built
+    const char* estimate = indexComplete ? "" : "~";
     if (showProgressPercentage) {
-      snprintf(progressStr, sizeof(progressStr), "%d/%d %.0f%%", currentPage + 1, totalPages, progress);
+      snprintf(progressStr, sizeof(progressStr), "%d/%s%d %s%.0f%%", currentPage + 1, estimate, totalPages, estimate,
+               progress);
     } else if (showBookPercentage) {
-      snprintf(progressStr, sizeof(progressStr), "%.0f%%", progress);
+      snprintf(progressStr, sizeof(progressStr), "%s%.0f%%", estimate, progress);
     } else {
-      snprintf(progressStr, sizeof(progressStr), "%d/%d", currentPage + 1, totalPages);
+      snprintf(progressStr, sizeof(progressStr), "%d/%s%d", currentPage + 1, estimate, totalPages);
     }
 
     progressTextWidth = renderer.getTextWidth(SMALL_FONT_ID, progressStr);
@@ -563,35 +569,53 @@ void TxtReaderActivity::renderStatusBar(const int orientedMarginRight, const int
   }
 }
 
+// progress.bin: page number (uint16), two zero bytes, then the page's file offset (uint32). Older files end after the
+// page number; the offset is what lets a book open before its page index exists.
 void TxtReaderActivity::saveProgress() const {
   FsFile f;
   if (Storage.openFileForWrite("TRS", txt->getCachePath() + "/progress.bin", f)) {
-    uint8_t data[4];
+    uint8_t data[8];
     data[0] = currentPage & 0xFF;
     data[1] = (currentPage >> 8) & 0xFF;
     data[2] = 0;
     data[3] = 0;
-    f.write(data, 4);
+    for (int i = 0; i < 4; i++) {
+      data[4 + i] = (currentOffset >> (8 * i)) & 0xFF;
+    }
+    f.write(data, 8);
     f.close();
   }
 }
 
 void TxtReaderActivity::loadProgress() {
   FsFile f;
-  if (Storage.openFileForRead("TRS", txt->getCachePath() + "/progress.bin", f)) {
-    uint8_t data[4];
-    if (f.read(data, 4) == 4) {
-      currentPage = data[0] + (data[1] << 8);
-      if (currentPage >= totalPages) {
-        currentPage = totalPages - 1;
-      }
-      if (currentPage < 0) {
-        currentPage = 0;
-      }
-      Serial.printf("[%lu] [TRS] Loaded progress: page %d/%d\n", millis(), currentPage, totalPages);
+  if (!Storage.openFileForRead("TRS", txt->getCachePath() + "/progress.bin", f)) {
+    return;
+  }
+  uint8_t data[8];
+  const int bytesRead = f.read(data, 8);
+  f.close();
+  if (bytesRead < 4) {
+    return;
+  }
+
+  if (bytesRead == 8) {
+    currentOffset = data[4] | (data[5] << 8) | (data[6] << 16) | (static_cast<size_t>(data[7]) << 24);
+    if (currentOffset >= txt->getFileSize()) {
+      currentOffset = 0;
+    }
+  } else {
+    // Only a page number: index up to that page to find where it starts
+    const int savedPage = data[0] + (data[1] << 8);
+    if (!indexComplete && static_cast<int>(pageOffsets.size()) <= savedPage) {
+      GUI.drawPopup(renderer, "Indexing...");
+      extendPageIndex([this, savedPage](size_t) { return static_cast<int>(pageOffsets.size()) > savedPage; });
+    }
+    if (!pageOffsets.empty()) {
+      currentOffset = pageOffsets[std::min(static_cast<size_t>(savedPage), pageOffsets.size() - 1)];
     }
-    f.close();
   }
+  Serial.printf("[%lu] [TRS] Loaded progress: offset %zu\n", millis(), currentOffset);
 }
 
 bool TxtReaderActivity::loadPageIndexCache() {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Txt.h>
+#include <TxtPaginator.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/semphr.h>
 #include <freertos/task.h>
@@ -13,6 +14,7 @@
 class TxtReaderActivity final : public ActivityWithSubactivity {
   std::unique_ptr<Txt> txt;
   TaskHandle_t displayTaskHandle = nullptr;
+  TaskHandle_t indexTaskHandle = nullptr;
   SemaphoreHandle_t renderingMutex = nullptr;
   int currentPage = 0;
   int totalPages = 1;
@@ -21,11 +23,17 @@ class TxtReaderActivity final : public ActivityWithSubactivity {
   const std::function<void()> onGoBack;
   const std::function<void()> onGoHome;
 
-  // Streaming text reader - stores file offsets for each page
+  // Streaming text reader - stores file offsets for each page. Unless index.bin already holds them, they are
+  // collected by a background task while reading; until indexComplete, currentPage and totalPages are estimates.
   std::vector<size_t> pageOffsets;  // File offset for start of each page
+  bool indexComplete = false;
+  size_t currentOffset = 0;   // File offset of the page on screen
+  size_t nextPageOffset = 0;  // Where the page after it starts
+  int pageTurn = 0;           // Requested by loop(), applied by renderScreen()
   std::vector<std::string> currentPageLines;
   int linesPerPage = 0;
   int viewportWidth = 0;
+  std::unique_ptr<TxtPaginator> paginator;
   bool initialized = false;
 
   // Cached settings for cache validation (different fonts/margins require re-indexing)
@@ -35,13 +43,17 @@ class TxtReaderActivity final : public ActivityWithSubactivity {
 
   static void taskTrampoline(void* param);
   [[noreturn]] void displayTaskLoop();
+  static void indexTaskTrampoline(void* param);
+  void indexTask();
   void renderScreen();
   void renderPage();
   void renderStatusBar(int orientedMarginRight, int orientedMarginBottom, int orientedMarginLeft) const;
 
   void initializeReader();
   bool loadPageAtOffset(size_t offset, std::vector<std::string>& outLines, size_t& nextOffset);
-  void buildPageIndex();
+  bool extendPageIndex(const std::function<bool(size_t offset)>& pauseFn);
+  size_t previousPageOffset();
+  void updatePageNumbers();
   bool loadPageIndexCache();
   void savePageIndexCache() const;
   void saveProgress() const;
@@ -10,6 +10,7 @@
 #include <FsHelpers.h>
 #include <GfxRenderer.h>
 #include <HalStorage.h>
+#include <Xtc/XtcPageBlitter.h>
 
 #include "CrossPointSettings.h"
 #include "CrossPointState.h"
@@ -22,6 +23,11 @@
 namespace {
 constexpr unsigned long skipPageMs = 700;
 constexpr unsigned long goHomeMs = 1000;
+// Page buffers for the current, next and previous page, leaving this much heap for everything else
+constexpr size_t pageCacheMaxPages = 3;
+constexpr size_t pageCacheHeapReserve = 48 * 1024;
+// Log the XTH gray level histogram of every page (debugging aid, costs an extra pass over the page)
+constexpr bool logPixelDistribution = false;
 }  // namespace
 
 void XtcReaderActivity::taskTrampoline(void* param) {
@@ -29,6 +35,11 @@ void XtcReaderActivity::taskTrampoline(void* param) {
   self->displayTaskLoop();
 }
 
+void XtcReaderActivity::prefetchTaskTrampoline(void* param) {
+  auto* self = static_cast<XtcReaderActivity*>(param);
+  self->prefetchTask();
+}
+
 void XtcReaderActivity::onEnter() {
   ActivityWithSubactivity::onEnter();
 
@@ -43,6 +54,8 @@ void XtcReaderActivity::onEnter() {
   // Load saved progress
   loadProgress();
 
+  xtc->setupPageCache(pageCacheMaxPages, pageCacheHeapReserve);
+
   // Save current XTC as last opened book and add to recent books
   APP_STATE.openEpubPath = xtc->getPath();
   APP_STATE.saveToFile();
@@ -62,20 +75,33 @@ void XtcReaderActivity::onEnter() {
 void XtcReaderActivity::onExit() {
   ActivityWithSubactivity::onExit();
 
-  // Wait until not rendering to delete task
+  // Wait until not rendering or prefetching to delete tasks
+  prefetchCancelRequested = true;
   xSemaphoreTake(renderingMutex, portMAX_DELAY);
   if (displayTaskHandle) {
     vTaskDelete(displayTaskHandle);
     displayTaskHandle = nullptr;
   }
+  if (prefetchTaskHandle) {
+    vTaskDelete(prefetchTaskHandle);
+    prefetchTaskHandle = nullptr;
+  }
   vSemaphoreDelete(renderingMutex);
   renderingMutex = nullptr;
   APP_STATE.readerActivityLoadCount = 0;
   APP_STATE.saveToFile();
+  if (xtc) {
+    xtc->releasePageCache();
+  }
   xtc.reset();
 }
 
 void XtcReaderActivity::loop() {
+  // Input takes priority over read-ahead; the page being read is finished first
+  if (mappedInput.wasAnyPressed()) {
+    prefetchCancelRequested = true;
+  }
+
   // Pass input responsibility to sub activity if exists
   if (subActivity) {
     subActivity->loop();
@@ -164,12 +190,50 @@ void XtcReaderActivity::displayTaskLoop() {
       updateRequired = false;
       xSemaphoreTake(renderingMutex, portMAX_DELAY);
       renderScreen();
+      schedulePrefetch();
       xSemaphoreGive(renderingMutex);
     }
     vTaskDelay(10 / portTICK_PERIOD_MS);
   }
 }
 
+// Called with the rendering mutex held, right after a page has been displayed
+void XtcReaderActivity::schedulePrefetch() {
+  if (subActivity || xtc->getPageCacheSlots() < 2) {
+    return;
+  }
+
+  // A worker that has not finished yet carries on with the new page's neighbours
+  prefetchCancelRequested = false;
+  if (prefetchTaskHandle) {
+    return;
+  }
+
+  if (xTaskCreate(&XtcReaderActivity::prefetchTaskTrampoline, "XtcPrefetchTask", 4096, this, 0,
+                  &prefetchTaskHandle) != pdPASS) {
+    Serial.printf("[%lu] [XTR] Could not start prefetch task\n", millis());
+    prefetchTaskHandle = nullptr;
+  }
+}
+
+void XtcReaderActivity::prefetchTask() {
+  // One page per mutex hold, so a page turn never waits for more than the read in progress
+  bool working = true;
+  while (working) {
+    xSemaphoreTake(renderingMutex, portMAX_DELAY);
+    working = false;
+    if (!prefetchCancelRequested && !subActivity && currentPage < xtc->getPageCount()) {
+      // Next page first, then the previous one
+      working = xtc->prefetchPage(currentPage + 1) || (currentPage > 0 && xtc->prefetchPage(currentPage - 1));
+    }
+    if (!working) {
+      prefetchTaskHandle = nullptr;
+    }
+    xSemaphoreGive(renderingMutex);
+  }
+  vTaskDelete(nullptr);
+}
+
 void XtcReaderActivity::renderScreen() {
   if (!xtc) {
     return;
@@ -193,43 +257,68 @@ void XtcReaderActivity::renderPage() {
   const uint16_t pageHeight = xtc->getPageHeight();
   const uint8_t bitDepth = xtc->getBitDepth();
 
-  // Calculate buffer size for one page
-  // XTG (1-bit): Row-major, ((width+7)/8) * height bytes
-  // XTH (2-bit): Two bit planes, column-major, ((width * height + 7) / 8) * 2 bytes
-  size_t pageBufferSize;
-  if (bitDepth == 2) {
-    pageBufferSize = ((static_cast<size_t>(pageWidth) * pageHeight + 7) / 8) * 2;
+  // Page buffers are kept across page turns; retry the allocation if it failed when the book was opened. Without
+  // one the page is decoded straight into the framebuffer instead.
+  const uint8_t* pageBuffer = nullptr;
+  if (xtc->getPageCacheSlots() > 0 || xtc->setupPageCache(pageCacheMaxPages, pageCacheHeapReserve) > 0) {
+    // Load page data, usually already read ahead by the prefetch task
+    pageBuffer = xtc->getCachedPage(currentPage, nullptr);
+    if (!pageBuffer) {
+      Serial.printf("[%lu] [XTR] Failed to load page %lu\n", millis(), currentPage);
+      renderer.clearScreen();
+      renderer.drawCenteredText(UI_12_FONT_ID, 300, "Page load error", true, EpdFontFamily::BOLD);
+      renderer.displayBuffer();
+      return;
+    }
   } else {
-    pageBufferSize = ((pageWidth + 7) / 8) * pageHeight;
+    Serial.printf("[%lu] [XTR] No page buffer, streaming page %lu\n", millis(), currentPage);
   }
 
-  // Allocate page buffer
-  uint8_t* pageBuffer = static_cast<uint8_t*>(malloc(pageBufferSize));
-  if (!pageBuffer) {
-    Serial.printf("[%lu] [XTR] Failed to allocate page buffer (%lu bytes)\n", millis(), pageBufferSize);
-    renderer.clearScreen();
-    renderer.drawCenteredText(UI_12_FONT_ID, 300, "Memory error", true, EpdFontFamily::BOLD);
-    renderer.displayBuffer();
-    return;
-  }
+  // Clear screen first
+  renderer.clearScreen();
+
+  // XTC/XTCH pages are pre-rendered for the portrait panel with status bar included, so they are blitted whole,
+  // straight into the framebuffer
+  const xtc::XtcPageBlitter::Panel panel = {renderer.getFrameBuffer(), HalDisplay::DISPLAY_WIDTH,
+                                            HalDisplay::DISPLAY_HEIGHT, HalDisplay::DISPLAY_WIDTH_BYTES};
+
+  // Decode the current page again, chunk by chunk, into one of the XtcPageBlitter streams
+  const auto streamPage = [this](auto& stream) {
+    const auto write = [&stream](const uint8_t* data, const size_t size, const size_t offset) {
+      stream.write(data, size, offset);
+    };
+    return xtc->loadPageStreaming(currentPage, write) == xtc::XtcError::OK;
+  };
+
+  // Draw one XTH plane from the page buffer, or by streaming the page again. The framebuffer must be cleared to the
+  // plane's background first.
+  const auto drawXthPlane = [&](const xtc::XtcPageBlitter::Plane plane) {
+    if (pageBuffer) {
+      xtc::XtcPageBlitter::blitXth(pageBuffer, pageWidth, pageHeight, plane, panel);
+      return true;
+    }
+    xtc::XtcPageBlitter::XthStream stream(pageWidth, pageHeight, plane, panel);
+    return streamPage(stream);
+  };
 
-  // Load page data
-  size_t bytesRead = xtc->loadPage(currentPage, pageBuffer, pageBufferSize);
-  if (bytesRead == 0) {
-    Serial.printf("[%lu] [XTR] Failed to load page %lu\n", millis(), currentPage);
-    free(pageBuffer);
+  const auto showLoadError = [this]() {
+    Serial.printf("[%lu] [XTR] Failed to stream page %lu\n", millis(), currentPage);
     renderer.clearScreen();
     renderer.drawCenteredText(UI_12_FONT_ID, 300, "Page load error", true, EpdFontFamily::BOLD);
     renderer.displayBuffer();
-    return;
-  }
+  };
 
-  // Clear screen first
-  renderer.clearScreen();
-
-  // Copy page bitmap using GfxRenderer's drawPixel
-  // XTC/XTCH pages are pre-rendered with status bar included, so render full page
-  const uint16_t maxSrcY = pageHeight;
+  // A gray plane failed to stream after the BW page was shown: keep the BW page, and put it back in the framebuffer
+  // and the display's gray planes so the next refresh starts from what is on screen
+  const auto abandonGrayscale = [&]() {
+    Serial.printf("[%lu] [XTR] Failed to stream gray planes of page %lu, keeping it in BW\n", millis(), currentPage);
+    renderer.clearScreen();
+    const bool restored = drawXthPlane(xtc::XtcPageBlitter::Plane::Bw);
+    renderer.cleanupGrayscaleWithFrameBuffer();
+    if (!restored) {
+      showLoadError();
+    }
+  };
 
   if (bitDepth == 2) {
     // XTH 2-bit mode: Two bit planes, column-major order
@@ -239,42 +328,21 @@ void XtcReaderActivity::renderPage() {
     // - Pixel value = (bit1 << 1) | bit2
     // - Grayscale: 0=White, 1=Dark Grey, 2=Light Grey, 3=Black
 
-    const size_t planeSize = (static_cast<size_t>(pageWidth) * pageHeight + 7) / 8;
-    const uint8_t* plane1 = pageBuffer;              // Bit1 plane
-    const uint8_t* plane2 = pageBuffer + planeSize;  // Bit2 plane
-    const size_t colBytes = (pageHeight + 7) / 8;    // Bytes per column (100 for 800 height)
-
-    // Lambda to get pixel value at (x, y)
-    auto getPixelValue = [&](uint16_t x, uint16_t y) -> uint8_t {
-      const size_t colIndex = pageWidth - 1 - x;
-      const size_t byteInCol = y / 8;
-      const size_t bitInByte = 7 - (y % 8);
-      const size_t byteOffset = colIndex * colBytes + byteInCol;
-      const uint8_t bit1 = (plane1[byteOffset] >> bitInByte) & 1;
-      const uint8_t bit2 = (plane2[byteOffset] >> bitInByte) & 1;
-      return (bit1 << 1) | bit2;
-    };
-
     // Optimized grayscale rendering without storeBwBuffer (saves 48KB peak memory)
     // Flow: BW display → LSB/MSB passes → grayscale display → re-render BW for next frame
+    // Each pass combines the two bit planes a word at a time, so redoing the BW pass is cheaper than storing it
 
-    // Count pixel distribution for debugging
-    uint32_t pixelCounts[4] = {0, 0, 0, 0};
-    for (uint16_t y = 0; y < pageHeight; y++) {
-      for (uint16_t x = 0; x < pageWidth; x++) {
-        pixelCounts[getPixelValue(x, y)]++;
-      }
+    if (logPixelDistribution && pageBuffer) {
+      uint32_t pixelCounts[4];
+      xtc::XtcPageBlitter::countXthPixels(pageBuffer, pageWidth, pageHeight, pixelCounts);
+      Serial.printf("[%lu] [XTR] Pixel distribution: White=%lu, DarkGrey=%lu, LightGrey=%lu, Black=%lu\n", millis(),
+                    pixelCounts[0], pixelCounts[1], pixelCounts[2], pixelCounts[3]);
     }
-    Serial.printf("[%lu] [XTR] Pixel distribution: White=%lu, DarkGrey=%lu, LightGrey=%lu, Black=%lu\n", millis(),
-                  pixelCounts[0], pixelCounts[1], pixelCounts[2], pixelCounts[3]);
 
     // Pass 1: BW buffer - draw all non-white pixels as black
-    for (uint16_t y = 0; y < pageHeight; y++) {
-      for (uint16_t x = 0; x < pageWidth; x++) {
-        if (getPixelValue(x, y) >= 1) {
-          renderer.drawPixel(x, y, true);
-        }
-      }
+    if (!drawXthPlane(xtc::XtcPageBlitter::Plane::Bw)) {
+      showLoadError();
+      return;
     }
 
     // Display BW with conditional refresh based on pagesUntilFullRefresh
@@ -289,25 +357,18 @@ void XtcReaderActivity::renderPage() {
     // Pass 2: LSB buffer - mark DARK gray only (XTH value 1)
     // In LUT: 0 bit = apply gray effect, 1 bit = untouched
     renderer.clearScreen(0x00);
-    for (uint16_t y = 0; y < pageHeight; y++) {
-      for (uint16_t x = 0; x < pageWidth; x++) {
-        if (getPixelValue(x, y) == 1) {  // Dark grey only
-          renderer.drawPixel(x, y, false);
-        }
-      }
+    if (!drawXthPlane(xtc::XtcPageBlitter::Plane::GrayLsb)) {
+      abandonGrayscale();
+      return;
     }
     renderer.copyGrayscaleLsbBuffers();
 
     // Pass 3: MSB buffer - mark LIGHT AND DARK gray (XTH value 1 or 2)
     // In LUT: 0 bit = apply gray effect, 1 bit = untouched
     renderer.clearScreen(0x00);
-    for (uint16_t y = 0; y < pageHeight; y++) {
-      for (uint16_t x = 0; x < pageWidth; x++) {
-        const uint8_t pv = getPixelValue(x, y);
-        if (pv == 1 || pv == 2) {  // Dark grey or Light grey
-          renderer.drawPixel(x, y, false);
-        }
-      }
+    if (!drawXthPlane(xtc::XtcPageBlitter::Plane::GrayMsb)) {
+      abandonGrayscale();
+      return;
     }
     renderer.copyGrayscaleMsbBuffers();
 
@@ -316,45 +377,32 @@ void XtcReaderActivity::renderPage() {
 
     // Pass 4: Re-render BW to framebuffer (restore for next frame, instead of restoreBwBuffer)
     renderer.clearScreen();
-    for (uint16_t y = 0; y < pageHeight; y++) {
-      for (uint16_t x = 0; x < pageWidth; x++) {
-        if (getPixelValue(x, y) >= 1) {
-          renderer.drawPixel(x, y, true);
-        }
-      }
-    }
+    const bool restored = drawXthPlane(xtc::XtcPageBlitter::Plane::Bw);
 
     // Cleanup grayscale buffers with current frame buffer
     renderer.cleanupGrayscaleWithFrameBuffer();
-
-    free(pageBuffer);
+    if (!restored) {
+      showLoadError();
+      return;
+    }
 
     Serial.printf("[%lu] [XTR] Rendered page %lu/%lu (2-bit grayscale)\n", millis(), currentPage + 1,
                   xtc->getPageCount());
     return;
   } else {
-    // 1-bit mode: 8 pixels per byte, MSB first
-    const size_t srcRowBytes = (pageWidth + 7) / 8;  // 60 bytes for 480 width
-
-    for (uint16_t srcY = 0; srcY < maxSrcY; srcY++) {
-      const size_t srcRowStart = srcY * srcRowBytes;
-
-      for (uint16_t srcX = 0; srcX < pageWidth; srcX++) {
-        // Read source pixel (MSB first, bit 7 = leftmost pixel)
-        const size_t srcByte = srcRowStart + srcX / 8;
-        const size_t srcBit = 7 - (srcX % 8);
-        const bool isBlack = !((pageBuffer[srcByte] >> srcBit) & 1);  // XTC: 0 = black, 1 = white
-
-        if (isBlack) {
-          renderer.drawPixel(srcX, srcY, true);
-        }
+    // 1-bit mode: 8 pixels per byte, MSB first, 0 = black
+    if (pageBuffer) {
+      xtc::XtcPageBlitter::blitXtg(pageBuffer, pageWidth, pageHeight, panel);
+    } else {
+      xtc::XtcPageBlitter::XtgStream stream(pageWidth, pageHeight, panel);
+      if (!streamPage(stream)) {
+        showLoadError();
+        return;
       }
     }
   }
   // White pixels are already cleared by clearScreen()
 
-  free(pageBuffer);
-
   // XTC pages already have status bar pre-rendered, no need to add our own
 
   // Display with appropriate refresh
@@ -17,6 +17,9 @@
 class XtcReaderActivity final : public ActivityWithSubactivity {
   std::shared_ptr<Xtc> xtc;
   TaskHandle_t displayTaskHandle = nullptr;
+  // Low-priority worker that reads the neighbouring pages into the page cache after each turn
+  TaskHandle_t prefetchTaskHandle = nullptr;
+  volatile bool prefetchCancelRequested = false;
   SemaphoreHandle_t renderingMutex = nullptr;
   uint32_t currentPage = 0;
   int pagesUntilFullRefresh = 0;
@@ -26,6 +29,9 @@ class XtcReaderActivity final : public ActivityWithSubactivity {
 
   static void taskTrampoline(void* param);
   [[noreturn]] void displayTaskLoop();
+  static void prefetchTaskTrampoline(void* param);
+  void prefetchTask();
+  void schedulePrefetch();
   void renderScreen();
   void renderPage();
   void saveProgress() const;
@@ -12,18 +12,26 @@
 #include "Battery.h"
 #include "CrossPointSettings.h"
 #include "CrossPointState.h"
+#if CROSSPOINT_EMULATED == 0
 #include "KOReaderCredentialStore.h"
+#endif
 #include "MappedInputManager.h"
 #include "RecentBooksStore.h"
 #include "activities/boot_sleep/BootActivity.h"
 #include "activities/boot_sleep/SleepActivity.h"
+#if CROSSPOINT_EMULATED == 0
 #include "activities/browser/OpdsBookBrowserActivity.h"
+#endif
 #include "activities/home/HomeActivity.h"
 #include "activities/home/MyLibraryActivity.h"
 #include "activities/home/RecentBooksActivity.h"
+#if CROSSPOINT_EMULATED == 0
 #include "activities/network/CrossPointWebServerActivity.h"
+#endif
 #include "activities/reader/ReaderActivity.h"
+#if CROSSPOINT_EMULATED == 0
 #include "activities/settings/SettingsActivity.h"
+#endif
 #include "activities/util/FullScreenMessageActivity.h"
 #include "components/UITheme.h"
 #include "fontIds.h"
@@ -208,22 +216,29 @@ void enterDeepSleep() {
 }
 
 void onGoHome();
-void onGoToMyLibraryWithPath(const std::string& path);
+void onGoToMyLibraryWithPath(std::string path);
 void onGoToRecentBooks();
-void onGoToReader(const std::string& initialEpubPath) {
+// These take the path by value: callers pass a string owned by the activity that exitActivity() destroys
+void onGoToReader(std::string initialEpubPath) {
   exitActivity();
-  enterNewActivity(
-      new ReaderActivity(renderer, mappedInputManager, initialEpubPath, onGoHome, onGoToMyLibraryWithPath));
+  enterNewActivity(new ReaderActivity(renderer, mappedInputManager, std::move(initialEpubPath), onGoHome,
+                                      onGoToMyLibraryWithPath));
 }
 
+// The emulator has no network stack, so file transfer, settings (which lead to WiFi and sync setup) and the OPDS
+// browser stay on the home screen there
 void onGoToFileTransfer() {
+#if CROSSPOINT_EMULATED == 0
   exitActivity();
   enterNewActivity(new CrossPointWebServerActivity(renderer, mappedInputManager, onGoHome));
+#endif
 }
 
 void onGoToSettings() {
+#if CROSSPOINT_EMULATED == 0
   exitActivity();
   enterNewActivity(new SettingsActivity(renderer, mappedInputManager, onGoHome));
+#endif
 }
 
 void onGoToMyLibrary() {
@@ -236,14 +251,16 @@ void onGoToRecentBooks() {
   enterNewActivity(new RecentBooksActivity(renderer, mappedInputManager, onGoHome, onGoToReader));
 }
 
-void onGoToMyLibraryWithPath(const std::string& path) {
+void onGoToMyLibraryWithPath(std::string path) {
   exitActivity();
-  enterNewActivity(new MyLibraryActivity(renderer, mappedInputManager, onGoHome, onGoToReader, path));
+  enterNewActivity(new MyLibraryActivity(renderer, mappedInputManager, onGoHome, onGoToReader, std::move(path)));
 }
 
 void onGoToBrowser() {
+#if CROSSPOINT_EMULATED == 0
   exitActivity();
   enterNewActivity(new OpdsBookBrowserActivity(renderer, mappedInputManager, onGoHome));
+#endif
 }
 
 void onGoHome() {
@@ -303,7 +320,9 @@ void setup() {
   }
 
   SETTINGS.loadFromFile();
+#if CROSSPOINT_EMULATED == 0
   KOREADER_STORE.loadFromFile();
+#endif
   UITheme::getInstance().reload();
   ButtonNavigator::setMappedInputManager(mappedInputManager);
 
@@ -0,0 +1,362 @@
+#include "ArchiveExtractor.h"
+
+#include <Arduino.h>
+#include <FsHelpers.h>
+#include <HalStorage.h>
+#include <ZipFile.h>
+#include <esp_task_wdt.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+constexpr size_t COPY_CHUNK_SIZE = 4096;
+constexpr size_t TAR_BLOCK_SIZE = 512;
+constexpr size_t TAR_MAX_NAME_RECORD = 4096;  // GNU long name / pax header data we are willing to read
+
+// Counts what ZipFile inflates into the output file and feeds the watchdog between chunks
+class WatchdogFileWriter final : public Print {
+ public:
+  explicit WatchdogFileWriter(FsFile& file) : file(file) {}
+
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buffer, size_t size) override {
+    esp_task_wdt_reset();
+    const size_t written = file.write(buffer, size);
+    total += written;
+    return written;
+  }
+
+  size_t total = 0;
+
+ private:
+  FsFile& file;
+};
+
+// Where an entry goes below `destDir`, or "" for entries that are skipped
+std::string targetPath(const std::string& destDir, const std::string& entryName) {
+  const std::string relative = FsHelpers::normalisePath(entryName);
+  if (relative.empty()) {
+    return "";
+  }
+  for (size_t start = 0; start < relative.size();) {
+    size_t end = relative.find('/', start);
+    if (end == std::string::npos) {
+      end = relative.size();
+    }
+    // Protected names are refused at any depth, so an archive cannot write into a system folder either
+    if (FsHelpers::isSkippedArchiveName(relative.substr(start, end - start))) {
+      return "";
+    }
+    start = end + 1;
+  }
+
+  std::string path = destDir;
+  if (path.empty() || path.back() != '/') {
+    path += '/';
+  }
+  return path + relative;
+}
+
+// Create `dir` unless it is the one created last; archives list the files of a folder together
+bool ensureDirectory(const std::string& dir, std::string& lastDir) {
+  if (dir.empty() || dir == "/" || dir == lastDir) {
+    return true;
+  }
+  if (!Storage.exists(dir.c_str()) && !Storage.mkdir(dir.c_str())) {
+    Serial.printf("[%lu] [ARC] Failed to create folder %s\n", millis(), dir.c_str());
+    return false;
+  }
+  lastDir = dir;
+  return true;
+}
+
+bool openTarget(const std::string& path, std::string& lastDir, FsFile& out, bool& replaced) {
+  if (!ensureDirectory(path.substr(0, path.rfind('/')), lastDir)) {
+    return false;
+  }
+  replaced = Storage.exists(path.c_str());
+  if (replaced) {
+    Storage.remove(path.c_str());
+  }
+  return Storage.openFileForWrite("ARC", path, out);
+}
+
+bool extractZip(const std::string& archivePath, const std::string& destDir,
+                const ArchiveExtractor::FileCallback& onFile, size_t& extracted, size_t& failed) {
+  ZipFile zip(archivePath);
+  std::vector<std::string> names;
+  if (!zip.open() || !zip.listEntries(names)) {
+    Serial.printf("[%lu] [ARC] Could not read zip directory of %s\n", millis(), archivePath.c_str());
+    return false;
+  }
+
+  // Progress counts the files that will be written, not folders or skipped entries
+  size_t total = 0;
+  for (const std::string& name : names) {
+    total += !name.empty() && name.back() != '/' && !targetPath(destDir, name).empty() ? 1 : 0;
+  }
+
+  std::string lastDir;
+  size_t done = 0;
+  for (const std::string& name : names) {
+    esp_task_wdt_reset();
+    const std::string path = targetPath(destDir, name);
+    if (path.empty()) {
+      continue;
+    }
+    if (name.back() == '/') {
+      ensureDirectory(path, lastDir);
+      continue;
+    }
+
+    size_t expected = 0;
+    bool replaced = false;
+    FsFile out;
+    bool ok = zip.getInflatedFileSize(name.c_str(), &expected) && openTarget(path, lastDir, out, replaced);
+    if (ok) {
+      WatchdogFileWriter writer(out);
+      ok = zip.readFileToStream(name.c_str(), writer, COPY_CHUNK_SIZE) && writer.total == expected;
+      out.close();
+      if (!ok) {
+        Storage.remove(path.c_str());
+      }
+    }
+
+    if (ok) {
+      extracted++;
+    } else {
+      failed++;
+      Serial.printf("[%lu] [ARC] Failed to extract %s\n", millis(), name.c_str());
+    }
+    if (onFile) {
+      onFile(++done, total, path, replaced);
+    }
+  }
+
+  zip.close();
+  return true;
+}
+
+size_t parseOctal(const uint8_t* field, const size_t len) {
+  size_t value = 0;
+  for (size_t i = 0; i < len && field[i] >= '0' && field[i] <= '7'; i++) {
+    value = value * 8 + (field[i] - '0');
+  }
+  return value;
+}
+
+bool tarChecksumValid(const uint8_t* header) {
+  size_t sum = 0;
+  for (size_t i = 0; i < TAR_BLOCK_SIZE; i++) {
+    sum += (i >= 148 && i < 156) ? ' ' : header[i];  // the checksum field counts as spaces
+  }
+  size_t start = 148;
+  while (start < 156 && header[start] == ' ') {
+    start++;
+  }
+  return sum == parseOctal(header + start, 156 - start);
+}
+
+// Value of the "path" record in pax extended header data ("<length> <key>=<value>\n" records)
+std::string paxPath(const std::string& data) {
+  size_t pos = 0;
+  while (pos < data.size()) {
+    char* end = nullptr;
+    const size_t length = strtoul(data.c_str() + pos, &end, 10);
+    const size_t keyStart = end - data.c_str() + 1;
+    if (length == 0 || pos + length > data.size() || keyStart >= pos + length) {
+      break;
+    }
+    if (data.compare(keyStart, 5, "path=") == 0) {
+      return data.substr(keyStart + 5, pos + length - 1 - (keyStart + 5));
+    }
+    pos += length;
+  }
+  return "";
+}
+
+struct TarEntry {
+  std::string name;
+  size_t size = 0;
+  bool isDirectory = false;
+};
+
+size_t tarPadded(const size_t size) { return (size + TAR_BLOCK_SIZE - 1) & ~(TAR_BLOCK_SIZE - 1); }
+
+// Read headers up to the next file or folder, applying GNU long names and pax paths on the way. Leaves `file` at the
+// entry's data. Returns false at the end of the archive or, with `corrupt` set, on a damaged header.
+bool readTarEntry(FsFile& file, TarEntry& entry, bool& corrupt) {
+  uint8_t header[TAR_BLOCK_SIZE];
+  std::string overrideName;
+  corrupt = false;
+
+  while (true) {
+    if (file.read(header, TAR_BLOCK_SIZE) != static_cast<int>(TAR_BLOCK_SIZE) || header[0] == '\0') {
+      return false;  // end-of-archive blocks, or an archive cut short after the last entry
+    }
+    if (!tarChecksumValid(header)) {
+      corrupt = true;
+      return false;
+    }
+
+    const size_t size = parseOctal(header + 124, 12);
+    const char type = static_cast<char>(header[156]);
+
+    if (type == 'L' || type == 'x') {
+      if (size > TAR_MAX_NAME_RECORD) {
+        corrupt = true;
+        return false;
+      }
+      std::string data(size, '\0');
+      if (file.read(&data[0], size) != static_cast<int>(size)) {
+        corrupt = true;
+        return false;
+      }
+      file.seekCur(tarPadded(size) - size);
+      const std::string name = type == 'L' ? std::string(data.c_str()) : paxPath(data);
+      if (!name.empty()) {
+        overrideName = name;
+      }
+      continue;
+    }
+
+    if (type != '0' && type != '\0' && type != '5') {
+      // Links, devices and global pax headers have nothing to extract
+      file.seekCur(tarPadded(size));
+      continue;
+    }
+
+    if (!overrideName.empty()) {
+      entry.name = overrideName;
+    } else {
+      entry.name.assign(reinterpret_cast<const char*>(header), strnlen(reinterpret_cast<const char*>(header), 100));
+      const char* prefix = reinterpret_cast<const char*>(header + 345);
+      if (memcmp(header + 257, "ustar", 5) == 0 && prefix[0] != '\0') {
+        entry.name = std::string(prefix, strnlen(prefix, 155)) + "/" + entry.name;
+      }
+    }
+    entry.size = size;
+    entry.isDirectory = type == '5' || (!entry.name.empty() && entry.name.back() == '/');
+    return true;
+  }
+}
+
+bool extractTar(const std::string& archivePath, const std::string& destDir,
+                const ArchiveExtractor::FileCallback& onFile, size_t& extracted, size_t& failed) {
+  FsFile file;
+  if (!Storage.openFileForRead("ARC", archivePath, file)) {
+    return false;
+  }
+
+  // Walk the headers once first: gives the total for progress and catches a damaged archive before anything is written
+  TarEntry entry;
+  bool corrupt = false;
+  size_t total = 0;
+  while (readTarEntry(file, entry, corrupt)) {
+    esp_task_wdt_reset();
+    total += entry.isDirectory || targetPath(destDir, entry.name).empty() ? 0 : 1;
+    file.seekCur(tarPadded(entry.size));
+  }
+  if (corrupt) {
+    Serial.printf("[%lu] [ARC] Corrupt tar header in %s\n", millis(), archivePath.c_str());
+    file.close();
+    return false;
+  }
+
+  auto* buffer = static_cast<uint8_t*>(malloc(COPY_CHUNK_SIZE));
+  if (!buffer) {
+    Serial.printf("[%lu] [ARC] Failed to allocate copy buffer\n", millis());
+    file.close();
+    return false;
+  }
+
+  file.seek(0);
+  std::string lastDir;
+  size_t done = 0;
+  while (readTarEntry(file, entry, corrupt)) {
+    esp_task_wdt_reset();
+    const size_t next = file.position() + tarPadded(entry.size);
+    const std::string path = targetPath(destDir, entry.name);
+    if (entry.isDirectory || path.empty()) {
+      if (entry.isDirectory && !path.empty()) {
+        ensureDirectory(path, lastDir);
+      }
+      file.seek(next);
+      continue;
+    }
+
+    bool replaced = false;
+    FsFile out;
+    bool ok = openTarget(path, lastDir, out, replaced);
+    for (size_t remaining = entry.size; ok && remaining > 0;) {
+      const size_t chunk = remaining < COPY_CHUNK_SIZE ? remaining : COPY_CHUNK_SIZE;
+      ok = file.read(buffer, chunk) == static_cast<int>(chunk) && out.write(buffer, chunk) == chunk;
+      remaining -= chunk;
+      esp_task_wdt_reset();
+    }
+    if (out) {
+      out.close();
+    }
+    if (ok) {
+      extracted++;
+    } else {
+      failed++;
+      Storage.remove(path.c_str());
+      Serial.printf("[%lu] [ARC] Failed to extract %s\n", millis(), entry.name.c_str());
+    }
+    if (onFile) {
+      onFile(++done, total, path, replaced);
+    }
+    file.seek(next);
+  }
+
+  free(buffer);
+  file.close();
+  return !corrupt;
+}
+}  // namespace
+
+ArchiveExtractor::Format ArchiveExtractor::detectFormat(const std::string& archivePath) {
+  FsFile file;
+  if (!Storage.openFileForRead("ARC", archivePath, file)) {
+    return Format::Unknown;
+  }
+  uint8_t header[TAR_BLOCK_SIZE];
+  const int bytesRead = file.read(header, TAR_BLOCK_SIZE);
+  file.close();
+
+  if (bytesRead >= 4 && header[0] == 'P' && header[1] == 'K' &&
+      ((header[2] == 3 && header[3] == 4) || (header[2] == 5 && header[3] == 6))) {
+    return Format::Zip;
+  }
+  if (bytesRead == static_cast<int>(TAR_BLOCK_SIZE) && header[0] != '\0' && tarChecksumValid(header)) {
+    return Format::Tar;
+  }
+  return Format::Unknown;
+}
+
+bool ArchiveExtractor::extract(const std::string& archivePath, const std::string& destDir, const FileCallback& onFile,
+                               size_t& extracted, size_t& failed) {
+  extracted = 0;
+  failed = 0;
+  const unsigned long start = millis();
+
+  bool ok = false;
+  switch (detectFormat(archivePath)) {
+    case Format::Zip:
+      ok = extractZip(archivePath, destDir, onFile, extracted, failed);
+      break;
+    case Format::Tar:
+      ok = extractTar(archivePath, destDir, onFile, extracted, failed);
+      break;
+    default:
+      Serial.printf("[%lu] [ARC] %s is neither a zip nor a tar archive\n", millis(), archivePath.c_str());
+      return false;
+  }
+
+  Serial.printf("[%lu] [ARC] Extracted %u files (%u failed) into %s in %lu ms\n", millis(), extracted, failed,
+                destDir.c_str(), millis() - start);
+  return ok;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <string>
+
+/**
+ * Unpacks a zip or tar archive on the SD card into a folder, entry by entry.
+ *
+ * Zip entries are inflated through ZipFile; tar archives may be plain ustar, GNU (long names) or pax. Entry names are
+ * normalised with FsHelpers, so nothing is written outside the destination folder, and entries with a protected path
+ * component (hidden ".DS_Store" and macOS "._" files, the web server's system folders) or under "__MACOSX" are
+ * skipped. The task watchdog is fed throughout, since extraction runs inside a request handler.
+ */
+class ArchiveExtractor {
+ public:
+  enum class Format { Unknown, Zip, Tar };
+
+  // Called after each file written (or failed) with the number handled so far, the number of files the archive will
+  // write, the path and whether it replaced an existing file
+  using FileCallback = std::function<void(size_t done, size_t total, const std::string& path, bool replaced)>;
+
+  // Tells zip from tar by content, not by name
+  static Format detectFormat(const std::string& archivePath);
+
+  // Extract every file entry into `destDir`. Returns false if the archive itself is unreadable or corrupt; entries that
+  // fail to write are counted in `failed` and extraction carries on with the next one.
+  static bool extract(const std::string& archivePath, const std::string& destDir, const FileCallback& onFile,
+                      size_t& extracted, size_t& failed);
+};
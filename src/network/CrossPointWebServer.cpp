@@ -8,7 +8,10 @@
 #include <esp_task_wdt.h>
 
 #include <algorithm>
+#include <cctype>
+#include <cstdlib>
 
+#include "ArchiveExtractor.h"
 #include "CrossPointSettings.h"
 #include "SettingsList.h"
 #include "html/FilesPageHtml.generated.h"
@@ -17,10 +20,6 @@
 #include "util/StringUtils.h"
 
 namespace {
-// Folders/files to hide from the web interface file browser
-// Note: Items starting with "." are automatically hidden
-const char* HIDDEN_ITEMS[] = {"System Volume Information", "XTCache"};
-constexpr size_t HIDDEN_ITEMS_COUNT = sizeof(HIDDEN_ITEMS) / sizeof(HIDDEN_ITEMS[0]);
 constexpr uint16_t UDP_PORTS[] = {54982, 48123, 39001, 44044, 59678};
 constexpr uint16_t LOCAL_UDP_PORT = 8134;
 
@@ -29,8 +28,11 @@ CrossPointWebServer* wsInstance = nullptr;
 
 // WebSocket upload state
 FsFile wsUploadFile;
+UploadPipeline wsUploadPipeline;
 String wsUploadFileName;
 String wsUploadPath;
+String wsUploadFilePath;  // where the data goes: the file itself, or the staging file of an archive
+bool wsUploadExtract = false;
 size_t wsUploadSize = 0;
 size_t wsUploadReceived = 0;
 unsigned long wsUploadStartTime = 0;
@@ -48,6 +50,249 @@ void clearEpubCacheIfNeeded(const String& filePath) {
   }
 }
 
+// Archive uploads are written to a hidden staging file in the target folder and unpacked from there
+String archiveStagingPath(const String& dir, const String& fileName) {
+  String path = dir;
+  if (!path.endsWith("/")) path += "/";
+  return path + "." + fileName + ".part";
+}
+
+// Unpack an uploaded archive into `dir`, then delete it. Only files that replaced an existing one can have a stale
+// epub cache, so the cache check is skipped for new files.
+bool extractUploadedArchive(const String& archivePath, const String& dir,
+                            const ArchiveExtractor::FileCallback& progress, size_t& extracted, size_t& failed) {
+  const bool ok = ArchiveExtractor::extract(
+      archivePath.c_str(), dir.c_str(),
+      [&progress](const size_t done, const size_t total, const std::string& path, const bool replaced) {
+        if (replaced) {
+          clearEpubCacheIfNeeded(String(path.c_str()));
+        }
+        if (progress) {
+          progress(done, total, path, replaced);
+        }
+      },
+      extracted, failed);
+  Storage.remove(archivePath.c_str());
+  return ok;
+}
+
+// Downloads: SD reads are double-buffered against socket writes (see streamFileRange)
+constexpr size_t DOWNLOAD_BUFFER_SIZE = 16 * 1024;
+constexpr size_t DOWNLOAD_MIN_BUFFER_SIZE = 2 * 1024;
+constexpr size_t DOWNLOAD_HEAP_RESERVE = 48 * 1024;  // keep this much free for WiFi/lwIP
+
+// Parse a single "bytes=" range against a file of `size` bytes into [start, end]. Returns false for a range that cannot
+// be satisfied. `ignored` is set for headers we answer with the whole file instead (other units, multiple ranges or
+// garbage), which RFC 9110 allows.
+bool parseByteRange(const String& header, const size_t size, size_t& start, size_t& end, bool& ignored) {
+  ignored = true;
+  if (!header.startsWith("bytes=") || header.indexOf(',') >= 0) {
+    return true;
+  }
+  const String spec = header.substring(6);
+  const int dash = spec.indexOf('-');
+  if (dash < 0) {
+    return true;
+  }
+  const String first = spec.substring(0, dash);
+  const String last = spec.substring(dash + 1);
+  for (const String* part : {&first, &last}) {
+    for (size_t i = 0; i < part->length(); i++) {
+      if (!isdigit(static_cast<unsigned char>((*part)[i]))) {
+        return true;
+      }
+    }
+  }
+  if (first.isEmpty() && last.isEmpty()) {
+    return true;
+  }
+  ignored = false;
+
+  if (first.isEmpty()) {
+    // Suffix range: the last N bytes
+    const size_t suffix = strtoul(last.c_str(), nullptr, 10);
+    if (suffix == 0 || size == 0) {
+      return false;
+    }
+    start = suffix >= size ? 0 : size - suffix;
+    end = size - 1;
+    return true;
+  }
+
+  start = strtoul(first.c_str(), nullptr, 10);
+  if (start >= size) {
+    return false;
+  }
+  end = last.isEmpty() ? size - 1 : std::min(static_cast<size_t>(strtoul(last.c_str(), nullptr, 10)), size - 1);
+  return end >= start;
+}
+
+// Validator for If-Range: changes whenever the file is rewritten
+String fileEtag(FsFile& file) {
+  uint16_t date = 0;
+  uint16_t time = 0;
+  file.getModifyDateTime(&date, &time);
+  char etag[32];
+  snprintf(etag, sizeof(etag), "\"%x-%x%04x\"", static_cast<unsigned>(file.size()), date, time);
+  return etag;
+}
+
+// Shared between the handler (which sends) and the reader task (which fills buffers from the SD card)
+struct DownloadStream {
+  FsFile* file = nullptr;
+  size_t remaining = 0;
+  size_t bufferSize = 0;
+  uint8_t* buffers[2] = {};
+  int filled[2] = {};                 // bytes in each buffer, <= 0 on a read error
+  SemaphoreHandle_t canFill[2] = {};  // given when the buffer may be filled
+  SemaphoreHandle_t canSend[2] = {};  // given when the buffer holds data to send
+  SemaphoreHandle_t readerDone = nullptr;
+  TaskHandle_t reader = nullptr;
+  volatile bool cancelled = false;
+};
+
+void downloadReaderTask(void* param) {
+  auto* stream = static_cast<DownloadStream*>(param);
+  for (int slot = 0; stream->remaining > 0; slot ^= 1) {
+    xSemaphoreTake(stream->canFill[slot], portMAX_DELAY);
+    if (stream->cancelled) {
+      break;
+    }
+    const size_t toRead = std::min(stream->bufferSize, stream->remaining);
+    int bytesRead;
+    {
+      // An upload's writer task may be using the card meanwhile
+      StorageLock lock;
+      bytesRead = stream->file->read(stream->buffers[slot], toRead);
+    }
+    stream->filled[slot] = bytesRead;
+    stream->remaining = bytesRead > 0 ? stream->remaining - bytesRead : 0;
+    xSemaphoreGive(stream->canSend[slot]);
+  }
+  xSemaphoreGive(stream->readerDone);
+  vTaskDelete(nullptr);
+}
+
+// Stop the reader task, if it was started, and free everything beginDownloadStream allocated
+void endDownloadStream(DownloadStream& stream) {
+  if (stream.reader) {
+    // Wake the reader wherever it waits and let it finish before its buffers go away
+    stream.cancelled = true;
+    xSemaphoreGive(stream.canFill[0]);
+    xSemaphoreGive(stream.canFill[1]);
+    xSemaphoreTake(stream.readerDone, portMAX_DELAY);
+    stream.reader = nullptr;
+  }
+  for (int i = 0; i < 2; i++) {
+    free(stream.buffers[i]);
+    stream.buffers[i] = nullptr;
+    if (stream.canFill[i]) {
+      vSemaphoreDelete(stream.canFill[i]);
+      stream.canFill[i] = nullptr;
+    }
+    if (stream.canSend[i]) {
+      vSemaphoreDelete(stream.canSend[i]);
+      stream.canSend[i] = nullptr;
+    }
+  }
+  if (stream.readerDone) {
+    vSemaphoreDelete(stream.readerDone);
+    stream.readerDone = nullptr;
+  }
+}
+
+// Allocate the two buffers and start the reader task on `length` bytes of `file` from its current position. Called
+// before any header is sent, so a failure here can still be answered with the synchronous copy instead.
+bool beginDownloadStream(DownloadStream& stream, FsFile& file, const size_t length) {
+  // Two large buffers when the heap allows it, smaller ones otherwise
+  size_t bufferSize = DOWNLOAD_BUFFER_SIZE;
+  while (bufferSize > DOWNLOAD_MIN_BUFFER_SIZE && ESP.getFreeHeap() < 2 * bufferSize + DOWNLOAD_HEAP_RESERVE) {
+    bufferSize /= 2;
+  }
+  stream.file = &file;
+  stream.remaining = length;
+  stream.bufferSize = std::min(bufferSize, std::max(length, static_cast<size_t>(1)));
+
+  bool ok = true;
+  for (int i = 0; i < 2 && ok; i++) {
+    stream.buffers[i] = static_cast<uint8_t*>(malloc(stream.bufferSize));
+    stream.canFill[i] = xSemaphoreCreateBinary();
+    stream.canSend[i] = xSemaphoreCreateBinary();
+    ok = stream.buffers[i] && stream.canFill[i] && stream.canSend[i];
+  }
+  stream.readerDone = ok ? xSemaphoreCreateBinary() : nullptr;
+  ok = ok && stream.readerDone;
+
+  if (ok) {
+    xSemaphoreGive(stream.canFill[0]);
+    xSemaphoreGive(stream.canFill[1]);
+    ok = xTaskCreate(&downloadReaderTask, "DownloadReader", 4096, &stream, uxTaskPriorityGet(nullptr),
+                     &stream.reader) == pdPASS;
+    if (!ok) {
+      stream.reader = nullptr;
+    }
+  }
+  if (!ok) {
+    Serial.printf("[%lu] [WEB] Could not set up a double-buffered download, free heap %d bytes\n", millis(),
+                  ESP.getFreeHeap());
+    endDownloadStream(stream);
+  }
+  return ok;
+}
+
+// Send `length` bytes from a started download stream. The reader task fills one buffer from the SD card while the
+// other one is being written to the socket, so neither side waits for the other as long as both keep up.
+bool streamFileRange(DownloadStream& stream, const size_t length, WiFiClient& client) {
+  bool ok = true;
+  size_t sent = 0;
+  const unsigned long start = millis();
+  for (int slot = 0; sent < length; slot ^= 1) {
+    xSemaphoreTake(stream.canSend[slot], portMAX_DELAY);
+    const int filled = stream.filled[slot];
+    if (filled <= 0) {
+      Serial.printf("[%lu] [WEB] Download read failed at %zu bytes\n", millis(), sent);
+      ok = false;
+      break;
+    }
+    esp_task_wdt_reset();
+    if (client.write(stream.buffers[slot], filled) != static_cast<size_t>(filled)) {
+      Serial.printf("[%lu] [WEB] Client went away after %zu bytes\n", millis(), sent);
+      ok = false;
+      break;
+    }
+    sent += filled;
+    xSemaphoreGive(stream.canFill[slot]);
+  }
+
+  const unsigned long elapsed = millis() - start;
+  Serial.printf("[%lu] [WEB] Sent %zu bytes in %lu ms (%u KB/s, %zu byte buffers)\n", millis(), sent, elapsed,
+                elapsed > 0 ? static_cast<unsigned>(sent / elapsed) : 0, stream.bufferSize);
+  return ok;
+}
+
+// Fallback when the heap is too low for the reader task: read and send in turn through one small stack buffer
+bool copyFileRange(FsFile& file, size_t length, WiFiClient& client) {
+  uint8_t buffer[1024];
+  while (length > 0) {
+    int bytesRead;
+    {
+      StorageLock lock;
+      bytesRead = file.read(buffer, std::min(sizeof(buffer), length));
+    }
+    if (bytesRead <= 0) {
+      Serial.printf("[%lu] [WEB] Download read failed with %zu bytes left\n", millis(), length);
+      return false;
+    }
+    esp_task_wdt_reset();
+    if (client.write(buffer, bytesRead) != static_cast<size_t>(bytesRead)) {
+      Serial.printf("[%lu] [WEB] Client went away with %zu bytes left\n", millis(), length);
+      return false;
+    }
+    length -= bytesRead;
+  }
+  return true;
+}
+
 String normalizeWebPath(const String& inputPath) {
   if (inputPath.isEmpty() || inputPath == "/") {
     return "/";
@@ -66,17 +311,7 @@ String normalizeWebPath(const String& inputPath) {
   return result;
 }
 
-bool isProtectedItemName(const String& name) {
-  if (name.startsWith(".")) {
-    return true;
-  }
-  for (size_t i = 0; i < HIDDEN_ITEMS_COUNT; i++) {
-    if (name.equals(HIDDEN_ITEMS[i])) {
-      return true;
-    }
-  }
-  return false;
-}
+bool isProtectedItemName(const String& name) { return FsHelpers::isProtectedItemName(name.c_str()); }
 }  // namespace
 
 // File listing page template - now using generated headers:
@@ -157,6 +392,10 @@ void CrossPointWebServer::begin() {
   server->on("/api/settings", HTTP_POST, [this] { handlePostSettings(); });
 
   server->onNotFound([this] { handleNotFound(); });
+
+  // Request headers WebServer should keep for the handlers (it drops all others)
+  static const char* collectedHeaders[] = {"Range", "If-Range"};
+  server->collectHeaders(collectedHeaders, sizeof(collectedHeaders) / sizeof(collectedHeaders[0]));
   Serial.printf("[%lu] [WEB] [MEM] Free heap after route setup: %d bytes\n", millis(), ESP.getFreeHeap());
 
   server->begin();
@@ -195,11 +434,18 @@ void CrossPointWebServer::stop() {
 
   Serial.printf("[%lu] [WEB] [MEM] Free heap before stop: %d bytes\n", millis(), ESP.getFreeHeap());
 
-  // Close any in-progress WebSocket upload
+  // Close any in-progress upload; their writer tasks must stop before the files go away
   if (wsUploadInProgress && wsUploadFile) {
+    wsUploadPipeline.abort();
+    StorageLock lock;
     wsUploadFile.close();
     wsUploadInProgress = false;
   }
+  if (upload.pipeline.isActive()) {
+    upload.pipeline.abort();
+    StorageLock lock;
+    upload.file.close();
+  }
 
   // Stop WebSocket server
   if (wsServer) {
@@ -344,20 +590,8 @@ void CrossPointWebServer::scanFiles(const char* path, const std::function<void(F
     file.getName(name, sizeof(name));
     auto fileName = String(name);
 
-    // Skip hidden items (starting with ".")
-    bool shouldHide = fileName.startsWith(".");
-
-    // Check against explicitly hidden items list
-    if (!shouldHide) {
-      for (size_t i = 0; i < HIDDEN_ITEMS_COUNT; i++) {
-        if (fileName.equals(HIDDEN_ITEMS[i])) {
-          shouldHide = true;
-          break;
-        }
-      }
-    }
-
-    if (!shouldHide) {
+    // Skip hidden items (starting with ".") and protected system folders
+    if (!isProtectedItemName(fileName)) {
       FileInfo info;
       info.name = fileName;
       info.isDirectory = file.isDirectory();
@@ -412,6 +646,8 @@ void CrossPointWebServer::handleFileListData() const {
   bool seenFirst = false;
   JsonDocument doc;
 
+  // Held for the whole listing: a WebSocket upload's writer task may be using the card between loop iterations
+  StorageLock lock;
   scanFiles(currentPath.c_str(), [this, &output, &doc, seenFirst](const FileInfo& info) mutable {
     doc.clear();
     doc["name"] = info.name;
@@ -459,27 +695,39 @@ void CrossPointWebServer::handleDownload() const {
     server->send(403, "text/plain", "Cannot access system files");
     return;
   }
-  for (size_t i = 0; i < HIDDEN_ITEMS_COUNT; i++) {
-    if (itemName.equals(HIDDEN_ITEMS[i])) {
-      server->send(403, "text/plain", "Cannot access protected items");
-      return;
-    }
-  }
-
-  if (!Storage.exists(itemPath.c_str())) {
-    server->send(404, "text/plain", "Item not found");
+  if (isProtectedItemName(itemName)) {
+    server->send(403, "text/plain", "Cannot access protected items");
     return;
   }
 
-  FsFile file = Storage.open(itemPath.c_str());
-  if (!file) {
-    server->send(500, "text/plain", "Failed to open file");
-    return;
-  }
-  if (file.isDirectory()) {
-    file.close();
-    server->send(400, "text/plain", "Path is a directory");
-    return;
+  // The SD card is only used under the storage lock, as an upload's writer task may be running. Streaming the body
+  // releases it between reads.
+  FsFile file;
+  size_t fileSize = 0;
+  String etag;
+  String filename = "download";
+  {
+    StorageLock lock;
+    if (!Storage.exists(itemPath.c_str())) {
+      server->send(404, "text/plain", "Item not found");
+      return;
+    }
+    file = Storage.open(itemPath.c_str());
+    if (!file) {
+      server->send(500, "text/plain", "Failed to open file");
+      return;
+    }
+    if (file.isDirectory()) {
+      file.close();
+      server->send(400, "text/plain", "Path is a directory");
+      return;
+    }
+    char nameBuf[128] = {0};
+    if (file.getName(nameBuf, sizeof(nameBuf))) {
+      filename = nameBuf;
+    }
+    fileSize = file.size();
+    etag = fileEtag(file);
   }
 
   String contentType = "application/octet-stream";
@@ -487,44 +735,85 @@ void CrossPointWebServer::handleDownload() const {
     contentType = "application/epub+zip";
   }
 
-  char nameBuf[128] = {0};
-  String filename = "download";
-  if (file.getName(nameBuf, sizeof(nameBuf))) {
-    filename = nameBuf;
+  // Resumable downloads: a single byte range is honoured unless If-Range names an older version of the file
+  size_t start = 0;
+  size_t end = fileSize > 0 ? fileSize - 1 : 0;
+  bool partial = false;
+  if (server->hasHeader("Range") && (!server->hasHeader("If-Range") || server->header("If-Range") == etag)) {
+    bool ignored = false;
+    if (!parseByteRange(server->header("Range"), fileSize, start, end, ignored)) {
+      StorageLock lock;
+      file.close();
+      server->sendHeader("Content-Range", "bytes */" + String(fileSize));
+      server->send(416, "text/plain", "Range not satisfiable");
+      return;
+    }
+    partial = !ignored;
+  }
+  if (!partial) {
+    start = 0;
+    end = fileSize > 0 ? fileSize - 1 : 0;
   }
+  const size_t length = fileSize > 0 ? end - start + 1 : 0;
 
-  server->setContentLength(file.size());
-  server->sendHeader("Content-Disposition", "attachment; filename=\"" + filename + "\"");
-  server->send(200, contentType.c_str(), "");
+  {
+    StorageLock lock;
+    if (start > 0 && !file.seek(start)) {
+      file.close();
+      server->send(500, "text/plain", "Failed to seek file");
+      return;
+    }
+  }
+
+  // Start the transfer before the status line goes out: once headers are sent, a failure can only truncate the body.
+  // Without the heap for the reader task the body is copied synchronously instead.
+  DownloadStream stream;
+  const bool pipelined = length > 0 && beginDownloadStream(stream, file, length);
 
-  WiFiClient client = server->client();
-  client.write(file);
+  server->setContentLength(length);
+  server->sendHeader("Content-Disposition", "attachment; filename=\"" + filename + "\"");
+  server->sendHeader("Accept-Ranges", "bytes");
+  server->sendHeader("ETag", etag);
+  if (partial) {
+    server->sendHeader("Content-Range", "bytes " + String(start) + "-" + String(end) + "/" + String(fileSize));
+  }
+  server->send(partial ? 206 : 200, contentType.c_str(), "");
+
+  if (length > 0) {
+    WiFiClient client = server->client();
+    if (pipelined) {
+      streamFileRange(stream, length, client);
+      endDownloadStream(stream);
+    } else {
+      copyFileRange(file, length, client);
+    }
+  }
+  StorageLock lock;
   file.close();
 }
 
-// Diagnostic counters for upload performance analysis
+// Upload timing for performance analysis
 static unsigned long uploadStartTime = 0;
-static unsigned long totalWriteTime = 0;
-static size_t writeCount = 0;
-
-static bool flushUploadBuffer(CrossPointWebServer::UploadState& state) {
-  if (state.bufferPos > 0 && state.file) {
-    esp_task_wdt_reset();  // Reset watchdog before potentially slow SD write
-    const unsigned long writeStart = millis();
-    const size_t written = state.file.write(state.buffer.data(), state.bufferPos);
-    totalWriteTime += millis() - writeStart;
-    writeCount++;
-    esp_task_wdt_reset();  // Reset watchdog after SD write
-
-    if (written != state.bufferPos) {
-      Serial.printf("[%lu] [WEB] [UPLOAD] Buffer flush failed: expected %d, wrote %d\n", millis(), state.bufferPos,
-                    written);
-      state.bufferPos = 0;
-      return false;
-    }
-    state.bufferPos = 0;
+
+// Summarise where an upload spent its time: SD busy time overlapping the transfer means the pipeline worked, time spent
+// waiting for a free buffer means the SD card rather than WiFi was the bottleneck
+static void logUploadDiagnostics(const char* tag, const UploadPipeline::Stats& stats, const size_t size,
+                                 const unsigned long elapsed) {
+  const float mbps = (elapsed > 0) ? (size / 1048576.0) / (elapsed / 1000.0) : 0;
+  const float writePercent = (elapsed > 0) ? (stats.writeTimeMs * 100.0 / elapsed) : 0;
+  Serial.printf("[%lu] [%s] [UPLOAD] Diagnostics: %.2f MB/s sustained, %d writes, SD busy %lu ms (%.1f%%), "
+                "waited for SD %lu ms\n",
+                millis(), tag, mbps, stats.writeCount, stats.writeTimeMs, writePercent, stats.stallTimeMs);
+}
+
+// Where an HTTP upload is written: the file itself, or the staging file of an archive that is unpacked afterwards
+static String uploadFilePath(const CrossPointWebServer::UploadState& state) {
+  if (state.extract) {
+    return archiveStagingPath(state.path, state.fileName);
   }
-  return true;
+  String filePath = state.path;
+  if (!filePath.endsWith("/")) filePath += "/";
+  return filePath + state.fileName;
 }
 
 void CrossPointWebServer::handleUpload(UploadState& state) const {
@@ -545,15 +834,15 @@ void CrossPointWebServer::handleUpload(UploadState& state) const {
     // Reset watchdog - this is the critical 1% crash point
     esp_task_wdt_reset();
 
+    state.pipeline.abort();  // Left over from a connection that dropped mid-upload
     state.fileName = upload.filename;
     state.size = 0;
     state.success = false;
     state.error = "";
+    state.extract = server->hasArg("extract");
+    state.extractedFiles = 0;
     uploadStartTime = millis();
     lastLoggedSize = 0;
-    state.bufferPos = 0;
-    totalWriteTime = 0;
-    writeCount = 0;
 
     // Get upload path from query parameter (defaults to root if not specified)
     // Note: We use query parameter instead of form data because multipart form
@@ -576,9 +865,11 @@ void CrossPointWebServer::handleUpload(UploadState& state) const {
     Serial.printf("[%lu] [WEB] [UPLOAD] Free heap: %d bytes\n", millis(), ESP.getFreeHeap());
 
     // Create file path
-    String filePath = state.path;
-    if (!filePath.endsWith("/")) filePath += "/";
-    filePath += state.fileName;
+    const String filePath = uploadFilePath(state);
+
+    // The writer tasks must never wait on the storage lock's holder, so it is only taken around direct SD calls and
+    // released before every pipeline call that can block on the writer (write, finish, abort)
+    StorageLock lock;
 
     // Check if file already exists - SD operations can be slow
     esp_task_wdt_reset();
@@ -596,32 +887,23 @@ void CrossPointWebServer::handleUpload(UploadState& state) const {
       return;
     }
     esp_task_wdt_reset();
+    if (!state.pipeline.begin(state.file)) {
+      state.error = "Not enough memory for upload buffers";
+      state.file.close();
+      Storage.remove(filePath.c_str());
+      return;
+    }
 
     Serial.printf("[%lu] [WEB] [UPLOAD] File created successfully: %s\n", millis(), filePath.c_str());
   } else if (upload.status == UPLOAD_FILE_WRITE) {
     if (state.file && state.error.isEmpty()) {
-      // Buffer incoming data and flush when buffer is full
-      // This reduces SD card write operations and improves throughput
-      const uint8_t* data = upload.buf;
-      size_t remaining = upload.currentSize;
-
-      while (remaining > 0) {
-        const size_t space = UploadState::UPLOAD_BUFFER_SIZE - state.bufferPos;
-        const size_t toCopy = (remaining < space) ? remaining : space;
-
-        memcpy(state.buffer.data() + state.bufferPos, data, toCopy);
-        state.bufferPos += toCopy;
-        data += toCopy;
-        remaining -= toCopy;
-
-        // Flush buffer when full
-        if (state.bufferPos >= UploadState::UPLOAD_BUFFER_SIZE) {
-          if (!flushUploadBuffer(state)) {
-            state.error = "Failed to write to SD card - disk may be full";
-            state.file.close();
-            return;
-          }
-        }
+      // Hand the data to the SD writer task; this only blocks while all of its buffers are queued
+      if (!state.pipeline.write(upload.buf, upload.currentSize)) {
+        state.error = "Failed to write to SD card - disk may be full";
+        state.pipeline.abort();
+        StorageLock lock;
+        state.file.close();
+        return;
       }
 
       state.size += upload.currentSize;
@@ -631,44 +913,51 @@ void CrossPointWebServer::handleUpload(UploadState& state) const {
         const unsigned long elapsed = millis() - uploadStartTime;
         const float kbps = (elapsed > 0) ? (state.size / 1024.0) / (elapsed / 1000.0) : 0;
         Serial.printf("[%lu] [WEB] [UPLOAD] %d bytes (%.1f KB), %.1f KB/s, %d writes\n", millis(), state.size,
-                      state.size / 1024.0, kbps, writeCount);
+                      state.size / 1024.0, kbps, state.pipeline.getStats().writeCount);
         lastLoggedSize = state.size;
       }
     }
   } else if (upload.status == UPLOAD_FILE_END) {
     if (state.file) {
-      // Flush any remaining buffered data
-      if (!flushUploadBuffer(state)) {
+      // Write out any remaining buffered data
+      if (!state.pipeline.finish() && state.error.isEmpty()) {
         state.error = "Failed to write final data to SD card";
       }
+      StorageLock lock;
       state.file.close();
 
       if (state.error.isEmpty()) {
         state.success = true;
         const unsigned long elapsed = millis() - uploadStartTime;
         const float avgKbps = (elapsed > 0) ? (state.size / 1024.0) / (elapsed / 1000.0) : 0;
-        const float writePercent = (elapsed > 0) ? (totalWriteTime * 100.0 / elapsed) : 0;
         Serial.printf("[%lu] [WEB] [UPLOAD] Complete: %s (%d bytes in %lu ms, avg %.1f KB/s)\n", millis(),
                       state.fileName.c_str(), state.size, elapsed, avgKbps);
-        Serial.printf("[%lu] [WEB] [UPLOAD] Diagnostics: %d writes, total write time: %lu ms (%.1f%%)\n", millis(),
-                      writeCount, totalWriteTime, writePercent);
-
-        // Clear epub cache to prevent stale metadata issues when overwriting files
-        String filePath = state.path;
-        if (!filePath.endsWith("/")) filePath += "/";
-        filePath += state.fileName;
-        clearEpubCacheIfNeeded(filePath);
+        logUploadDiagnostics("WEB", state.pipeline.getStats(), state.size, elapsed);
+
+        if (state.extract) {
+          size_t failed = 0;
+          const auto progress = [](const size_t done, const size_t total, const std::string& path, bool) {
+            Serial.printf("[%lu] [WEB] [UPLOAD] Unpacked %u/%u: %s\n", millis(), done, total, path.c_str());
+          };
+          if (!extractUploadedArchive(uploadFilePath(state), state.path, progress, state.extractedFiles, failed)) {
+            state.error = "Not a readable zip or tar archive";
+          } else if (failed > 0) {
+            state.error = "Unpacked " + String(state.extractedFiles) + " files, " + String(failed) + " failed";
+          }
+          state.success = state.error.isEmpty();
+        } else {
+          // Clear epub cache to prevent stale metadata issues when overwriting files
+          clearEpubCacheIfNeeded(uploadFilePath(state));
+        }
       }
     }
   } else if (upload.status == UPLOAD_FILE_ABORTED) {
-    state.bufferPos = 0;  // Discard buffered data
+    state.pipeline.abort();  // Discard buffered data
     if (state.file) {
+      StorageLock lock;
       state.file.close();
       // Try to delete the incomplete file
-      String filePath = state.path;
-      if (!filePath.endsWith("/")) filePath += "/";
-      filePath += state.fileName;
-      Storage.remove(filePath.c_str());
+      Storage.remove(uploadFilePath(state).c_str());
     }
     state.error = "Upload aborted";
     Serial.printf("[%lu] [WEB] Upload aborted\n", millis());
@@ -676,7 +965,9 @@ void CrossPointWebServer::handleUpload(UploadState& state) const {
 }
 
 void CrossPointWebServer::handleUploadPost(UploadState& state) const {
-  if (state.success) {
+  if (state.success && state.extract) {
+    server->send(200, "text/plain", "Unpacked " + String(state.extractedFiles) + " files from " + state.fileName);
+  } else if (state.success) {
     server->send(200, "text/plain", "File uploaded successfully: " + state.fileName);
   } else {
     const String error = state.error.isEmpty() ? "Unknown error during upload" : state.error;
@@ -718,6 +1009,8 @@ void CrossPointWebServer::handleCreateFolder() const {
 
   Serial.printf("[%lu] [WEB] Creating folder: %s\n", millis(), folderPath.c_str());
 
+  StorageLock lock;
+
   // Check if already exists
   if (Storage.exists(folderPath.c_str())) {
     server->send(400, "text/plain", "Folder already exists");
@@ -771,6 +1064,7 @@ void CrossPointWebServer::handleRename() const {
     return;
   }
 
+  StorageLock lock;
   if (!Storage.exists(itemPath.c_str())) {
     server->send(404, "text/plain", "Item not found");
     return;
@@ -847,6 +1141,7 @@ void CrossPointWebServer::handleMove() const {
     }
   }
 
+  StorageLock lock;
   if (!Storage.exists(itemPath.c_str())) {
     server->send(404, "text/plain", "Item not found");
     return;
@@ -941,14 +1236,14 @@ void CrossPointWebServer::handleDelete() const {
   }
 
   // Check against explicitly protected items
-  for (size_t i = 0; i < HIDDEN_ITEMS_COUNT; i++) {
-    if (itemName.equals(HIDDEN_ITEMS[i])) {
-      Serial.printf("[%lu] [WEB] Delete rejected - protected item: %s\n", millis(), itemPath.c_str());
-      server->send(403, "text/plain", "Cannot delete protected items");
-      return;
-    }
+  if (isProtectedItemName(itemName)) {
+    Serial.printf("[%lu] [WEB] Delete rejected - protected item: %s\n", millis(), itemPath.c_str());
+    server->send(403, "text/plain", "Cannot delete protected items");
+    return;
   }
 
+  StorageLock lock;
+
   // Check if item exists
   if (!Storage.exists(itemPath.c_str())) {
     Serial.printf("[%lu] [WEB] Delete failed - item not found: %s\n", millis(), itemPath.c_str());
@@ -1147,7 +1442,10 @@ void CrossPointWebServer::handlePostSettings() {
     }
   }
 
-  SETTINGS.saveToFile();
+  {
+    StorageLock lock;
+    SETTINGS.saveToFile();
+  }
 
   Serial.printf("[%lu] [WEB] Applied %d setting(s)\n", millis(), applied);
   server->send(200, "text/plain", String("Applied ") + String(applied) + " setting(s)");
@@ -1172,13 +1470,12 @@ void CrossPointWebServer::onWebSocketEvent(uint8_t num, WStype_t type, uint8_t*
       Serial.printf("[%lu] [WS] Client %u disconnected\n", millis(), num);
       // Clean up any in-progress upload
       if (wsUploadInProgress && wsUploadFile) {
+        wsUploadPipeline.abort();
+        StorageLock lock;
         wsUploadFile.close();
         // Delete incomplete file
-        String filePath = wsUploadPath;
-        if (!filePath.endsWith("/")) filePath += "/";
-        filePath += wsUploadFileName;
-        Storage.remove(filePath.c_str());
-        Serial.printf("[%lu] [WS] Deleted incomplete upload: %s\n", millis(), filePath.c_str());
+        Storage.remove(wsUploadFilePath.c_str());
+        Serial.printf("[%lu] [WS] Deleted incomplete upload: %s\n", millis(), wsUploadFilePath.c_str());
       }
       wsUploadInProgress = false;
       break;
@@ -1193,13 +1490,23 @@ void CrossPointWebServer::onWebSocketEvent(uint8_t num, WStype_t type, uint8_t*
       String msg = String((char*)payload);
       Serial.printf("[%lu] [WS] Text from client %u: %s\n", millis(), num, msg.c_str());
 
-      if (msg.startsWith("START:")) {
+      // ARCHIVE: is START: for a zip or tar archive that is unpacked into <path> once it has arrived
+      const bool isArchive = msg.startsWith("ARCHIVE:");
+      if (msg.startsWith("START:") || isArchive) {
         // Parse: START:<filename>:<size>:<path>
-        int firstColon = msg.indexOf(':', 6);
+        const int nameStart = isArchive ? 8 : 6;
+        int firstColon = msg.indexOf(':', nameStart);
         int secondColon = msg.indexOf(':', firstColon + 1);
 
         if (firstColon > 0 && secondColon > 0) {
-          wsUploadFileName = msg.substring(6, firstColon);
+          // A new START replaces an unfinished upload; its writer task must let go of the file first
+          wsUploadPipeline.abort();
+          if (wsUploadFile) {
+            StorageLock lock;
+            wsUploadFile.close();
+          }
+
+          wsUploadFileName = msg.substring(nameStart, firstColon);
           wsUploadSize = msg.substring(firstColon + 1, secondColon).toInt();
           wsUploadPath = msg.substring(secondColon + 1);
           wsUploadReceived = 0;
@@ -1212,13 +1519,21 @@ void CrossPointWebServer::onWebSocketEvent(uint8_t num, WStype_t type, uint8_t*
           }
 
           // Build file path
-          String filePath = wsUploadPath;
-          if (!filePath.endsWith("/")) filePath += "/";
-          filePath += wsUploadFileName;
+          wsUploadExtract = isArchive;
+          if (isArchive) {
+            wsUploadFilePath = archiveStagingPath(wsUploadPath, wsUploadFileName);
+          } else {
+            wsUploadFilePath = wsUploadPath;
+            if (!wsUploadFilePath.endsWith("/")) wsUploadFilePath += "/";
+            wsUploadFilePath += wsUploadFileName;
+          }
+          const String& filePath = wsUploadFilePath;
 
           Serial.printf("[%lu] [WS] Starting upload: %s (%d bytes) to %s\n", millis(), wsUploadFileName.c_str(),
                         wsUploadSize, filePath.c_str());
 
+          StorageLock lock;
+
           // Check if file exists and remove it
           esp_task_wdt_reset();
           if (Storage.exists(filePath.c_str())) {
@@ -1233,6 +1548,13 @@ void CrossPointWebServer::onWebSocketEvent(uint8_t num, WStype_t type, uint8_t*
             return;
           }
           esp_task_wdt_reset();
+          if (!wsUploadPipeline.begin(wsUploadFile)) {
+            wsUploadFile.close();
+            Storage.remove(filePath.c_str());
+            wsServer->sendTXT(num, "ERROR:Not enough memory for upload buffers");
+            wsUploadInProgress = false;
+            return;
+          }
 
           wsUploadInProgress = true;
           wsServer->sendTXT(num, "READY");
@@ -1249,19 +1571,18 @@ void CrossPointWebServer::onWebSocketEvent(uint8_t num, WStype_t type, uint8_t*
         return;
       }
 
-      // Write binary data directly to file
+      // Queue the data for the SD writer task; this only blocks while all of its buffers are queued
       esp_task_wdt_reset();
-      size_t written = wsUploadFile.write(payload, length);
-      esp_task_wdt_reset();
-
-      if (written != length) {
+      if (!wsUploadPipeline.write(payload, length)) {
+        wsUploadPipeline.abort();
+        StorageLock lock;
         wsUploadFile.close();
         wsUploadInProgress = false;
         wsServer->sendTXT(num, "ERROR:Write failed - disk full?");
         return;
       }
 
-      wsUploadReceived += written;
+      wsUploadReceived += length;
 
       // Send progress update (every 64KB or at end)
       static size_t lastProgressSent = 0;
@@ -1273,8 +1594,15 @@ void CrossPointWebServer::onWebSocketEvent(uint8_t num, WStype_t type, uint8_t*
 
       // Check if upload complete
       if (wsUploadReceived >= wsUploadSize) {
+        const bool written = wsUploadPipeline.finish();
+        StorageLock lock;
         wsUploadFile.close();
         wsUploadInProgress = false;
+        if (!written) {
+          wsServer->sendTXT(num, "ERROR:Write failed - disk full?");
+          lastProgressSent = 0;
+          return;
+        }
 
         wsLastCompleteName = wsUploadFileName;
         wsLastCompleteSize = wsUploadSize;
@@ -1285,15 +1613,34 @@ void CrossPointWebServer::onWebSocketEvent(uint8_t num, WStype_t type, uint8_t*
 
         Serial.printf("[%lu] [WS] Upload complete: %s (%d bytes in %lu ms, %.1f KB/s)\n", millis(),
                       wsUploadFileName.c_str(), wsUploadSize, elapsed, kbps);
+        logUploadDiagnostics("WS", wsUploadPipeline.getStats(), wsUploadSize, elapsed);
 
-        // Clear epub cache to prevent stale metadata issues when overwriting files
-        String filePath = wsUploadPath;
-        if (!filePath.endsWith("/")) filePath += "/";
-        filePath += wsUploadFileName;
-        clearEpubCacheIfNeeded(filePath);
+        lastProgressSent = 0;
+        if (wsUploadExtract) {
+          // Report each unpacked file as EXTRACT:<done>:<total>:<path>
+          size_t extracted = 0;
+          size_t failed = 0;
+          const bool unpacked = extractUploadedArchive(
+              wsUploadFilePath, wsUploadPath,
+              [this, num](const size_t done, const size_t total, const std::string& path, bool) {
+                String progress = "EXTRACT:" + String(done) + ":" + String(total) + ":" + String(path.c_str());
+                wsServer->sendTXT(num, progress);
+              },
+              extracted, failed);
+          if (!unpacked) {
+            wsServer->sendTXT(num, "ERROR:Not a readable zip or tar archive");
+            return;
+          }
+          if (failed > 0) {
+            wsServer->sendTXT(num, "ERROR:Unpacked " + String(extracted) + " files, " + String(failed) + " failed");
+            return;
+          }
+        } else {
+          // Clear epub cache to prevent stale metadata issues when overwriting files
+          clearEpubCacheIfNeeded(wsUploadFilePath);
+        }
 
         wsServer->sendTXT(num, "DONE");
-        lastProgressSent = 0;
       }
       break;
     }
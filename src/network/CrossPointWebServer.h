@@ -9,6 +9,8 @@
 #include <string>
 #include <vector>
 
+#include "UploadPipeline.h"
+
 // Structure to hold file information
 struct FileInfo {
   String name;
@@ -37,15 +39,11 @@ class CrossPointWebServer {
     size_t size = 0;
     bool success = false;
     String error = "";
+    bool extract = false;  // unpack the uploaded zip/tar archive into `path`
+    size_t extractedFiles = 0;
 
-    // Upload write buffer - batches small writes into larger SD card operations
-    // 4KB is a good balance: large enough to reduce syscall overhead, small enough
-    // to keep individual write times short and avoid watchdog issues
-    static constexpr size_t UPLOAD_BUFFER_SIZE = 4096;  // 4KB buffer
-    std::vector<uint8_t> buffer;
-    size_t bufferPos = 0;
-
-    UploadState() { buffer.resize(UPLOAD_BUFFER_SIZE); }
+    // Batches incoming data into larger SD card writes, done by a separate task so receiving continues meanwhile
+    UploadPipeline pipeline;
   } upload;
 
   CrossPointWebServer();
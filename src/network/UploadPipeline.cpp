@@ -0,0 +1,183 @@
+#include "UploadPipeline.h"
+
+#include <Arduino.h>
+#include <esp_task_wdt.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+constexpr size_t HEAP_RESERVE = 48 * 1024;  // keep this much free for WiFi/lwIP
+constexpr TickType_t WAIT_SLICE = pdMS_TO_TICKS(100);
+}  // namespace
+
+UploadPipeline::~UploadPipeline() { abort(); }
+
+bool UploadPipeline::begin(FsFile& file) {
+  abort();
+  this->file = &file;
+  failed = false;
+  cancelled = false;
+  stats = Stats();
+
+  // Fewer buffers first, then smaller ones, until the ring fits next to the WiFi stack. Two buffers are enough to
+  // overlap receiving with writing; more of them absorb the occasional slow FAT cluster allocation.
+  bufferCount = MAX_BUFFERS;
+  bufferSize = BUFFER_SIZE;
+  while (ESP.getFreeHeap() < bufferCount * bufferSize + HEAP_RESERVE) {
+    if (bufferCount > 2) {
+      bufferCount--;
+    } else if (bufferSize > MIN_BUFFER_SIZE) {
+      bufferSize /= 2;
+    } else {
+      break;
+    }
+  }
+
+  freeSlots = xQueueCreate(bufferCount, sizeof(uint8_t));
+  fullSlots = xQueueCreate(bufferCount + 1, sizeof(uint8_t));
+  writerDone = xSemaphoreCreateBinary();
+  bool ok = freeSlots && fullSlots && writerDone;
+  for (size_t i = 0; i < bufferCount && ok; i++) {
+    buffers[i] = static_cast<uint8_t*>(malloc(bufferSize));
+    ok = buffers[i] != nullptr;
+    const auto slot = static_cast<uint8_t>(i);
+    ok = ok && xQueueSend(freeSlots, &slot, 0) == pdTRUE;
+  }
+  ok = ok && xTaskCreate(&UploadPipeline::writerTask, "UploadWriter", 4096, this, uxTaskPriorityGet(nullptr),
+                         &writer) == pdPASS;
+  if (!ok) {
+    Serial.printf("[%lu] [UPL] Failed to start upload pipeline, free heap %d bytes\n", millis(), ESP.getFreeHeap());
+    writer = nullptr;
+    release();
+    return false;
+  }
+
+  Serial.printf("[%lu] [UPL] Pipeline: %u x %u byte buffers, free heap %d bytes\n", millis(), bufferCount, bufferSize,
+                ESP.getFreeHeap());
+  return true;
+}
+
+void UploadPipeline::writerTask(void* param) {
+  auto* self = static_cast<UploadPipeline*>(param);
+  uint8_t slot;
+  while (xQueueReceive(self->fullSlots, &slot, portMAX_DELAY) == pdTRUE && slot != END_OF_STREAM) {
+    if (!self->failed && !self->cancelled) {
+      const unsigned long start = millis();
+      size_t written;
+      {
+        // The web server's handlers may be using the card meanwhile
+        StorageLock lock;
+        written = self->file->write(self->buffers[slot], self->lengths[slot]);
+      }
+      self->stats.writeTimeMs += millis() - start;
+      self->stats.writeCount++;
+      self->stats.bytesWritten += written;
+      if (written != self->lengths[slot]) {
+        Serial.printf("[%lu] [UPL] SD write failed: expected %u, wrote %u\n", millis(), self->lengths[slot], written);
+        self->failed = true;
+      }
+    }
+    xQueueSend(self->freeSlots, &slot, 0);
+  }
+  xSemaphoreGive(self->writerDone);
+  vTaskDelete(nullptr);
+}
+
+bool UploadPipeline::acquireSlot() {
+  const unsigned long start = millis();
+  uint8_t slot;
+  // Every buffer is queued for the SD card: wait, which stops reading from the socket and lets TCP push back
+  while (xQueueReceive(freeSlots, &slot, WAIT_SLICE) != pdTRUE) {
+    esp_task_wdt_reset();
+    if (failed) {
+      return false;
+    }
+  }
+  stats.stallTimeMs += millis() - start;
+  currentSlot = slot;
+  currentFill = 0;
+  return true;
+}
+
+void UploadPipeline::submitSlot() {
+  const auto slot = static_cast<uint8_t>(currentSlot);
+  lengths[slot] = currentFill;
+  // fullSlots holds every buffer plus the end marker, so this never blocks
+  xQueueSend(fullSlots, &slot, portMAX_DELAY);
+  currentSlot = -1;
+  currentFill = 0;
+}
+
+bool UploadPipeline::write(const uint8_t* data, size_t size) {
+  if (!writer) {
+    return false;
+  }
+  while (size > 0) {
+    if (failed || (currentSlot < 0 && !acquireSlot())) {
+      return false;
+    }
+    const size_t toCopy = std::min(size, bufferSize - currentFill);
+    memcpy(buffers[currentSlot] + currentFill, data, toCopy);
+    currentFill += toCopy;
+    data += toCopy;
+    size -= toCopy;
+    if (currentFill == bufferSize) {
+      submitSlot();
+    }
+  }
+  return !failed;
+}
+
+bool UploadPipeline::finish() {
+  if (!writer) {
+    return false;
+  }
+  if (currentSlot >= 0 && currentFill > 0) {
+    submitSlot();
+  }
+  stop();
+  return !failed;
+}
+
+void UploadPipeline::abort() {
+  if (!writer) {
+    return;
+  }
+  cancelled = true;
+  stop();
+}
+
+void UploadPipeline::stop() {
+  const uint8_t end = END_OF_STREAM;
+  xQueueSend(fullSlots, &end, portMAX_DELAY);
+  // The writer drains what is queued first; keep the watchdog fed while the SD card catches up
+  while (xSemaphoreTake(writerDone, WAIT_SLICE) != pdTRUE) {
+    esp_task_wdt_reset();
+  }
+  writer = nullptr;
+  release();
+}
+
+void UploadPipeline::release() {
+  for (size_t i = 0; i < MAX_BUFFERS; i++) {
+    free(buffers[i]);
+    buffers[i] = nullptr;
+  }
+  if (freeSlots) {
+    vQueueDelete(freeSlots);
+    freeSlots = nullptr;
+  }
+  if (fullSlots) {
+    vQueueDelete(fullSlots);
+    fullSlots = nullptr;
+  }
+  if (writerDone) {
+    vSemaphoreDelete(writerDone);
+    writerDone = nullptr;
+  }
+  currentSlot = -1;
+  currentFill = 0;
+  file = nullptr;
+}
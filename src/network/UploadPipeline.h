@@ -0,0 +1,76 @@
+#pragma once
+#include <HalStorage.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Writes an upload to the SD card from a separate task.
+ *
+ * Network callbacks only copy incoming data into a ring of buffers; the writer task drains full buffers to the file.
+ * write() blocks only while every buffer is still waiting for the SD card, which throttles the sender through TCP
+ * instead of stalling every receive on an SD write.
+ *
+ * The writer task takes the storage lock around each write. write(), finish() and abort() wait for it, so they must
+ * be called without holding that lock.
+ */
+class UploadPipeline {
+ public:
+  static constexpr size_t MAX_BUFFERS = 4;
+  static constexpr size_t BUFFER_SIZE = 8 * 1024;
+  static constexpr size_t MIN_BUFFER_SIZE = 2 * 1024;
+
+  struct Stats {
+    size_t bytesWritten = 0;
+    size_t writeCount = 0;
+    unsigned long writeTimeMs = 0;  // time the writer task spent in FsFile::write
+    unsigned long stallTimeMs = 0;  // time write() waited for a free buffer
+  };
+
+  UploadPipeline() = default;
+  ~UploadPipeline();
+  UploadPipeline(const UploadPipeline&) = delete;
+  UploadPipeline& operator=(const UploadPipeline&) = delete;
+
+  // Start draining into `file`. The file belongs to the writer task until finish() or abort() returns.
+  bool begin(FsFile& file);
+
+  // Queue `size` bytes for writing. Returns false once a write to the SD card has failed.
+  bool write(const uint8_t* data, size_t size);
+
+  // Write out everything queued and stop the writer task. Returns false if any write failed.
+  bool finish();
+
+  // Drop whatever is still queued and stop the writer task
+  void abort();
+
+  bool isActive() const { return writer != nullptr; }
+  const Stats& getStats() const { return stats; }
+
+ private:
+  static constexpr uint8_t END_OF_STREAM = 0xFF;
+
+  FsFile* file = nullptr;
+  TaskHandle_t writer = nullptr;
+  QueueHandle_t freeSlots = nullptr;  // buffers the network side may fill
+  QueueHandle_t fullSlots = nullptr;  // buffers waiting for the writer task, then END_OF_STREAM
+  SemaphoreHandle_t writerDone = nullptr;
+  uint8_t* buffers[MAX_BUFFERS] = {};
+  size_t lengths[MAX_BUFFERS] = {};
+  size_t bufferCount = 0;
+  size_t bufferSize = 0;
+  int currentSlot = -1;
+  size_t currentFill = 0;
+  volatile bool failed = false;
+  volatile bool cancelled = false;
+  Stats stats;
+
+  static void writerTask(void* param);
+  bool acquireSlot();
+  void submitSlot();
+  void stop();
+  void release();
+};
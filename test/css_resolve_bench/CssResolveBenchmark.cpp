@@ -0,0 +1,318 @@
+#include <HalStorage.h>
+#include <SDCardManager.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Epub/css/CssParser.h"
+
+// Checks CssParser::resolveStyle against the plain map lookups it replaced, on generated stylesheets, and times both.
+// The reference keeps every rule in a map keyed by the normalised selector, as the parser did before selectors were
+// interned, and resolves tag, then each class, then each tag.class with lowercased string keys.
+
+namespace {
+// Deterministic noise, so failures reproduce
+uint32_t rngState = 12345;
+uint32_t nextRandom() {
+  rngState = rngState * 1103515245 + 12345;
+  return rngState >> 8;
+}
+size_t pick(const size_t count) { return nextRandom() % count; }
+
+const char* const TAGS[] = {"p", "div", "span", "h1", "h2", "h3", "a", "em", "li", "blockquote", "body", "section"};
+constexpr size_t TAG_COUNT = sizeof(TAGS) / sizeof(TAGS[0]);
+constexpr size_t CLASS_COUNT = 200;
+
+// Selectors the index ignores; they must never match a plain element lookup
+const char* const COMPLEX_SELECTORS[] = {"div p", "p > span", "#note", "a:hover", "p.c1.c2", "*", "h1 + p", ".c3 .c4",
+                                         "li::before"};
+const char* const DECLARATIONS[] = {"text-align: center", "text-align: justify", "text-align: right",
+                                    "font-style: italic", "font-weight: bold", "font-weight: normal",
+                                    "text-decoration: underline", "text-indent: 1.5em", "margin-top: 2px",
+                                    "margin: 1em 0", "padding-left: 5%", "margin-left: 3pt", "padding: 1px 2px 3px 4px",
+                                    "color: red", "line-height: 1.4"};
+
+struct SheetSpec {
+  const char* name;
+  int rules;
+  int maxSelectors;  // Per rule group
+  bool mixedCase;
+  bool comments;
+  uint32_t seed;
+};
+
+struct Rule {
+  std::vector<std::string> selectors;
+  std::string declarations;
+};
+
+std::string className(const size_t index) { return "c" + std::to_string(index); }
+
+std::string randomCase(std::string s) {
+  for (char& c : s) {
+    if (nextRandom() % 3 == 0) {
+      c = static_cast<char>(toupper(static_cast<unsigned char>(c)));
+    }
+  }
+  return s;
+}
+
+std::vector<Rule> makeRules(const SheetSpec& spec) {
+  rngState = spec.seed;
+  std::vector<Rule> rules(spec.rules);
+  for (Rule& rule : rules) {
+    const int selectorCount = 1 + static_cast<int>(pick(spec.maxSelectors));
+    for (int i = 0; i < selectorCount; i++) {
+      std::string selector;
+      const size_t kind = pick(20);
+      if (kind < 4) {
+        selector = TAGS[pick(TAG_COUNT)];
+      } else if (kind < 11) {
+        selector = "." + className(pick(CLASS_COUNT));
+      } else if (kind < 17) {
+        selector = std::string(TAGS[pick(TAG_COUNT)]) + "." + className(pick(CLASS_COUNT));
+      } else {
+        selector = COMPLEX_SELECTORS[pick(sizeof(COMPLEX_SELECTORS) / sizeof(COMPLEX_SELECTORS[0]))];
+      }
+      rule.selectors.push_back(spec.mixedCase ? randomCase(selector) : selector);
+    }
+    const int declarationCount = 1 + static_cast<int>(pick(4));
+    for (int i = 0; i < declarationCount; i++) {
+      rule.declarations += std::string(i > 0 ? "; " : "") + DECLARATIONS[pick(sizeof(DECLARATIONS) / sizeof(char*))];
+    }
+  }
+  return rules;
+}
+
+std::string stylesheetText(const std::vector<Rule>& rules, const bool comments) {
+  std::string css;
+  for (const Rule& rule : rules) {
+    if (comments && nextRandom() % 5 == 0) {
+      css += "/* generated { rule } */\n";
+    }
+    for (size_t i = 0; i < rule.selectors.size(); i++) {
+      css += (i > 0 ? ",\n  " : "") + rule.selectors[i];
+    }
+    css += " {\n  " + rule.declarations + ";\n}\n";
+  }
+  return css;
+}
+
+// ---- Reference ----
+
+std::string lowercase(std::string s) {
+  for (char& c : s) {
+    c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+  }
+  return s;
+}
+
+std::vector<std::string> splitWhitespace(const std::string& s) {
+  std::vector<std::string> parts;
+  std::string part;
+  for (const char c : s) {
+    if (isspace(static_cast<unsigned char>(c))) {
+      if (!part.empty()) {
+        parts.push_back(part);
+        part.clear();
+      }
+    } else {
+      part.push_back(c);
+    }
+  }
+  if (!part.empty()) {
+    parts.push_back(part);
+  }
+  return parts;
+}
+
+using ReferenceRules = std::unordered_map<std::string, CssStyle>;
+
+ReferenceRules referenceRules(const std::vector<Rule>& rules) {
+  ReferenceRules map;
+  for (const Rule& rule : rules) {
+    const CssStyle style = CssParser::parseInlineStyle(rule.declarations);
+    if (!style.defined.anySet()) {
+      continue;
+    }
+    for (const std::string& selector : rule.selectors) {
+      const std::string key = lowercase(selector);
+      const auto it = map.find(key);
+      if (it != map.end()) {
+        it->second.applyOver(style);
+      } else {
+        map[key] = style;
+      }
+    }
+  }
+  return map;
+}
+
+CssStyle referenceResolve(const ReferenceRules& rules, const std::string& tagName, const std::string& classAttr) {
+  CssStyle result;
+  const std::string tag = lowercase(tagName);
+  const auto apply = [&](const std::string& key) {
+    const auto it = rules.find(key);
+    if (it != rules.end()) {
+      result.applyOver(it->second);
+    }
+  };
+  apply(tag);
+  const auto classes = splitWhitespace(classAttr);
+  for (const auto& cls : classes) {
+    apply("." + lowercase(cls));
+  }
+  for (const auto& cls : classes) {
+    apply(tag + "." + lowercase(cls));
+  }
+  return result;
+}
+
+bool sameLength(const CssLength& a, const CssLength& b) { return a.value == b.value && a.unit == b.unit; }
+
+bool sameStyle(const CssStyle& a, const CssStyle& b) {
+  const CssPropertyFlags& fa = a.defined;
+  const CssPropertyFlags& fb = b.defined;
+  return a.textAlign == b.textAlign && a.fontStyle == b.fontStyle && a.fontWeight == b.fontWeight &&
+         a.textDecoration == b.textDecoration && sameLength(a.textIndent, b.textIndent) &&
+         sameLength(a.marginTop, b.marginTop) && sameLength(a.marginBottom, b.marginBottom) &&
+         sameLength(a.marginLeft, b.marginLeft) && sameLength(a.marginRight, b.marginRight) &&
+         sameLength(a.paddingTop, b.paddingTop) && sameLength(a.paddingBottom, b.paddingBottom) &&
+         sameLength(a.paddingLeft, b.paddingLeft) && sameLength(a.paddingRight, b.paddingRight) &&
+         fa.textAlign == fb.textAlign && fa.fontStyle == fb.fontStyle && fa.fontWeight == fb.fontWeight &&
+         fa.textDecoration == fb.textDecoration && fa.textIndent == fb.textIndent && fa.marginTop == fb.marginTop &&
+         fa.marginBottom == fb.marginBottom && fa.marginLeft == fb.marginLeft && fa.marginRight == fb.marginRight &&
+         fa.paddingTop == fb.paddingTop && fa.paddingBottom == fb.paddingBottom && fa.paddingLeft == fb.paddingLeft &&
+         fa.paddingRight == fb.paddingRight;
+}
+
+// ---- Queries ----
+
+struct Query {
+  std::string tag;
+  std::string classAttr;
+  bool nullClass;  // Pass nullptr rather than "" to resolveStyle
+};
+
+// Elements as a chapter produces them: known and unknown tags and classes in any case, odd spacing, and runs of
+// repeated combinations like consecutive paragraphs
+std::vector<Query> makeQueries(const size_t count) {
+  std::vector<Query> queries;
+  queries.reserve(count);
+  while (queries.size() < count) {
+    if (queries.size() >= 16 && nextRandom() % 2 == 0) {
+      queries.push_back(queries[queries.size() - 1 - pick(16)]);
+      continue;
+    }
+    Query query;
+    const size_t tagKind = pick(10);
+    query.tag = tagKind < 7 ? TAGS[pick(TAG_COUNT)] : tagKind < 9 ? randomCase(TAGS[pick(TAG_COUNT)]) : "table";
+    const int classCount = static_cast<int>(pick(7));
+    for (int i = 0; i < classCount; i++) {
+      std::string cls = nextRandom() % 5 == 0 ? "u" + std::to_string(pick(50)) : className(pick(CLASS_COUNT));
+      query.classAttr += (i > 0 ? (nextRandom() % 4 == 0 ? " \t " : " ") : nextRandom() % 4 == 0 ? "  " : "") +
+                         (nextRandom() % 6 == 0 ? randomCase(cls) : cls);
+    }
+    query.nullClass = query.classAttr.empty() && nextRandom() % 2 == 0;
+    queries.push_back(query);
+  }
+  return queries;
+}
+
+template <typename Fn>
+double timeNs(const size_t count, Fn&& fn) {
+  const auto start = std::chrono::steady_clock::now();
+  fn();
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+}
+
+bool checkSheet(const SheetSpec& spec, const std::string& tempDir, const size_t queryCount) {
+  const std::vector<Rule> rules = makeRules(spec);
+  const std::string path = tempDir + "/" + std::to_string(spec.seed) + ".css";
+  std::ofstream(path) << stylesheetText(rules, spec.comments);
+
+  CssParser parser;
+  FsFile file;
+  if (!Storage.openFileForRead("CSS", path, file) || !parser.loadFromStream(file)) {
+    std::cout << "  " << spec.name << ": FAILED to load the stylesheet" << std::endl;
+    return false;
+  }
+  file.close();
+
+  const ReferenceRules reference = referenceRules(rules);
+  const std::vector<Query> queries = makeQueries(queryCount);
+
+  std::vector<CssStyle> expected(queries.size());
+  const double referenceNs = timeNs(queries.size(), [&] {
+    for (size_t i = 0; i < queries.size(); i++) {
+      expected[i] = referenceResolve(reference, queries[i].tag, queries[i].classAttr);
+    }
+  });
+  std::vector<CssStyle> actual(queries.size());
+  const double internedNs = timeNs(queries.size(), [&] {
+    for (size_t i = 0; i < queries.size(); i++) {
+      const Query& q = queries[i];
+      actual[i] = parser.resolveStyle(q.tag.c_str(), q.nullClass ? nullptr : q.classAttr.c_str());
+    }
+  });
+
+  size_t mismatches = 0;
+  for (size_t i = 0; i < queries.size(); i++) {
+    if (!sameStyle(expected[i], actual[i])) {
+      if (mismatches++ == 0) {
+        std::cout << "    first mismatch: <" << queries[i].tag << " class=\"" << queries[i].classAttr << "\">"
+                  << std::endl;
+      }
+    }
+  }
+  const bool match = mismatches == 0 && parser.ruleCount() == reference.size();
+  std::cout << "  " << spec.name << ": " << reference.size() << " selectors, " << queries.size() << " lookups, "
+            << referenceNs << " ns -> " << internedNs << " ns per lookup";
+  if (parser.ruleCount() != reference.size()) {
+    std::cout << "  MISMATCH parser kept " << parser.ruleCount() << " selectors";
+  }
+  if (mismatches > 0) {
+    std::cout << "  MISMATCH on " << mismatches << " lookups";
+  }
+  std::cout << std::endl;
+  return match;
+}
+}  // namespace
+
+int main() {
+  const std::string tempDir =
+      (std::filesystem::temp_directory_path() / ("css_resolve_bench_" + std::to_string(getpid()))).string();
+  std::filesystem::create_directories(tempDir);
+
+  // Paths are absolute, so the card is the host's root. The parser's own logging goes to stdout as well.
+  SDCardManager::getInstance().setRoot("");
+  Storage.begin();
+
+  const SheetSpec sheets[] = {
+      {"small", 12, 1, false, false, 1},
+      {"medium, grouped selectors", 80, 3, false, true, 2},
+      {"large", 436, 2, false, true, 3},
+      {"mixed case", 150, 2, true, false, 4},
+      {"many duplicates", 300, 1, true, true, 5},
+  };
+  constexpr size_t QUERY_COUNT = 300000;
+
+  int failures = 0;
+  std::cout << "resolveStyle against the map lookups (reference -> interned)" << std::endl;
+  for (const SheetSpec& spec : sheets) {
+    failures += checkSheet(spec, tempDir, QUERY_COUNT) ? 0 : 1;
+  }
+
+  std::error_code error;
+  std::filesystem::remove_all(tempDir, error);
+
+  std::cout << (failures == 0 ? "All lookups match" : std::to_string(failures) + " stylesheet(s) failed") << std::endl;
+  return failures == 0 ? 0 : 1;
+}
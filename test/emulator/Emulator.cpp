@@ -0,0 +1,80 @@
+#include <Arduino.h>
+#include <EInkDisplay.h>
+#include <SDCardManager.h>
+
+#include <cstdlib>
+
+#include "host/HostInput.h"
+
+// Runs the firmware's setup() and loop() on the host. The SD card is a directory, every display refresh can be
+// written out as an image, and buttons are replayed from a script, so a session can run under perf or valgrind.
+
+namespace {
+unsigned long startTime = 0;
+
+void printUsage(const char* program) {
+  printf(
+      "Usage: %s --sd <dir> [--script <file>] [--frames <dir>] [--landscape] [--timeout <ms>]\n"
+      "  --sd         directory used as the SD card\n"
+      "  --script     button input script, the emulator exits once it has been replayed\n"
+      "  --frames     write every display refresh to this directory as PBM/PGM images\n"
+      "  --landscape  write frames in panel orientation instead of portrait\n"
+      "  --timeout    exit after this many milliseconds\n",
+      program);
+}
+
+void printSummary() {
+  Serial.printf("[%lu] [EMU] Ran for %lu ms, %u display refreshes, min free heap %u bytes\n", millis(),
+                millis() - startTime, EInkDisplay::getRefreshCount(), ESP.getMinFreeHeap());
+  Serial.flush();
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  const char* sdRoot = nullptr;
+  const char* script = nullptr;
+  const char* frames = "";
+  bool portrait = true;
+  unsigned long timeoutMs = 0;
+
+  for (int i = 1; i < argc; i++) {
+    const bool hasValue = i + 1 < argc;
+    if (strcmp(argv[i], "--sd") == 0 && hasValue) {
+      sdRoot = argv[++i];
+    } else if (strcmp(argv[i], "--script") == 0 && hasValue) {
+      script = argv[++i];
+    } else if (strcmp(argv[i], "--frames") == 0 && hasValue) {
+      frames = argv[++i];
+    } else if (strcmp(argv[i], "--landscape") == 0) {
+      portrait = false;
+    } else if (strcmp(argv[i], "--timeout") == 0 && hasValue) {
+      timeoutMs = strtoul(argv[++i], nullptr, 10);
+    } else {
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+  if (!sdRoot) {
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  // Line buffered even when piped, so the log is complete up to a crash
+  setvbuf(stdout, nullptr, _IOLBF, 0);
+
+  SDCardManager::getInstance().setRoot(sdRoot);
+  EInkDisplay::setFrameOutput(frames, portrait);
+  if (script && !HostInput::getInstance().loadScript(script)) {
+    return 1;
+  }
+
+  // Exits from deep sleep use quick_exit too, since the firmware's tasks never stop
+  at_quick_exit(printSummary);
+  startTime = millis();
+
+  setup();
+  while ((!script || !HostInput::getInstance().isDone()) && (timeoutMs == 0 || millis() - startTime < timeoutMs)) {
+    loop();
+  }
+  std::quick_exit(0);
+}
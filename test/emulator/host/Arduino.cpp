@@ -0,0 +1,134 @@
+#include "Arduino.h"
+
+#include <malloc.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <random>
+#include <thread>
+
+#include "SPI.h"
+
+HardwareSerial Serial;
+EspClass ESP;
+SPIClass SPI;
+
+namespace {
+// Function-local so that static initializers elsewhere which log already see the clock started
+std::chrono::steady_clock::time_point startTime() {
+  static const auto start = std::chrono::steady_clock::now();
+  return start;
+}
+
+std::mt19937 randomEngine(0);
+
+std::atomic<size_t> usedHeap{0};
+std::atomic<size_t> peakUsedHeap{0};
+
+void onAllocated(void* ptr) {
+  if (!ptr) {
+    return;
+  }
+  const size_t size = malloc_usable_size(ptr);
+  const size_t used = usedHeap.fetch_add(size) + size;
+  size_t peak = peakUsedHeap.load();
+  while (used > peak && !peakUsedHeap.compare_exchange_weak(peak, used)) {
+  }
+}
+
+void onFreed(void* ptr) {
+  if (ptr) {
+    usedHeap.fetch_sub(malloc_usable_size(ptr));
+  }
+}
+}  // namespace
+
+// glibc's allocator wrapped so that every allocation, C or C++, is counted and the heap high-water mark is exact
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* ptr);
+
+void* malloc(const size_t size) {
+  void* ptr = __libc_malloc(size);
+  onAllocated(ptr);
+  return ptr;
+}
+
+void* calloc(const size_t count, const size_t size) {
+  void* ptr = __libc_calloc(count, size);
+  onAllocated(ptr);
+  return ptr;
+}
+
+void* realloc(void* ptr, const size_t size) {
+  onFreed(ptr);
+  void* resized = __libc_realloc(ptr, size);
+  // A failed realloc leaves the old block in place
+  onAllocated(resized || size == 0 ? resized : ptr);
+  return resized;
+}
+
+void* memalign(const size_t alignment, const size_t size) {
+  void* ptr = __libc_memalign(alignment, size);
+  onAllocated(ptr);
+  return ptr;
+}
+
+void* aligned_alloc(const size_t alignment, const size_t size) { return memalign(alignment, size); }
+
+int posix_memalign(void** ptr, const size_t alignment, const size_t size) {
+  *ptr = memalign(alignment, size);
+  return *ptr ? 0 : ENOMEM;
+}
+
+void free(void* ptr) {
+  onFreed(ptr);
+  __libc_free(ptr);
+}
+}
+
+unsigned long millis() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime()).count();
+}
+
+unsigned long micros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime()).count();
+}
+
+void delay(const unsigned long ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+
+void yield() { std::this_thread::yield(); }
+
+void pinMode(uint8_t, uint8_t) {}
+
+// Only the USB detection pin is read; the emulated device is always plugged in so Serial logging starts
+int digitalRead(uint8_t) { return HIGH; }
+
+long random(const long max) { return max > 0 ? random(0, max) : 0; }
+
+long random(const long min, const long max) {
+  if (max <= min) {
+    return min;
+  }
+  return std::uniform_int_distribution<long>(min, max - 1)(randomEngine);
+}
+
+size_t EspClass::getUsedHeap() { return usedHeap.load(); }
+
+size_t EspClass::getPeakUsedHeap() { return peakUsedHeap.load(); }
+
+void EspClass::resetPeakUsedHeap() { peakUsedHeap.store(usedHeap.load()); }
+
+uint32_t EspClass::getFreeHeap() {
+  const size_t used = getUsedHeap();
+  return used >= HEAP_SIZE ? 0 : HEAP_SIZE - used;
+}
+
+uint32_t EspClass::getMinFreeHeap() {
+  const size_t peak = getPeakUsedHeap();
+  return peak >= HEAP_SIZE ? 0 : HEAP_SIZE - peak;
+}
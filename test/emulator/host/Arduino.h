@@ -0,0 +1,60 @@
+#pragma once
+
+// Subset of the Arduino-ESP32 core that the firmware uses, implemented on top of the host's libc and threads
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "HardwareSerial.h"
+#include "Print.h"
+#include "WString.h"
+#include "esp32-hal.h"
+
+using std::max;
+using std::min;
+
+#define PROGMEM
+#define pgm_read_byte(addr) (*reinterpret_cast<const uint8_t*>(addr))
+#define pgm_read_word(addr) (*reinterpret_cast<const uint16_t*>(addr))
+#define pgm_read_dword(addr) (*reinterpret_cast<const uint32_t*>(addr))
+
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define LOW 0x0
+#define HIGH 0x1
+
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+
+long random(long max);
+long random(long min, long max);
+
+// Heap figures come from the host allocator, reported against a heap the size of the device's so that code which
+// sizes buffers from ESP.getFreeHeap() takes the same paths as on the device
+class EspClass {
+ public:
+  static constexpr uint32_t HEAP_SIZE = 320 * 1024;
+
+  uint32_t getHeapSize() const { return HEAP_SIZE; }
+  uint32_t getFreeHeap();
+  uint32_t getMinFreeHeap();
+  uint32_t getMaxAllocHeap() { return getFreeHeap(); }
+  // Bytes currently allocated on the host heap
+  static size_t getUsedHeap();
+  // Most bytes allocated at once since startup or the last resetPeakUsedHeap()
+  static size_t getPeakUsedHeap();
+  static void resetPeakUsedHeap();
+};
+
+extern EspClass ESP;
+
+void setup();
+void loop();
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstdint>
+
+// No battery on the host; reports a fixed charge level
+class BatteryMonitor {
+ public:
+  explicit BatteryMonitor(uint8_t) {}
+  uint16_t readPercentage() const { return 100; }
+};
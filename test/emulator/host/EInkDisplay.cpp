@@ -0,0 +1,113 @@
+#include "EInkDisplay.h"
+
+#include <Arduino.h>
+
+#include <cstdio>
+#include <cstring>
+
+std::string EInkDisplay::frameDirectory;
+bool EInkDisplay::framePortrait = true;
+uint32_t EInkDisplay::refreshCount = 0;
+
+EInkDisplay::EInkDisplay(int8_t, int8_t, int8_t, int8_t, int8_t, int8_t) {
+  memset(frameBuffer, 0xFF, sizeof(frameBuffer));
+  memset(shownBuffer, 0xFF, sizeof(shownBuffer));
+  memset(lsbPlane, 0, sizeof(lsbPlane));
+  memset(msbPlane, 0, sizeof(msbPlane));
+}
+
+void EInkDisplay::setFrameOutput(const std::string& directory, const bool portrait) {
+  frameDirectory = directory;
+  framePortrait = portrait;
+}
+
+void EInkDisplay::clearScreen(const uint8_t color) const { memset(frameBuffer, color, sizeof(frameBuffer)); }
+
+void EInkDisplay::drawImage(const uint8_t* imageData, const uint16_t x, const uint16_t y, const uint16_t w,
+                            const uint16_t h, bool) const {
+  // Same layout as the framebuffer: rows of w / 8 bytes, x on a byte boundary
+  const uint16_t rowBytes = w / 8;
+  for (uint16_t row = 0; row < h && y + row < DISPLAY_HEIGHT; row++) {
+    const uint16_t destX = x / 8;
+    const uint16_t copyBytes = destX + rowBytes > DISPLAY_WIDTH_BYTES ? DISPLAY_WIDTH_BYTES - destX : rowBytes;
+    memcpy(frameBuffer + (y + row) * DISPLAY_WIDTH_BYTES + destX, imageData + row * rowBytes, copyBytes);
+  }
+}
+
+void EInkDisplay::displayBuffer(RefreshMode, bool) {
+  memcpy(shownBuffer, frameBuffer, sizeof(shownBuffer));
+  writeFrame("pbm", false, [](const EInkDisplay& display, const uint32_t byteIndex, const uint8_t mask) -> uint8_t {
+    return (display.shownBuffer[byteIndex] & mask) ? 255 : 0;
+  });
+}
+
+void EInkDisplay::refreshDisplay(const RefreshMode mode, const bool turnOffScreen) {
+  displayBuffer(mode, turnOffScreen);
+}
+
+void EInkDisplay::copyGrayscaleBuffers(const uint8_t* lsbBuffer, const uint8_t* msbBuffer) {
+  copyGrayscaleLsbBuffers(lsbBuffer);
+  copyGrayscaleMsbBuffers(msbBuffer);
+}
+
+void EInkDisplay::copyGrayscaleLsbBuffers(const uint8_t* lsbBuffer) { memcpy(lsbPlane, lsbBuffer, sizeof(lsbPlane)); }
+
+void EInkDisplay::copyGrayscaleMsbBuffers(const uint8_t* msbBuffer) { memcpy(msbPlane, msbBuffer, sizeof(msbPlane)); }
+
+void EInkDisplay::cleanupGrayscaleBuffers(const uint8_t* bwBuffer) {
+  memcpy(shownBuffer, bwBuffer, sizeof(shownBuffer));
+  memset(lsbPlane, 0, sizeof(lsbPlane));
+  memset(msbPlane, 0, sizeof(msbPlane));
+}
+
+void EInkDisplay::displayGrayBuffer(bool) {
+  // Marked plane bits darken the shown image: both planes give dark gray, the MSB plane alone light gray
+  writeFrame("pgm", true, [](const EInkDisplay& display, const uint32_t byteIndex, const uint8_t mask) -> uint8_t {
+    const bool lsb = display.lsbPlane[byteIndex] & mask;
+    const bool msb = display.msbPlane[byteIndex] & mask;
+    if (msb) {
+      return lsb ? 85 : 170;
+    }
+    return (display.shownBuffer[byteIndex] & mask) ? 255 : 0;
+  });
+}
+
+void EInkDisplay::writeFrame(const char* extension, const bool gray, const PixelFn pixel) const {
+  refreshCount++;
+  if (frameDirectory.empty()) {
+    return;
+  }
+
+  char path[512];
+  snprintf(path, sizeof(path), "%s/frame_%05u.%s", frameDirectory.c_str(), refreshCount, extension);
+  FILE* out = fopen(path, "wb");
+  if (!out) {
+    Serial.printf("[%lu] [EMU] Failed to write frame %s\n", millis(), path);
+    return;
+  }
+
+  const int width = framePortrait ? DISPLAY_HEIGHT : DISPLAY_WIDTH;
+  const int height = framePortrait ? DISPLAY_WIDTH : DISPLAY_HEIGHT;
+  fprintf(out, gray ? "P5\n%d %d\n255\n" : "P4\n%d %d\n", width, height);
+
+  uint8_t row[DISPLAY_WIDTH];
+  for (int y = 0; y < height; y++) {
+    if (!gray) {
+      memset(row, 0, (width + 7) / 8);
+    }
+    for (int x = 0; x < width; x++) {
+      // Portrait frames undo GfxRenderer's 90 degree clockwise rotation
+      const int phyX = framePortrait ? y : x;
+      const int phyY = framePortrait ? DISPLAY_HEIGHT - 1 - x : y;
+      const uint8_t level = pixel(*this, phyY * DISPLAY_WIDTH_BYTES + phyX / 8, 0x80 >> (phyX % 8));
+      if (gray) {
+        row[x] = level;
+      } else if (level < 128) {
+        // PBM: 1 is black
+        row[x / 8] |= 0x80 >> (x % 8);
+      }
+    }
+    fwrite(row, 1, gray ? width : (width + 7) / 8, out);
+  }
+  fclose(out);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Headless panel: keeps the framebuffer in memory and, when a frame directory is set, writes every refresh to it as
+// a PBM image (grayscale refreshes as PGM). Frames are numbered in refresh order.
+class EInkDisplay {
+ public:
+  static constexpr uint16_t DISPLAY_WIDTH = 800;
+  static constexpr uint16_t DISPLAY_HEIGHT = 480;
+  static constexpr uint16_t DISPLAY_WIDTH_BYTES = DISPLAY_WIDTH / 8;
+  static constexpr uint32_t BUFFER_SIZE = DISPLAY_WIDTH_BYTES * DISPLAY_HEIGHT;
+
+  enum RefreshMode { FULL_REFRESH, HALF_REFRESH, FAST_REFRESH };
+
+  EInkDisplay(int8_t sclk, int8_t mosi, int8_t cs, int8_t dc, int8_t rst, int8_t busy);
+
+  // Where frames are written; empty disables dumping. `portrait` rotates them the way the device is usually held.
+  static void setFrameOutput(const std::string& directory, bool portrait);
+  static uint32_t getRefreshCount() { return refreshCount; }
+
+  void begin() {}
+  void clearScreen(uint8_t color = 0xFF) const;
+  void drawImage(const uint8_t* imageData, uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                 bool fromProgmem = false) const;
+  void displayBuffer(RefreshMode mode = FAST_REFRESH, bool turnOffScreen = false);
+  void refreshDisplay(RefreshMode mode = FAST_REFRESH, bool turnOffScreen = false);
+  void deepSleep() {}
+  uint8_t* getFrameBuffer() const { return frameBuffer; }
+
+  void copyGrayscaleBuffers(const uint8_t* lsbBuffer, const uint8_t* msbBuffer);
+  void copyGrayscaleLsbBuffers(const uint8_t* lsbBuffer);
+  void copyGrayscaleMsbBuffers(const uint8_t* msbBuffer);
+  void cleanupGrayscaleBuffers(const uint8_t* bwBuffer);
+  void displayGrayBuffer(bool turnOffScreen = false);
+
+ private:
+  static std::string frameDirectory;
+  static bool framePortrait;
+  static uint32_t refreshCount;
+
+  mutable uint8_t frameBuffer[BUFFER_SIZE];
+  // What the panel shows after the last BW refresh, the base that grayscale planes are drawn over
+  uint8_t shownBuffer[BUFFER_SIZE];
+  uint8_t lsbPlane[BUFFER_SIZE];
+  uint8_t msbPlane[BUFFER_SIZE];
+
+  // Gray level of a panel pixel: 0 black, 255 white
+  using PixelFn = uint8_t (*)(const EInkDisplay& display, uint32_t byteIndex, uint8_t mask);
+  void writeFrame(const char* extension, bool gray, PixelFn pixel) const;
+};
@@ -0,0 +1,129 @@
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+struct HostTask {
+  TaskFunction_t function;
+  void* parameters;
+  std::string name;
+  UBaseType_t priority;
+  bool deleteRequested = false;
+  bool finished = false;
+};
+
+struct HostSemaphore {
+  UBaseType_t count;
+  UBaseType_t maxCount;
+};
+
+namespace {
+// One lock and condition for every task and semaphore keeps deletion simple: a task parked in any kernel call wakes
+// up on every state change and checks whether it was deleted before touching anything else
+std::mutex kernelMutex;
+std::condition_variable kernelChanged;
+thread_local HostTask* currentTask = nullptr;
+
+// Thrown inside a deleted task to unwind it back to its thread entry
+struct TaskDeleted {};
+
+// Arduino's loopTask, which runs setup() and loop()
+constexpr UBaseType_t LOOP_TASK_PRIORITY = 1;
+
+void throwIfDeleted() {
+  if (currentTask && currentTask->deleteRequested) {
+    throw TaskDeleted();
+  }
+}
+
+void runTask(HostTask* task) {
+  currentTask = task;
+  try {
+    task->function(task->parameters);
+  } catch (const TaskDeleted&) {
+  }
+
+  std::lock_guard<std::mutex> lock(kernelMutex);
+  task->finished = true;
+  kernelChanged.notify_all();
+}
+}  // namespace
+
+BaseType_t xTaskCreate(const TaskFunction_t function, const char* name, uint32_t, void* parameters,
+                       const UBaseType_t priority, TaskHandle_t* createdTask) {
+  auto* task = new HostTask{function, parameters, name ? name : "", priority};
+  if (createdTask) {
+    *createdTask = task;
+  }
+  std::thread(runTask, task).detach();
+  return pdPASS;
+}
+
+void vTaskDelete(const TaskHandle_t task) {
+  if (!task || task == currentTask) {
+    throw TaskDeleted();
+  }
+
+  std::unique_lock<std::mutex> lock(kernelMutex);
+  task->deleteRequested = true;
+  kernelChanged.notify_all();
+  kernelChanged.wait(lock, [task] { return task->finished; });
+  delete task;
+}
+
+void vTaskDelay(const TickType_t ticks) {
+  std::unique_lock<std::mutex> lock(kernelMutex);
+  kernelChanged.wait_for(lock, std::chrono::milliseconds(ticks),
+                         [] { return currentTask && currentTask->deleteRequested; });
+  throwIfDeleted();
+}
+
+TickType_t xTaskGetTickCount() { return millis(); }
+
+UBaseType_t uxTaskPriorityGet(const TaskHandle_t task) {
+  const HostTask* target = task ? task : currentTask;
+  return target ? target->priority : LOOP_TASK_PRIORITY;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex() { return new HostSemaphore{1, 1}; }
+
+SemaphoreHandle_t xSemaphoreCreateBinary() { return new HostSemaphore{0, 1}; }
+
+BaseType_t xSemaphoreTake(const SemaphoreHandle_t semaphore, const TickType_t ticksToWait) {
+  std::unique_lock<std::mutex> lock(kernelMutex);
+  // Checks deletion first: the semaphore may already be gone once a deleted task wakes up
+  const auto ready = [semaphore] { return (currentTask && currentTask->deleteRequested) || semaphore->count > 0; };
+  if (ticksToWait == portMAX_DELAY) {
+    kernelChanged.wait(lock, ready);
+  } else {
+    kernelChanged.wait_for(lock, std::chrono::milliseconds(ticksToWait), ready);
+  }
+  throwIfDeleted();
+
+  if (semaphore->count == 0) {
+    return pdFALSE;
+  }
+  semaphore->count--;
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(const SemaphoreHandle_t semaphore) {
+  std::lock_guard<std::mutex> lock(kernelMutex);
+  if (semaphore->count >= semaphore->maxCount) {
+    return pdFALSE;
+  }
+  semaphore->count++;
+  kernelChanged.notify_all();
+  return pdTRUE;
+}
+
+void vSemaphoreDelete(const SemaphoreHandle_t semaphore) {
+  std::lock_guard<std::mutex> lock(kernelMutex);
+  delete semaphore;
+}
@@ -0,0 +1,36 @@
+#include <HalGPIO.h>
+
+#include <cstdlib>
+
+#include "HostInput.h"
+
+// Emulated build: buttons come from the input script, sleeping ends the process
+
+void HalGPIO::begin() {}
+
+void HalGPIO::update() { HostInput::getInstance().update(); }
+
+bool HalGPIO::isPressed(uint8_t buttonIndex) const { return HostInput::getInstance().isPressed(buttonIndex); }
+
+bool HalGPIO::wasPressed(uint8_t buttonIndex) const { return HostInput::getInstance().wasPressed(buttonIndex); }
+
+bool HalGPIO::wasAnyPressed() const { return HostInput::getInstance().wasAnyPressed(); }
+
+bool HalGPIO::wasReleased(uint8_t buttonIndex) const { return HostInput::getInstance().wasReleased(buttonIndex); }
+
+bool HalGPIO::wasAnyReleased() const { return HostInput::getInstance().wasAnyReleased(); }
+
+unsigned long HalGPIO::getHeldTime() const { return HostInput::getInstance().getHeldTime(); }
+
+void HalGPIO::startDeepSleep() {
+  Serial.printf("[%lu] [EMU] Deep sleep, exiting\n", millis());
+  Serial.flush();
+  // Background tasks are still running, so skip static destructors
+  std::quick_exit(0);
+}
+
+int HalGPIO::getBatteryPercentage() const { return 100; }
+
+bool HalGPIO::isUsbConnected() const { return true; }
+
+HalGPIO::WakeupReason HalGPIO::getWakeupReason() const { return WakeupReason::AfterFlash; }
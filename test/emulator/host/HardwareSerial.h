@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Print.h"
+#include "esp32-hal.h"
+
+// Serial writes straight to stdout, so the firmware's log lines can be read or piped like the device's console
+class HardwareSerial : public Stream {
+ public:
+  void begin(unsigned long) {}
+  void end() {}
+  explicit operator bool() const { return true; }
+
+  size_t write(uint8_t c) override { return fputc(c, stdout) == EOF ? 0 : 1; }
+  size_t write(const uint8_t* buffer, const size_t size) override { return fwrite(buffer, 1, size, stdout); }
+  using Print::write;
+  void flush() override { fflush(stdout); }
+
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+};
+
+extern HardwareSerial Serial;
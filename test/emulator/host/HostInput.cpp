@@ -0,0 +1,117 @@
+#include "HostInput.h"
+
+#include <Arduino.h>
+#include <HalGPIO.h>
+
+#include <fstream>
+#include <sstream>
+
+HostInput HostInput::instance;
+
+namespace {
+constexpr unsigned long TAP_DURATION_MS = 50;
+
+int buttonFromName(const std::string& name) {
+  static const struct {
+    const char* name;
+    uint8_t index;
+  } buttons[] = {
+      {"back", HalGPIO::BTN_BACK}, {"confirm", HalGPIO::BTN_CONFIRM}, {"left", HalGPIO::BTN_LEFT},
+      {"right", HalGPIO::BTN_RIGHT}, {"up", HalGPIO::BTN_UP},          {"down", HalGPIO::BTN_DOWN},
+      {"power", HalGPIO::BTN_POWER},
+  };
+  for (const auto& button : buttons) {
+    if (name == button.name) {
+      return button.index;
+    }
+  }
+  return -1;
+}
+}  // namespace
+
+bool HostInput::loadScript(const char* path) {
+  std::ifstream in(path);
+  if (!in) {
+    Serial.printf("[%lu] [EMU] Could not open input script %s\n", millis(), path);
+    return false;
+  }
+
+  steps.clear();
+  std::string line;
+  int lineNumber = 0;
+  while (std::getline(in, line)) {
+    lineNumber++;
+    line = line.substr(0, line.find('#'));
+    std::istringstream words(line);
+    std::string command;
+    if (!(words >> command)) {
+      continue;
+    }
+
+    Step step = {-1, 0};
+    std::string buttonName;
+    bool valid;
+    if (command == "wait") {
+      valid = static_cast<bool>(words >> step.durationMs);
+    } else if (command == "press") {
+      valid = static_cast<bool>(words >> buttonName);
+      step.durationMs = TAP_DURATION_MS;
+    } else if (command == "hold") {
+      valid = static_cast<bool>(words >> buttonName >> step.durationMs);
+    } else {
+      valid = false;
+    }
+    if (valid && !buttonName.empty()) {
+      step.button = buttonFromName(buttonName);
+      valid = step.button >= 0;
+    }
+    if (!valid) {
+      Serial.printf("[%lu] [EMU] %s:%d: cannot parse '%s'\n", millis(), path, lineNumber, line.c_str());
+      return false;
+    }
+    steps.push_back(step);
+  }
+
+  nextStep = 0;
+  stepActive = false;
+  return true;
+}
+
+void HostInput::update() {
+  const unsigned long now = millis();
+  pressedEvents = 0;
+  releasedEvents = 0;
+
+  while (true) {
+    if (!stepActive) {
+      if (nextStep >= steps.size()) {
+        return;
+      }
+      stepActive = true;
+      stepStart = now;
+      const Step& step = steps[nextStep];
+      if (step.button >= 0) {
+        currentState |= 1 << step.button;
+        pressedEvents |= 1 << step.button;
+        pressStart = now;
+        return;
+      }
+    }
+
+    const Step& step = steps[nextStep];
+    if (now - stepStart < step.durationMs) {
+      return;
+    }
+    stepActive = false;
+    nextStep++;
+    if (step.button >= 0) {
+      currentState &= ~(1 << step.button);
+      releasedEvents |= 1 << step.button;
+      releasedHeldTime = now - pressStart;
+      // Report the release on its own before the next step can press anything
+      return;
+    }
+  }
+}
+
+unsigned long HostInput::getHeldTime() const { return currentState ? millis() - pressStart : releasedHeldTime; }
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Button presses for the emulated device, replayed from a script. One step per line, '#' starts a comment:
+//
+//   wait 500          nothing pressed for 500 ms
+//   press confirm     tap a button (held for 50 ms)
+//   hold power 1500   hold a button for 1500 ms
+//
+// Buttons are back, confirm, left, right, up, down and power. Each press and each release shows up in its own
+// update(), the same way InputManager reports them on the device.
+class HostInput {
+ public:
+  static HostInput& getInstance() { return instance; }
+
+  bool loadScript(const char* path);
+  // True once every step has been replayed
+  bool isDone() const { return nextStep >= steps.size() && !stepActive; }
+
+  void update();
+  bool isPressed(uint8_t buttonIndex) const { return currentState & (1 << buttonIndex); }
+  bool wasPressed(uint8_t buttonIndex) const { return pressedEvents & (1 << buttonIndex); }
+  bool wasAnyPressed() const { return pressedEvents != 0; }
+  bool wasReleased(uint8_t buttonIndex) const { return releasedEvents & (1 << buttonIndex); }
+  bool wasAnyReleased() const { return releasedEvents != 0; }
+  unsigned long getHeldTime() const;
+
+ private:
+  struct Step {
+    int button;  // -1 for a wait
+    unsigned long durationMs;
+  };
+
+  static HostInput instance;
+
+  std::vector<Step> steps;
+  size_t nextStep = 0;
+  bool stepActive = false;
+  unsigned long stepStart = 0;
+
+  uint8_t currentState = 0;
+  uint8_t pressedEvents = 0;
+  uint8_t releasedEvents = 0;
+  unsigned long pressStart = 0;
+  unsigned long releasedHeldTime = 0;
+};
@@ -0,0 +1,4 @@
+#pragma once
+
+// Buttons are emulated by HalGPIO and HostInput; only this header has to exist for HalGPIO.h
+class InputManager {};
@@ -0,0 +1,315 @@
+#include "SDCardManager.h"
+
+#include <Arduino.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <filesystem>
+
+SDCardManager SDCardManager::instance;
+
+FsFile& FsFile::operator=(FsFile&& other) noexcept {
+  if (this != &other) {
+    close();
+    file = other.file;
+    dir = other.dir;
+    hostPath = std::move(other.hostPath);
+    lastOp = other.lastOp;
+    other.file = nullptr;
+    other.dir = nullptr;
+  }
+  return *this;
+}
+
+bool FsFile::open(const std::string& path, const oflag_t oflag) {
+  close();
+  hostPath = path;
+
+  struct stat st = {};
+  if (stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+    dir = opendir(path.c_str());
+    return dir != nullptr;
+  }
+
+  const int fd = ::open(path.c_str(), oflag, 0644);
+  if (fd < 0) {
+    return false;
+  }
+  const int access = oflag & O_ACCMODE;
+  const char* mode = access == O_RDONLY ? "rb" : access == O_WRONLY ? ((oflag & O_APPEND) ? "ab" : "wb") : "r+b";
+  file = fdopen(fd, mode);
+  if (!file) {
+    ::close(fd);
+    return false;
+  }
+  return true;
+}
+
+bool FsFile::close() {
+  if (file) {
+    fclose(file);
+    file = nullptr;
+  }
+  if (dir) {
+    closedir(dir);
+    dir = nullptr;
+  }
+  lastOp = LastOp::None;
+  return true;
+}
+
+size_t FsFile::getName(char* name, const size_t size) const {
+  if (size == 0) {
+    return 0;
+  }
+  const size_t slash = hostPath.find_last_of('/');
+  const std::string base = slash == std::string::npos ? hostPath : hostPath.substr(slash + 1);
+  snprintf(name, size, "%s", base.c_str());
+  return base.length() < size ? base.length() : size - 1;
+}
+
+void FsFile::switchTo(const LastOp op) {
+  if (lastOp != LastOp::None && lastOp != op) {
+    fseek(file, 0, SEEK_CUR);
+  }
+  lastOp = op;
+}
+
+int FsFile::read(void* buffer, const size_t size) {
+  if (!file) {
+    return -1;
+  }
+  switchTo(LastOp::Read);
+  return static_cast<int>(fread(buffer, 1, size, file));
+}
+
+int FsFile::read() {
+  uint8_t c;
+  return read(&c, 1) == 1 ? c : -1;
+}
+
+int FsFile::peek() {
+  const int c = read();
+  if (c >= 0) {
+    fseek(file, -1, SEEK_CUR);
+    lastOp = LastOp::None;
+  }
+  return c;
+}
+
+int FsFile::available() {
+  if (!file) {
+    return 0;
+  }
+  const uint64_t fileSize = size();
+  const uint64_t pos = position();
+  return fileSize > pos ? static_cast<int>(std::min<uint64_t>(fileSize - pos, INT32_MAX)) : 0;
+}
+
+size_t FsFile::write(const uint8_t* buffer, const size_t size) {
+  if (!file) {
+    return 0;
+  }
+  switchTo(LastOp::Write);
+  return fwrite(buffer, 1, size, file);
+}
+
+void FsFile::flush() {
+  if (file) {
+    fflush(file);
+  }
+}
+
+bool FsFile::seek(const uint64_t position) {
+  lastOp = LastOp::None;
+  return file && fseeko(file, static_cast<off_t>(position), SEEK_SET) == 0;
+}
+
+bool FsFile::seekCur(const int64_t offset) {
+  lastOp = LastOp::None;
+  return file && fseeko(file, static_cast<off_t>(offset), SEEK_CUR) == 0;
+}
+
+uint64_t FsFile::position() const {
+  if (!file) {
+    return 0;
+  }
+  const off_t pos = ftello(file);
+  return pos < 0 ? 0 : static_cast<uint64_t>(pos);
+}
+
+uint64_t FsFile::size() const {
+  if (!file) {
+    return 0;
+  }
+  // Buffered writes are not in the file yet
+  if (lastOp == LastOp::Write) {
+    fflush(file);
+  }
+  struct stat st = {};
+  return fstat(fileno(file), &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+}
+
+bool FsFile::rename(const char* newPath) {
+  const std::string newHostPath = SDCardManager::getInstance().toHostPath(newPath);
+  if (::rename(hostPath.c_str(), newHostPath.c_str()) != 0) {
+    return false;
+  }
+  hostPath = newHostPath;
+  return true;
+}
+
+FsFile FsFile::openNextFile(const oflag_t oflag) {
+  FsFile next;
+  if (!dir) {
+    return next;
+  }
+  while (const dirent* entry = readdir(dir)) {
+    if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+      continue;
+    }
+    if (next.open(hostPath + "/" + entry->d_name, oflag)) {
+      break;
+    }
+  }
+  return next;
+}
+
+void FsFile::rewindDirectory() {
+  if (dir) {
+    rewinddir(dir);
+  }
+}
+
+std::string SDCardManager::toHostPath(const char* path) const {
+  if (!path || path[0] == '\0') {
+    return root;
+  }
+  return path[0] == '/' ? root + path : root + "/" + path;
+}
+
+bool SDCardManager::begin() {
+  struct stat st = {};
+  initialized = stat(root.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+  if (!initialized) {
+    Serial.printf("[%lu] [SD] SD card directory %s not found\n", millis(), root.c_str());
+  }
+  return initialized;
+}
+
+std::vector<String> SDCardManager::listFiles(const char* path, const int maxFiles) {
+  std::vector<String> names;
+  FsFile dir = open(path);
+  if (!dir.isDirectory()) {
+    return names;
+  }
+  char name[256];
+  for (auto file = dir.openNextFile(); file && static_cast<int>(names.size()) < maxFiles; file = dir.openNextFile()) {
+    if (!file.isDirectory()) {
+      file.getName(name, sizeof(name));
+      names.emplace_back(name);
+    }
+  }
+  return names;
+}
+
+String SDCardManager::readFile(const char* path) {
+  FsFile file;
+  if (!openFileForRead("SD", path, file)) {
+    return String();
+  }
+  std::string content(file.size(), '\0');
+  const int bytesRead = file.read(&content[0], content.size());
+  content.resize(bytesRead > 0 ? bytesRead : 0);
+  return String(content);
+}
+
+bool SDCardManager::readFileToStream(const char* path, Print& out, const size_t chunkSize) {
+  FsFile file;
+  if (!openFileForRead("SD", path, file)) {
+    return false;
+  }
+  std::vector<uint8_t> buffer(chunkSize);
+  int bytesRead;
+  while ((bytesRead = file.read(buffer.data(), buffer.size())) > 0) {
+    out.write(buffer.data(), bytesRead);
+  }
+  return true;
+}
+
+size_t SDCardManager::readFileToBuffer(const char* path, char* buffer, const size_t bufferSize, const size_t maxBytes) {
+  if (!buffer || bufferSize == 0) {
+    return 0;
+  }
+  FsFile file;
+  if (!openFileForRead("SD", path, file)) {
+    buffer[0] = '\0';
+    return 0;
+  }
+  size_t toRead = bufferSize - 1;
+  if (maxBytes > 0 && maxBytes < toRead) {
+    toRead = maxBytes;
+  }
+  const int bytesRead = file.read(buffer, toRead);
+  const size_t length = bytesRead > 0 ? bytesRead : 0;
+  buffer[length] = '\0';
+  return length;
+}
+
+bool SDCardManager::writeFile(const char* path, const String& content) {
+  FsFile file;
+  if (!openFileForWrite("SD", path, file)) {
+    return false;
+  }
+  return file.write(reinterpret_cast<const uint8_t*>(content.c_str()), content.length()) == content.length();
+}
+
+bool SDCardManager::ensureDirectoryExists(const char* path) { return exists(path) || mkdir(path); }
+
+FsFile SDCardManager::open(const char* path, const oflag_t oflag) {
+  FsFile file;
+  file.open(toHostPath(path), oflag);
+  return file;
+}
+
+bool SDCardManager::mkdir(const char* path, const bool pFlag) {
+  std::error_code error;
+  if (pFlag) {
+    std::filesystem::create_directories(toHostPath(path), error);
+    return !error;
+  }
+  return ::mkdir(toHostPath(path).c_str(), 0755) == 0;
+}
+
+bool SDCardManager::exists(const char* path) {
+  struct stat st = {};
+  return stat(toHostPath(path).c_str(), &st) == 0;
+}
+
+bool SDCardManager::remove(const char* path) { return ::unlink(toHostPath(path).c_str()) == 0; }
+
+bool SDCardManager::rmdir(const char* path) { return ::rmdir(toHostPath(path).c_str()) == 0; }
+
+bool SDCardManager::openFileForRead(const char* moduleName, const char* path, FsFile& file) {
+  if (!file.open(toHostPath(path), O_RDONLY) || file.isDirectory()) {
+    Serial.printf("[%lu] [%s] Failed to open %s for reading\n", millis(), moduleName, path);
+    file.close();
+    return false;
+  }
+  return true;
+}
+
+bool SDCardManager::openFileForWrite(const char* moduleName, const char* path, FsFile& file) {
+  if (!file.open(toHostPath(path), O_RDWR | O_CREAT | O_TRUNC) || file.isDirectory()) {
+    Serial.printf("[%lu] [%s] Failed to open %s for writing\n", millis(), moduleName, path);
+    file.close();
+    return false;
+  }
+  return true;
+}
+
+bool SDCardManager::removeDir(const char* path) {
+  std::error_code error;
+  std::filesystem::remove_all(toHostPath(path), error);
+  return !error;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <dirent.h>
+#include <fcntl.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "Arduino.h"
+
+typedef int oflag_t;
+
+// SdFat's FsFile over a host file or directory. Files are buffered stdio streams, directories iterate with readdir.
+class FsFile : public Stream {
+ public:
+  FsFile() = default;
+  ~FsFile() override { close(); }
+  FsFile(const FsFile&) = delete;
+  FsFile& operator=(const FsFile&) = delete;
+  FsFile(FsFile&& other) noexcept { *this = std::move(other); }
+  FsFile& operator=(FsFile&& other) noexcept;
+
+  // Opens `hostPath` with SdFat open flags; `name` is what getName() reports
+  bool open(const std::string& hostPath, oflag_t oflag);
+  bool close();
+  bool isOpen() const { return file || dir; }
+  explicit operator bool() const { return isOpen(); }
+  bool isDirectory() const { return dir != nullptr; }
+  size_t getName(char* name, size_t size) const;
+
+  int read(void* buffer, size_t size);
+  int read() override;
+  int peek() override;
+  int available() override;
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buffer, size_t size) override;
+  size_t write(const void* buffer, const size_t size) { return write(static_cast<const uint8_t*>(buffer), size); }
+  using Print::write;
+  void flush() override;
+  bool sync() {
+    flush();
+    return true;
+  }
+
+  bool seek(uint64_t position);
+  bool seekSet(const uint64_t position) { return seek(position); }
+  bool seekCur(int64_t offset);
+  uint64_t position() const;
+  uint64_t size() const;
+  uint64_t fileSize() const { return size(); }
+  // Renames to another path on the card
+  bool rename(const char* newPath);
+
+  FsFile openNextFile(oflag_t oflag = O_RDONLY);
+  void rewindDirectory();
+
+ private:
+  enum class LastOp { None, Read, Write };
+
+  FILE* file = nullptr;
+  DIR* dir = nullptr;
+  std::string hostPath;
+  LastOp lastOp = LastOp::None;
+
+  // stdio needs a seek between reads and writes on the same stream
+  void switchTo(LastOp op);
+};
+
+// The SD card is a directory on the host, set with setRoot() before begin()
+class SDCardManager {
+ public:
+  static SDCardManager& getInstance() { return instance; }
+
+  void setRoot(const std::string& path) { root = path; }
+  std::string toHostPath(const char* path) const;
+
+  bool begin();
+  bool ready() const { return initialized; }
+  std::vector<String> listFiles(const char* path = "/", int maxFiles = 200);
+  String readFile(const char* path);
+  bool readFileToStream(const char* path, Print& out, size_t chunkSize = 256);
+  size_t readFileToBuffer(const char* path, char* buffer, size_t bufferSize, size_t maxBytes = 0);
+  bool writeFile(const char* path, const String& content);
+  bool ensureDirectoryExists(const char* path);
+
+  FsFile open(const char* path, oflag_t oflag = O_RDONLY);
+  bool mkdir(const char* path, bool pFlag = true);
+  bool exists(const char* path);
+  bool remove(const char* path);
+  bool rmdir(const char* path);
+  bool openFileForRead(const char* moduleName, const char* path, FsFile& file);
+  bool openFileForWrite(const char* moduleName, const char* path, FsFile& file);
+  bool removeDir(const char* path);
+
+ private:
+  static SDCardManager instance;
+
+  std::string root = ".";
+  bool initialized = false;
+};
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstdint>
+
+class SPIClass {
+ public:
+  void begin(int8_t, int8_t, int8_t, int8_t) {}
+  void end() {}
+};
+
+extern SPIClass SPI;
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cctype>
+#include <string>
+
+// The parts of Arduino's String that the firmware uses, backed by std::string
+class String {
+ public:
+  String() = default;
+  String(const char* str) : value(str ? str : "") {}
+  String(const std::string& str) : value(str) {}
+  explicit String(const int number) : value(std::to_string(number)) {}
+  explicit String(const unsigned int number) : value(std::to_string(number)) {}
+  explicit String(const long number) : value(std::to_string(number)) {}
+  explicit String(const unsigned long number) : value(std::to_string(number)) {}
+
+  const char* c_str() const { return value.c_str(); }
+  unsigned int length() const { return value.length(); }
+  bool isEmpty() const { return value.empty(); }
+  char operator[](const unsigned int index) const { return index < value.length() ? value[index] : 0; }
+
+  bool startsWith(const String& prefix) const { return value.rfind(prefix.value, 0) == 0; }
+  bool endsWith(const String& suffix) const {
+    return value.length() >= suffix.value.length() &&
+           value.compare(value.length() - suffix.value.length(), suffix.value.length(), suffix.value) == 0;
+  }
+  int indexOf(const char c, const unsigned int from = 0) const {
+    const size_t pos = value.find(c, from);
+    return pos == std::string::npos ? -1 : static_cast<int>(pos);
+  }
+  int lastIndexOf(const char c) const {
+    const size_t pos = value.rfind(c);
+    return pos == std::string::npos ? -1 : static_cast<int>(pos);
+  }
+  String substring(const unsigned int from) const { return from < value.length() ? value.substr(from) : ""; }
+  String substring(const unsigned int from, const unsigned int to) const {
+    return from < to && from < value.length() ? value.substr(from, to - from) : "";
+  }
+  void toLowerCase() {
+    for (char& c : value) {
+      c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    }
+  }
+  void toUpperCase() {
+    for (char& c : value) {
+      c = static_cast<char>(toupper(static_cast<unsigned char>(c)));
+    }
+  }
+  void trim() {
+    const size_t start = value.find_first_not_of(" \t\r\n");
+    const size_t end = value.find_last_not_of(" \t\r\n");
+    value = start == std::string::npos ? "" : value.substr(start, end - start + 1);
+  }
+  long toInt() const { return strtol(value.c_str(), nullptr, 10); }
+
+  String& operator+=(const String& other) {
+    value += other.value;
+    return *this;
+  }
+  String& operator+=(const char* other) {
+    value += other ? other : "";
+    return *this;
+  }
+  String& operator+=(const char c) {
+    value += c;
+    return *this;
+  }
+  friend String operator+(String lhs, const String& rhs) { return lhs += rhs; }
+  friend String operator+(String lhs, const char* rhs) { return lhs += rhs; }
+  friend String operator+(const char* lhs, const String& rhs) { return String(lhs) += rhs; }
+  bool operator==(const String& other) const { return value == other.value; }
+  bool operator!=(const String& other) const { return value != other.value; }
+  bool operator<(const String& other) const { return value < other.value; }
+
+ private:
+  std::string value;
+};
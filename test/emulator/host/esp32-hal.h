@@ -0,0 +1,7 @@
+#pragma once
+
+// Timing functions, which the Arduino core's headers make visible almost everywhere
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void yield();
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "FreeRTOS.h"
+
+BaseType_t xTaskCreate(TaskFunction_t function, const char* name, uint32_t stackDepth, void* parameters,
+                       UBaseType_t priority, TaskHandle_t* createdTask);
+// Deleting another task waits until it reaches its next vTaskDelay() or semaphore take, where it unwinds. The
+// firmware only deletes tasks that are parked there, usually while holding the mutex they are waiting for.
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount();
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task);
@@ -0,0 +1,314 @@
+#include <Arduino.h>
+#include <Epub.h>
+#include <Epub/Page.h>
+#include <Epub/Section.h>
+#include <GfxRenderer.h>
+#include <HalDisplay.h>
+#include <HalStorage.h>
+#include <SDCardManager.h>
+#include <builtinFonts/bookerly_14_bold.h>
+#include <builtinFonts/bookerly_14_bolditalic.h>
+#include <builtinFonts/bookerly_14_italic.h>
+#include <builtinFonts/bookerly_14_regular.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "fontIds.h"
+
+// Times every stage of opening and reading each EPUB in a directory, the way EpubReaderActivity drives them with the
+// default reader settings, and records the heap high-water mark of each stage:
+//
+//   load     Epub::load without CSS: zip index, OPF and TOC passes, buildBookBin
+//   css      Epub::load from the cached book.bin, which reads the stylesheet list from the OPF and parses the CSS
+//   section  Section::createSectionFile, one row per spine item
+//   render   Page::render of every page of the book into the framebuffer
+//
+// Results are written as CSV (or JSON with --json) so runs can be compared between releases. Every run starts from an
+// empty cache.
+
+namespace {
+// Portrait viewport of the reader with the default 5px screen margin and the status bar
+constexpr int kScreenMargin = 5;
+constexpr int kStatusBarMargin = 19;
+
+EpdFont bookerly14RegularFont(&bookerly_14_regular);
+EpdFont bookerly14BoldFont(&bookerly_14_bold);
+EpdFont bookerly14ItalicFont(&bookerly_14_italic);
+EpdFont bookerly14BoldItalicFont(&bookerly_14_bolditalic);
+EpdFontFamily bookerly14FontFamily(&bookerly14RegularFont, &bookerly14BoldFont, &bookerly14ItalicFont,
+                                   &bookerly14BoldItalicFont);
+
+struct StageResult {
+  std::string book;
+  const char* stage;
+  int spineIndex;  // -1 for whole-book stages
+  double ms;
+  size_t peakHeap;  // Bytes allocated at once during the stage, above what was allocated when it started
+  int count;        // Pages for section and render, spine items for load, CSS rules for css
+  bool ok;
+};
+
+class StageTimer {
+ public:
+  StageTimer() : heapBase(ESP.getUsedHeap()), start(std::chrono::steady_clock::now()) { ESP.resetPeakUsedHeap(); }
+
+  StageResult finish(const std::string& book, const char* stage, const int spineIndex, const int count,
+                     const bool ok) const {
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    const size_t peak = ESP.getPeakUsedHeap();
+    return {book, stage, spineIndex, ms, peak > heapBase ? peak - heapBase : 0, count, ok};
+  }
+
+ private:
+  size_t heapBase;
+  std::chrono::steady_clock::time_point start;
+};
+
+void benchmarkBook(GfxRenderer& renderer, const std::string& path, const std::string& cacheDir,
+                   std::vector<StageResult>& results) {
+  const std::string book = std::filesystem::path(path).filename().string();
+  auto epub = std::make_shared<Epub>(path, cacheDir);
+  epub->clearCache();
+
+  {
+    const StageTimer timer;
+    const bool ok = epub->load(true, true);
+    results.push_back(timer.finish(book, "load", -1, ok ? epub->getSpineItemsCount() : 0, ok));
+    if (!ok) {
+      return;
+    }
+  }
+
+  {
+    const StageTimer timer;
+    const bool ok = epub->load(false, false);
+    const int rules = ok && epub->getCssParser() ? static_cast<int>(epub->getCssParser()->ruleCount()) : 0;
+    results.push_back(timer.finish(book, "css", -1, rules, ok));
+    if (!ok) {
+      return;
+    }
+  }
+
+  int marginTop, marginRight, marginBottom, marginLeft;
+  renderer.getOrientedViewableTRBL(&marginTop, &marginRight, &marginBottom, &marginLeft);
+  marginTop += kScreenMargin;
+  marginLeft += kScreenMargin;
+  marginRight += kScreenMargin;
+  marginBottom += kStatusBarMargin;
+  const auto viewportWidth = static_cast<uint16_t>(renderer.getScreenWidth() - marginLeft - marginRight);
+  const auto viewportHeight = static_cast<uint16_t>(renderer.getScreenHeight() - marginTop - marginBottom);
+
+  std::vector<std::unique_ptr<Section>> sections;
+  for (int i = 0; i < epub->getSpineItemsCount(); i++) {
+    auto section = std::make_unique<Section>(epub, i, renderer);
+    const StageTimer timer;
+    const bool ok = section->createSectionFile(BOOKERLY_14_FONT_ID, 1.0f, true, 0, viewportWidth, viewportHeight,
+                                               false, true, false);
+    results.push_back(timer.finish(book, "section", i, ok ? section->pageCount : 0, ok));
+    if (ok) {
+      sections.push_back(std::move(section));
+    }
+  }
+
+  // Pages are read from the section files outside the timed region, so only rendering is measured
+  double renderMs = 0;
+  size_t renderPeak = 0;
+  int pages = 0;
+  bool renderOk = true;
+  for (const auto& section : sections) {
+    for (int p = 0; p < section->pageCount; p++) {
+      section->currentPage = p;
+      const auto page = section->loadPageFromSectionFile();
+      if (!page) {
+        renderOk = false;
+        continue;
+      }
+      const StageTimer timer;
+      renderer.clearScreen();
+      page->render(renderer, BOOKERLY_14_FONT_ID, marginLeft, marginTop);
+      const StageResult result = timer.finish(book, "render", -1, 1, true);
+      renderMs += result.ms;
+      renderPeak = std::max(renderPeak, result.peakHeap);
+      pages++;
+    }
+  }
+  results.push_back({book, "render", -1, renderMs, renderPeak, pages, renderOk});
+}
+
+std::string jsonEscape(const std::string& value) {
+  std::string escaped;
+  for (const char c : value) {
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+    }
+    if (static_cast<unsigned char>(c) < 0x20) {
+      char buffer[8];
+      snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+      escaped += buffer;
+    } else {
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+
+void writeCsv(FILE* out, const std::vector<StageResult>& results) {
+  fprintf(out, "book,stage,spine_index,ms,peak_heap_bytes,count,ok\n");
+  for (const auto& r : results) {
+    std::string book = r.book;
+    if (book.find_first_of(",\"") != std::string::npos) {
+      std::string quoted = "\"";
+      for (const char c : book) {
+        quoted += c == '"' ? std::string("\"\"") : std::string(1, c);
+      }
+      book = quoted + "\"";
+    }
+    fprintf(out, "%s,%s,%d,%.3f,%zu,%d,%d\n", book.c_str(), r.stage, r.spineIndex, r.ms, r.peakHeap, r.count,
+            r.ok ? 1 : 0);
+  }
+}
+
+void writeJson(FILE* out, const std::vector<StageResult>& results) {
+  fprintf(out, "[\n");
+  for (size_t i = 0; i < results.size(); i++) {
+    const auto& r = results[i];
+    fprintf(out,
+            "  {\"book\": \"%s\", \"stage\": \"%s\", \"spine_index\": %d, \"ms\": %.3f, \"peak_heap_bytes\": %zu, "
+            "\"count\": %d, \"ok\": %s}%s\n",
+            jsonEscape(r.book).c_str(), r.stage, r.spineIndex, r.ms, r.peakHeap, r.count, r.ok ? "true" : "false",
+            i + 1 < results.size() ? "," : "");
+  }
+  fprintf(out, "]\n");
+}
+
+// Totals per stage across the corpus, for a quick look without a spreadsheet
+void printSummary(FILE* out, const std::vector<StageResult>& results, const size_t books) {
+  fprintf(out, "%zu books\n", books);
+  for (const char* stage : {"load", "css", "section", "render"}) {
+    double ms = 0;
+    size_t peak = 0;
+    int count = 0;
+    int failures = 0;
+    for (const auto& r : results) {
+      if (strcmp(r.stage, stage) == 0) {
+        ms += r.ms;
+        peak = std::max(peak, r.peakHeap);
+        count += r.count;
+        failures += r.ok ? 0 : 1;
+      }
+    }
+    fprintf(out, "  %-8s %10.1f ms  peak heap %7zu bytes  count %6d  failures %d\n", stage, ms, peak, count,
+            failures);
+  }
+}
+
+void printUsage(const char* program) {
+  fprintf(stderr,
+          "Usage: %s [--json] [--out <file>] [--cache <dir>] [--verbose] <epub directory>\n"
+          "  --json     write JSON instead of CSV\n"
+          "  --out      write results to this file instead of stdout\n"
+          "  --cache    directory for the book caches, each book's is cleared first (default: a temporary directory)\n"
+          "  --verbose  keep the firmware's log output\n",
+          program);
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  bool json = false;
+  bool verbose = false;
+  const char* outPath = nullptr;
+  std::string cacheDir;
+  const char* corpus = nullptr;
+
+  for (int i = 1; i < argc; i++) {
+    const bool hasValue = i + 1 < argc;
+    if (strcmp(argv[i], "--json") == 0) {
+      json = true;
+    } else if (strcmp(argv[i], "--verbose") == 0) {
+      verbose = true;
+    } else if (strcmp(argv[i], "--out") == 0 && hasValue) {
+      outPath = argv[++i];
+    } else if (strcmp(argv[i], "--cache") == 0 && hasValue) {
+      cacheDir = argv[++i];
+    } else if (!corpus && argv[i][0] != '-') {
+      corpus = argv[i];
+    } else {
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+  if (!corpus) {
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  std::vector<std::string> books;
+  std::error_code error;
+  for (const auto& entry : std::filesystem::directory_iterator(corpus, error)) {
+    std::string extension = entry.path().extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    if (entry.is_regular_file() && extension == ".epub") {
+      books.push_back(std::filesystem::absolute(entry.path()).string());
+    }
+  }
+  if (error || books.empty()) {
+    fprintf(stderr, "No EPUBs found in %s\n", corpus);
+    return 1;
+  }
+  std::sort(books.begin(), books.end());
+
+  const bool temporaryCache = cacheDir.empty();
+  if (temporaryCache) {
+    cacheDir = (std::filesystem::temp_directory_path() / ("epub_pipeline_bench_" + std::to_string(getpid()))).string();
+  }
+  cacheDir = std::filesystem::absolute(cacheDir).string();
+  std::filesystem::create_directories(cacheDir);
+
+  // Results go to the real stdout; the firmware logs through Serial, which also writes to stdout
+  FILE* results = outPath ? fopen(outPath, "w") : fdopen(dup(STDOUT_FILENO), "w");
+  if (!results) {
+    fprintf(stderr, "Could not open %s\n", outPath ? outPath : "stdout");
+    return 1;
+  }
+  if (!verbose) {
+    freopen("/dev/null", "w", stdout);
+  }
+
+  // Paths are absolute, so the card is the host's root
+  SDCardManager::getInstance().setRoot("");
+  Storage.begin();
+  HalDisplay display;
+  GfxRenderer renderer(display);
+  display.begin();
+  renderer.begin();
+  renderer.insertFont(BOOKERLY_14_FONT_ID, bookerly14FontFamily);
+
+  std::vector<StageResult> stageResults;
+  for (const auto& book : books) {
+    fprintf(stderr, "%s\n", book.c_str());
+    benchmarkBook(renderer, book, cacheDir, stageResults);
+  }
+
+  if (json) {
+    writeJson(results, stageResults);
+  } else {
+    writeCsv(results, stageResults);
+  }
+  fclose(results);
+  printSummary(stderr, stageResults, books.size());
+
+  if (temporaryCache) {
+    std::filesystem::remove_all(cacheDir, error);
+  }
+
+  const bool failed = std::any_of(stageResults.begin(), stageResults.end(), [](const StageResult& r) { return !r.ok; });
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,345 @@
+#include <EpdFont.h>
+#include <Utf8.h>
+#include <builtinFonts/bookerly_14_regular.h>
+#include <builtinFonts/notosans_8_regular.h>
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "lib/GfxRenderer/GlyphBlitter.h"
+
+// Same geometry as the X4 panel (HalDisplay / EInkDisplay)
+constexpr int kPanelWidth = 800;
+constexpr int kPanelHeight = 480;
+constexpr int kPanelWidthBytes = kPanelWidth / 8;
+constexpr size_t kBufferSize = kPanelWidthBytes * kPanelHeight;
+
+enum class RenderMode { BW, GRAYSCALE_LSB, GRAYSCALE_MSB };
+
+const char* const kOrientationNames[] = {"Portrait", "LandscapeClockwise", "PortraitInverted",
+                                         "LandscapeCounterClockwise"};
+const char* const kRenderModeNames[] = {"BW", "GRAYSCALE_LSB", "GRAYSCALE_MSB"};
+
+const char* const kPageText =
+    "It was a bright cold day in April, and the clocks were striking thirteen. Winston Smith, his chin nuzzled into "
+    "his breast in an effort to escape the vile wind, slipped quickly through the glass doors of Victory Mansions, "
+    "though not quickly enough to prevent a swirl of gritty dust from entering along with him. Quand j'étais petit, "
+    "je lisais «Les Misérables» — über 1 234 567 890 Seiten!";
+
+// Reference: the per-pixel path GfxRenderer::renderChar used before the blitter
+struct ReferenceRenderer {
+  uint8_t* frameBuffer;
+  GlyphBlitter::Rotation orientation;
+
+  void drawPixel(const int x, const int y, const bool state) const {
+    int phyX = 0;
+    int phyY = 0;
+    switch (orientation) {
+      case GlyphBlitter::Portrait:
+        phyX = y;
+        phyY = kPanelHeight - 1 - x;
+        break;
+      case GlyphBlitter::LandscapeClockwise:
+        phyX = kPanelWidth - 1 - x;
+        phyY = kPanelHeight - 1 - y;
+        break;
+      case GlyphBlitter::PortraitInverted:
+        phyX = kPanelWidth - 1 - y;
+        phyY = x;
+        break;
+      case GlyphBlitter::LandscapeCounterClockwise:
+        phyX = x;
+        phyY = y;
+        break;
+    }
+    if (phyX < 0 || phyX >= kPanelWidth || phyY < 0 || phyY >= kPanelHeight) {
+      return;
+    }
+    const uint16_t byteIndex = phyY * kPanelWidthBytes + (phyX / 8);
+    const uint8_t bitPosition = 7 - (phyX % 8);
+    if (state) {
+      frameBuffer[byteIndex] &= ~(1 << bitPosition);
+    } else {
+      frameBuffer[byteIndex] |= 1 << bitPosition;
+    }
+  }
+
+  void renderGlyph(const EpdFontData& data, const EpdGlyph& glyph, const int x, const int y, const bool pixelState,
+                   const RenderMode renderMode) const {
+    const uint8_t* bitmap = &data.bitmap[glyph.dataOffset];
+    for (int glyphY = 0; glyphY < glyph.height; glyphY++) {
+      const int screenY = y - glyph.top + glyphY;
+      for (int glyphX = 0; glyphX < glyph.width; glyphX++) {
+        const int pixelPosition = glyphY * glyph.width + glyphX;
+        const int screenX = x + glyph.left + glyphX;
+        if (data.is2Bit) {
+          const uint8_t byte = bitmap[pixelPosition / 4];
+          const uint8_t bit_index = (3 - pixelPosition % 4) * 2;
+          const uint8_t bmpVal = (3 - (byte >> bit_index)) & 0x3;
+          if (renderMode == RenderMode::BW && bmpVal < 3) {
+            drawPixel(screenX, screenY, pixelState);
+          } else if (renderMode == RenderMode::GRAYSCALE_MSB && (bmpVal == 1 || bmpVal == 2)) {
+            drawPixel(screenX, screenY, false);
+          } else if (renderMode == RenderMode::GRAYSCALE_LSB && bmpVal == 1) {
+            drawPixel(screenX, screenY, false);
+          }
+        } else {
+          const uint8_t byte = bitmap[pixelPosition / 8];
+          const uint8_t bit_index = 7 - (pixelPosition % 8);
+          if ((byte >> bit_index) & 1) {
+            drawPixel(screenX, screenY, pixelState);
+          }
+        }
+      }
+    }
+  }
+};
+
+// Mirrors the lit mask / state selection in GfxRenderer::renderChar
+GlyphBlitter::Plane makePlane(const GlyphBlitter::Target& target, const EpdFontData& data, const bool pixelState,
+                              const RenderMode renderMode) {
+  uint8_t litMask = GlyphBlitter::LIT_1BIT;
+  bool state = pixelState;
+  if (data.is2Bit) {
+    if (renderMode == RenderMode::BW) {
+      litMask = GlyphBlitter::LIT_2BIT_ANY;
+    } else if (renderMode == RenderMode::GRAYSCALE_MSB) {
+      litMask = GlyphBlitter::LIT_2BIT_LIGHT_AND_DARK;
+      state = false;
+    } else {
+      litMask = GlyphBlitter::LIT_2BIT_DARK;
+      state = false;
+    }
+  }
+  return {target, litMask, state};
+}
+
+void blitGlyph(const GlyphBlitter::Plane* planes, const int planeCount, const GlyphBlitter::Rotation orientation,
+               const EpdFontData& data, const EpdGlyph& glyph, const int x, const int y, const int strikeOffset) {
+  GlyphBlitter::blit(planes, planeCount, orientation, &data.bitmap[glyph.dataOffset], glyph.width, glyph.height,
+                     data.is2Bit, x + glyph.left, y - glyph.top, strikeOffset);
+}
+
+// A panel buffer split into 8KB chunks of whole rows, like GfxRenderer's stored BW buffer
+struct ChunkedBuffer {
+  static constexpr int kChunkSize = 8000;
+  static constexpr int kRowsPerChunk = kChunkSize / kPanelWidthBytes;
+  std::vector<std::vector<uint8_t>> storage;
+  std::vector<uint8_t*> chunks;
+
+  ChunkedBuffer() : storage(kBufferSize / kChunkSize, std::vector<uint8_t>(kChunkSize)) {
+    for (auto& chunk : storage) {
+      chunks.push_back(chunk.data());
+    }
+  }
+
+  void fill(const uint8_t value) {
+    for (auto& chunk : storage) {
+      memset(chunk.data(), value, chunk.size());
+    }
+  }
+
+  std::vector<uint8_t> flatten() const {
+    std::vector<uint8_t> flat;
+    for (const auto& chunk : storage) {
+      flat.insert(flat.end(), chunk.begin(), chunk.end());
+    }
+    return flat;
+  }
+
+  GlyphBlitter::Target target() const {
+    return {chunks.data(), kRowsPerChunk, kPanelWidth, kPanelHeight, kPanelWidthBytes};
+  }
+};
+
+struct PlacedGlyph {
+  const EpdGlyph* glyph;
+  int x;
+  int y;
+};
+
+// Lay out kPageText line after line, starting slightly off-screen so clipping is exercised on every edge
+std::vector<PlacedGlyph> layoutPage(const EpdFont& font, const GlyphBlitter::Rotation orientation) {
+  const bool portrait = orientation == GlyphBlitter::Portrait || orientation == GlyphBlitter::PortraitInverted;
+  const int screenWidth = portrait ? kPanelHeight : kPanelWidth;
+  const int screenHeight = portrait ? kPanelWidth : kPanelHeight;
+  const int lineHeight = font.data->advanceY;
+
+  std::vector<PlacedGlyph> page;
+  int line = 0;
+  for (int y = font.data->ascender - 6; y < screenHeight + lineHeight; y += lineHeight, line++) {
+    int x = -7 + (line % 5) * 3;
+    const auto* text = reinterpret_cast<const unsigned char*>(kPageText) + (line * 17) % 40;
+    uint32_t cp;
+    while (x < screenWidth + 20 && (cp = utf8NextCodepoint(&text))) {
+      const EpdGlyph* glyph = font.getGlyph(cp);
+      if (!glyph) {
+        glyph = font.getGlyph(REPLACEMENT_GLYPH);
+      }
+      if (!glyph) {
+        continue;
+      }
+      page.push_back({glyph, x, y});
+      x += glyph->advanceX;
+    }
+  }
+  return page;
+}
+
+struct FontCase {
+  const char* name;
+  const EpdFont* font;
+};
+
+template <typename Fn>
+double timePerPage(const int iterations, Fn&& renderPage) {
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    renderPage();
+  }
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+int main(int argc, char* argv[]) {
+  const int iterations = argc > 1 ? std::atoi(argv[1]) : 50;
+
+  const EpdFont bookerly(&bookerly_14_regular);
+  const EpdFont notoSans(&notosans_8_regular);
+  const FontCase fonts[] = {{"bookerly_14_regular (2-bit)", &bookerly}, {"notosans_8_regular (1-bit)", &notoSans}};
+
+  std::vector<uint8_t> reference(kBufferSize);
+  std::vector<uint8_t> referenceLsb(kBufferSize);
+  std::vector<uint8_t> referenceMsb(kBufferSize);
+  std::vector<uint8_t> blitted(kBufferSize);
+  uint8_t* blittedChunks[] = {blitted.data()};
+  const GlyphBlitter::Target blittedTarget = {blittedChunks, kPanelHeight, kPanelWidth, kPanelHeight,
+                                              kPanelWidthBytes};
+  ChunkedBuffer blittedLsb;
+  ChunkedBuffer blittedMsb;
+  int failures = 0;
+
+  for (const auto& fontCase : fonts) {
+    const EpdFontData& data = *fontCase.font->data;
+    for (int o = 0; o < 4; o++) {
+      const auto orientation = static_cast<GlyphBlitter::Rotation>(o);
+      const auto page = layoutPage(*fontCase.font, orientation);
+
+      // Every render mode and pixel state, one plane at a time, must match the per-pixel path
+      for (int m = 0; m < 3; m++) {
+        const auto renderMode = static_cast<RenderMode>(m);
+        for (const bool pixelState : {true, false}) {
+          const uint8_t background = pixelState ? 0xFF : 0x00;
+          memset(reference.data(), background, kBufferSize);
+          memset(blitted.data(), background, kBufferSize);
+
+          const ReferenceRenderer referenceRenderer{reference.data(), orientation};
+          const GlyphBlitter::Plane plane = makePlane(blittedTarget, data, pixelState, renderMode);
+          for (const auto& placed : page) {
+            referenceRenderer.renderGlyph(data, *placed.glyph, placed.x, placed.y, pixelState, renderMode);
+            blitGlyph(&plane, 1, orientation, data, *placed.glyph, placed.x, placed.y, 0);
+          }
+
+          if (reference != blitted) {
+            std::cout << "MISMATCH " << fontCase.name << " " << kOrientationNames[o] << " " << kRenderModeNames[m]
+                      << " state=" << pixelState << std::endl;
+            failures++;
+          }
+        }
+      }
+
+      // Anti-aliased page: BW, LSB and MSB planes with a 1px strike in one pass must match six per-pixel passes
+      memset(reference.data(), 0xFF, kBufferSize);
+      memset(referenceLsb.data(), 0x00, kBufferSize);
+      memset(referenceMsb.data(), 0x00, kBufferSize);
+      memset(blitted.data(), 0xFF, kBufferSize);
+      blittedLsb.fill(0x00);
+      blittedMsb.fill(0x00);
+
+      const ReferenceRenderer referenceBw{reference.data(), orientation};
+      const ReferenceRenderer referenceLsbRenderer{referenceLsb.data(), orientation};
+      const ReferenceRenderer referenceMsbRenderer{referenceMsb.data(), orientation};
+      const GlyphBlitter::Plane planes[] = {makePlane(blittedTarget, data, true, RenderMode::BW),
+                                            makePlane(blittedLsb.target(), data, true, RenderMode::GRAYSCALE_LSB),
+                                            makePlane(blittedMsb.target(), data, true, RenderMode::GRAYSCALE_MSB)};
+      for (const int shift : {0, 1}) {
+        for (const auto& placed : page) {
+          referenceBw.renderGlyph(data, *placed.glyph, placed.x + shift, placed.y, true, RenderMode::BW);
+          referenceLsbRenderer.renderGlyph(data, *placed.glyph, placed.x + shift, placed.y, true,
+                                           RenderMode::GRAYSCALE_LSB);
+          referenceMsbRenderer.renderGlyph(data, *placed.glyph, placed.x + shift, placed.y, true,
+                                           RenderMode::GRAYSCALE_MSB);
+        }
+      }
+      for (const auto& placed : page) {
+        blitGlyph(planes, 3, orientation, data, *placed.glyph, placed.x, placed.y, 1);
+      }
+
+      if (reference != blitted || referenceLsb != blittedLsb.flatten() || referenceMsb != blittedMsb.flatten()) {
+        std::cout << "MISMATCH " << fontCase.name << " " << kOrientationNames[o] << " single-pass grayscale"
+                  << std::endl;
+        failures++;
+      }
+    }
+  }
+  std::cout << (failures == 0 ? "All framebuffers match the per-pixel reference" : "Framebuffer mismatches found")
+            << std::endl
+            << std::endl;
+
+  for (const auto& fontCase : fonts) {
+    const EpdFontData& data = *fontCase.font->data;
+    std::cout << fontCase.name << ", " << iterations << " pages" << std::endl;
+    for (int o = 0; o < 4; o++) {
+      const auto orientation = static_cast<GlyphBlitter::Rotation>(o);
+      const auto page = layoutPage(*fontCase.font, orientation);
+      const ReferenceRenderer referenceRenderer{reference.data(), orientation};
+      const GlyphBlitter::Plane bwPlane = makePlane(blittedTarget, data, true, RenderMode::BW);
+      const GlyphBlitter::Plane planes[] = {bwPlane,
+                                            makePlane(blittedLsb.target(), data, true, RenderMode::GRAYSCALE_LSB),
+                                            makePlane(blittedMsb.target(), data, true, RenderMode::GRAYSCALE_MSB)};
+
+      // BW page
+      const double referenceMicros = timePerPage(iterations, [&] {
+        memset(reference.data(), 0xFF, kBufferSize);
+        for (const auto& placed : page) {
+          referenceRenderer.renderGlyph(data, *placed.glyph, placed.x, placed.y, true, RenderMode::BW);
+        }
+      });
+      const double blitMicros = timePerPage(iterations, [&] {
+        memset(blitted.data(), 0xFF, kBufferSize);
+        for (const auto& placed : page) {
+          blitGlyph(&bwPlane, 1, orientation, data, *placed.glyph, placed.x, placed.y, 0);
+        }
+      });
+
+      // Anti-aliased page: six per-pixel passes (BW, LSB and MSB, each drawn twice) vs one three-plane pass
+      const double referenceAaMicros = timePerPage(iterations, [&] {
+        const RenderMode modes[] = {RenderMode::BW, RenderMode::GRAYSCALE_LSB, RenderMode::GRAYSCALE_MSB};
+        for (const auto renderMode : modes) {
+          memset(reference.data(), renderMode == RenderMode::BW ? 0xFF : 0x00, kBufferSize);
+          for (const int shift : {0, 1}) {
+            for (const auto& placed : page) {
+              referenceRenderer.renderGlyph(data, *placed.glyph, placed.x + shift, placed.y, true, renderMode);
+            }
+          }
+        }
+      });
+      const double blitAaMicros = timePerPage(iterations, [&] {
+        memset(blitted.data(), 0xFF, kBufferSize);
+        blittedLsb.fill(0x00);
+        blittedMsb.fill(0x00);
+        for (const auto& placed : page) {
+          blitGlyph(planes, 3, orientation, data, *placed.glyph, placed.x, placed.y, 1);
+        }
+      });
+
+      std::cout << "  " << kOrientationNames[o] << ": BW drawPixel " << referenceMicros << " us, blitter "
+                << blitMicros << " us (" << referenceMicros / blitMicros << "x); anti-aliased 6 passes "
+                << referenceAaMicros << " us, single pass " << blitAaMicros << " us ("
+                << referenceAaMicros / blitAaMicros << "x)" << std::endl;
+    }
+  }
+
+  return failures == 0 ? 0 : 1;
+}
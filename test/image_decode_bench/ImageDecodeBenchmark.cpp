@@ -0,0 +1,626 @@
+#include <BmpRowWriter.h>
+#include <GifToBmpConverter.h>
+#include <PngToBmpConverter.h>
+#include <Print.h>
+#include <miniz.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+// Fixtures are encoded here rather than checked in, so every filter, color type and bit depth is covered and the
+// expected gray value of every pixel is known exactly
+struct Fixture {
+  std::string name;
+  std::vector<uint8_t> data;
+  int width = 0;
+  int height = 0;
+  std::vector<uint8_t> gray;  // Expected decoded gray, row-major, transparent pixels already on white
+  bool interlaced = false;
+};
+
+class MemoryPrint final : public Print {
+ public:
+  std::vector<uint8_t> bytes;
+  size_t write(const uint8_t c) override {
+    bytes.push_back(c);
+    return 1;
+  }
+  size_t write(const uint8_t* buffer, const size_t size) override {
+    bytes.insert(bytes.end(), buffer, buffer + size);
+    return size;
+  }
+};
+
+// Deterministic noise, so failures reproduce
+uint32_t rngState = 12345;
+uint32_t nextRandom() {
+  rngState = rngState * 1103515245 + 12345;
+  return rngState >> 8;
+}
+
+// The decoders' own conversions, restated as the expected behaviour
+int toGray(const int r, const int g, const int b) { return (r * 25 + g * 50 + b * 25) / 100; }
+int onWhite(const int gray, const int alpha) { return (gray * alpha + 255 * (255 - alpha)) / 255; }
+
+void putBe32(std::vector<uint8_t>& out, const uint32_t value) {
+  out.push_back(value >> 24);
+  out.push_back(value >> 16);
+  out.push_back(value >> 8);
+  out.push_back(value);
+}
+
+void putLe16(std::vector<uint8_t>& out, const int value) {
+  out.push_back(value & 0xFF);
+  out.push_back(value >> 8);
+}
+
+// ---- PNG ----
+
+void addPngChunk(std::vector<uint8_t>& png, const char* type, const std::vector<uint8_t>& payload) {
+  putBe32(png, payload.size());
+  const size_t typeStart = png.size();
+  png.insert(png.end(), type, type + 4);
+  png.insert(png.end(), payload.begin(), payload.end());
+  putBe32(png, mz_crc32(MZ_CRC32_INIT, png.data() + typeStart, png.size() - typeStart));
+}
+
+int paeth(const int a, const int b, const int c) {
+  const int p = a + b - c;
+  const int pa = std::abs(p - a);
+  const int pb = std::abs(p - b);
+  const int pc = std::abs(p - c);
+  if (pa <= pb && pa <= pc) return a;
+  if (pb <= pc) return b;
+  return c;
+}
+
+// Filter one scanline against the previous one of the same pass
+void filterRow(const int type, const std::vector<uint8_t>& row, const std::vector<uint8_t>& prior, const int bpp,
+               std::vector<uint8_t>& out) {
+  out.push_back(type);
+  for (size_t i = 0; i < row.size(); i++) {
+    const int a = i >= static_cast<size_t>(bpp) ? row[i - bpp] : 0;
+    const int b = prior[i];
+    const int c = i >= static_cast<size_t>(bpp) ? prior[i - bpp] : 0;
+    int predicted = 0;
+    switch (type) {
+      case 1:
+        predicted = a;
+        break;
+      case 2:
+        predicted = b;
+        break;
+      case 3:
+        predicted = (a + b) >> 1;
+        break;
+      case 4:
+        predicted = paeth(a, b, c);
+        break;
+      default:
+        break;
+    }
+    out.push_back(static_cast<uint8_t>(row[i] - predicted));
+  }
+}
+
+struct PngSpec {
+  std::string name;
+  int width;
+  int height;
+  int colorType;  // 0 gray, 2 RGB, 3 palette, 4 gray + alpha, 6 RGBA
+  int bitDepth;
+  int filter;  // 0-4, or -1 to pick one per row
+  bool interlaced;
+  int paletteSize;    // Palette images only
+  bool paletteAlpha;  // Palette images: add a tRNS chunk
+};
+
+Fixture makePng(const PngSpec& spec) {
+  Fixture fixture;
+  fixture.name = spec.name;
+  fixture.width = spec.width;
+  fixture.height = spec.height;
+  fixture.interlaced = spec.interlaced;
+
+  const int channels = spec.colorType == 0 || spec.colorType == 3 ? 1
+                       : spec.colorType == 2                     ? 3
+                       : spec.colorType == 4                     ? 2
+                                                                 : 4;
+  const int maxSample = (1 << spec.bitDepth) - 1;
+
+  // Palette: colors and alpha, and their expected gray
+  std::vector<uint8_t> plte;
+  std::vector<uint8_t> trns;
+  std::vector<int> paletteGray;
+  for (int i = 0; i < spec.paletteSize; i++) {
+    const int r = nextRandom() & 0xFF;
+    const int g = nextRandom() & 0xFF;
+    const int b = nextRandom() & 0xFF;
+    const int alpha = spec.paletteAlpha ? (i % 3 == 0 ? 0 : i % 3 == 1 ? 128 : 255) : 255;
+    plte.insert(plte.end(), {static_cast<uint8_t>(r), static_cast<uint8_t>(g), static_cast<uint8_t>(b)});
+    trns.push_back(alpha);
+    paletteGray.push_back(onWhite(toGray(r, g, b), alpha));
+  }
+
+  // Samples: a gradient with noise on top, so neighbouring pixels differ but filters still have something to predict
+  std::vector<std::vector<int>> samples(spec.width * spec.height, std::vector<int>(channels));
+  fixture.gray.resize(spec.width * spec.height);
+  for (int y = 0; y < spec.height; y++) {
+    for (int x = 0; x < spec.width; x++) {
+      std::vector<int>& px = samples[y * spec.width + x];
+      for (int c = 0; c < channels; c++) {
+        const int base = (x * 7 + y * 3 + c * 50) * (maxSample + 1) / 256;
+        px[c] = (base + static_cast<int>(nextRandom() % 5)) & maxSample;
+      }
+      if (spec.colorType == 3) {
+        px[0] %= spec.paletteSize;
+      }
+      // Gray of the first byte of each sample, which is what the decoder keeps of 16-bit samples
+      auto top = [&](const int value) { return spec.bitDepth == 16 ? value >> 8 : value; };
+      int gray;
+      switch (spec.colorType) {
+        case 0:
+          gray = spec.bitDepth < 8 ? px[0] * 255 / maxSample : top(px[0]);
+          break;
+        case 2:
+          gray = toGray(top(px[0]), top(px[1]), top(px[2]));
+          break;
+        case 3:
+          gray = paletteGray[px[0]];
+          break;
+        case 4:
+          gray = onWhite(top(px[0]), top(px[1]));
+          break;
+        default:
+          gray = onWhite(toGray(top(px[0]), top(px[1]), top(px[2])), top(px[3]));
+          break;
+      }
+      fixture.gray[y * spec.width + x] = gray;
+    }
+  }
+
+  // Scanlines of each pass (a single pass when not interlaced), packed and filtered
+  struct Pass {
+    int x0, y0, dx, dy;
+  };
+  const Pass adam7[7] = {{0, 0, 8, 8}, {4, 0, 8, 8}, {0, 4, 4, 8}, {2, 0, 4, 4},
+                         {0, 2, 2, 4}, {1, 0, 2, 2}, {0, 1, 1, 2}};
+  const Pass single[1] = {{0, 0, 1, 1}};
+  const Pass* passes = spec.interlaced ? adam7 : single;
+  const int passCount = spec.interlaced ? 7 : 1;
+  const int bpp = std::max(1, channels * spec.bitDepth / 8);
+
+  std::vector<uint8_t> raw;
+  int rowNumber = 0;
+  for (int p = 0; p < passCount; p++) {
+    const Pass& pass = passes[p];
+    const int passWidth = (spec.width - pass.x0 + pass.dx - 1) / pass.dx;
+    const int passHeight = (spec.height - pass.y0 + pass.dy - 1) / pass.dy;
+    if (passWidth <= 0 || passHeight <= 0) {
+      continue;
+    }
+    const size_t rowBytes = (static_cast<size_t>(passWidth) * channels * spec.bitDepth + 7) / 8;
+    std::vector<uint8_t> prior(rowBytes, 0);
+    for (int py = 0; py < passHeight; py++) {
+      std::vector<uint8_t> row(rowBytes, 0);
+      int bit = 0;
+      for (int px = 0; px < passWidth; px++) {
+        const std::vector<int>& s = samples[(pass.y0 + py * pass.dy) * spec.width + pass.x0 + px * pass.dx];
+        for (int c = 0; c < channels; c++) {
+          if (spec.bitDepth == 16) {
+            row[bit / 8] = s[c] >> 8;
+            row[bit / 8 + 1] = s[c] & 0xFF;
+          } else if (spec.bitDepth == 8) {
+            row[bit / 8] = s[c];
+          } else {
+            row[bit / 8] |= s[c] << (8 - spec.bitDepth - bit % 8);
+          }
+          bit += spec.bitDepth;
+        }
+      }
+      const int filter = spec.filter >= 0 ? spec.filter : rowNumber % 5;
+      filterRow(filter, row, prior, bpp, raw);
+      prior = row;
+      rowNumber++;
+    }
+  }
+
+  std::vector<uint8_t> compressed(mz_compressBound(raw.size()));
+  mz_ulong compressedSize = compressed.size();
+  mz_compress(compressed.data(), &compressedSize, raw.data(), raw.size());
+  compressed.resize(compressedSize);
+
+  std::vector<uint8_t>& png = fixture.data;
+  png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  std::vector<uint8_t> ihdr;
+  putBe32(ihdr, spec.width);
+  putBe32(ihdr, spec.height);
+  ihdr.insert(ihdr.end(), {static_cast<uint8_t>(spec.bitDepth), static_cast<uint8_t>(spec.colorType), 0, 0,
+                           static_cast<uint8_t>(spec.interlaced ? 1 : 0)});
+  addPngChunk(png, "IHDR", ihdr);
+  addPngChunk(png, "tEXt", {'C', 'o', 'm', 'm', 'e', 'n', 't', 0, 't', 'e', 's', 't'});
+  if (spec.colorType == 3) {
+    addPngChunk(png, "PLTE", plte);
+    if (spec.paletteAlpha) {
+      addPngChunk(png, "tRNS", trns);
+    }
+  }
+  // Split the image data over several IDAT chunks, the way encoders with a fixed buffer do
+  for (size_t offset = 0; offset < compressed.size(); offset += 97) {
+    const size_t end = std::min(compressed.size(), offset + 97);
+    addPngChunk(png, "IDAT", std::vector<uint8_t>(compressed.begin() + offset, compressed.begin() + end));
+  }
+  addPngChunk(png, "IEND", {});
+  return fixture;
+}
+
+// ---- GIF ----
+
+// LSB-first bit packing into 255-byte sub-blocks
+class GifBitWriter {
+ public:
+  void put(const int code, const int size) {
+    buffer |= static_cast<uint32_t>(code) << bits;
+    bits += size;
+    while (bits >= 8) {
+      bytes.push_back(buffer & 0xFF);
+      buffer >>= 8;
+      bits -= 8;
+    }
+  }
+  void finish(std::vector<uint8_t>& out) {
+    if (bits > 0) {
+      bytes.push_back(buffer & 0xFF);
+    }
+    for (size_t offset = 0; offset < bytes.size(); offset += 255) {
+      const size_t n = std::min<size_t>(255, bytes.size() - offset);
+      out.push_back(n);
+      out.insert(out.end(), bytes.begin() + offset, bytes.begin() + offset + n);
+    }
+    out.push_back(0);
+  }
+
+ private:
+  std::vector<uint8_t> bytes;
+  uint32_t buffer = 0;
+  int bits = 0;
+};
+
+// Plain LZW, with a clear code whenever the 4096-entry table fills up
+void lzwEncode(const std::vector<uint8_t>& indexes, const int minCodeSize, std::vector<uint8_t>& out) {
+  const int clearCode = 1 << minCodeSize;
+  const int endCode = clearCode + 1;
+  int codeSize = minCodeSize + 1;
+  int nextCode = endCode + 1;
+  bool firstAfterClear = true;
+  std::map<uint32_t, int> table;
+  GifBitWriter writer;
+
+  out.push_back(minCodeSize);
+  writer.put(clearCode, codeSize);
+  int current = indexes[0];
+  for (size_t i = 1; i < indexes.size(); i++) {
+    const uint32_t key = (static_cast<uint32_t>(current) << 8) | indexes[i];
+    const auto found = table.find(key);
+    if (found != table.end()) {
+      current = found->second;
+      continue;
+    }
+    writer.put(current, codeSize);
+    firstAfterClear = false;
+    table[key] = nextCode++;
+    if (nextCode > (1 << codeSize) && codeSize < 12) {
+      codeSize++;
+    }
+    if (nextCode == 4096) {
+      writer.put(clearCode, codeSize);
+      table.clear();
+      codeSize = minCodeSize + 1;
+      nextCode = endCode + 1;
+      firstAfterClear = true;
+    }
+    current = indexes[i];
+  }
+  writer.put(current, codeSize);
+  // The decoder adds a table entry for the last code too (unless it follows a clear), which may widen the end code
+  if (!firstAfterClear && nextCode < 4096 && nextCode + 1 > (1 << codeSize) && codeSize < 12) {
+    codeSize++;
+  }
+  writer.put(endCode, codeSize);
+  writer.finish(out);
+}
+
+struct GifSpec {
+  std::string name;
+  int width;
+  int height;
+  int colors;  // Power of two
+  bool interlaced;
+  int transparentIndex;  // -1 for none
+  bool localPalette;     // Color table on the image instead of the screen
+};
+
+Fixture makeGif(const GifSpec& spec) {
+  Fixture fixture;
+  fixture.name = spec.name;
+  fixture.width = spec.width;
+  fixture.height = spec.height;
+  fixture.interlaced = spec.interlaced;
+
+  int tableBits = 0;
+  while ((2 << tableBits) < spec.colors) {
+    tableBits++;
+  }
+  std::vector<uint8_t> palette;
+  std::vector<int> paletteGray;
+  for (int i = 0; i < spec.colors; i++) {
+    const int r = nextRandom() & 0xFF;
+    const int g = nextRandom() & 0xFF;
+    const int b = nextRandom() & 0xFF;
+    palette.insert(palette.end(), {static_cast<uint8_t>(r), static_cast<uint8_t>(g), static_cast<uint8_t>(b)});
+    paletteGray.push_back(i == spec.transparentIndex ? 255 : toGray(r, g, b));
+  }
+
+  // Indexes in display order; noisy enough that a 256-color image fills the LZW table several times
+  std::vector<uint8_t> image(spec.width * spec.height);
+  fixture.gray.resize(image.size());
+  for (int y = 0; y < spec.height; y++) {
+    for (int x = 0; x < spec.width; x++) {
+      const int index = ((x + y) / 3 + static_cast<int>(nextRandom() % 4)) % spec.colors;
+      image[y * spec.width + x] = index;
+      fixture.gray[y * spec.width + x] = paletteGray[index];
+    }
+  }
+
+  // Rows in the order they are stored: every 8th from 0, every 8th from 4, every 4th from 2, then the odd rows
+  std::vector<uint8_t> indexes;
+  std::vector<int> rowOrder;
+  if (spec.interlaced) {
+    const int starts[4] = {0, 4, 2, 1};
+    const int steps[4] = {8, 8, 4, 2};
+    for (int p = 0; p < 4; p++) {
+      for (int y = starts[p]; y < spec.height; y += steps[p]) {
+        rowOrder.push_back(y);
+      }
+    }
+  } else {
+    for (int y = 0; y < spec.height; y++) {
+      rowOrder.push_back(y);
+    }
+  }
+  for (const int y : rowOrder) {
+    indexes.insert(indexes.end(), image.begin() + y * spec.width, image.begin() + (y + 1) * spec.width);
+  }
+
+  std::vector<uint8_t>& gif = fixture.data;
+  const char* header = "GIF89a";
+  gif.insert(gif.end(), header, header + 6);
+  putLe16(gif, spec.width);
+  putLe16(gif, spec.height);
+  gif.push_back(spec.localPalette ? 0x00 : 0x80 | tableBits);
+  gif.push_back(0);  // Background color
+  gif.push_back(0);  // Aspect ratio
+  if (!spec.localPalette) {
+    gif.insert(gif.end(), palette.begin(), palette.end());
+  }
+  // An application extension before the frame, which the decoder has to skip
+  gif.insert(gif.end(), {0x21, 0xFF, 11, 'N', 'E', 'T', 'S', 'C', 'A', 'P', 'E', '2', '.', '0', 3, 1, 0, 0, 0});
+  if (spec.transparentIndex >= 0) {
+    gif.insert(gif.end(), {0x21, 0xF9, 4, 0x01, 0, 0, static_cast<uint8_t>(spec.transparentIndex), 0});
+  }
+  gif.push_back(0x2C);
+  putLe16(gif, 0);
+  putLe16(gif, 0);
+  putLe16(gif, spec.width);
+  putLe16(gif, spec.height);
+  gif.push_back((spec.interlaced ? 0x40 : 0) | (spec.localPalette ? 0x80 | tableBits : 0));
+  if (spec.localPalette) {
+    gif.insert(gif.end(), palette.begin(), palette.end());
+  }
+  lzwEncode(indexes, std::max(2, tableBits + 1), gif);
+  gif.push_back(0x3B);
+  return fixture;
+}
+
+// ---- Checks ----
+
+std::vector<BmpTarget> targetsFor(std::vector<MemoryPrint>& outputs) {
+  // A cropped 2-bit cover and a fitted 1-bit thumbnail, so both scaler paths and both bit depths are checked
+  return {{&outputs[0], BmpTarget::COVER_MAX_WIDTH, BmpTarget::COVER_MAX_HEIGHT, false, true},
+          {&outputs[1], 60, 90, true, false}};
+}
+
+// What the decoder should produce: the expected rows fed straight into the same writers. Interlaced images are
+// decoded from their odd rows only.
+std::vector<MemoryPrint> referenceBmps(const Fixture& fixture) {
+  std::vector<MemoryPrint> outputs(2);
+  const std::vector<BmpTarget> targets = targetsFor(outputs);
+  const int srcHeight = fixture.interlaced ? fixture.height / 2 : fixture.height;
+  for (const BmpTarget& target : targets) {
+    BmpRowWriter writer;
+    writer.fit(target, fixture.width, fixture.height);
+    writer.begin(fixture.width, srcHeight);
+    for (int y = 0; y < srcHeight; y++) {
+      const int row = fixture.interlaced ? y * 2 + 1 : y;
+      writer.addSourceRow(fixture.gray.data() + row * fixture.width, y);
+    }
+  }
+  return outputs;
+}
+
+template <typename Fn>
+double timeMs(Fn&& fn) {
+  const auto start = std::chrono::steady_clock::now();
+  fn();
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Decode `fixture` from memory into `target`, `maxRead` bytes at most per read
+bool decodeFixture(const Fixture& fixture, const bool png, const BmpTarget& target, const size_t maxRead) {
+  size_t offset = 0;
+  const ImageReadFn read = [&fixture, &offset, maxRead](uint8_t* buf, const size_t len) {
+    const size_t n = std::min({len, maxRead, fixture.data.size() - offset});
+    memcpy(buf, fixture.data.data() + offset, n);
+    offset += n;
+    return n;
+  };
+  return png ? PngToBmpConverter::pngToBmpStream(read, target) : GifToBmpConverter::gifToBmpStream(read, target);
+}
+
+bool checkDecode(const Fixture& fixture, const bool png) {
+  std::vector<MemoryPrint> outputs(2);
+  bool ok = true;
+  const double ms = timeMs([&] {
+    for (const BmpTarget& target : targetsFor(outputs)) {
+      // Odd read sizes, so chunk and sub-block boundaries fall anywhere in a read
+      ok = decodeFixture(fixture, png, target, 61) && ok;
+    }
+  });
+  const std::vector<MemoryPrint> expected = referenceBmps(fixture);
+  const bool match = ok && outputs[0].bytes == expected[0].bytes && outputs[1].bytes == expected[1].bytes;
+  std::cout << "  " << fixture.name << ": " << fixture.width << "x" << fixture.height << ", " << fixture.data.size()
+            << " bytes, " << ms << " ms" << (match ? "" : ok ? "  MISMATCH against the reference BMPs" : "  FAILED")
+            << std::endl;
+  return match;
+}
+
+// Write `gray` (`width` x `rows`, fitted as a `width` x `height` image) through one BmpRowWriter
+std::vector<uint8_t> writeBmp(const BmpTarget& target, const std::vector<uint8_t>& gray, const int width,
+                              const int height, const int rows) {
+  MemoryPrint out;
+  BmpTarget t = target;
+  t.out = &out;
+  BmpRowWriter writer;
+  writer.fit(t, width, height);
+  writer.begin(width, rows);
+  for (int y = 0; y < rows; y++) {
+    writer.addSourceRow(gray.data() + y * width, y);
+  }
+  return out.bytes;
+}
+
+std::vector<uint8_t> testPattern(const int width, const int height) {
+  std::vector<uint8_t> gray(width * height);
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      gray[y * width + x] = (x * 255 / (width - 1) + static_cast<int>(nextRandom() % 32) + y / 8) & 0xFF;
+    }
+  }
+  return gray;
+}
+
+// BmpRowWriter's scaler against its unscaled path. Halving an image must average each 2x2 block (rounding down) and
+// a half-height source must repeat each row; either way the dithered BMP is then the same as writing the expected rows
+// unscaled.
+bool checkRowWriter(const char* name, const BmpTarget& target, const bool halfHeightSource) {
+  const int outWidth = target.maxWidth;
+  const int outHeight = target.maxHeight;
+  std::vector<uint8_t> expectedRows(outWidth * outHeight);
+  std::vector<uint8_t> scaled;
+  if (halfHeightSource) {
+    const std::vector<uint8_t> half = testPattern(outWidth, outHeight / 2);
+    for (int y = 0; y < outHeight; y++) {
+      memcpy(expectedRows.data() + y * outWidth, half.data() + (y / 2) * outWidth, outWidth);
+    }
+    scaled = writeBmp(target, half, outWidth, outHeight, outHeight / 2);
+  } else {
+    const int width = outWidth * 2;
+    const std::vector<uint8_t> full = testPattern(width, outHeight * 2);
+    for (int y = 0; y < outHeight; y++) {
+      for (int x = 0; x < outWidth; x++) {
+        const uint8_t* p = full.data() + (y * 2) * width + x * 2;
+        expectedRows[y * outWidth + x] = (p[0] + p[1] + p[width] + p[width + 1]) / 4;
+      }
+    }
+    scaled = writeBmp(target, full, width, outHeight * 2, outHeight * 2);
+  }
+  const std::vector<uint8_t> expected = writeBmp(target, expectedRows, outWidth, outHeight, outHeight);
+
+  // The header must describe the output size, top-down, with the requested depth
+  auto le32 = [&scaled](const size_t at) {
+    return static_cast<int32_t>(scaled[at] | scaled[at + 1] << 8 | scaled[at + 2] << 16 |
+                                static_cast<uint32_t>(scaled[at + 3]) << 24);
+  };
+  const bool header = scaled.size() > 54 && scaled[0] == 'B' && scaled[1] == 'M' && le32(18) == outWidth &&
+                      le32(22) == -outHeight && scaled[28] == (target.oneBit ? 1 : 2) &&
+                      static_cast<size_t>(le32(2)) == scaled.size();
+  const bool match = header && scaled == expected;
+  std::cout << "  " << name << ": " << outWidth << "x" << outHeight << ", " << scaled.size() << " bytes"
+            << (match    ? ""
+                : header ? "  MISMATCH against writing the expected rows unscaled"
+                         : "  MISMATCH in the BMP header")
+            << std::endl;
+  return match;
+}
+
+int main() {
+  int failures = 0;
+
+  std::cout << "PNG" << std::endl;
+  const PngSpec pngs[] = {
+      {"gray 8, filter none", 41, 29, 0, 8, 0, false, 0, false},
+      {"gray 8, filter sub", 41, 29, 0, 8, 1, false, 0, false},
+      {"gray 8, filter up", 41, 29, 0, 8, 2, false, 0, false},
+      {"gray 8, filter average", 41, 29, 0, 8, 3, false, 0, false},
+      {"gray 8, filter paeth", 41, 29, 0, 8, 4, false, 0, false},
+      {"gray 1", 45, 20, 0, 1, -1, false, 0, false},
+      {"gray 2", 45, 20, 0, 2, -1, false, 0, false},
+      {"gray 4", 45, 20, 0, 4, -1, false, 0, false},
+      {"gray 16", 33, 21, 0, 16, -1, false, 0, false},
+      {"gray + alpha 8", 33, 21, 4, 8, -1, false, 0, false},
+      {"rgb 8", 64, 48, 2, 8, -1, false, 0, false},
+      {"rgb 16", 31, 17, 2, 16, -1, false, 0, false},
+      {"rgba 8", 64, 48, 6, 8, -1, false, 0, false},
+      {"rgba 16", 31, 17, 6, 16, -1, false, 0, false},
+      {"palette 4 with tRNS", 37, 23, 3, 4, -1, false, 13, true},
+      {"palette 8", 120, 90, 3, 8, -1, false, 200, false},
+      {"palette 8 with tRNS", 50, 40, 3, 8, -1, false, 256, true},
+      {"adam7 rgba 8", 37, 29, 6, 8, -1, true, 0, false},
+      {"adam7 gray 2", 23, 18, 0, 2, -1, true, 0, false},
+      {"adam7 palette 8 with tRNS", 9, 7, 3, 8, -1, true, 40, true},
+      {"large rgb 8, downscaled", 900, 1300, 2, 8, -1, false, 0, false},
+  };
+  for (const PngSpec& spec : pngs) {
+    failures += checkDecode(makePng(spec), true) ? 0 : 1;
+  }
+
+  std::cout << "GIF" << std::endl;
+  const GifSpec gifs[] = {
+      {"2 colors", 40, 30, 2, false, -1, false},
+      {"16 colors, local palette", 53, 31, 16, false, -1, true},
+      {"256 colors, code size resets", 300, 200, 256, false, -1, false},
+      {"interlaced", 61, 45, 64, true, -1, false},
+      {"interlaced, 7 rows", 20, 7, 4, true, -1, false},
+      {"transparent", 48, 36, 32, false, 5, false},
+      {"interlaced, transparent, code size resets", 257, 301, 256, true, 0, true},
+  };
+  for (const GifSpec& spec : gifs) {
+    failures += checkDecode(makeGif(spec), false) ? 0 : 1;
+  }
+
+  std::cout << "BmpRowWriter" << std::endl;
+  failures += checkRowWriter("cover, halved", {nullptr, 480, 800, false, true}, false) ? 0 : 1;
+  failures += checkRowWriter("cover, rows repeated", {nullptr, 480, 800, false, true}, true) ? 0 : 1;
+  failures += checkRowWriter("1-bit thumbnail, halved", {nullptr, 120, 200, true, false}, false) ? 0 : 1;
+
+  // Broken input must fail cleanly rather than produce an image
+  std::cout << "Invalid input" << std::endl;
+  Fixture truncated = makePng({"truncated png", 40, 40, 2, 8, -1, false, 0, false});
+  truncated.data.resize(truncated.data.size() / 2);
+  Fixture truncatedGif = makeGif({"truncated gif", 40, 40, 16, false, -1, false});
+  truncatedGif.data.resize(truncatedGif.data.size() / 2);
+  for (const Fixture* fixture : {&truncated, &truncatedGif}) {
+    std::vector<MemoryPrint> outputs(2);
+    const bool ok = decodeFixture(*fixture, fixture == &truncated, targetsFor(outputs)[0], fixture->data.size());
+    std::cout << "  " << fixture->name << ": " << (ok ? "MISMATCH decoded without error" : "rejected") << std::endl;
+    failures += ok ? 1 : 0;
+  }
+
+  std::cout << (failures == 0 ? "All images match" : std::to_string(failures) + " check(s) failed") << std::endl;
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,130 @@
+#include <picojpeg.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+constexpr double kMinPsnr = 35.0;
+
+struct DecodedImage {
+  int width = 0;
+  int height = 0;
+  std::vector<uint8_t> gray;
+};
+
+unsigned char readCallback(unsigned char* buf, const unsigned char size, unsigned char* bytesRead, void* data) {
+  *bytesRead = static_cast<unsigned char>(fread(buf, 1, size, static_cast<FILE*>(data)));
+  return 0;
+}
+
+// Decode the whole file the way JpegToBmpConverter walks the MCU buffers. `shift` is log2 of the scale `reduce`
+// decodes at; full-size decodes are converted to gray from RGB, reduced ones are already luma.
+bool decode(const char* path, const unsigned char reduce, const int shift, DecodedImage& image) {
+  FILE* file = fopen(path, "rb");
+  if (!file) {
+    return false;
+  }
+  pjpeg_image_info_t info;
+  bool ok = pjpeg_decode_init(&info, readCallback, file, reduce) == 0;
+  image.width = (info.m_width + (1 << shift) - 1) >> shift;
+  image.height = (info.m_height + (1 << shift) - 1) >> shift;
+  image.gray.assign(ok ? image.width * image.height : 0, 0);
+
+  const int mcuWidth = info.m_MCUWidth >> shift;
+  const int mcuHeight = info.m_MCUHeight >> shift;
+  const int blockPixels = 8 >> shift;
+  for (int mcuY = 0; ok && mcuY < info.m_MCUSPerCol; mcuY++) {
+    for (int mcuX = 0; ok && mcuX < info.m_MCUSPerRow; mcuX++) {
+      ok = pjpeg_decode_mcu() == 0;
+      for (int y = 0; ok && y < mcuHeight; y++) {
+        for (int x = 0; x < mcuWidth; x++) {
+          const int pixelX = mcuX * mcuWidth + x;
+          const int pixelY = mcuY * mcuHeight + y;
+          if (pixelX >= image.width || pixelY >= image.height) {
+            continue;
+          }
+          const int offset = ((y / blockPixels) * 2 + x / blockPixels) * 64 + (y % blockPixels) * 8 + x % blockPixels;
+          image.gray[pixelY * image.width + pixelX] =
+              shift > 0 && reduce != PJPG_REDUCE_DC
+                  ? info.m_pMCUBufR[offset]
+                  : (info.m_pMCUBufR[offset] * 77 + info.m_pMCUBufG[offset] * 150 + info.m_pMCUBufB[offset] * 29) >> 8;
+        }
+      }
+    }
+  }
+  fclose(file);
+  return ok;
+}
+
+// PSNR of `reduced` against `full` box-filtered down to the same size
+double psnrAgainstBox(const DecodedImage& full, const DecodedImage& reduced, const int factor) {
+  double squaredError = 0;
+  for (int y = 0; y < reduced.height; y++) {
+    for (int x = 0; x < reduced.width; x++) {
+      int sum = 0;
+      int count = 0;
+      for (int dy = 0; dy < factor; dy++) {
+        for (int dx = 0; dx < factor; dx++) {
+          const int srcX = x * factor + dx;
+          const int srcY = y * factor + dy;
+          if (srcX < full.width && srcY < full.height) {
+            sum += full.gray[srcY * full.width + srcX];
+            count++;
+          }
+        }
+      }
+      const double diff = reduced.gray[y * reduced.width + x] - static_cast<double>(sum) / count;
+      squaredError += diff * diff;
+    }
+  }
+  const double mse = squaredError / (reduced.width * reduced.height);
+  return mse == 0 ? 99.0 : 10 * std::log10(255.0 * 255.0 / mse);
+}
+
+template <typename Fn>
+double timeMs(Fn&& fn) {
+  const auto start = std::chrono::steady_clock::now();
+  fn();
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+  const char* path = argc > 1 ? argv[1] : "docs/images/cover.jpg";
+
+  DecodedImage full;
+  bool ok = false;
+  const double fullMs = timeMs([&] { ok = decode(path, PJPG_REDUCE_NONE, 0, full); });
+  if (!ok) {
+    std::cout << "Could not decode " << path << std::endl;
+    return 1;
+  }
+  std::cout << path << ": " << full.width << "x" << full.height << std::endl;
+  std::cout << "  full size:  " << fullMs << " ms" << std::endl;
+
+  struct Mode {
+    const char* name;
+    unsigned char reduce;
+    int shift;
+  };
+  const Mode modes[] = {{"1/2 luma", PJPG_REDUCE_LUMA_2, 1},
+                        {"1/4 luma", PJPG_REDUCE_LUMA_4, 2},
+                        {"1/8 luma", PJPG_REDUCE_LUMA_8, 3},
+                        {"1/8 DC", PJPG_REDUCE_DC, 3}};
+
+  int failures = 0;
+  for (const Mode& mode : modes) {
+    DecodedImage reduced;
+    const double ms = timeMs([&] { ok = decode(path, mode.reduce, mode.shift, reduced); });
+    const double psnr = ok ? psnrAgainstBox(full, reduced, 1 << mode.shift) : 0;
+    std::cout << "  " << mode.name << ":   " << ms << " ms (" << fullMs / ms << "x), " << reduced.width << "x"
+              << reduced.height << ", " << psnr << " dB against a box-filtered full decode" << std::endl;
+    if (!ok || psnr < kMinPsnr) {
+      std::cout << "MISMATCH " << mode.name << " decode is not a downscaled copy of the image" << std::endl;
+      failures++;
+    }
+  }
+
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,50 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Builds the CSS style resolution check against the emulated HAL in test/emulator/host and runs it. Generated
+# stylesheets are loaded through CssParser, and resolveStyle is compared with plain map lookups on random elements.
+
+ROOT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+BUILD_DIR="$ROOT_DIR/build/css_resolve_bench"
+HOST_DIR="$ROOT_DIR/test/emulator/host"
+BINARY="$BUILD_DIR/CssResolveBenchmark"
+
+mkdir -p "$BUILD_DIR"
+
+DEFINES=(
+  -DCROSSPOINT_EMULATED=1
+  -DMINIZ_NO_ZLIB_COMPATIBLE_NAMES=1
+)
+
+INCLUDES=(-I"$HOST_DIR" -I"$ROOT_DIR/src" -I"$ROOT_DIR/lib")
+for dir in "$ROOT_DIR"/lib/*/; do
+  INCLUDES+=(-I"$dir")
+done
+
+# miniz is vendored C, built without warnings; CssParser links ZipFile for its zip stream overload
+cc -O2 -w "${DEFINES[@]}" -c "$ROOT_DIR/lib/miniz/miniz.c" -o "$BUILD_DIR/miniz.o"
+
+SOURCES=(
+  "$ROOT_DIR"/test/css_resolve_bench/CssResolveBenchmark.cpp
+  "$HOST_DIR"/*.cpp
+  "$ROOT_DIR"/lib/hal/HalDisplay.cpp
+  "$ROOT_DIR"/lib/hal/HalStorage.cpp
+  "$ROOT_DIR"/lib/Epub/Epub/css/CssParser.cpp
+  "$ROOT_DIR"/lib/ZipFile/*.cpp
+)
+
+CXXFLAGS=(
+  -std=c++20
+  -O2
+  -g
+  -Wall
+  # Firmware printf formats assume a 32-bit target and would drown the output on a 64-bit host
+  -Wno-format
+  -pthread
+  # The ESP32 toolchain's headers pull the standard library in transitively, which some firmware headers rely on
+  -include Arduino.h
+)
+
+c++ "${CXXFLAGS[@]}" "${DEFINES[@]}" "${INCLUDES[@]}" "${SOURCES[@]}" "$BUILD_DIR/miniz.o" -o "$BINARY"
+
+"$BINARY" "$@"
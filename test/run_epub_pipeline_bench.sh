@@ -0,0 +1,88 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Builds the EPUB pipeline benchmark against the emulated HAL in test/emulator/host and runs it over a directory of
+# EPUBs, e.g.:
+#   test/run_epub_pipeline_bench.sh --out results.csv ~/books
+
+ROOT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+BUILD_DIR="$ROOT_DIR/build/epub_pipeline_bench"
+HOST_DIR="$ROOT_DIR/test/emulator/host"
+BINARY="$BUILD_DIR/EpubPipelineBenchmark"
+
+mkdir -p "$BUILD_DIR/obj"
+
+DEFINES=(
+  -DCROSSPOINT_EMULATED=1
+  -DMINIZ_NO_ZLIB_COMPATIBLE_NAMES=1
+  -DXML_GE=0
+  -DXML_CONTEXT_BYTES=1024
+)
+
+INCLUDES=(-I"$HOST_DIR" -I"$ROOT_DIR/src" -I"$ROOT_DIR/lib")
+for dir in "$ROOT_DIR"/lib/*/; do
+  INCLUDES+=(-I"$dir")
+done
+
+# expat, miniz and picojpeg are vendored C, built without warnings
+C_SOURCES=(
+  "$ROOT_DIR/lib/expat/xmlparse.c"
+  "$ROOT_DIR/lib/expat/xmlrole.c"
+  "$ROOT_DIR/lib/expat/xmltok.c"
+  "$ROOT_DIR/lib/miniz/miniz.c"
+  "$ROOT_DIR/lib/picojpeg/picojpeg.c"
+)
+C_OBJECTS=()
+for source in "${C_SOURCES[@]}"; do
+  object="$BUILD_DIR/obj/$(basename "$source").o"
+  cc -O2 -g -w "${DEFINES[@]}" "${INCLUDES[@]}" -c "$source" -o "$object"
+  C_OBJECTS+=("$object")
+done
+
+SOURCES=(
+  "$ROOT_DIR"/test/epub_pipeline_bench/EpubPipelineBenchmark.cpp
+  "$HOST_DIR"/*.cpp
+  "$ROOT_DIR"/lib/hal/HalDisplay.cpp
+  "$ROOT_DIR"/lib/hal/HalStorage.cpp
+  "$ROOT_DIR"/lib/EpdFont/*.cpp
+  "$ROOT_DIR"/lib/Epub/Epub.cpp
+  "$ROOT_DIR"/lib/Epub/Epub/*.cpp
+  "$ROOT_DIR"/lib/Epub/Epub/*/*.cpp
+  "$ROOT_DIR"/lib/FsHelpers/*.cpp
+  "$ROOT_DIR"/lib/GfxRenderer/*.cpp
+  "$ROOT_DIR"/lib/JpegToBmpConverter/*.cpp
+  "$ROOT_DIR"/lib/PngToBmpConverter/*.cpp
+  "$ROOT_DIR"/lib/GifToBmpConverter/*.cpp
+  "$ROOT_DIR"/lib/Utf8/*.cpp
+  "$ROOT_DIR"/lib/ZipFile/*.cpp
+)
+
+CXXFLAGS=(
+  -std=c++20
+  -O2
+  -g
+  -Wall
+  # Firmware printf formats assume a 32-bit target and would drown the output on a 64-bit host
+  -Wno-format
+  # The generated font tables quote bidirectional control characters in their glyph comments
+  -Wno-bidi-chars
+  -pthread
+  # The ESP32 toolchain's headers pull the standard library in transitively, which some firmware headers rely on
+  -include Arduino.h
+)
+
+# One object per source, compiled in parallel; object names keep the source path so equal basenames don't clash
+CXX_OBJECTS=()
+for source in "${SOURCES[@]}"; do
+  relative="${source#"$ROOT_DIR"/}"
+  CXX_OBJECTS+=("$BUILD_DIR/obj/${relative//\//_}.o")
+done
+export ROOT_DIR BUILD_DIR
+printf '%s\n' "${SOURCES[@]}" | xargs -P "$(nproc)" -I{} bash -c '
+  relative="${1#"$ROOT_DIR"/}"
+  c++ "${@:2}" -c "$1" -o "$BUILD_DIR/obj/${relative//\//_}.o"
+' _ {} "${CXXFLAGS[@]}" "${DEFINES[@]}" "${INCLUDES[@]}"
+
+c++ -pthread "${CXX_OBJECTS[@]}" "${C_OBJECTS[@]}" -o "$BINARY"
+
+"$BINARY" "$@"
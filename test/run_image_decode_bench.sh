@@ -0,0 +1,52 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Builds the PNG and GIF decoder checks against the emulated HAL in test/emulator/host and runs them. The fixtures are
+# encoded by the test itself; every decoded BMP is compared with the expected rows written through BmpRowWriter.
+
+ROOT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+BUILD_DIR="$ROOT_DIR/build/image_decode_bench"
+HOST_DIR="$ROOT_DIR/test/emulator/host"
+BINARY="$BUILD_DIR/ImageDecodeBenchmark"
+
+mkdir -p "$BUILD_DIR"
+
+DEFINES=(
+  -DCROSSPOINT_EMULATED=1
+  -DMINIZ_NO_ZLIB_COMPATIBLE_NAMES=1
+)
+
+INCLUDES=(-I"$HOST_DIR" -I"$ROOT_DIR/src" -I"$ROOT_DIR/lib")
+for dir in "$ROOT_DIR"/lib/*/; do
+  INCLUDES+=(-I"$dir")
+done
+
+# miniz is vendored C, built without warnings; the test also uses its deflate side to encode PNG fixtures
+cc -O2 -w "${DEFINES[@]}" -c "$ROOT_DIR/lib/miniz/miniz.c" -o "$BUILD_DIR/miniz.o"
+
+SOURCES=(
+  "$ROOT_DIR"/test/image_decode_bench/ImageDecodeBenchmark.cpp
+  "$HOST_DIR"/*.cpp
+  "$ROOT_DIR"/lib/hal/HalDisplay.cpp
+  "$ROOT_DIR"/lib/hal/HalStorage.cpp
+  "$ROOT_DIR"/lib/GfxRenderer/BmpRowWriter.cpp
+  "$ROOT_DIR"/lib/GfxRenderer/BitmapHelpers.cpp
+  "$ROOT_DIR"/lib/PngToBmpConverter/*.cpp
+  "$ROOT_DIR"/lib/GifToBmpConverter/*.cpp
+)
+
+CXXFLAGS=(
+  -std=c++20
+  -O2
+  -g
+  -Wall
+  # Firmware printf formats assume a 32-bit target and would drown the output on a 64-bit host
+  -Wno-format
+  -pthread
+  # The ESP32 toolchain's headers pull the standard library in transitively, which some firmware headers rely on
+  -include Arduino.h
+)
+
+c++ "${CXXFLAGS[@]}" "${DEFINES[@]}" "${INCLUDES[@]}" "${SOURCES[@]}" "$BUILD_DIR/miniz.o" -o "$BINARY"
+
+"$BINARY" "$@"
@@ -0,0 +1,29 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+ROOT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+BUILD_DIR="$ROOT_DIR/build/jpeg_scale_bench"
+BINARY="$BUILD_DIR/JpegScaleBenchmark"
+
+mkdir -p "$BUILD_DIR"
+
+# picojpeg is C; build it on its own and link it in
+cc -O2 -w -I"$ROOT_DIR/lib/picojpeg" -c "$ROOT_DIR/lib/picojpeg/picojpeg.c" -o "$BUILD_DIR/picojpeg.o"
+
+SOURCES=(
+  "$ROOT_DIR/test/jpeg_scale_bench/JpegScaleBenchmark.cpp"
+  "$BUILD_DIR/picojpeg.o"
+)
+
+CXXFLAGS=(
+  -std=c++20
+  -O2
+  -Wall
+  -Wextra
+  -pedantic
+  -I"$ROOT_DIR/lib/picojpeg"
+)
+
+c++ "${CXXFLAGS[@]}" "${SOURCES[@]}" -o "$BINARY"
+
+"$BINARY" "${@:-$ROOT_DIR/docs/images/cover.jpg}"
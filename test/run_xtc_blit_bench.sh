@@ -0,0 +1,32 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+ROOT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+BUILD_DIR="$ROOT_DIR/build/xtc_blit_bench"
+BINARY="$BUILD_DIR/XtcBlitBenchmark"
+
+mkdir -p "$BUILD_DIR"
+
+SOURCES=(
+  "$ROOT_DIR/test/xtc_blit_bench/XtcBlitBenchmark.cpp"
+  "$ROOT_DIR/lib/Xtc/Xtc/XtcPageBlitter.cpp"
+  "$ROOT_DIR/lib/Xtc/Xtc/XtcPageDecoder.cpp"
+)
+
+CXXFLAGS=(
+  -std=c++20
+  -O2
+  -Wall
+  -Wextra
+  -pedantic
+  -I"$ROOT_DIR"
+  -I"$ROOT_DIR/lib/miniz"
+  -DMINIZ_NO_ZLIB_COMPATIBLE_NAMES=1
+)
+
+# miniz is C; build it separately so the C++ flags above do not apply to it
+cc -O2 -DMINIZ_NO_ZLIB_COMPATIBLE_NAMES=1 -DMINIZ_NO_STDIO -c "$ROOT_DIR/lib/miniz/miniz.c" -o "$BUILD_DIR/miniz.o"
+
+c++ "${CXXFLAGS[@]}" "${SOURCES[@]}" "$BUILD_DIR/miniz.o" -o "$BINARY"
+
+"$BINARY" "$@"
@@ -0,0 +1,140 @@
+#include <EpdFontFamily.h>
+#include <Utf8.h>
+#include <builtinFonts/bookerly_14_bold.h>
+#include <builtinFonts/bookerly_14_bolditalic.h>
+#include <builtinFonts/bookerly_14_italic.h>
+#include <builtinFonts/bookerly_14_regular.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Mixed Latin, Latin-1 and general punctuation so both halves of the metrics cache are exercised
+const char* const kParagraph =
+    "It was a bright cold day in April, and the clocks were striking thirteen. Winston Smith, his chin nuzzled into "
+    "his breast in an effort to escape the vile wind, slipped quickly through the glass doors of Victory Mansions, "
+    "though not quickly enough to prevent a swirl of gritty dust from entering along with him. Quand j’étais "
+    "petit, je lisais «Les Misérables» — über 1 234 567 890 Seiten! “Naturally,” "
+    "she said…";
+
+struct Word {
+  std::string text;
+  EpdFontFamily::Style style;
+};
+
+std::vector<Word> splitWords() {
+  std::vector<Word> words;
+  const std::string paragraph = kParagraph;
+  size_t start = 0;
+  while (start < paragraph.size()) {
+    size_t end = paragraph.find(' ', start);
+    if (end == std::string::npos) {
+      end = paragraph.size();
+    }
+    if (end > start) {
+      words.push_back({paragraph.substr(start, end - start), static_cast<EpdFontFamily::Style>(words.size() % 4)});
+    }
+    start = end + 1;
+  }
+  return words;
+}
+
+// The measurement GfxRenderer::getTextWidth did before the metrics cache: full text bounds per word
+int referenceWidth(const EpdFontFamily& family, const char* text, const EpdFontFamily::Style style) {
+  int w = 0;
+  int h = 0;
+  family.getTextDimensions(text, &w, &h, style);
+  return w;
+}
+
+// The loop GfxRenderer::getTextAdvanceX ran before (regular style only)
+int referenceAdvance(const EpdFontFamily& family, const char* text, const EpdFontFamily::Style style) {
+  int width = 0;
+  uint32_t cp;
+  while ((cp = utf8NextCodepoint(reinterpret_cast<const uint8_t**>(&text)))) {
+    const EpdGlyph* glyph = family.getGlyph(cp, style);
+    if (!glyph) {
+      glyph = family.getGlyph(REPLACEMENT_GLYPH, style);
+    }
+    width += glyph->advanceX;
+    if (EpdFontFamily::globalForceBold && cp != ' ' && cp != 0x00A0) {
+      width -= 1;
+    }
+  }
+  return width;
+}
+
+// Same shape as ParsedText::calculateWordWidths: one width per word, pushed into a reserved vector
+template <typename MeasureFn>
+double wordsPerSecond(const std::vector<Word>& words, const int iterations, MeasureFn&& measure) {
+  size_t checksum = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    std::vector<uint16_t> wordWidths;
+    wordWidths.reserve(words.size());
+    for (const auto& word : words) {
+      wordWidths.push_back(static_cast<uint16_t>(measure(word.text.c_str(), word.style)));
+    }
+    checksum += wordWidths.back();
+  }
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  if (checksum == 0) {
+    std::cout << "(empty checksum)" << std::endl;
+  }
+  return static_cast<double>(words.size()) * iterations / seconds;
+}
+
+int main(int argc, char* argv[]) {
+  const int iterations = argc > 1 ? std::atoi(argv[1]) : 20000;
+
+  const EpdFont regular(&bookerly_14_regular);
+  const EpdFont bold(&bookerly_14_bold);
+  const EpdFont italic(&bookerly_14_italic);
+  const EpdFont boldItalic(&bookerly_14_bolditalic);
+  const EpdFontFamily family(&regular, &bold, &italic, &boldItalic);
+  const auto words = splitWords();
+
+  // Cached widths and advances must match the uncached measurement exactly, with and without forced bold tracking
+  int failures = 0;
+  for (const bool forceBold : {false, true}) {
+    EpdFontFamily::globalForceBold = forceBold;
+    for (int pass = 0; pass < 2; pass++) {
+      for (const auto& word : words) {
+        const char* text = word.text.c_str();
+        const int expectedWidth = referenceWidth(family, text, word.style);
+        const int expectedAdvance = referenceAdvance(family, text, word.style);
+        if (family.getTextWidth(text, word.style) != expectedWidth ||
+            family.getTextAdvanceX(text, word.style) != expectedAdvance) {
+          std::cout << "MISMATCH \"" << word.text << "\" style " << word.style << " forceBold " << forceBold
+                    << std::endl;
+          failures++;
+        }
+      }
+    }
+  }
+  EpdFontFamily::globalForceBold = false;
+  std::cout << (failures == 0 ? "All cached widths match the text bounds reference" : "Width mismatches found")
+            << std::endl
+            << std::endl;
+
+  const double referenceRate = wordsPerSecond(words, iterations, [&](const char* text, EpdFontFamily::Style style) {
+    return referenceWidth(family, text, style);
+  });
+  const double cachedRate = wordsPerSecond(words, iterations, [&](const char* text, EpdFontFamily::Style style) {
+    return family.getTextWidth(text, style);
+  });
+  const double advanceRate = wordsPerSecond(words, iterations, [&](const char* text, EpdFontFamily::Style style) {
+    return family.getTextAdvanceX(text, style);
+  });
+
+  std::cout << "bookerly_14, " << words.size() << " words x " << iterations << " paragraphs" << std::endl;
+  std::cout << "  text bounds:       " << static_cast<long>(referenceRate) << " words/s" << std::endl;
+  std::cout << "  cached width:      " << static_cast<long>(cachedRate) << " words/s (" << cachedRate / referenceRate
+            << "x)" << std::endl;
+  std::cout << "  cached advance:    " << static_cast<long>(advanceRate) << " words/s (" << advanceRate / referenceRate
+            << "x)" << std::endl;
+
+  return failures == 0 ? 0 : 1;
+}
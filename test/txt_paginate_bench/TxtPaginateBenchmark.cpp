@@ -0,0 +1,228 @@
+#include <EpdFont.h>
+#include <builtinFonts/bookerly_14_regular.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "lib/Txt/TxtPaginator.h"
+
+constexpr int kViewportWidth = 440;
+constexpr int kLinesPerPage = 24;
+
+const char* const kSentences[] = {
+    "It was a bright cold day in April, and the clocks were striking thirteen. ",
+    "Winston Smith, his chin nuzzled into his breast in an effort to escape the vile wind, slipped quickly through the "
+    "glass doors of Victory Mansions. ",
+    "Quand j’étais petit, je lisais «Les Misérables» — über 1 234 567 890 Seiten! ",
+    "Supercalifragilisticexpialidociousandthensomemorewithoutanyspacesatallsothatitmustbreakinsideaword. ",
+    "“Naturally,” she said… ",
+};
+
+// Paragraphs of varying length, LF and CRLF line ends, runs of blank lines and the odd paragraph longer than a window
+std::string makeText(const size_t targetSize) {
+  std::string text;
+  unsigned seed = 12345;
+  while (text.size() < targetSize) {
+    seed = seed * 1103515245 + 12345;
+    const unsigned sentences = (seed >> 16) % 12 + 1;
+    for (unsigned i = 0; i < sentences; i++) {
+      text += kSentences[(seed >> (i % 8)) % 5];
+    }
+    if ((seed >> 8) % 97 == 0) {
+      for (int i = 0; i < 80; i++) {
+        text += kSentences[i % 5];
+      }
+    }
+    text += (seed >> 4) % 3 == 0 ? "\r\n" : "\n";
+    if ((seed >> 12) % 5 == 0) {
+      text += "\n\n";
+    }
+  }
+  return text;
+}
+
+int textWidth(const EpdFont& font, const std::string& text) {
+  int w = 0;
+  int h = 0;
+  font.getTextDimensions(text.c_str(), &w, &h);
+  return w;
+}
+
+// TxtReaderActivity::loadPageAtOffset before the paginator: every break point found by measuring shrinking substr
+// copies of the line from the start
+bool referenceLoadPage(const EpdFont& font, const std::string& file, const size_t offset,
+                       std::vector<std::string>& outLines, size_t& nextOffset) {
+  outLines.clear();
+  const size_t fileSize = file.size();
+  if (offset >= fileSize) {
+    return false;
+  }
+  const size_t chunkSize = std::min(TxtPaginator::WINDOW_SIZE, fileSize - offset);
+  const std::string chunk = file.substr(offset, chunkSize);
+  const char* buffer = chunk.c_str();
+
+  size_t pos = 0;
+  while (pos < chunkSize && static_cast<int>(outLines.size()) < kLinesPerPage) {
+    size_t lineEnd = pos;
+    while (lineEnd < chunkSize && buffer[lineEnd] != '\n') {
+      lineEnd++;
+    }
+    const bool lineComplete = (lineEnd < chunkSize) || (offset + lineEnd >= fileSize);
+    if (!lineComplete && !outLines.empty()) {
+      break;
+    }
+    const size_t lineContentLen = lineEnd - pos;
+    const bool hasCR = (lineContentLen > 0 && buffer[pos + lineContentLen - 1] == '\r');
+    const size_t displayLen = hasCR ? lineContentLen - 1 : lineContentLen;
+    std::string line(buffer + pos, displayLen);
+    size_t lineBytePos = 0;
+
+    while (!line.empty() && static_cast<int>(outLines.size()) < kLinesPerPage) {
+      if (textWidth(font, line) <= kViewportWidth) {
+        outLines.push_back(line);
+        lineBytePos = displayLen;
+        line.clear();
+        break;
+      }
+      size_t breakPos = line.length();
+      while (breakPos > 0 && textWidth(font, line.substr(0, breakPos)) > kViewportWidth) {
+        const size_t spacePos = line.rfind(' ', breakPos - 1);
+        if (spacePos != std::string::npos && spacePos > 0) {
+          breakPos = spacePos;
+        } else {
+          breakPos--;
+          while (breakPos > 0 && (line[breakPos] & 0xC0) == 0x80) {
+            breakPos--;
+          }
+        }
+      }
+      if (breakPos == 0) {
+        breakPos = 1;
+      }
+      outLines.push_back(line.substr(0, breakPos));
+      size_t skipChars = breakPos;
+      if (breakPos < line.length() && line[breakPos] == ' ') {
+        skipChars++;
+      }
+      lineBytePos += skipChars;
+      line = line.substr(skipChars);
+    }
+
+    if (line.empty()) {
+      pos = lineEnd + 1;
+    } else {
+      pos = pos + lineBytePos;
+      break;
+    }
+  }
+  nextOffset = std::min(offset + pos, fileSize);
+  return !outLines.empty();
+}
+
+std::vector<size_t> referenceBuildIndex(const EpdFont& font, const std::string& file) {
+  std::vector<size_t> pageOffsets = {0};
+  size_t offset = 0;
+  std::vector<std::string> lines;
+  while (offset < file.size()) {
+    size_t nextOffset = offset;
+    if (!referenceLoadPage(font, file, offset, lines, nextOffset) || nextOffset <= offset) {
+      break;
+    }
+    offset = nextOffset;
+    if (offset < file.size()) {
+      pageOffsets.push_back(offset);
+    }
+  }
+  return pageOffsets;
+}
+
+// `pagesPerSlice` > 0 pauses and resumes the index every that many pages, like the reader's background indexing
+std::vector<size_t> paginatorBuildIndex(const TxtPaginator& paginator, const std::string& file, size_t* reads,
+                                        const int pagesPerSlice) {
+  std::vector<size_t> pageOffsets;
+  *reads = 0;
+  TxtPaginator::IndexStatus status;
+  do {
+    size_t readOffset = pageOffsets.empty() ? 0 : pageOffsets.back();
+    int pages = 0;
+    status = paginator.buildIndex(
+        file.size(),
+        [&](uint8_t* buf, const size_t len) {
+          const size_t bytes = std::min(len, file.size() - readOffset);
+          memcpy(buf, file.data() + readOffset, bytes);
+          readOffset += bytes;
+          *reads += bytes;
+          return bytes;
+        },
+        pageOffsets, [&](size_t) { return pagesPerSlice > 0 && ++pages == pagesPerSlice; });
+  } while (status == TxtPaginator::IndexStatus::Paused);
+  return pageOffsets;
+}
+
+template <typename Fn>
+double timeMs(Fn&& fn) {
+  const auto start = std::chrono::steady_clock::now();
+  fn();
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+  const size_t textSize = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 128 * 1024;
+
+  const EpdFont font(&bookerly_14_regular);
+  const TxtPaginator paginator(font, kViewportWidth, kLinesPerPage);
+  const std::string text = makeText(textSize);
+
+  std::vector<size_t> referenceOffsets;
+  std::vector<size_t> offsets;
+  size_t bytesRead = 0;
+  const double referenceMs = timeMs([&] { referenceOffsets = referenceBuildIndex(font, text); });
+  const double paginatorMs = timeMs([&] { offsets = paginatorBuildIndex(paginator, text, &bytesRead, 0); });
+
+  // Same page offsets (so existing index.bin caches stay valid) and the same lines on every page
+  int failures = 0;
+  if (offsets != referenceOffsets) {
+    std::cout << "MISMATCH page offsets: " << offsets.size() << " pages vs " << referenceOffsets.size() << std::endl;
+    failures++;
+  }
+  for (const size_t offset : referenceOffsets) {
+    std::vector<std::string> expected;
+    size_t expectedNext = 0;
+    referenceLoadPage(font, text, offset, expected, expectedNext);
+
+    std::vector<std::string> lines;
+    size_t consumed = 0;
+    const size_t windowSize = std::min(TxtPaginator::WINDOW_SIZE, text.size() - offset);
+    paginator.layoutPage(
+        reinterpret_cast<const uint8_t*>(text.data() + offset), windowSize, offset + windowSize >= text.size(),
+        [&lines](const char* line, const size_t length) { lines.emplace_back(line, length); }, consumed);
+    if (lines != expected || offset + consumed != expectedNext) {
+      std::cout << "MISMATCH page at offset " << offset << std::endl;
+      failures++;
+    }
+  }
+  if (bytesRead != text.size()) {
+    std::cout << "Paginator read " << bytesRead << " of " << text.size() << " bytes" << std::endl;
+    failures++;
+  }
+  size_t slicedBytesRead = 0;
+  if (paginatorBuildIndex(paginator, text, &slicedBytesRead, 7) != referenceOffsets) {
+    std::cout << "MISMATCH page offsets when indexing in slices" << std::endl;
+    failures++;
+  }
+  std::cout << (failures == 0 ? "Page offsets and lines match the substr reference" : "Pagination mismatches found")
+            << std::endl
+            << std::endl;
+
+  std::cout << text.size() << " bytes, " << offsets.size() << " pages" << std::endl;
+  std::cout << "  substr reference: " << referenceMs << " ms" << std::endl;
+  std::cout << "  paginator:        " << paginatorMs << " ms (" << referenceMs / paginatorMs << "x), " << bytesRead
+            << " bytes read" << std::endl;
+
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <list>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "lib/Epub/Epub/blocks/WordBuffer.h"
+
+// Heap accounting via global operator new/delete so both storage layouts are measured the same way
+namespace {
+size_t gLiveBytes = 0;
+size_t gPeakBytes = 0;
+size_t gAllocCount = 0;
+
+void resetCounters() {
+  gLiveBytes = 0;
+  gPeakBytes = 0;
+  gAllocCount = 0;
+}
+}  // namespace
+
+__attribute__((noinline)) void* operator new(const size_t size) {
+  // Stash the size in front of the block so delete can account for it
+  auto* block = static_cast<size_t*>(std::malloc(size + sizeof(std::max_align_t)));
+  if (!block) {
+    throw std::bad_alloc();
+  }
+  *block = size;
+  gLiveBytes += size;
+  gAllocCount++;
+  if (gLiveBytes > gPeakBytes) {
+    gPeakBytes = gLiveBytes;
+  }
+  return reinterpret_cast<char*>(block) + sizeof(std::max_align_t);
+}
+
+__attribute__((noinline)) void operator delete(void* ptr) noexcept {
+  if (!ptr) {
+    return;
+  }
+  auto* block = reinterpret_cast<size_t*>(static_cast<char*>(ptr) - sizeof(std::max_align_t));
+  gLiveBytes -= *block;
+  std::free(block);
+}
+
+void operator delete(void* ptr, size_t) noexcept { operator delete(ptr); }
+
+struct RunResult {
+  size_t peakBytes;
+  size_t allocations;
+  double micros;
+};
+
+const char* const kSampleWords[] = {"The",   "quick", "brown", "fox",  "jumps", "over",            "the",
+                                    "lazy",  "dog,",  "while", "an",   "extraordinarily",  "patient", "reader",
+                                    "turns", "pages", "late",  "into", "the",   "night."};
+constexpr size_t kSampleWordCount = sizeof(kSampleWords) / sizeof(kSampleWords[0]);
+
+// Mirrors the previous ParsedText/TextBlock layout: three parallel std::lists per paragraph and per line
+RunResult runListStorage(const size_t paragraphWords, const size_t wordsPerLine, const int paragraphs) {
+  resetCounters();
+  const auto start = std::chrono::steady_clock::now();
+  size_t checksum = 0;
+  for (int p = 0; p < paragraphs; p++) {
+    std::list<std::string> words;
+    std::list<uint8_t> styles;
+    std::list<bool> continues;
+    for (size_t i = 0; i < paragraphWords; i++) {
+      words.emplace_back(kSampleWords[i % kSampleWordCount]);
+      styles.push_back(0);
+      continues.push_back(false);
+    }
+    while (!words.empty()) {
+      std::list<std::string> lineWords;
+      std::list<uint16_t> lineXPos;
+      std::list<uint8_t> lineStyles;
+      for (size_t i = 0; i < wordsPerLine && !words.empty(); i++) {
+        lineWords.splice(lineWords.end(), words, words.begin());
+        lineXPos.push_back(static_cast<uint16_t>(i * 40));
+        lineStyles.splice(lineStyles.end(), styles, styles.begin());
+        continues.pop_front();
+      }
+      for (const auto& w : lineWords) {
+        checksum += w.size();
+      }
+    }
+  }
+  const auto end = std::chrono::steady_clock::now();
+  if (checksum == 0) {
+    std::cerr << "unexpected checksum" << std::endl;
+  }
+  return {gPeakBytes, gAllocCount, std::chrono::duration<double, std::micro>(end - start).count() / paragraphs};
+}
+
+RunResult runWordBuffer(const size_t paragraphWords, const size_t wordsPerLine, const int paragraphs) {
+  resetCounters();
+  const auto start = std::chrono::steady_clock::now();
+  size_t checksum = 0;
+  // The parser reuses one buffer across paragraphs
+  WordBuffer words;
+  for (int p = 0; p < paragraphs; p++) {
+    words.clear();
+    for (size_t i = 0; i < paragraphWords; i++) {
+      const char* word = kSampleWords[i % kSampleWordCount];
+      words.push(word, strlen(word), EpdFontFamily::REGULAR, false);
+    }
+    size_t consumed = 0;
+    while (consumed < words.size()) {
+      const size_t lineEnd = std::min(consumed + wordsPerLine, words.size());
+      WordBuffer lineWords;
+      lineWords.reserve(lineEnd - consumed, 0);
+      for (size_t i = consumed; i < lineEnd; i++) {
+        lineWords.push(words.c_str(i), words[i].length, words[i].style, false, static_cast<uint16_t>(i * 40));
+      }
+      for (size_t i = 0; i < lineWords.size(); i++) {
+        checksum += lineWords[i].length;
+      }
+      consumed = lineEnd;
+    }
+  }
+  const auto end = std::chrono::steady_clock::now();
+  if (checksum == 0) {
+    std::cerr << "unexpected checksum" << std::endl;
+  }
+  return {gPeakBytes, gAllocCount, std::chrono::duration<double, std::micro>(end - start).count() / paragraphs};
+}
+
+void printResult(const char* name, const RunResult& result, const int paragraphs) {
+  std::cout << name << ": peak heap " << result.peakBytes << " B, " << result.allocations / paragraphs
+            << " allocations/paragraph, " << result.micros << " us/paragraph" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+  const size_t paragraphWords = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 750;
+  const size_t wordsPerLine = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 9;
+  constexpr int paragraphs = 200;
+
+  std::cout << "Paragraph of " << paragraphWords << " words, " << wordsPerLine << " words per line, " << paragraphs
+            << " paragraphs" << std::endl;
+
+  const RunResult listResult = runListStorage(paragraphWords, wordsPerLine, paragraphs);
+  const RunResult bufferResult = runWordBuffer(paragraphWords, wordsPerLine, paragraphs);
+
+  printResult("std::list storage", listResult, paragraphs);
+  printResult("WordBuffer       ", bufferResult, paragraphs);
+  return 0;
+}
@@ -0,0 +1,425 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "lib/Xtc/Xtc/XtcPageBlitter.h"
+#include "lib/Xtc/Xtc/XtcPageDecoder.h"
+#include "miniz.h"
+
+// Same geometry as the X4 panel (HalDisplay / EInkDisplay)
+constexpr int kPanelWidth = 800;
+constexpr int kPanelHeight = 480;
+constexpr int kPanelWidthBytes = kPanelWidth / 8;
+constexpr size_t kBufferSize = kPanelWidthBytes * kPanelHeight;
+
+using xtc::XtcPageBlitter;
+
+// Page pixel values in reading order: 0 = white, 1 = dark grey, 2 = light grey, 3 = black
+struct SourcePage {
+  int width;
+  int height;
+  std::vector<uint8_t> values;
+
+  uint8_t at(const int x, const int y) const { return values[y * width + x]; }
+};
+
+// Text-like content: lines of "words" made of black strokes with grey anti-aliased edges
+SourcePage makeSourcePage(const int width, const int height, const bool grayscale) {
+  SourcePage page{width, height, std::vector<uint8_t>(static_cast<size_t>(width) * height, 0)};
+  uint32_t seed = 0x12345678u ^ (width * 31 + height);
+  const auto next = [&seed] {
+    seed = seed * 1664525u + 1013904223u;
+    return seed >> 8;
+  };
+  for (int y = 0; y < height; y++) {
+    const bool inLine = (y % 36) >= 8 && (y % 36) < 30;
+    for (int x = 0; x < width; x++) {
+      uint8_t value = 0;
+      if (inLine && (x / 7 + y / 36) % 9 != 0) {
+        const uint32_t r = next() % 16;
+        value = r < 7 ? 0 : (r < 12 ? 3 : (grayscale ? static_cast<uint8_t>(1 + r % 2) : 3));
+      }
+      page.values[static_cast<size_t>(y) * width + x] = value;
+    }
+  }
+  return page;
+}
+
+// XTG: row-major, MSB first, 0 = black
+std::vector<uint8_t> encodeXtg(const SourcePage& page) {
+  const size_t rowBytes = (page.width + 7) / 8;
+  std::vector<uint8_t> data(rowBytes * page.height, 0xFF);
+  for (int y = 0; y < page.height; y++) {
+    for (int x = 0; x < page.width; x++) {
+      if (page.at(x, y) != 0) {
+        data[y * rowBytes + x / 8] &= ~(1 << (7 - x % 8));
+      }
+    }
+  }
+  return data;
+}
+
+// XTH: two column-major planes, columns right to left, MSB = topmost pixel
+std::vector<uint8_t> encodeXth(const SourcePage& page) {
+  const size_t planeSize = (static_cast<size_t>(page.width) * page.height + 7) / 8;
+  const size_t colBytes = (page.height + 7) / 8;
+  // The last column of the first plane may run past planeSize when the height is not a multiple of 8
+  std::vector<uint8_t> data(planeSize + page.width * colBytes, 0);
+  for (int x = 0; x < page.width; x++) {
+    for (int y = 0; y < page.height; y++) {
+      const uint8_t value = page.at(x, y);
+      const size_t offset = (page.width - 1 - x) * colBytes + y / 8;
+      const uint8_t bit = 1 << (7 - y % 8);
+      if (value & 2) {
+        data[offset] |= bit;
+      }
+      if (value & 1) {
+        data[planeSize + offset] |= bit;
+      }
+    }
+  }
+  return data;
+}
+
+// Reference: the per-pixel path XtcReaderActivity::renderPage used before the blitter, with GfxRenderer::drawPixel
+// in portrait orientation. drawPixel lives in another translation unit on device, so keep it out of line here too.
+struct ReferenceRenderer {
+  uint8_t* frameBuffer;
+
+  __attribute__((noinline)) void drawPixel(const int x, const int y, const bool state) const {
+    const int phyX = y;
+    const int phyY = kPanelHeight - 1 - x;
+    if (phyX < 0 || phyX >= kPanelWidth || phyY < 0 || phyY >= kPanelHeight) {
+      return;
+    }
+    const uint16_t byteIndex = phyY * kPanelWidthBytes + (phyX / 8);
+    const uint8_t bitPosition = 7 - (phyX % 8);
+    if (state) {
+      frameBuffer[byteIndex] &= ~(1 << bitPosition);
+    } else {
+      frameBuffer[byteIndex] |= 1 << bitPosition;
+    }
+  }
+
+  void drawXtg(const uint8_t* pageBuffer, const uint16_t pageWidth, const uint16_t pageHeight) const {
+    const size_t srcRowBytes = (pageWidth + 7) / 8;
+    for (uint16_t srcY = 0; srcY < pageHeight; srcY++) {
+      const size_t srcRowStart = srcY * srcRowBytes;
+      for (uint16_t srcX = 0; srcX < pageWidth; srcX++) {
+        const size_t srcByte = srcRowStart + srcX / 8;
+        const size_t srcBit = 7 - (srcX % 8);
+        const bool isBlack = !((pageBuffer[srcByte] >> srcBit) & 1);
+        if (isBlack) {
+          drawPixel(srcX, srcY, true);
+        }
+      }
+    }
+  }
+
+  static auto pixelReader(const uint8_t* pageBuffer, const uint16_t pageWidth, const uint16_t pageHeight) {
+    const size_t planeSize = (static_cast<size_t>(pageWidth) * pageHeight + 7) / 8;
+    const uint8_t* plane1 = pageBuffer;
+    const uint8_t* plane2 = pageBuffer + planeSize;
+    const size_t colBytes = (pageHeight + 7) / 8;
+    return [=](uint16_t x, uint16_t y) -> uint8_t {
+      const size_t colIndex = pageWidth - 1 - x;
+      const size_t byteInCol = y / 8;
+      const size_t bitInByte = 7 - (y % 8);
+      const size_t byteOffset = colIndex * colBytes + byteInCol;
+      const uint8_t bit1 = (plane1[byteOffset] >> bitInByte) & 1;
+      const uint8_t bit2 = (plane2[byteOffset] >> bitInByte) & 1;
+      return (bit1 << 1) | bit2;
+    };
+  }
+
+  void drawXthPlane(const uint8_t* pageBuffer, const uint16_t pageWidth, const uint16_t pageHeight,
+                    const XtcPageBlitter::Plane plane) const {
+    const auto getPixelValue = pixelReader(pageBuffer, pageWidth, pageHeight);
+    for (uint16_t y = 0; y < pageHeight; y++) {
+      for (uint16_t x = 0; x < pageWidth; x++) {
+        const uint8_t pv = getPixelValue(x, y);
+        if (plane == XtcPageBlitter::Plane::Bw && pv >= 1) {
+          drawPixel(x, y, true);
+        } else if (plane == XtcPageBlitter::Plane::GrayLsb && pv == 1) {
+          drawPixel(x, y, false);
+        } else if (plane == XtcPageBlitter::Plane::GrayMsb && (pv == 1 || pv == 2)) {
+          drawPixel(x, y, false);
+        }
+      }
+    }
+  }
+
+  static void countXthPixels(const uint8_t* pageBuffer, const uint16_t pageWidth, const uint16_t pageHeight,
+                             uint32_t counts[4]) {
+    const auto getPixelValue = pixelReader(pageBuffer, pageWidth, pageHeight);
+    counts[0] = counts[1] = counts[2] = counts[3] = 0;
+    for (uint16_t y = 0; y < pageHeight; y++) {
+      for (uint16_t x = 0; x < pageWidth; x++) {
+        counts[getPixelValue(x, y)]++;
+      }
+    }
+  }
+};
+
+// Raw deflate, as a converter writing PAGE_COMPRESSION_DEFLATE pages would store it
+std::vector<uint8_t> deflatePage(const uint8_t* bitmap, const size_t size) {
+  size_t compressedSize = 0;
+  void* compressed = tdefl_compress_mem_to_heap(bitmap, size, &compressedSize, TDEFL_DEFAULT_MAX_PROBES);
+  std::vector<uint8_t> payload(static_cast<uint8_t*>(compressed), static_cast<uint8_t*>(compressed) + compressedSize);
+  mz_free(compressed);
+  return payload;
+}
+
+// XtcPageDecoder::ReadFn over an in-memory payload, handing out at most `maxRead` bytes per call like a short SD read
+auto memoryReader(const std::vector<uint8_t>& payload, size_t& cursor, const size_t maxRead = SIZE_MAX) {
+  cursor = 0;
+  return [&payload, &cursor, maxRead](uint8_t* buf, const size_t len) {
+    const size_t count = std::min({len, payload.size() - cursor, maxRead});
+    memcpy(buf, payload.data() + cursor, count);
+    cursor += count;
+    return count;
+  };
+}
+
+// Feed `data` to a stream blitter in chunks of `chunkSize` bytes
+template <typename Stream>
+void feed(Stream& stream, const std::vector<uint8_t>& data, const size_t chunkSize) {
+  for (size_t offset = 0; offset < data.size(); offset += chunkSize) {
+    stream.write(data.data() + offset, std::min(chunkSize, data.size() - offset), offset);
+  }
+}
+
+uint8_t background(const XtcPageBlitter::Plane plane) { return plane == XtcPageBlitter::Plane::Bw ? 0xFF : 0x00; }
+
+template <typename Fn>
+double timePerPage(const int iterations, Fn&& renderPage) {
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    renderPage();
+  }
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+int main(int argc, char* argv[]) {
+  const int iterations = argc > 1 ? std::atoi(argv[1]) : 20;
+
+  std::vector<uint8_t> reference(kBufferSize);
+  std::vector<uint8_t> blitted(kBufferSize);
+  const ReferenceRenderer referenceRenderer{reference.data()};
+  const XtcPageBlitter::Panel panel = {blitted.data(), kPanelWidth, kPanelHeight, kPanelWidthBytes};
+  const XtcPageBlitter::Plane planes[] = {XtcPageBlitter::Plane::Bw, XtcPageBlitter::Plane::GrayLsb,
+                                          XtcPageBlitter::Plane::GrayMsb};
+  const char* const planeNames[] = {"BW", "GRAY_LSB", "GRAY_MSB"};
+
+  // The X4 page size, plus odd sizes that exercise clipping and partial bytes on every edge
+  const int sizes[][2] = {{480, 800}, {472, 792}, {500, 810}, {480, 803}, {477, 797}};
+
+  int failures = 0;
+  for (const auto& size : sizes) {
+    const SourcePage monoPage = makeSourcePage(size[0], size[1], false);
+    const SourcePage grayPage = makeSourcePage(size[0], size[1], true);
+    const auto xtg = encodeXtg(monoPage);
+    const auto xth = encodeXth(grayPage);
+    const auto width = static_cast<uint16_t>(size[0]);
+    const auto height = static_cast<uint16_t>(size[1]);
+
+    // Every plane is checked on a cleared buffer and on a noisy one, since undrawn pixels must stay untouched
+    for (const bool noisy : {false, true}) {
+      const auto prepare = [&](const uint8_t value) {
+        for (size_t i = 0; i < kBufferSize; i++) {
+          reference[i] = noisy ? static_cast<uint8_t>(i * 2654435761u >> 13) : value;
+        }
+        blitted = reference;
+      };
+
+      prepare(0xFF);
+      referenceRenderer.drawXtg(xtg.data(), width, height);
+      XtcPageBlitter::blitXtg(xtg.data(), width, height, panel);
+      if (reference != blitted) {
+        std::cout << "MISMATCH XTG " << size[0] << "x" << size[1] << (noisy ? " noisy" : "") << std::endl;
+        failures++;
+      }
+
+      for (int p = 0; p < 3; p++) {
+        prepare(background(planes[p]));
+        referenceRenderer.drawXthPlane(xth.data(), width, height, planes[p]);
+        XtcPageBlitter::blitXth(xth.data(), width, height, planes[p], panel);
+        if (reference != blitted) {
+          std::cout << "MISMATCH XTH " << planeNames[p] << " " << size[0] << "x" << size[1]
+                    << (noisy ? " noisy" : "") << std::endl;
+          failures++;
+        }
+      }
+    }
+
+    // Stream blitters fed in arbitrary chunks must draw exactly what the whole-page blitters draw. The XTH stream
+    // stages the first plane in the framebuffer, so it is only defined on a buffer cleared to the plane's background.
+    for (const size_t chunkSize : {size_t{1}, size_t{7}, size_t{1000}, size_t{4096}}) {
+      for (const bool noisy : {false, true}) {
+        for (size_t i = 0; i < kBufferSize; i++) {
+          reference[i] = noisy ? static_cast<uint8_t>(i * 2654435761u >> 13) : 0xFF;
+        }
+        blitted = reference;
+        XtcPageBlitter::blitXtg(xtg.data(), width, height, {reference.data(), kPanelWidth, kPanelHeight,
+                                                            kPanelWidthBytes});
+        XtcPageBlitter::XtgStream stream(width, height, panel);
+        feed(stream, xtg, chunkSize);
+        if (reference != blitted) {
+          std::cout << "MISMATCH XTG stream " << size[0] << "x" << size[1] << " chunk " << chunkSize
+                    << (noisy ? " noisy" : "") << std::endl;
+          failures++;
+        }
+      }
+
+      for (int p = 0; p < 3; p++) {
+        memset(reference.data(), background(planes[p]), kBufferSize);
+        blitted = reference;
+        XtcPageBlitter::blitXth(xth.data(), width, height, planes[p],
+                                {reference.data(), kPanelWidth, kPanelHeight, kPanelWidthBytes});
+        XtcPageBlitter::XthStream stream(width, height, planes[p], panel);
+        feed(stream, xth, chunkSize);
+        if (reference != blitted) {
+          std::cout << "MISMATCH XTH stream " << planeNames[p] << " " << size[0] << "x" << size[1] << " chunk "
+                    << chunkSize << std::endl;
+          failures++;
+        }
+      }
+    }
+
+    // Deflated pages must decode back to the exact bitmap, whole and streamed, whatever the read granularity
+    for (const auto* bitmap : {&xtg, &xth}) {
+      const auto payload = deflatePage(bitmap->data(), bitmap->size());
+      for (const size_t maxRead : {size_t{3}, size_t{SIZE_MAX}}) {
+        size_t cursor;
+        std::vector<uint8_t> decoded(bitmap->size());
+        const auto wholeResult = xtc::XtcPageDecoder::decode(xtc::PAGE_COMPRESSION_DEFLATE, payload.size(),
+                                                             bitmap->size(), memoryReader(payload, cursor, maxRead),
+                                                             decoded.data());
+
+        std::vector<uint8_t> streamed;
+        const auto streamResult = xtc::XtcPageDecoder::decodeStreaming(
+            xtc::PAGE_COMPRESSION_DEFLATE, payload.size(), bitmap->size(), memoryReader(payload, cursor, maxRead),
+            [&streamed](const uint8_t* data, const size_t chunkSize, const size_t offset) {
+              if (offset == streamed.size()) {
+                streamed.insert(streamed.end(), data, data + chunkSize);
+              }
+            },
+            1024);
+
+        if (wholeResult != xtc::XtcError::OK || decoded != *bitmap || streamResult != xtc::XtcError::OK ||
+            streamed != *bitmap) {
+          std::cout << "MISMATCH deflate " << (bitmap == &xtg ? "XTG " : "XTH ") << size[0] << "x" << size[1]
+                    << " read " << maxRead << std::endl;
+          failures++;
+        }
+      }
+
+      // A truncated payload must fail instead of handing back a partial page
+      size_t cursor;
+      std::vector<uint8_t> decoded(bitmap->size());
+      if (xtc::XtcPageDecoder::decode(xtc::PAGE_COMPRESSION_DEFLATE, payload.size() / 2, bitmap->size(),
+                                      memoryReader(payload, cursor), decoded.data()) == xtc::XtcError::OK) {
+        std::cout << "Truncated deflate payload decoded " << size[0] << "x" << size[1] << std::endl;
+        failures++;
+      }
+    }
+
+    uint32_t referenceCounts[4];
+    uint32_t counts[4];
+    ReferenceRenderer::countXthPixels(xth.data(), width, height, referenceCounts);
+    XtcPageBlitter::countXthPixels(xth.data(), width, height, counts);
+    if (memcmp(referenceCounts, counts, sizeof(counts)) != 0) {
+      std::cout << "MISMATCH XTH histogram " << size[0] << "x" << size[1] << std::endl;
+      failures++;
+    }
+  }
+
+  std::cout << (failures == 0 ? "All framebuffers match the per-pixel reference" : "Framebuffer mismatches found")
+            << std::endl
+            << std::endl;
+
+  // Full page turns at the X4 page size, as XtcReaderActivity::renderPage does them (display calls excluded)
+  const SourcePage monoPage = makeSourcePage(480, 800, false);
+  const SourcePage grayPage = makeSourcePage(480, 800, true);
+  const auto xtg = encodeXtg(monoPage);
+  const auto xth = encodeXth(grayPage);
+
+  const double referenceXtgMicros = timePerPage(iterations, [&] {
+    memset(reference.data(), 0xFF, kBufferSize);
+    referenceRenderer.drawXtg(xtg.data(), 480, 800);
+  });
+  const double blitXtgMicros = timePerPage(iterations, [&] {
+    memset(blitted.data(), 0xFF, kBufferSize);
+    XtcPageBlitter::blitXtg(xtg.data(), 480, 800, panel);
+  });
+
+  // Histogram, BW, LSB, MSB and the BW re-render
+  const double referenceXthMicros = timePerPage(iterations, [&] {
+    uint32_t counts[4];
+    ReferenceRenderer::countXthPixels(xth.data(), 480, 800, counts);
+    for (const auto plane : {XtcPageBlitter::Plane::Bw, XtcPageBlitter::Plane::GrayLsb,
+                             XtcPageBlitter::Plane::GrayMsb, XtcPageBlitter::Plane::Bw}) {
+      memset(reference.data(), background(plane), kBufferSize);
+      referenceRenderer.drawXthPlane(xth.data(), 480, 800, plane);
+    }
+  });
+  const auto blitXthPage = [&](const bool histogram) {
+    if (histogram) {
+      uint32_t counts[4];
+      XtcPageBlitter::countXthPixels(xth.data(), 480, 800, counts);
+    }
+    for (const auto plane : {XtcPageBlitter::Plane::Bw, XtcPageBlitter::Plane::GrayLsb,
+                             XtcPageBlitter::Plane::GrayMsb, XtcPageBlitter::Plane::Bw}) {
+      memset(blitted.data(), background(plane), kBufferSize);
+      XtcPageBlitter::blitXth(xth.data(), 480, 800, plane, panel);
+    }
+  };
+  const double blitXthHistogramMicros = timePerPage(iterations, [&] { blitXthPage(true); });
+  const double blitXthMicros = timePerPage(iterations, [&] { blitXthPage(false); });
+
+  // Page decode from memory, stored vs deflated, and the streamed XTH page turn without any page buffer (every plane
+  // pass decodes the page again)
+  const size_t xthBitmapSize = xth.size();
+  const auto xtgPayload = deflatePage(xtg.data(), xtg.size());
+  const auto xthPayload = deflatePage(xth.data(), xthBitmapSize);
+  std::vector<uint8_t> pageBuffer(xthBitmapSize);
+  size_t cursor;
+  const double storedDecodeMicros = timePerPage(iterations, [&] {
+    xtc::XtcPageDecoder::decode(xtc::PAGE_COMPRESSION_NONE, xthBitmapSize, xthBitmapSize, memoryReader(xth, cursor),
+                                pageBuffer.data());
+  });
+  const double deflateDecodeMicros = timePerPage(iterations, [&] {
+    xtc::XtcPageDecoder::decode(xtc::PAGE_COMPRESSION_DEFLATE, xthPayload.size(), xthBitmapSize,
+                                memoryReader(xthPayload, cursor), pageBuffer.data());
+  });
+  const double streamedXthMicros = timePerPage(iterations, [&] {
+    for (const auto plane : {XtcPageBlitter::Plane::Bw, XtcPageBlitter::Plane::GrayLsb,
+                             XtcPageBlitter::Plane::GrayMsb, XtcPageBlitter::Plane::Bw}) {
+      memset(blitted.data(), background(plane), kBufferSize);
+      XtcPageBlitter::XthStream stream(480, 800, plane, panel);
+      xtc::XtcPageDecoder::decodeStreaming(
+          xtc::PAGE_COMPRESSION_DEFLATE, xthPayload.size(), xthBitmapSize, memoryReader(xthPayload, cursor),
+          [&stream](const uint8_t* data, const size_t size, const size_t offset) { stream.write(data, size, offset); },
+          1024);
+    }
+  });
+
+  std::cout << "480x800 pages, " << iterations << " iterations" << std::endl;
+  std::cout << "  XTG: drawPixel " << referenceXtgMicros << " us, blitter " << blitXtgMicros << " us ("
+            << referenceXtgMicros / blitXtgMicros << "x)" << std::endl;
+  std::cout << "  XTH (histogram + 4 plane passes): drawPixel " << referenceXthMicros << " us, blitter "
+            << blitXthHistogramMicros << " us (" << referenceXthMicros / blitXthHistogramMicros
+            << "x), blitter without histogram " << blitXthMicros << " us (" << referenceXthMicros / blitXthMicros
+            << "x)" << std::endl;
+  std::cout << "  Payload: XTG " << xtg.size() << " -> " << xtgPayload.size() << " bytes deflated, XTH "
+            << xthBitmapSize << " -> " << xthPayload.size() << " bytes deflated" << std::endl;
+  std::cout << "  XTH decode: stored " << storedDecodeMicros << " us, deflated " << deflateDecodeMicros
+            << " us, streamed deflated page turn (4 decodes + plane passes) " << streamedXthMicros << " us"
+            << std::endl;
+
+  return failures == 0 ? 0 : 1;
+}